@@ -0,0 +1,806 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAU3DTilesExporter.h"
+#include "PLATEAUExportSettings.h"
+#include "PLATEAUInstancedCityModel.h"
+#include "Component/PLATEAUCityObjectGroup.h"
+#include "Util/PLATEAUComponentUtil.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/Texture.h"
+#include "StaticMeshResources.h"
+#include "Materials/MaterialInstance.h"
+#include "MaterialTypes.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformFileManager.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include <atomic>
+
+#if WITH_EDITOR
+#include "HAL/FileManager.h"
+#include "EditorFramework/AssetImportData.h"
+#endif
+
+namespace {
+    constexpr uint32 GlbMagic = 0x46546C67;          // "glTF"
+    constexpr uint32 GlbVersion = 2;
+    constexpr uint32 GlbChunkTypeJson = 0x4E4F534A;  // "JSON"
+    constexpr uint32 GlbChunkTypeBin = 0x004E4942;   // "BIN\0"
+
+    constexpr int32 GltfComponentTypeFloat = 5126;
+    constexpr int32 GltfComponentTypeUnsignedInt = 5125;
+    constexpr int32 GltfTargetArrayBuffer = 34962;
+    constexpr int32 GltfTargetElementArrayBuffer = 34963;
+
+    constexpr TCHAR TilesDirectoryName[] = TEXT("tiles");
+    constexpr TCHAR TilesetFileName[] = TEXT("tileset.json");
+    constexpr TCHAR MetadataClassName[] = TEXT("city_object");
+    constexpr TCHAR GmlIdPropertyName[] = TEXT("gml_id");
+    constexpr TCHAR TypePropertyName[] = TEXT("city_object_type");
+    constexpr TCHAR AttributesPropertyName[] = TEXT("attributes");
+
+    // 4分木の最大深さ。同一地点に大量のコンポーネントが重なる場合の無限分割防止
+    constexpr int32 MaxTileDepth = 16;
+
+    /**
+     * @brief glbに格納する地物情報(プロパティテーブルの1行)
+     */
+    struct FTileFeature {
+        FString GmlId;
+        FString Type;
+        FString AttributesJson;
+    };
+
+    /**
+     * @brief マテリアル単位のインデックス列
+     */
+    struct FTileSubMesh {
+        TArray<uint32> Indices;
+        FString TexturePath;
+    };
+
+    /**
+     * @brief 1コンポーネント分のメッシュ情報。座標はENU(m)です。
+     */
+    struct FTileComponentData {
+        FString Name;
+        TArray<FVector> Positions;
+        TArray<FVector3f> Normals;
+        TArray<FVector2f> UVs;
+        // Featuresへのインデックス
+        TArray<float> FeatureIds;
+        TArray<FTileSubMesh> SubMeshes;
+        TArray<FTileFeature> Features;
+        FBox Bounds = FBox(ForceInit);
+    };
+
+    struct FTileNode {
+        FString Id;
+        FBox Bounds = FBox(ForceInit);
+        TArray<int32> ComponentIndices;
+        TArray<TUniquePtr<FTileNode>> Children;
+
+        bool IsLeaf() const {
+            return Children.Num() == 0;
+        }
+    };
+
+    /**
+     * @brief glbのバイナリチャンクとbufferView, accessorを構築します。
+     */
+    class FGlbBuilder {
+    public:
+        int32 AddBufferView(const void* Data, const int64 Size, const int32 Target) {
+            Align();
+            const auto Offset = Bin.Num();
+            Bin.Append(static_cast<const uint8*>(Data), Size);
+
+            const auto View = MakeShared<FJsonObject>();
+            View->SetNumberField(TEXT("buffer"), 0);
+            View->SetNumberField(TEXT("byteOffset"), Offset);
+            View->SetNumberField(TEXT("byteLength"), Size);
+            if (Target != 0)
+                View->SetNumberField(TEXT("target"), Target);
+            BufferViews.Add(MakeShared<FJsonValueObject>(View));
+            return BufferViews.Num() - 1;
+        }
+
+        int32 AddAccessor(const int32 BufferView, const int32 ComponentType, const int32 Count, const FString& Type,
+                          const TArray<double>& Min = {}, const TArray<double>& Max = {}) {
+            const auto Accessor = MakeShared<FJsonObject>();
+            Accessor->SetNumberField(TEXT("bufferView"), BufferView);
+            Accessor->SetNumberField(TEXT("componentType"), ComponentType);
+            Accessor->SetNumberField(TEXT("count"), Count);
+            Accessor->SetStringField(TEXT("type"), Type);
+            if (Min.Num() > 0 && Max.Num() > 0) {
+                Accessor->SetArrayField(TEXT("min"), ToJsonArray(Min));
+                Accessor->SetArrayField(TEXT("max"), ToJsonArray(Max));
+            }
+            Accessors.Add(MakeShared<FJsonValueObject>(Accessor));
+            return Accessors.Num() - 1;
+        }
+
+        /**
+         * @brief EXT_structural_metadataの文字列プロパティを追加します。
+         */
+        TSharedRef<FJsonObject> AddStringProperty(const TArray<FString>& Values) {
+            TArray<uint8> Bytes;
+            TArray<uint32> Offsets;
+            Offsets.Reserve(Values.Num() + 1);
+            for (const auto& Value : Values) {
+                Offsets.Add(Bytes.Num());
+                const FTCHARToUTF8 Utf8(*Value);
+                Bytes.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+            }
+            Offsets.Add(Bytes.Num());
+
+            const auto Property = MakeShared<FJsonObject>();
+            Property->SetNumberField(TEXT("values"), AddBufferView(Bytes.GetData(), Bytes.Num(), 0));
+            Property->SetNumberField(TEXT("stringOffsets"), AddBufferView(Offsets.GetData(), Offsets.Num() * sizeof(uint32), 0));
+            Property->SetStringField(TEXT("stringOffsetType"), TEXT("UINT32"));
+            return Property;
+        }
+
+        void Align() {
+            while (Bin.Num() % 4 != 0)
+                Bin.Add(0);
+        }
+
+        static TArray<TSharedPtr<FJsonValue>> ToJsonArray(const TArray<double>& Values) {
+            TArray<TSharedPtr<FJsonValue>> Array;
+            for (const auto Value : Values)
+                Array.Add(MakeShared<FJsonValueNumber>(Value));
+            return Array;
+        }
+
+        TArray<uint8> Bin;
+        TArray<TSharedPtr<FJsonValue>> BufferViews;
+        TArray<TSharedPtr<FJsonValue>> Accessors;
+    };
+
+    /**
+     * @brief ESU(cm)の座標をENU(m)に変換します。
+     */
+    FVector ConvertToENU(const FVector& InPosition) {
+        return FVector(InPosition.X, -InPosition.Y, InPosition.Z) * 0.01;
+    }
+
+    /**
+     * @brief ENUの座標をglTF(Y-up)の座標に変換します。3D Tilesではglb読み込み時にY-upからZ-upへ戻されます。
+     */
+    FVector3f ConvertToGltf(const FVector& InEnu) {
+        return FVector3f(InEnu.X, InEnu.Z, -InEnu.Y);
+    }
+
+    /**
+     * @brief 緯度経度高さにおけるENU座標系からECEF座標系への変換行列(列優先)を求めます。
+     */
+    TArray<double> CreateEnuToEcefTransform(const FPLATEAUGeoCoordinate& Origin) {
+        // WGS84
+        constexpr double A = 6378137.0;
+        constexpr double F = 1.0 / 298.257223563;
+        constexpr double E2 = F * (2.0 - F);
+
+        const double Lat = FMath::DegreesToRadians(Origin.Latitude);
+        const double Lon = FMath::DegreesToRadians(Origin.Longitude);
+        const double SinLat = FMath::Sin(Lat);
+        const double CosLat = FMath::Cos(Lat);
+        const double SinLon = FMath::Sin(Lon);
+        const double CosLon = FMath::Cos(Lon);
+        const double N = A / FMath::Sqrt(1.0 - E2 * SinLat * SinLat);
+
+        const FVector Position(
+            (N + Origin.Height) * CosLat * CosLon,
+            (N + Origin.Height) * CosLat * SinLon,
+            (N * (1.0 - E2) + Origin.Height) * SinLat);
+        const FVector East(-SinLon, CosLon, 0.0);
+        const FVector North(-SinLat * CosLon, -SinLat * SinLon, CosLat);
+        const FVector Up(CosLat * CosLon, CosLat * SinLon, SinLat);
+
+        return {
+            East.X, East.Y, East.Z, 0.0,
+            North.X, North.Y, North.Z, 0.0,
+            Up.X, Up.Y, Up.Z, 0.0,
+            Position.X, Position.Y, Position.Z, 1.0
+        };
+    }
+
+    TArray<TSharedPtr<FJsonValue>> CreateBoundingBox(const FBox& Bounds) {
+        const auto Center = Bounds.GetCenter();
+        // 高さ0の箱はビューアによって正しく扱えないため最小値を設ける
+        const auto Extent = Bounds.GetExtent().ComponentMax(FVector(0.01));
+        return FGlbBuilder::ToJsonArray({
+            Center.X, Center.Y, Center.Z,
+            Extent.X, 0.0, 0.0,
+            0.0, Extent.Y, 0.0,
+            0.0, 0.0, Extent.Z
+        });
+    }
+
+    TSharedRef<FJsonObject> CreateAttributesJsonObject(const FPLATEAUAttributeMap& InAttributeMap) {
+        const auto JsonObject = MakeShared<FJsonObject>();
+        for (const auto& Pair : InAttributeMap.AttributeMap) {
+            const auto& Key = Pair.Key;
+            const auto& Value = Pair.Value;
+            switch (Value.Type) {
+            case EPLATEAUAttributeType::AttributeSets:
+                if (Value.Attributes.IsValid())
+                    JsonObject->SetObjectField(Key, CreateAttributesJsonObject(*Value.Attributes));
+                break;
+            case EPLATEAUAttributeType::Double:
+            case EPLATEAUAttributeType::Measure:
+                JsonObject->SetNumberField(Key, Value.DoubleValue);
+                break;
+            case EPLATEAUAttributeType::Integer:
+                JsonObject->SetNumberField(Key, Value.IntValue);
+                break;
+            default:
+                JsonObject->SetStringField(Key, Value.StringValue);
+                break;
+            }
+        }
+        return JsonObject;
+    }
+
+    FTileFeature CreateFeature(const FPLATEAUCityObject& InCityObject, const bool bExportAttributes) {
+        FTileFeature Feature;
+        Feature.GmlId = InCityObject.GmlID;
+        Feature.Type = plateau::CityObject::CityObjectsTypeToString(InCityObject.Type);
+        if (bExportAttributes) {
+            const auto Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Feature.AttributesJson);
+            FJsonSerializer::Serialize(CreateAttributesJsonObject(InCityObject.Attributes), Writer);
+        }
+        return Feature;
+    }
+
+    /**
+     * @brief マテリアルが参照するテクスチャの元ファイルパスを取得します。取得できない場合は空文字を返します。
+     */
+    FString GetTextureSourcePath(UMaterialInterface* MaterialInterface) {
+#if WITH_EDITOR
+        const auto MaterialInstance = Cast<UMaterialInstance>(MaterialInterface);
+        if (MaterialInstance == nullptr || MaterialInstance->TextureParameterValues.Num() == 0)
+            return FString();
+
+        FMaterialParameterMetadata MetaData;
+        MaterialInstance->TextureParameterValues[0].GetValue(MetaData);
+        const auto Texture = MetaData.Value.Texture;
+        if (Texture == nullptr || Texture->AssetImportData == nullptr)
+            return FString();
+
+        const auto TextureSourceFiles = Texture->AssetImportData->GetSourceData().SourceFiles;
+        if (TextureSourceFiles.Num() == 0)
+            return FString();
+
+        const auto AssetBasePath = FPaths::GetPath(Texture->GetPackage()->GetLoadedPath().GetLocalFullPath());
+        const auto TextureFilePath = AssetBasePath / TextureSourceFiles[0].RelativeFilename;
+        return IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*TextureFilePath);
+#else
+        return FString();
+#endif
+    }
+
+    /**
+     * @brief glTFで扱える画像形式であればMIMEタイプを返します。
+     */
+    FString GetImageMimeType(const FString& InPath) {
+        const auto Extension = FPaths::GetExtension(InPath).ToLower();
+        if (Extension == TEXT("png"))
+            return TEXT("image/png");
+        if (Extension == TEXT("jpg") || Extension == TEXT("jpeg"))
+            return TEXT("image/jpeg");
+        return FString();
+    }
+
+    /**
+     * @brief コンポーネントのメッシュと地物情報を取得します。
+     * @return メッシュが存在しない場合false
+     */
+    bool ExtractComponentData(UPLATEAUCityObjectGroup* Component, const FTransform& ActorTransform, const FPLATEAUMeshExportOptions& Option, FTileComponentData& OutData) {
+        const auto StaticMesh = Component->GetStaticMesh();
+        if (StaticMesh == nullptr)
+            return false;
+
+        const auto& RenderMesh = StaticMesh->GetLODForExport(0);
+        const auto& PositionBuffer = RenderMesh.VertexBuffers.PositionVertexBuffer;
+        const auto& VertexBuffer = RenderMesh.VertexBuffers.StaticMeshVertexBuffer;
+        const auto NumVertices = PositionBuffer.GetNumVertices();
+        if (NumVertices == 0 || RenderMesh.IndexBuffer.GetNumIndices() == 0)
+            return false;
+
+        OutData.Name = Component->GetName();
+        const auto ComponentTransform = Component->GetComponentTransform().GetRelativeTransform(ActorTransform);
+
+        OutData.Positions.Reserve(NumVertices);
+        OutData.Normals.Reserve(NumVertices);
+        OutData.UVs.Reserve(NumVertices);
+        for (uint32 i = 0; i < NumVertices; ++i) {
+            const auto Position = ConvertToENU(ComponentTransform.TransformPosition(FVector(PositionBuffer.VertexPosition(i))));
+            OutData.Positions.Add(Position);
+            OutData.Bounds += Position;
+
+            const auto Normal = ConvertToENU(ComponentTransform.TransformVectorNoScale(FVector(FVector3f(VertexBuffer.VertexTangentZ(i))))).GetSafeNormal();
+            OutData.Normals.Add(FVector3f(Normal));
+            OutData.UVs.Add(VertexBuffer.GetNumTexCoords() > 0 ? VertexBuffer.GetVertexUV(i, 0) : FVector2f::ZeroVector);
+        }
+
+        // UV4(CityObjectIndex)から地物IDを求める
+        const auto RootCityObjects = Component->GetAllRootCityObjects();
+        TMap<FIntPoint, const FPLATEAUCityObject*> IndexToCityObject;
+        for (const auto& RootCityObject : RootCityObjects) {
+            IndexToCityObject.Add(FIntPoint(RootCityObject.CityObjectIndex.PrimaryIndex, RootCityObject.CityObjectIndex.AtomicIndex), &RootCityObject);
+            for (const auto& Child : RootCityObject.Children) {
+                IndexToCityObject.Add(FIntPoint(Child.CityObjectIndex.PrimaryIndex, Child.CityObjectIndex.AtomicIndex), &Child);
+            }
+        }
+
+        TMap<const FPLATEAUCityObject*, int32> CityObjectToFeatureId;
+        int32 ComponentFeatureId = INDEX_NONE;
+        const bool bHasCityObjectUV = VertexBuffer.GetNumTexCoords() > 3;
+        OutData.FeatureIds.Reserve(NumVertices);
+        for (uint32 i = 0; i < NumVertices; ++i) {
+            const FPLATEAUCityObject* CityObject = nullptr;
+            if (bHasCityObjectUV) {
+                const auto UV = VertexBuffer.GetVertexUV(i, 3);
+                const auto PrimaryIndex = FMath::RoundToInt32(UV.X);
+                const auto AtomicIndex = FMath::RoundToInt32(UV.Y);
+                if (const auto Found = IndexToCityObject.Find(FIntPoint(PrimaryIndex, AtomicIndex)))
+                    CityObject = *Found;
+                else if (const auto FoundPrimary = IndexToCityObject.Find(FIntPoint(PrimaryIndex, -1)))
+                    CityObject = *FoundPrimary;
+            }
+
+            if (CityObject != nullptr) {
+                if (const auto FeatureId = CityObjectToFeatureId.Find(CityObject)) {
+                    OutData.FeatureIds.Add(*FeatureId);
+                    continue;
+                }
+                const auto FeatureId = OutData.Features.Add(CreateFeature(*CityObject, Option.bExportAttributes));
+                CityObjectToFeatureId.Add(CityObject, FeatureId);
+                OutData.FeatureIds.Add(FeatureId);
+                continue;
+            }
+
+            // 対応する地物が見つからない場合はコンポーネント自体を1つの地物とみなす
+            if (ComponentFeatureId == INDEX_NONE) {
+                FTileFeature Feature;
+                Feature.GmlId = FPLATEAUComponentUtil::GetOriginalComponentName(Component);
+                ComponentFeatureId = OutData.Features.Add(Feature);
+            }
+            OutData.FeatureIds.Add(ComponentFeatureId);
+        }
+
+        for (int32 SectionIndex = 0; SectionIndex < RenderMesh.Sections.Num(); ++SectionIndex) {
+            const auto& Section = RenderMesh.Sections[SectionIndex];
+            if (Section.NumTriangles <= 0)
+                continue;
+
+            FTileSubMesh SubMesh;
+            SubMesh.Indices.Reserve(Section.NumTriangles * 3);
+            for (uint32 i = 0; i < Section.NumTriangles * 3; ++i) {
+                SubMesh.Indices.Add(RenderMesh.IndexBuffer.GetIndex(Section.FirstIndex + i));
+            }
+            if (Option.bExportTexture) {
+                SubMesh.TexturePath = GetTextureSourcePath(Component->GetMaterial(Section.MaterialIndex));
+            }
+            OutData.SubMeshes.Add(MoveTemp(SubMesh));
+        }
+        return OutData.SubMeshes.Num() > 0;
+    }
+
+    void BuildTileTree(FTileNode& Node, const TArray<int32>& Indices, const TArray<FTileComponentData>& Components, const int32 MaxComponentsPerTile, const int32 Depth) {
+        for (const auto Index : Indices) {
+            Node.Bounds += Components[Index].Bounds;
+        }
+
+        if (Indices.Num() <= MaxComponentsPerTile || Depth >= MaxTileDepth) {
+            Node.ComponentIndices = Indices;
+            return;
+        }
+
+        // バウンディングボックス中心の属する象限でXY平面を4分割
+        const auto Center = Node.Bounds.GetCenter();
+        TArray<int32> Quadrants[4];
+        for (const auto Index : Indices) {
+            const auto ComponentCenter = Components[Index].Bounds.GetCenter();
+            const auto Quadrant = (ComponentCenter.X >= Center.X ? 1 : 0) + (ComponentCenter.Y >= Center.Y ? 2 : 0);
+            Quadrants[Quadrant].Add(Index);
+        }
+
+        // すべて同じ象限に入る場合はこれ以上分割できない
+        for (const auto& Quadrant : Quadrants) {
+            if (Quadrant.Num() == Indices.Num()) {
+                Node.ComponentIndices = Indices;
+                return;
+            }
+        }
+
+        for (int32 i = 0; i < 4; ++i) {
+            if (Quadrants[i].Num() == 0)
+                continue;
+
+            auto Child = MakeUnique<FTileNode>();
+            Child->Id = FString::Printf(TEXT("%s_%d"), *Node.Id, i);
+            BuildTileTree(*Child, Quadrants[i], Components, MaxComponentsPerTile, Depth + 1);
+            Node.Children.Add(MoveTemp(Child));
+        }
+    }
+
+    void CollectLeaves(FTileNode& Node, TArray<FTileNode*>& OutLeaves) {
+        if (Node.IsLeaf()) {
+            OutLeaves.Add(&Node);
+            return;
+        }
+        for (const auto& Child : Node.Children) {
+            CollectLeaves(*Child, OutLeaves);
+        }
+    }
+
+    FString GetTileContentUri(const FTileNode& Node) {
+        return FString::Printf(TEXT("%s/%s.glb"), TilesDirectoryName, *Node.Id);
+    }
+
+    TSharedRef<FJsonObject> CreateTileJsonObject(const FTileNode& Node) {
+        const auto Tile = MakeShared<FJsonObject>();
+        const auto BoundingVolume = MakeShared<FJsonObject>();
+        BoundingVolume->SetArrayField(TEXT("box"), CreateBoundingBox(Node.Bounds));
+        Tile->SetObjectField(TEXT("boundingVolume"), BoundingVolume);
+
+        if (Node.IsLeaf()) {
+            Tile->SetNumberField(TEXT("geometricError"), 0.0);
+            const auto Content = MakeShared<FJsonObject>();
+            Content->SetStringField(TEXT("uri"), GetTileContentUri(Node));
+            Tile->SetObjectField(TEXT("content"), Content);
+            return Tile;
+        }
+
+        // 子タイルはLODを持たないため、タイルの大きさを幾何誤差として扱う
+        Tile->SetNumberField(TEXT("geometricError"), Node.Bounds.GetSize().Size());
+        Tile->SetStringField(TEXT("refine"), TEXT("ADD"));
+        TArray<TSharedPtr<FJsonValue>> Children;
+        for (const auto& Child : Node.Children) {
+            Children.Add(MakeShared<FJsonValueObject>(CreateTileJsonObject(*Child)));
+        }
+        Tile->SetArrayField(TEXT("children"), Children);
+        return Tile;
+    }
+
+    bool WriteGlb(const FString& FilePath, const TSharedRef<FJsonObject>& Gltf, FGlbBuilder& Builder) {
+        FString JsonString;
+        const auto Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&JsonString);
+        if (!FJsonSerializer::Serialize(Gltf, Writer))
+            return false;
+
+        const FTCHARToUTF8 JsonUtf8(*JsonString);
+        TArray<uint8> JsonChunk;
+        JsonChunk.Append(reinterpret_cast<const uint8*>(JsonUtf8.Get()), JsonUtf8.Length());
+        while (JsonChunk.Num() % 4 != 0)
+            JsonChunk.Add(' ');
+        Builder.Align();
+
+        TArray<uint8> Glb;
+        const auto AppendUint32 = [&Glb](const uint32 Value) {
+            for (int32 i = 0; i < 4; ++i)
+                Glb.Add(static_cast<uint8>((Value >> (i * 8)) & 0xFF));
+        };
+        const uint32 TotalLength = 12 + 8 + JsonChunk.Num() + 8 + Builder.Bin.Num();
+        Glb.Reserve(TotalLength);
+        AppendUint32(GlbMagic);
+        AppendUint32(GlbVersion);
+        AppendUint32(TotalLength);
+        AppendUint32(JsonChunk.Num());
+        AppendUint32(GlbChunkTypeJson);
+        Glb.Append(JsonChunk);
+        AppendUint32(Builder.Bin.Num());
+        AppendUint32(GlbChunkTypeBin);
+        Glb.Append(Builder.Bin);
+
+        return FFileHelper::SaveArrayToFile(Glb, *FilePath);
+    }
+
+    /**
+     * @brief 葉タイルに含まれるコンポーネントを1つのglbとして出力します。
+     */
+    bool WriteTileGlb(const FString& FilePath, const FTileNode& Node, const TArray<FTileComponentData>& Components, const bool bExportAttributes) {
+        FGlbBuilder Builder;
+        const auto TileCenter = Node.Bounds.GetCenter();
+
+        TArray<TSharedPtr<FJsonValue>> Meshes;
+        TArray<TSharedPtr<FJsonValue>> Materials;
+        TArray<TSharedPtr<FJsonValue>> Images;
+        TArray<TSharedPtr<FJsonValue>> Textures;
+        TMap<FString, int32> TexturePathToMaterial;
+        TArray<FString> GmlIds;
+        TArray<FString> Types;
+        TArray<FString> AttributesJsons;
+
+        const auto GetMaterialIndex = [&](const FString& TexturePath) {
+            if (const auto Found = TexturePathToMaterial.Find(TexturePath))
+                return *Found;
+
+            const auto PbrMetallicRoughness = MakeShared<FJsonObject>();
+            PbrMetallicRoughness->SetNumberField(TEXT("metallicFactor"), 0.0);
+            PbrMetallicRoughness->SetNumberField(TEXT("roughnessFactor"), 1.0);
+
+            TArray<uint8> ImageData;
+            const auto MimeType = GetImageMimeType(TexturePath);
+            if (!MimeType.IsEmpty() && FFileHelper::LoadFileToArray(ImageData, *TexturePath)) {
+                const auto Image = MakeShared<FJsonObject>();
+                Image->SetNumberField(TEXT("bufferView"), Builder.AddBufferView(ImageData.GetData(), ImageData.Num(), 0));
+                Image->SetStringField(TEXT("mimeType"), MimeType);
+                Images.Add(MakeShared<FJsonValueObject>(Image));
+
+                const auto Texture = MakeShared<FJsonObject>();
+                Texture->SetNumberField(TEXT("source"), Images.Num() - 1);
+                Textures.Add(MakeShared<FJsonValueObject>(Texture));
+
+                const auto TextureInfo = MakeShared<FJsonObject>();
+                TextureInfo->SetNumberField(TEXT("index"), Textures.Num() - 1);
+                PbrMetallicRoughness->SetObjectField(TEXT("baseColorTexture"), TextureInfo);
+            } else if (!TexturePath.IsEmpty()) {
+                UE_LOG(LogTemp, Warning, TEXT("Export3DTiles : Unsupported texture is skipped : %s"), *TexturePath);
+            }
+
+            const auto Material = MakeShared<FJsonObject>();
+            Material->SetObjectField(TEXT("pbrMetallicRoughness"), PbrMetallicRoughness);
+            Material->SetBoolField(TEXT("doubleSided"), false);
+            Materials.Add(MakeShared<FJsonValueObject>(Material));
+            return TexturePathToMaterial.Add(TexturePath, Materials.Num() - 1);
+        };
+
+        for (const auto ComponentIndex : Node.ComponentIndices) {
+            const auto& Component = Components[ComponentIndex];
+            const auto FeatureOffset = GmlIds.Num();
+            for (const auto& Feature : Component.Features) {
+                GmlIds.Add(Feature.GmlId);
+                Types.Add(Feature.Type);
+                AttributesJsons.Add(Feature.AttributesJson);
+            }
+
+            TArray<FVector3f> Positions;
+            Positions.Reserve(Component.Positions.Num());
+            FVector3f Min(TNumericLimits<float>::Max());
+            FVector3f Max(TNumericLimits<float>::Lowest());
+            for (const auto& Position : Component.Positions) {
+                const auto GltfPosition = ConvertToGltf(Position - TileCenter);
+                Positions.Add(GltfPosition);
+                Min = Min.ComponentMin(GltfPosition);
+                Max = Max.ComponentMax(GltfPosition);
+            }
+            TArray<FVector3f> Normals;
+            Normals.Reserve(Component.Normals.Num());
+            for (const auto& Normal : Component.Normals) {
+                Normals.Add(ConvertToGltf(FVector(Normal)));
+            }
+            TArray<float> FeatureIds;
+            FeatureIds.Reserve(Component.FeatureIds.Num());
+            for (const auto FeatureId : Component.FeatureIds) {
+                FeatureIds.Add(FeatureId + FeatureOffset);
+            }
+
+            const auto NumVertices = Positions.Num();
+            const auto PositionAccessor = Builder.AddAccessor(
+                Builder.AddBufferView(Positions.GetData(), Positions.Num() * sizeof(FVector3f), GltfTargetArrayBuffer),
+                GltfComponentTypeFloat, NumVertices, TEXT("VEC3"), { Min.X, Min.Y, Min.Z }, { Max.X, Max.Y, Max.Z });
+            const auto NormalAccessor = Builder.AddAccessor(
+                Builder.AddBufferView(Normals.GetData(), Normals.Num() * sizeof(FVector3f), GltfTargetArrayBuffer),
+                GltfComponentTypeFloat, NumVertices, TEXT("VEC3"));
+            const auto UVAccessor = Builder.AddAccessor(
+                Builder.AddBufferView(Component.UVs.GetData(), Component.UVs.Num() * sizeof(FVector2f), GltfTargetArrayBuffer),
+                GltfComponentTypeFloat, NumVertices, TEXT("VEC2"));
+            const auto FeatureIdAccessor = Builder.AddAccessor(
+                Builder.AddBufferView(FeatureIds.GetData(), FeatureIds.Num() * sizeof(float), GltfTargetArrayBuffer),
+                GltfComponentTypeFloat, NumVertices, TEXT("SCALAR"));
+
+            TArray<TSharedPtr<FJsonValue>> Primitives;
+            for (const auto& SubMesh : Component.SubMeshes) {
+                const auto Attributes = MakeShared<FJsonObject>();
+                Attributes->SetNumberField(TEXT("POSITION"), PositionAccessor);
+                Attributes->SetNumberField(TEXT("NORMAL"), NormalAccessor);
+                Attributes->SetNumberField(TEXT("TEXCOORD_0"), UVAccessor);
+                Attributes->SetNumberField(TEXT("_FEATURE_ID_0"), FeatureIdAccessor);
+
+                const auto Primitive = MakeShared<FJsonObject>();
+                Primitive->SetObjectField(TEXT("attributes"), Attributes);
+                Primitive->SetNumberField(TEXT("indices"), Builder.AddAccessor(
+                    Builder.AddBufferView(SubMesh.Indices.GetData(), SubMesh.Indices.Num() * sizeof(uint32), GltfTargetElementArrayBuffer),
+                    GltfComponentTypeUnsignedInt, SubMesh.Indices.Num(), TEXT("SCALAR")));
+                Primitive->SetNumberField(TEXT("material"), GetMaterialIndex(SubMesh.TexturePath));
+                Primitives.Add(MakeShared<FJsonValueObject>(Primitive));
+            }
+
+            const auto Mesh = MakeShared<FJsonObject>();
+            Mesh->SetStringField(TEXT("name"), Component.Name);
+            Mesh->SetArrayField(TEXT("primitives"), Primitives);
+            Meshes.Add(MakeShared<FJsonValueObject>(Mesh));
+        }
+
+        // 地物数はタイル内の全地物数として後から設定する
+        for (const auto& Mesh : Meshes) {
+            for (const auto& Primitive : Mesh->AsObject()->GetArrayField(TEXT("primitives"))) {
+                const auto FeatureId = MakeShared<FJsonObject>();
+                FeatureId->SetNumberField(TEXT("featureCount"), GmlIds.Num());
+                FeatureId->SetNumberField(TEXT("attribute"), 0);
+                FeatureId->SetNumberField(TEXT("propertyTable"), 0);
+                const auto MeshFeatures = MakeShared<FJsonObject>();
+                TArray<TSharedPtr<FJsonValue>> FeatureIds;
+                FeatureIds.Add(MakeShared<FJsonValueObject>(FeatureId));
+                MeshFeatures->SetArrayField(TEXT("featureIds"), FeatureIds);
+                const auto Extensions = MakeShared<FJsonObject>();
+                Extensions->SetObjectField(TEXT("EXT_mesh_features"), MeshFeatures);
+                Primitive->AsObject()->SetObjectField(TEXT("extensions"), Extensions);
+            }
+        }
+
+        // EXT_structural_metadata
+        const auto ClassProperties = MakeShared<FJsonObject>();
+        const auto PropertyTableProperties = MakeShared<FJsonObject>();
+        const auto AddStringProperty = [&](const TCHAR* Name, const TArray<FString>& Values) {
+            const auto PropertyDefinition = MakeShared<FJsonObject>();
+            PropertyDefinition->SetStringField(TEXT("type"), TEXT("STRING"));
+            ClassProperties->SetObjectField(Name, PropertyDefinition);
+            PropertyTableProperties->SetObjectField(Name, Builder.AddStringProperty(Values));
+        };
+        AddStringProperty(GmlIdPropertyName, GmlIds);
+        AddStringProperty(TypePropertyName, Types);
+        if (bExportAttributes)
+            AddStringProperty(AttributesPropertyName, AttributesJsons);
+
+        const auto MetadataClass = MakeShared<FJsonObject>();
+        MetadataClass->SetObjectField(TEXT("properties"), ClassProperties);
+        const auto Classes = MakeShared<FJsonObject>();
+        Classes->SetObjectField(MetadataClassName, MetadataClass);
+        const auto Schema = MakeShared<FJsonObject>();
+        Schema->SetStringField(TEXT("id"), TEXT("plateau"));
+        Schema->SetObjectField(TEXT("classes"), Classes);
+        const auto PropertyTable = MakeShared<FJsonObject>();
+        PropertyTable->SetStringField(TEXT("class"), MetadataClassName);
+        PropertyTable->SetNumberField(TEXT("count"), GmlIds.Num());
+        PropertyTable->SetObjectField(TEXT("properties"), PropertyTableProperties);
+        const auto StructuralMetadata = MakeShared<FJsonObject>();
+        StructuralMetadata->SetObjectField(TEXT("schema"), Schema);
+        TArray<TSharedPtr<FJsonValue>> PropertyTables;
+        PropertyTables.Add(MakeShared<FJsonValueObject>(PropertyTable));
+        StructuralMetadata->SetArrayField(TEXT("propertyTables"), PropertyTables);
+        const auto RootExtensions = MakeShared<FJsonObject>();
+        RootExtensions->SetObjectField(TEXT("EXT_structural_metadata"), StructuralMetadata);
+
+        // glTFのノード構成 : ルートノードでタイル中心へ平行移動し、子ノードに各コンポーネントのメッシュを持たせる
+        TArray<TSharedPtr<FJsonValue>> Nodes;
+        for (int32 i = 0; i < Meshes.Num(); ++i) {
+            const auto ChildNode = MakeShared<FJsonObject>();
+            ChildNode->SetNumberField(TEXT("mesh"), i);
+            ChildNode->SetStringField(TEXT("name"), Meshes[i]->AsObject()->GetStringField(TEXT("name")));
+            Nodes.Add(MakeShared<FJsonValueObject>(ChildNode));
+        }
+        TArray<TSharedPtr<FJsonValue>> RootChildren;
+        for (int32 i = 0; i < Meshes.Num(); ++i) {
+            RootChildren.Add(MakeShared<FJsonValueNumber>(i));
+        }
+        const auto RootNode = MakeShared<FJsonObject>();
+        const auto GltfCenter = ConvertToGltf(TileCenter);
+        RootNode->SetArrayField(TEXT("translation"), FGlbBuilder::ToJsonArray({ GltfCenter.X, GltfCenter.Y, GltfCenter.Z }));
+        RootNode->SetArrayField(TEXT("children"), RootChildren);
+        Nodes.Add(MakeShared<FJsonValueObject>(RootNode));
+
+        const auto Scene = MakeShared<FJsonObject>();
+        TArray<TSharedPtr<FJsonValue>> SceneNodes;
+        SceneNodes.Add(MakeShared<FJsonValueNumber>(Nodes.Num() - 1));
+        Scene->SetArrayField(TEXT("nodes"), SceneNodes);
+
+        Builder.Align();
+        const auto Buffer = MakeShared<FJsonObject>();
+        Buffer->SetNumberField(TEXT("byteLength"), Builder.Bin.Num());
+
+        const auto Asset = MakeShared<FJsonObject>();
+        Asset->SetStringField(TEXT("version"), TEXT("2.0"));
+        Asset->SetStringField(TEXT("generator"), TEXT("PLATEAU SDK for Unreal"));
+
+        TArray<TSharedPtr<FJsonValue>> ExtensionsUsed;
+        ExtensionsUsed.Add(MakeShared<FJsonValueString>(TEXT("EXT_mesh_features")));
+        ExtensionsUsed.Add(MakeShared<FJsonValueString>(TEXT("EXT_structural_metadata")));
+        TArray<TSharedPtr<FJsonValue>> Scenes;
+        Scenes.Add(MakeShared<FJsonValueObject>(Scene));
+        TArray<TSharedPtr<FJsonValue>> Buffers;
+        Buffers.Add(MakeShared<FJsonValueObject>(Buffer));
+
+        const auto Gltf = MakeShared<FJsonObject>();
+        Gltf->SetObjectField(TEXT("asset"), Asset);
+        Gltf->SetArrayField(TEXT("extensionsUsed"), ExtensionsUsed);
+        Gltf->SetObjectField(TEXT("extensions"), RootExtensions);
+        Gltf->SetNumberField(TEXT("scene"), 0);
+        Gltf->SetArrayField(TEXT("scenes"), Scenes);
+        Gltf->SetArrayField(TEXT("nodes"), Nodes);
+        Gltf->SetArrayField(TEXT("meshes"), Meshes);
+        Gltf->SetArrayField(TEXT("materials"), Materials);
+        if (Images.Num() > 0) {
+            Gltf->SetArrayField(TEXT("images"), Images);
+            Gltf->SetArrayField(TEXT("textures"), Textures);
+        }
+        Gltf->SetArrayField(TEXT("accessors"), Builder.Accessors);
+        Gltf->SetArrayField(TEXT("bufferViews"), Builder.BufferViews);
+        Gltf->SetArrayField(TEXT("buffers"), Buffers);
+
+        return WriteGlb(FilePath, Gltf, Builder);
+    }
+}
+
+bool FPLATEAU3DTilesExporter::Export(const FString& ExportPath, APLATEAUInstancedCityModel* ModelActor, const FPLATEAUMeshExportOptions& Option) {
+    const auto TargetComponents = GetTargetComponents(ModelActor, Option);
+
+    // コンポーネントのメッシュ取得はゲームスレッドで行う
+    TArray<FTileComponentData> Components;
+    Components.Reserve(TargetComponents.Num());
+    const auto ActorTransform = ModelActor->GetActorTransform();
+    for (const auto Component : TargetComponents) {
+        FTileComponentData Data;
+        if (ExtractComponentData(Component, ActorTransform, Option, Data))
+            Components.Add(MoveTemp(Data));
+    }
+    if (Components.Num() == 0) {
+        UE_LOG(LogTemp, Warning, TEXT("Export3DTiles : No mesh to export."));
+        return false;
+    }
+
+    TArray<int32> Indices;
+    for (int32 i = 0; i < Components.Num(); ++i) {
+        Indices.Add(i);
+    }
+    FTileNode Root;
+    Root.Id = TEXT("0");
+    BuildTileTree(Root, Indices, Components, FMath::Max(1, Option.MaxComponentsPerTile), 0);
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    const auto TilesDirectory = ExportPath / TilesDirectoryName;
+    if (!PlatformFile.CreateDirectoryTree(*TilesDirectory)) {
+        UE_LOG(LogTemp, Error, TEXT("Export3DTiles : Failed to create directory : %s"), *TilesDirectory);
+        return false;
+    }
+
+    // glbのエンコードと書き込みはタイル毎に独立しているため並列に行う
+    TArray<FTileNode*> Leaves;
+    CollectLeaves(Root, Leaves);
+    std::atomic<bool> bSucceeded = true;
+    ParallelFor(Leaves.Num(), [&](const int32 Index) {
+        const auto& Leaf = *Leaves[Index];
+        const auto FilePath = ExportPath / GetTileContentUri(Leaf);
+        if (!WriteTileGlb(FilePath, Leaf, Components, Option.bExportAttributes)) {
+            UE_LOG(LogTemp, Error, TEXT("Export3DTiles : Failed to write : %s"), *FilePath);
+            bSucceeded = false;
+        }
+    });
+    if (!bSucceeded)
+        return false;
+
+    const auto RootTile = CreateTileJsonObject(Root);
+    const auto Origin = UPLATEAUGeoReferenceBlueprintLibrary::Unproject(ModelActor->GeoReference, FVector::ZeroVector);
+    RootTile->SetArrayField(TEXT("transform"), FGlbBuilder::ToJsonArray(CreateEnuToEcefTransform(Origin)));
+
+    const auto Asset = MakeShared<FJsonObject>();
+    Asset->SetStringField(TEXT("version"), TEXT("1.1"));
+    Asset->SetStringField(TEXT("generator"), TEXT("PLATEAU SDK for Unreal"));
+    const auto Tileset = MakeShared<FJsonObject>();
+    Tileset->SetObjectField(TEXT("asset"), Asset);
+    Tileset->SetNumberField(TEXT("geometricError"), Root.Bounds.GetSize().Size());
+    Tileset->SetObjectField(TEXT("root"), RootTile);
+
+    FString TilesetString;
+    const auto Writer = TJsonWriterFactory<>::Create(&TilesetString);
+    if (!FJsonSerializer::Serialize(Tileset, Writer))
+        return false;
+
+    return FFileHelper::SaveStringToFile(TilesetString, *(ExportPath / TilesetFileName), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+TArray<UPLATEAUCityObjectGroup*> FPLATEAU3DTilesExporter::GetTargetComponents(APLATEAUInstancedCityModel* ModelActor, const FPLATEAUMeshExportOptions& Option) const {
+    TArray<UPLATEAUCityObjectGroup*> Components;
+    ModelActor->GetComponents<UPLATEAUCityObjectGroup>(Components);
+    return Components.FilterByPredicate([&Option](const UPLATEAUCityObjectGroup* Component) {
+        return Component->GetStaticMesh() != nullptr && (Option.bExportHiddenObjects || Component->IsVisible());
+    });
+}
@@ -10,6 +10,8 @@
 #include "plateau/polygon_mesh/mesh_extractor.h"
 #include "plateau/polygon_mesh/mesh_extract_options.h"
 #include "PLATEAUMeshLoader.h"
+#include "PLATEAUMaterialRegistry.h"
+#include "PLATEAUPackageSaver.h"
 #include "citygml/citygml.h"
 #include "Kismet/GameplayStatics.h"
 #include "Reconstruct/PLATEAUMeshLoaderForHeightmap.h"
@@ -57,6 +59,7 @@ public:
 
                 LoadInputData.bIncludeAttrInfo = Settings.bIncludeAttrInfo;
                 LoadInputData.FallbackMaterial = Settings.FallbackMaterial;
+                LoadInputData.bCompressTexture = Settings.bCompressTexture;
                 auto& ExtractOptions = LoadInputData.ExtractOptions;
                 ExtractOptions.reference_point = GeoReference.GetData().getReferencePoint();
                 ExtractOptions.mesh_axes = plateau::geometry::CoordinateSystem::ESU;
@@ -236,6 +239,9 @@ void APLATEAUCityModelLoader::LoadAsync(const bool bAutomationTest) {
     ModelActor->MeshCodes = MeshCodes;
     ModelActor->Loader = this;
 
+    // インポート中に作成したテクスチャ等の保存は、インポート終了後にまとめて行います。
+    FPLATEAUPackageSaver::Get().BeginBatch();
+
     Async(EAsyncExecution::Thread,
         [
             ModelActor,
@@ -278,6 +284,9 @@ void APLATEAUCityModelLoader::LoadAsync(const bool bAutomationTest) {
                 TArray<TFuture<bool>> Futures;
                 TArray<FString> GmlNames;
 
+                // 同一のマテリアル・テクスチャをGML間で共有するためのキャッシュ
+                const TSharedRef<FPLATEAUMaterialRegistry> MaterialRegistry = MakeShared<FPLATEAUMaterialRegistry>();
+
                 bool bHasDatasetNameSet = false;
                 FCriticalSection SetDatasetNameSection;
 
@@ -376,7 +385,7 @@ void APLATEAUCityModelLoader::LoadAsync(const bool bAutomationTest) {
                     GmlNames.Add(GmlName);
                     Futures.Add(Async(EAsyncExecution::Thread,
                         [InputData, &LoadInputDataArray, Source, ModelActor, GmlName, OwnerLoader,
-                        CopiedGmlPath, &LoadMeshSection, bAutomationTest, &bCanceledRef, Index, ImportGmlProgressDelegate, ImportFailedGmlFileDelegate] {
+                        CopiedGmlPath, &LoadMeshSection, bAutomationTest, &bCanceledRef, Index, ImportGmlProgressDelegate, ImportFailedGmlFileDelegate, MaterialRegistry] {
 
                             if (bCanceledRef->Load(EMemoryOrder::Relaxed))
                                 return false;
@@ -429,7 +438,9 @@ void APLATEAUCityModelLoader::LoadAsync(const bool bAutomationTest) {
 
                             {
                                 FScopeLock Lock(LoadMeshSection);
-                                FPLATEAUMeshLoader(bAutomationTest).LoadModel(ModelActor, GmlRootComponent, Model, InputData, CityModel, bCanceledRef);
+                                FPLATEAUMeshLoader MeshLoader(bAutomationTest);
+                                MeshLoader.SetMaterialRegistry(MaterialRegistry);
+                                MeshLoader.LoadModel(ModelActor, GmlRootComponent, Model, InputData, CityModel, bCanceledRef);
                             }
 
                             FFunctionGraphTask::CreateAndDispatchWhenReady(
@@ -468,9 +479,13 @@ void APLATEAUCityModelLoader::LoadAsync(const bool bAutomationTest) {
                         return CurrentLoadingGmls.Num() == 0;
                     }, 3);
 
+                UE_LOG(LogTemp, Log, TEXT("Material registry: %d unique materials, %d material lookups served from the cache."),
+                    MaterialRegistry->GetMaterialCount(), MaterialRegistry->GetReusedMaterialCount());
+
                 *Phase = ECityModelLoadingPhase::Finished;
                 FFunctionGraphTask::CreateAndDispatchWhenReady(
                     [ImportFinishedDelegate] {
+                        FPLATEAUPackageSaver::Get().EndBatch();
                         ImportFinishedDelegate.Broadcast();
                     }, TStatId(), nullptr, ENamedThreads::GameThread);
             });
@@ -498,6 +513,8 @@ void APLATEAUCityModelLoader::LoadGmlAsync(const FString& GmlPath) {
     ModelActor->SetActorLabel(ModelActor->DatasetName);
     ModelActor->Loader = this;
 
+    FPLATEAUPackageSaver::Get().BeginBatch();
+
     Async(EAsyncExecution::Thread,
         [
             ModelActor, GmlPath,
@@ -531,6 +548,7 @@ void APLATEAUCityModelLoader::LoadGmlAsync(const FString& GmlPath) {
 
             FFunctionGraphTask::CreateAndDispatchWhenReady(
                 [ImportFinishedDelegate] {
+                    FPLATEAUPackageSaver::Get().EndBatch();
                     ImportFinishedDelegate.Broadcast();
                 }, TStatId(), nullptr, ENamedThreads::GameThread);
 
@@ -0,0 +1,82 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUMaterialRegistry.h"
+
+#include "Engine/Texture2D.h"
+#include "Materials/MaterialInterface.h"
+
+UMaterialInterface* FPLATEAUMaterialRegistry::FindMaterial(const FSubMeshMaterialSet& Key) {
+    FScopeLock Lock(&Section);
+    const auto Found = Materials.Find(MakeMaterialKey(Key));
+    if (Found == nullptr || !Found->IsValid())
+        return nullptr;
+
+    ++ReusedMaterialCount;
+    return Found->Get();
+}
+
+UMaterialInterface* FPLATEAUMaterialRegistry::AddMaterial(const FSubMeshMaterialSet& Key, UMaterialInterface* Material) {
+    FScopeLock Lock(&Section);
+    auto& Registered = Materials.FindOrAdd(MakeMaterialKey(Key));
+    if (Registered.IsValid())
+        return Registered.Get();
+
+    Registered = Material;
+    return Material;
+}
+
+bool FPLATEAUMaterialRegistry::FindTexture(const FString& TexturePath, UTexture2D*& OutTexture) {
+    FScopeLock Lock(&Section);
+    const auto Found = Textures.Find(TexturePath);
+    if (Found == nullptr || Found->IsStale())
+        return false;
+
+    // ロードに失敗したテクスチャはnullptrとして登録されています。
+    OutTexture = Found->Get();
+    return true;
+}
+
+void FPLATEAUMaterialRegistry::AddTexture(const FString& TexturePath, UTexture2D* Texture) {
+    FScopeLock Lock(&Section);
+    Textures.Add(TexturePath, Texture);
+}
+
+UTexture2D* FPLATEAUMaterialRegistry::FindTextureByContent(const FSHAHash& ContentHash) {
+    FScopeLock Lock(&Section);
+    const auto Found = TexturesByContent.Find(ContentHash);
+    return Found == nullptr ? nullptr : Found->Get();
+}
+
+void FPLATEAUMaterialRegistry::AddTextureContent(const FSHAHash& ContentHash, UTexture2D* Texture) {
+    if (Texture == nullptr)
+        return;
+
+    FScopeLock Lock(&Section);
+    TexturesByContent.Add(ContentHash, Texture);
+}
+
+int32 FPLATEAUMaterialRegistry::GetMaterialCount() const {
+    FScopeLock Lock(&Section);
+    return Materials.Num();
+}
+
+int32 FPLATEAUMaterialRegistry::GetReusedMaterialCount() const {
+    FScopeLock Lock(&Section);
+    return ReusedMaterialCount;
+}
+
+FPLATEAUMaterialRegistry::FMaterialKey FPLATEAUMaterialRegistry::MakeMaterialKey(const FSubMeshMaterialSet& MaterialSet) const {
+    FMaterialKey Key;
+    Key.MaterialSet = MaterialSet;
+    if (MaterialSet.TexturePath.IsEmpty())
+        return Key;
+
+    // 画素が同じためパスが異なっても同じテクスチャを使う場合、マテリアルも同じになるようにテクスチャで比較します。
+    // 未ロードやロードに失敗したテクスチャはパスのまま比較します。
+    const auto Found = Textures.Find(MaterialSet.TexturePath);
+    if (Found != nullptr && Found->IsValid()) {
+        Key.Texture = Found->Get();
+        Key.MaterialSet.TexturePath.Empty();
+    }
+    return Key;
+}
@@ -5,6 +5,7 @@
 #include "plateau/mesh_writer/obj_writer.h"
 #include "plateau/mesh_writer/fbx_writer.h"
 #include "PLATEAUExportSettings.h"
+#include "PLATEAU3DTilesExporter.h"
 #include "PLATEAUInstancedCityModel.h"
 #include "plateau/polygon_mesh/model.h"
 #include "plateau/polygon_mesh/node.h"
@@ -75,6 +76,8 @@ bool FPLATEAUMeshExporter::Export(const FString& ExportPath, APLATEAUInstancedCi
         return ExportAsFBX(ExportPath, ModelActor, Option);
     case EMeshFileFormat::GLTF:
         return ExportAsGLTF(ExportPath, ModelActor, Option);
+    case EMeshFileFormat::Tiles3D:
+        return FPLATEAU3DTilesExporter().Export(ExportPath, ModelActor, Option);
     default:
         return false;
     }
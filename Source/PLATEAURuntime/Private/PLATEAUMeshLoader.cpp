@@ -2,6 +2,8 @@
 
 #include "PLATEAUMeshLoader.h"
 #include "PLATEAUTextureLoader.h"
+#include "PLATEAUPackageSaver.h"
+#include "PLATEAUMaterialRegistry.h"
 #include "plateau/polygon_mesh/mesh_extractor.h"
 #include "citygml/citygml.h"
 #include "Engine/StaticMesh.h"
@@ -21,6 +23,7 @@
 #include "Util/PLATEAUGmlUtil.h"
 #include "PLATEAUModelFiltering.h"
 #include "Math/UnrealMathUtility.h"
+#include "Async/ParallelFor.h"
 
 #if WITH_EDITOR
 #include "EditorFramework/AssetImportData.h"
@@ -70,22 +73,18 @@ bool FSubMeshMaterialSet::Equals(const FSubMeshMaterialSet& Other) const {
         GameMaterialID == Other.GameMaterialID;
 }
 
-FORCEINLINE uint32 GetTypeHash(const FSubMeshMaterialSet& Value) {
-    TArray<uint32> HashArray;
-    HashArray.Add(FCrc::MemCrc32(&Value.Diffuse, sizeof(FVector3f)));
-    HashArray.Add(FCrc::MemCrc32(&Value.Specular, sizeof(FVector3f)));
-    HashArray.Add(FCrc::MemCrc32(&Value.Emissive, sizeof(FVector3f)));
-    HashArray.Add(FCrc::MemCrc32(&Value.Shininess, sizeof(float)));
-    HashArray.Add(FCrc::MemCrc32(&Value.Transparency, sizeof(float)));
-    HashArray.Add(FCrc::MemCrc32(&Value.Ambient, sizeof(float)));
-    HashArray.Add(FCrc::MemCrc32(&Value.isSmooth, sizeof(bool)));
-    HashArray.Add(FCrc::MemCrc32(&Value.TexturePath, sizeof(FString)));
-    HashArray.Add(FCrc::MemCrc32(&Value.GameMaterialID, sizeof(int)));
-    uint32 Hash = 0;
-    for (auto h : HashArray) {
-        Hash = HashCombine(Hash, h);
-    }
-    return Hash;
+FPLATEAUMeshLoader::FPLATEAUMeshLoader()
+    : bAutomationTest(false)
+    , MaterialRegistry(MakeShared<FPLATEAUMaterialRegistry>()) {
+}
+
+FPLATEAUMeshLoader::FPLATEAUMeshLoader(const bool InbAutomationTest)
+    : bAutomationTest(InbAutomationTest)
+    , MaterialRegistry(MakeShared<FPLATEAUMaterialRegistry>()) {
+}
+
+void FPLATEAUMeshLoader::SetMaterialRegistry(const TSharedRef<FPLATEAUMaterialRegistry>& InMaterialRegistry) {
+    MaterialRegistry = InMaterialRegistry;
 }
 
 FNodeHierarchy::FNodeHierarchy() {
@@ -324,6 +323,13 @@ void FPLATEAUMeshLoader::LoadModel(AActor* ModelActor, USceneComponent* ParentCo
                 UStaticMesh::BatchBuild(CopiedStaticMeshes, true, [&bCanceled](UStaticMesh* mesh) {
                     return bCanceled->Load(EMemoryOrder::Relaxed);
                     });
+
+                // インポート中であれば、メッシュを含むパッケージもインポート終了後にまとめて保存します。
+                auto& PackageSaver = FPLATEAUPackageSaver::Get();
+                if (PackageSaver.IsInBatch() && !bCanceled->Load(EMemoryOrder::Relaxed)) {
+                    for (const auto StaticMesh : CopiedStaticMeshes)
+                        PackageSaver.Enqueue(StaticMesh);
+                }
             }, TStatId(), nullptr, ENamedThreads::GameThread)->Wait();
         StaticMeshes.Reset();
     }
@@ -334,9 +340,10 @@ void FPLATEAUMeshLoader::LoadModel(AActor* ModelActor, USceneComponent* ParentCo
             FPLATEAUModelFiltering().FilterLowLods(ParentComponent);
 
             // Texture保存(5.5のクラッシュ回避のためパッケージ保存はロード後に行う
+            // 保存はFPLATEAUPackageSaverでインポート全体の終了後にまとめて行います。
             if (OverwriteTexture) {
                 for (const auto TexKV : PathToTexture) {
-                    FPLATEAUTextureLoader::SaveTexture(TexKV.Value, TexKV.Key);
+                    FPLATEAUTextureLoader::SaveTextureDeferred(TexKV.Value, TexKV.Key);
                 }
             }
         }, TStatId(), nullptr, ENamedThreads::GameThread)->Wait();
@@ -429,14 +436,31 @@ UStaticMeshComponent* FPLATEAUMeshLoader::CreateStaticMeshComponent(AActor& Acto
         if (SubMeshMaterialSets.Num() != MeshDescription->PolygonGroups().Num())
             UE_LOG(LogTemp, Error, TEXT("SubMesh/PolygonGroups size wrong => %s %s SubMesh: %d PolygonGroups: %d "), *ParentComponent.GetName(), *NodeName, SubMeshMaterialSets.Num(), MeshDescription->PolygonGroups().Num());
 
+        // 画像のデコードとミップマップ生成はゲームスレッドの外で並列に行います。
+        TMap<FString, FPLATEAUDecodedTexture> DecodedTextures;
+        if (OverwriteTexture()) {
+            for (const auto& SubMeshValue : SubMeshMaterialSets) {
+                UTexture2D* LoadedTexture;
+                if (SubMeshValue.TexturePath.IsEmpty() || MaterialRegistry->FindTexture(SubMeshValue.TexturePath, LoadedTexture))
+                    continue;
+                DecodedTextures.Add(SubMeshValue.TexturePath);
+            }
+            TArray<FString> DecodeTargets;
+            DecodedTextures.GetKeys(DecodeTargets);
+            ParallelFor(DecodeTargets.Num(), [&DecodeTargets, &DecodedTextures](const int32 Index) {
+                // 失敗した場合はMipsが空のまま残り、ゲームスレッド側でnullptrとして扱われます。
+                FPLATEAUTextureLoader::Decode(DecodeTargets[Index], DecodedTextures[DecodeTargets[Index]]);
+                });
+        }
+
         const auto ComponentSetupTask = FFunctionGraphTask::CreateAndDispatchWhenReady(
             [&SubMeshMaterialSets, this, &Component, &StaticMesh, &MeshDescription, &Actor, &ParentComponent, &
-                ComponentRef, &LoadInputData, &NodeHier]
+                ComponentRef, &LoadInputData, &NodeHier, &DecodedTextures]
             {
                 for (const auto& SubMeshValue : SubMeshMaterialSets)
                 {
-                    UMaterialInterface** SharedMatPtr = CachedMaterials.Find(SubMeshValue);
-                    if (SharedMatPtr == nullptr)
+                    UMaterialInterface* SharedMaterial = MaterialRegistry->FindMaterial(SubMeshValue);
+                    if (SharedMaterial == nullptr)
                     {
                         // マテリアル作成
                         UMaterialInterface* MaterialInterface;
@@ -458,21 +482,38 @@ UStaticMeshComponent* FPLATEAUMeshLoader::CreateStaticMeshComponent(AActor& Acto
                             }
                             else
                             {
-                                const bool TextureInCache = PathToTexture.Contains(TexturePath);
-                                if (TextureInCache) // テクスチャをすでにロード済みの場合、使い回します。
-                                {
-                                    Texture = PathToTexture[TexturePath]; // nullptrの場合もあります。
-                                }
-                                else // テクスチャ未ロードの場合、ロードします。
+                                // テクスチャをすでにロード済みの場合、使い回します。(nullptrの場合もあります。)
+                                const bool TextureInCache = MaterialRegistry->FindTexture(TexturePath, Texture);
+                                if (!TextureInCache) // テクスチャ未ロードの場合、ロードします。
                                 {
-                                    Texture = FPLATEAUTextureLoader::Load(TexturePath, OverwriteTexture());
+                                    bool bReusedContent = false;
+                                    if (const auto DecodedTexture = DecodedTextures.Find(TexturePath)) {
+                                        // 別のパスで同じ画像をロード済みの場合はそのテクスチャを使い回します。
+                                        UTexture2D* SameContentTexture = DecodedTexture->Mips.Num() > 0 ? MaterialRegistry->FindTextureByContent(DecodedTexture->ContentHash) : nullptr;
+                                        if (SameContentTexture != nullptr) {
+                                            Texture = SameContentTexture;
+                                            bReusedContent = true;
+                                        }
+                                        else {
+                                            Texture = FPLATEAUTextureLoader::Load(TexturePath, *DecodedTexture, OverwriteTexture(), LoadInputData.bCompressTexture);
+                                            MaterialRegistry->AddTextureContent(DecodedTexture->ContentHash, Texture);
+                                        }
+                                        // GPU転送とアセットへの書き込みが済んだ画素データはすぐに解放します。
+                                        DecodedTextures.Remove(TexturePath);
+                                    }
+                                    else
+                                        Texture = FPLATEAUTextureLoader::Load(TexturePath, OverwriteTexture(), LoadInputData.bCompressTexture);
                                     // なければnullptrを返します。
-                                    PathToTexture.Add(TexturePath, Texture);
+                                    MaterialRegistry->AddTexture(TexturePath, Texture);
+                                    // 使い回したテクスチャは最初にロードしたパスで保存されます。
+                                    if (!bReusedContent)
+                                        PathToTexture.Add(TexturePath, Texture);
                                 }
                             }
 
+                            // 複数のGMLのコンポーネントで共有されるため、アクターをOuterとします。
                             MaterialInterface = GetMaterialForSubMesh(SubMeshValue, Component, LoadInputData, Texture,
-                                                                      NodeHier, &ParentComponent);
+                                                                      NodeHier, &Actor);
 
                             if (auto DynMaterial = Cast<UMaterialInstanceDynamic>(MaterialInterface))
                             {
@@ -485,13 +526,13 @@ UStaticMeshComponent* FPLATEAUMeshLoader::CreateStaticMeshComponent(AActor& Acto
                         }
                         
                         
-                        StaticMesh->AddMaterial(MaterialInterface);
-
                         if (UseCachedMaterial()) {
                             //Materialをキャッシュに保存
-                            CachedMaterials.Add(SubMeshValue, MaterialInterface);
+                            MaterialInterface = MaterialRegistry->AddMaterial(SubMeshValue, MaterialInterface);
                         }
 
+                        StaticMesh->AddMaterial(MaterialInterface);
+
                         //SubMeshのPolygonGroupIDとMeshDescriptionのPolygonGroupIDの整合性チェック
                         TAttributesSet<FPolygonGroupID> PolygonGroupAttributes = MeshDescription->PolygonGroupAttributes();
                         if (PolygonGroupAttributes.HasAttribute(MeshAttribute::PolygonGroup::ImportedMaterialSlotName)) {
@@ -502,7 +543,7 @@ UStaticMeshComponent* FPLATEAUMeshLoader::CreateStaticMeshComponent(AActor& Acto
                     }
                     else {
                         //キャッシュのMaterialを使用
-                        StaticMesh->AddMaterial(*SharedMatPtr);
+                        StaticMesh->AddMaterial(SharedMaterial);
                     }
                 }
 
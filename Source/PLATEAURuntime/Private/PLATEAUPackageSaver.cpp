@@ -0,0 +1,152 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUPackageSaver.h"
+
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+DECLARE_STATS_GROUP(TEXT("PLATEAUPackageSaver"), STATGROUP_PLATEAUPackageSaver, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Package.Save"), STAT_Package_Save, STATGROUP_PLATEAUPackageSaver);
+
+namespace {
+    // 1回のTickで保存処理に使用する時間(秒)
+    constexpr double SaveTimeBudgetPerTick = 0.02;
+}
+
+FPLATEAUPackageSaver& FPLATEAUPackageSaver::Get() {
+    static FPLATEAUPackageSaver Instance;
+    return Instance;
+}
+
+void FPLATEAUPackageSaver::Enqueue(UObject* Asset) {
+    check(IsInGameThread());
+    if (!IsValid(Asset))
+        return;
+
+    const UPackage* Package = Asset->GetPackage();
+    // 一度も保存されていないレベル等は保存先が決まっていないため対象外とします。
+    if (FPackageName::IsTempPackage(Package->GetName()))
+        return;
+    if (PendingPackages.Contains(Package))
+        return;
+
+    if (PendingAssets.Num() == 0 && SavedCount == 0)
+        StartTime = FPlatformTime::Seconds();
+
+    PendingPackages.Add(Package);
+    PendingAssets.Emplace(TStrongObjectPtr<UObject>(Asset), Package);
+    ++TotalCount;
+    StartTickerIfNeeded();
+}
+
+void FPLATEAUPackageSaver::BeginBatch() {
+    check(IsInGameThread());
+    ++BatchDepth;
+}
+
+void FPLATEAUPackageSaver::EndBatch() {
+    check(IsInGameThread());
+    BatchDepth = FMath::Max(0, BatchDepth - 1);
+    StartTickerIfNeeded();
+}
+
+bool FPLATEAUPackageSaver::Flush() {
+    check(IsInGameThread());
+    if (TickerHandle.IsValid()) {
+        FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+        TickerHandle.Reset();
+    }
+
+    while (SaveNext()) {}
+
+    const bool bSucceeded = FailedCount == 0;
+    Finish();
+    return bSucceeded;
+}
+
+int32 FPLATEAUPackageSaver::GetPendingCount() const {
+    return PendingAssets.Num();
+}
+
+bool FPLATEAUPackageSaver::IsInBatch() const {
+    return BatchDepth > 0;
+}
+
+bool FPLATEAUPackageSaver::Tick(float DeltaTime) {
+    // インポート中は保存しない(UE5.5ではロード中のパッケージ保存でクラッシュするため)
+    if (BatchDepth > 0)
+        return true;
+
+    const double TickStartTime = FPlatformTime::Seconds();
+    while (FPlatformTime::Seconds() - TickStartTime < SaveTimeBudgetPerTick) {
+        if (!SaveNext())
+            break;
+    }
+
+    if (PendingAssets.Num() > 0)
+        return true;
+
+    // falseを返すとTickerから削除されます。
+    TickerHandle.Reset();
+    Finish();
+    return false;
+}
+
+bool FPLATEAUPackageSaver::SaveNext() {
+    SCOPE_CYCLE_COUNTER(STAT_Package_Save);
+
+    if (PendingAssets.Num() == 0)
+        return false;
+
+    const auto Pending = PendingAssets.Pop();
+    const TStrongObjectPtr<UObject>& Asset = Pending.Key;
+    // 保存できない場合も含め、取り出したパッケージは必ず保存待ちから外します。
+    PendingPackages.Remove(Pending.Value);
+
+    if (!IsValid(Asset.Get())) {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to save package : asset is no longer valid."));
+        ++FailedCount;
+        ++SavedCount;
+        return true;
+    }
+
+    UPackage* Package = Asset->GetPackage();
+    // アセットでない場合はパッケージのアセット(レベルならUWorld)を基準に保存します。外部アクターのパッケージ等ではnullptrになります。
+    UObject* SaveAsset = Asset->IsAsset() ? Asset.Get() : Package->FindAssetInPackage();
+
+    const FString PackageFileName = FPackageName::LongPackageNameToFilename(
+        Package->GetName(), Package->ContainsMap() ? FPackageName::GetMapPackageExtension() : FPackageName::GetAssetPackageExtension());
+    FSavePackageArgs Args;
+    // シリアライズ後のファイル書き込みはバックグラウンドで行います。
+    Args.SaveFlags = SAVE_NoError | SAVE_Async;
+    Args.TopLevelFlags = EObjectFlags::RF_Public | EObjectFlags::RF_Standalone;
+    Args.Error = GError;
+    if (!UPackage::SavePackage(Package, SaveAsset, *PackageFileName, Args)) {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to save package : %s"), *PackageFileName);
+        ++FailedCount;
+    }
+
+    ++SavedCount;
+    return true;
+}
+
+void FPLATEAUPackageSaver::StartTickerIfNeeded() {
+    if (TickerHandle.IsValid() || PendingAssets.Num() == 0 || BatchDepth > 0)
+        return;
+
+    TickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateRaw(this, &FPLATEAUPackageSaver::Tick));
+}
+
+void FPLATEAUPackageSaver::Finish() {
+    UPackage::WaitForAsyncFileWrites();
+
+    if (TotalCount > 0) {
+        UE_LOG(LogTemp, Log, TEXT("Saved %d packages (%d failed) in %.2f sec."),
+            SavedCount, FailedCount, FPlatformTime::Seconds() - StartTime);
+    }
+    SavedCount = 0;
+    TotalCount = 0;
+    FailedCount = 0;
+}
@@ -3,15 +3,24 @@
 #include "PLATEAURuntime.h"
 
 #include "Interfaces/IPluginManager.h"
+#include "Misc/CoreDelegates.h"
+#include "PLATEAUPackageSaver.h"
 
 #define LOCTEXT_NAMESPACE "FPLATEAURuntimeModule"
 
 void FPLATEAURuntimeModule::StartupModule() {
     // TODO: キャッシュディレクトリ作成
     // IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+    // 保存待ちのパッケージをエンジン終了前に書き出す
+    EnginePreExitHandle = FCoreDelegates::OnEnginePreExit.AddLambda([] {
+        FPLATEAUPackageSaver::Get().Flush();
+    });
 }
 
-void FPLATEAURuntimeModule::ShutdownModule() {}
+void FPLATEAURuntimeModule::ShutdownModule() {
+    FCoreDelegates::OnEnginePreExit.Remove(EnginePreExitHandle);
+}
 
 FString FPLATEAURuntimeModule::GetContentDir() {
     return IPluginManager::Get()
@@ -1,6 +1,7 @@
 // Copyright © 2023 Ministry of Land, Infrastructure and Transport
 
 #include "PLATEAUTextureLoader.h"
+#include "PLATEAUPackageSaver.h"
 
 #include "IImageWrapper.h"
 #include "IImageWrapperModule.h"
@@ -15,6 +16,8 @@
 #include "Misc/Paths.h"
 #include "Components/SceneComponent.h"
 #include "Misc/PackageName.h"
+#include "Math/Float16.h"
+#include "Async/ParallelFor.h"
 #if WITH_EDITOR
 #include "EditorFramework/AssetImportData.h"
 #endif
@@ -22,6 +25,7 @@ namespace fs = std::filesystem;
 
 DECLARE_STATS_GROUP(TEXT("PLATEAUTextureLoader"), STATGROUP_PLATEAUTextureLoader, STATCAT_Advanced);
 DECLARE_CYCLE_STAT(TEXT("Texture.UpdateResource"), STAT_Texture_UpdateResource, STATGROUP_PLATEAUTextureLoader);
+DECLARE_CYCLE_STAT(TEXT("Texture.GenerateMips"), STAT_Texture_GenerateMips, STATGROUP_PLATEAUTextureLoader);
 
 namespace {
     bool TryLoadAndUncompressImageFile(const FString& TexturePath,
@@ -80,6 +84,75 @@ namespace {
         return true;
     }
 
+    FString NormalizeTexturePath(const FString& TexturePath_SlashOrBackSlash) {
+        // パスに ".." が含まれる場合は、std::filesystem の機能を使って適用します。
+        fs::path TexturePathCpp = fs::path(*TexturePath_SlashOrBackSlash).lexically_normal();
+
+        const FString TexturePath_Normalized = TexturePathCpp.c_str();
+        // 引数のパスのセパレーターはOSによって "/" か "¥" なので "/" に統一します。
+        return TexturePath_Normalized.Replace(*FString("\\"), *FString("/"));
+    }
+
+    /**
+     * @brief Mips[0]から1x1までのミップマップを2x2ボックスフィルタで生成します。
+     * 各ミップの行単位で並列に処理します。
+     */
+    void GenerateMips(FPLATEAUDecodedTexture& Texture) {
+        SCOPE_CYCLE_COUNTER(STAT_Texture_GenerateMips);
+
+        const int32 BlockBytes = GPixelFormats[Texture.PixelFormat].BlockBytes;
+        const bool bIsFloat = Texture.PixelFormat == PF_FloatRGBA;
+        int32 SrcWidth = Texture.Width;
+        int32 SrcHeight = Texture.Height;
+        while (SrcWidth > 1 || SrcHeight > 1) {
+            const int32 DstWidth = FMath::Max(1, SrcWidth / 2);
+            const int32 DstHeight = FMath::Max(1, SrcHeight / 2);
+            TArray64<uint8> Dst;
+            Dst.SetNumUninitialized(static_cast<int64>(DstWidth) * DstHeight * BlockBytes);
+            const uint8* Src = Texture.Mips.Last().GetData();
+
+            ParallelFor(DstHeight, [&](const int32 Y) {
+                const int64 SrcRow0 = static_cast<int64>(FMath::Min(Y * 2, SrcHeight - 1)) * SrcWidth;
+                const int64 SrcRow1 = static_cast<int64>(FMath::Min(Y * 2 + 1, SrcHeight - 1)) * SrcWidth;
+                for (int32 X = 0; X < DstWidth; ++X) {
+                    const int32 X0 = FMath::Min(X * 2, SrcWidth - 1);
+                    const int32 X1 = FMath::Min(X * 2 + 1, SrcWidth - 1);
+                    const int64 SrcPixels[4] = { SrcRow0 + X0, SrcRow0 + X1, SrcRow1 + X0, SrcRow1 + X1 };
+                    uint8* DstPixel = Dst.GetData() + (static_cast<int64>(Y) * DstWidth + X) * BlockBytes;
+
+                    if (bIsFloat) {
+                        // RGBA各16bit浮動小数点
+                        for (int32 Channel = 0; Channel < 4; ++Channel) {
+                            float Sum = 0.0f;
+                            for (const auto SrcPixel : SrcPixels) {
+                                Sum += reinterpret_cast<const FFloat16*>(Src + SrcPixel * BlockBytes)[Channel].GetFloat();
+                            }
+                            reinterpret_cast<FFloat16*>(DstPixel)[Channel] = FFloat16(Sum * 0.25f);
+                        }
+                    }
+                    else {
+                        // BGRA各8bit
+                        for (int32 Channel = 0; Channel < BlockBytes; ++Channel) {
+                            uint32 Sum = 2;
+                            for (const auto SrcPixel : SrcPixels) {
+                                Sum += Src[SrcPixel * BlockBytes + Channel];
+                            }
+                            DstPixel[Channel] = static_cast<uint8>(Sum / 4);
+                        }
+                    }
+                }
+            });
+
+            Texture.Mips.Add(MoveTemp(Dst));
+            SrcWidth = DstWidth;
+            SrcHeight = DstHeight;
+        }
+    }
+
+    /**
+     * @brief 1x1のダミーでテクスチャリソースを作成します。LoadTransientのようにPostEditChangeでリソースが作られない場合に使用します。
+     * 画素データはUpdateTextureGPUResourceAsyncで1度だけGPUへ転送し、ここではリソースとTextureReferenceの作成のみを行います。
+     */
     void UpdateTextureGPUResourceWithDummy(UTexture2D* const Texture, const EPixelFormat PixelFormat) {
         Texture->SetPlatformData(new FTexturePlatformData());
         Texture->GetPlatformData()->SizeX = 1;
@@ -97,11 +170,7 @@ namespace {
             Mip->BulkData.Lock(LOCK_READ_WRITE);
 
             void* TextureData = Mip->BulkData.Realloc(MipBytes);
-
-            static TArray<uint8> DummyBytes;
-            DummyBytes.SetNum(MipBytes);
-
-            FMemory::Memcpy(TextureData, DummyBytes.GetData(), MipBytes);
+            FMemory::Memzero(TextureData, MipBytes);
 
             Mip->BulkData.Unlock();
         }
@@ -110,34 +179,35 @@ namespace {
         Texture->UpdateResource();
     }
 
-    void SetTexturePlatformData(UTexture2D* Texture, const TArray64<uint8>& UncompressedImageData,
-        const int32 Mip0Size, const int32 Width, const int32 Height, const EPixelFormat PixelFormat) {
+    void SetTexturePlatformData(UTexture2D* Texture, const FPLATEAUDecodedTexture& DecodedTexture) {
         Texture->SetPlatformData(new FTexturePlatformData());
-        Texture->GetPlatformData()->SizeX = Width;
-        Texture->GetPlatformData()->SizeY = Height;
-        Texture->GetPlatformData()->PixelFormat = PixelFormat;
-        FTexture2DMipMap* Mip = new FTexture2DMipMap();
-        Texture->GetPlatformData()->Mips.Add(Mip);
-        Mip->SizeX = Width;
-        Mip->SizeY = Height;
-        {
-            Mip->BulkData.Lock(LOCK_READ_WRITE);
-
-            void* TextureData = Mip->BulkData.Realloc(Mip0Size);
-            FMemory::Memcpy(TextureData, UncompressedImageData.GetData(), Mip0Size);
-
-            Mip->BulkData.Unlock();
+        Texture->GetPlatformData()->SizeX = DecodedTexture.Width;
+        Texture->GetPlatformData()->SizeY = DecodedTexture.Height;
+        Texture->GetPlatformData()->PixelFormat = DecodedTexture.PixelFormat;
+        for (int32 MipIndex = 0; MipIndex < DecodedTexture.Mips.Num(); ++MipIndex) {
+            FTexture2DMipMap* Mip = new FTexture2DMipMap();
+            Texture->GetPlatformData()->Mips.Add(Mip);
+            Mip->SizeX = FMath::Max(1, DecodedTexture.Width >> MipIndex);
+            Mip->SizeY = FMath::Max(1, DecodedTexture.Height >> MipIndex);
+            {
+                const auto& MipData = DecodedTexture.Mips[MipIndex];
+                Mip->BulkData.Lock(LOCK_READ_WRITE);
+
+                void* TextureData = Mip->BulkData.Realloc(MipData.Num());
+                FMemory::Memcpy(TextureData, MipData.GetData(), MipData.Num());
+
+                Mip->BulkData.Unlock();
+            }
         }
     }
 
-    void UpdateTextureGPUResourceAsync(
-        const TArray64<uint8>& UncompressedImageData, UTexture2D* const Texture,
-        const int32 Mip0Size, const int32 Width, const int32 Height, const EPixelFormat PixelFormat, ERHIAccess InResourceState) {
-
+    void UpdateTextureGPUResourceAsync(const FPLATEAUDecodedTexture& DecodedTexture, UTexture2D* const Texture, ERHIAccess InResourceState) {
+        const int32 NumMips = DecodedTexture.Mips.Num();
+        // RHIAsyncCreateTexture2Dは呼び出し中に初期データを読み取るため、デコード済みのバッファを直接渡します。
         TArray<void*, TInlineAllocator<MAX_TEXTURE_MIP_COUNT>> MipData;
-        MipData.Add(FMemory::Malloc(Mip0Size));
-        // TODO: 動的メモリ確保不要?
-        FMemory::Memcpy(MipData[0], UncompressedImageData.GetData(), Mip0Size);
+        for (const auto& Mip : DecodedTexture.Mips) {
+            MipData.Add(const_cast<uint8*>(Mip.GetData()));
+        }
 
         if (!GRHISupportsAsyncTextureCreation) {
             Texture->UpdateResource();
@@ -146,34 +216,27 @@ namespace {
 #if UE_VERSION_NEWER_THAN(5, 5, 0)
         FGraphEventRef CompletionEvent;
         FTextureRHIRef RHITexture2D = RHIAsyncCreateTexture2D(
-            Width, Height,
-            PixelFormat,
-            1,
+            DecodedTexture.Width, DecodedTexture.Height,
+            DecodedTexture.PixelFormat,
+            NumMips,
             TexCreate_ShaderResource,
             InResourceState,
-            MipData.GetData(), 1,
+            MipData.GetData(), NumMips,
             TEXT("RHIAsyncCreateTexture2D"),
             CompletionEvent
         );
 #else
         FGraphEventRef CompletionEvent;
         FTextureRHIRef RHITexture2D = RHIAsyncCreateTexture2D(
-            Width, Height,
-            PixelFormat,
-            1,
+            DecodedTexture.Width, DecodedTexture.Height,
+            DecodedTexture.PixelFormat,
+            NumMips,
             TexCreate_ShaderResource,
-            MipData.GetData(), 1,
+            MipData.GetData(), NumMips,
             CompletionEvent
         );
 #endif
 
-        for (void* NewData : MipData) {
-            if (NewData) {
-                FMemory::Free(NewData);
-            }
-        }
-        MipData.Empty();
-
         // link RHI texture to UTexture2D
         ENQUEUE_RENDER_COMMAND(UpdateTextureReference)(
             [Texture, RHITexture2D](FRHICommandListImmediate& RHICmdList) {
@@ -183,117 +246,176 @@ namespace {
         );
     }
 
-    bool SaveTexturePackage(UTexture2D* Texture, const FString TexturePath, UPackage* Package, FString PackageName) {
-
-        // 3Dファイルエクスポート用にテクスチャファイルのパスを保持
-        const auto ContentPath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(
-            *(FPaths::ProjectContentDir()));
-        auto TextureFilePath = TexturePath.Replace(*ContentPath, TEXT("")).Replace(*FString("\\"), *FString("/"));
-        Package->SetLoadedPath(FPackagePath::FromLocalPath(TexturePath));
-
-        FAssetRegistryModule::AssetCreated(Texture);
-        const FString PackageFileName = FPackageName::LongPackageNameToFilename(
-            PackageName, FPackageName::GetAssetPackageExtension());
-        FSavePackageArgs Args;
-        Args.SaveFlags = SAVE_NoError;
-        Args.TopLevelFlags = EObjectFlags::RF_Public | EObjectFlags::RF_Standalone;
-        Args.Error = GError;
-        return UPackage::SavePackage(Package, Texture, *PackageFileName, Args);
-    }
-}
-
-UTexture2D* FPLATEAUTextureLoader::Load(const FString& TexturePath_SlashOrBackSlash, bool OverwriteTextre) {
-    int32 Width, Height;
-    EPixelFormat PixelFormat;
-    TArray64<uint8> UncompressedData;
-    if (TexturePath_SlashOrBackSlash.IsEmpty()) return nullptr;
-
-    // パスに ".." が含まれる場合は、std::filesystem の機能を使って適用します。
-    fs::path TexturePathCpp = fs::path(*TexturePath_SlashOrBackSlash).lexically_normal();
-
-    const FString TexturePath_Normalized = TexturePathCpp.c_str();
-    // 引数のパスのセパレーターはOSによって "/" か "¥" なので "/" に統一します。
-    const auto TexturePath = TexturePath_Normalized.Replace(*FString("\\"), *FString("/"));
-
-    if (!TryLoadAndUncompressImageFile(TexturePath, UncompressedData, Width, Height, PixelFormat))
-        return nullptr;
+    /**
+     * @brief テクスチャアセットを検索し、なければ作成します。
+     * @param OutbFound 既存のアセットが見つかった場合true
+     */
+    UTexture2D* FindOrCreateTextureAsset(const FString& TexturePath, UPackage*& OutPackage, bool& OutbFound) {
+        FString PackageName = TEXT("/Game/PLATEAU/Textures/");
+        PackageName += FPaths::GetBaseFilename(TexturePath).Replace(TEXT("."), TEXT("_"));
+        OutPackage = CreatePackage(*PackageName);
+        OutPackage->FullyLoad();
+        UTexture2D* NewTexture = Cast<UTexture2D>(OutPackage->FindAssetInPackage());
 
-    // Mip0Data
-    const int32 Mip0Size = Width * Height * GPixelFormats[PixelFormat].BlockBytes;
+        OutbFound = IsValid(NewTexture);
+        if (OutbFound)
+            return NewTexture;
 
-    // テクスチャ作成
-    UTexture2D* NewTexture = nullptr;
-
-    FString PackageName = TEXT("/Game/PLATEAU/Textures/");
-    PackageName += FPaths::GetBaseFilename(TexturePath).Replace(TEXT("."), TEXT("_"));
-    UPackage* Package = CreatePackage(*PackageName);
-    Package->FullyLoad();
-    NewTexture = Cast<UTexture2D>(Package->FindAssetInPackage());
-
-    if (!IsValid(NewTexture)) {
-        NewTexture = NewObject<UTexture2D>(Package, NAME_None, RF_Public | RF_Standalone | RF_MarkAsRootSet);
+        NewTexture = NewObject<UTexture2D>(OutPackage, NAME_None, RF_Public | RF_Standalone | RF_MarkAsRootSet);
 
         // テクスチャのアセット名設定
         // "."はパッケージの階層とみなされるためリプレース
         FString TextureName = FPaths::GetBaseFilename(TexturePath).Replace(TEXT("."), TEXT("_"));
         if (!NewTexture->Rename(*TextureName, nullptr, REN_Test)) {
-            TextureName = MakeUniqueObjectName(Package, USceneComponent::StaticClass(), FName(TextureName)).ToString();
+            TextureName = MakeUniqueObjectName(OutPackage, USceneComponent::StaticClass(), FName(TextureName)).ToString();
         }
         NewTexture->Rename(*TextureName, nullptr, REN_DontCreateRedirectors);
 
-        NewTexture->NeverStream = true; // NeverStreamをtrueにしないと、レベルを保存して開き直したときにテクスチャ解像度が極端に低く見えます。
+        // ミップマップを持つためテクスチャストリーミングの対象とする
+        NewTexture->NeverStream = false;
+        NewTexture->LODGroup = TEXTUREGROUP_World;
 
         NewTexture->AddToRoot();
-    }
-    else if (!OverwriteTextre) {
         return NewTexture;
     }
+
+    /**
+     * @brief デコード済みの画像でテクスチャを上書きします。
+     */
+    void ApplyDecodedTexture(UTexture2D* NewTexture, UPackage* Package, const FString& TexturePath, const FPLATEAUDecodedTexture& DecodedTexture, const bool bCompress) {
+        SCOPE_CYCLE_COUNTER(STAT_Texture_UpdateResource);
+
+        const bool bIsFloat = DecodedTexture.PixelFormat == PF_FloatRGBA;
+        // 圧縮設定はTC_Defaultのまま変えず, 非圧縮の場合はCompressionNoneでデコード結果のフォーマットのまま保持する
+        if (bIsFloat)
+            NewTexture->CompressionSettings = bCompress ? TC_HDR_Compressed : TC_HDR;
+        else
+            NewTexture->CompressionSettings = TC_Default;
+        NewTexture->CompressionNone = !bCompress;
+
 #if WITH_EDITOR
-    // テクスチャ上書き開始
-    NewTexture->PreEditChange(nullptr);
+        // テクスチャ上書き開始
+        NewTexture->PreEditChange(nullptr);
 
-    // ソースパス設定
-    const auto PLATEAURootDir = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(
-        *(FPaths::ProjectContentDir() + FString("PLATEAU/")));
-    // アセットからテクスチャファイルへの相対パス
-    auto RelativeTextureFilePath = TexturePath.Replace(*PLATEAURootDir, *FString("../"));
-    NewTexture->AssetImportData->SetSourceFiles({ RelativeTextureFilePath });
+        // ソースパス設定
+        const auto PLATEAURootDir = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(
+            *(FPaths::ProjectContentDir() + FString("PLATEAU/")));
+        // アセットからテクスチャファイルへの相対パス
+        auto RelativeTextureFilePath = TexturePath.Replace(*PLATEAURootDir, *FString("../"));
+        NewTexture->AssetImportData->SetSourceFiles({ RelativeTextureFilePath });
 
-    if (GRHISupportsAsyncTextureCreation)
-        UpdateTextureGPUResourceWithDummy(NewTexture, PixelFormat);
+        // ソースに生成済みのミップマップを含めるため、アセットのビルド時は再生成しない
+        NewTexture->MipGenSettings = TMGS_LeaveExistingMips;
 
-    // アセットとして保存するデータで上書き
-    SetTexturePlatformData(NewTexture, UncompressedData, Mip0Size, Width, Height, PixelFormat);
+        // アセットとして保存するデータで上書き
+        SetTexturePlatformData(NewTexture, DecodedTexture);
 
-    // GPUがRHIに対応している場合描画自体はRHIで行うため、NewTexture->UpdateResourceは実行しない。
-    if (!GRHISupportsAsyncTextureCreation)
-        NewTexture->UpdateResource();
+        // GPUがRHIに対応している場合描画自体はRHIで行うため、NewTexture->UpdateResourceは実行しない。
+        if (!GRHISupportsAsyncTextureCreation)
+            NewTexture->UpdateResource();
 
-    NewTexture->Source.Init(Width, Height, 1, 1, ETextureSourceFormat::TSF_BGRA8, UncompressedData.GetData());
+        // ソースは確保だけ行い、ミップチェーンを直接書き込みます。
+        // ソースのミップは先頭から連続して並んでいるため、先頭のミップを1回だけロックして順に書き込みます。
+        {
+            NewTexture->Source.Init(DecodedTexture.Width, DecodedTexture.Height, 1, DecodedTexture.Mips.Num(),
+                bIsFloat ? ETextureSourceFormat::TSF_RGBA16F : ETextureSourceFormat::TSF_BGRA8, nullptr);
+            uint8* SourceData = NewTexture->Source.LockMip(0);
+            int64 Offset = 0;
+            for (const auto& Mip : DecodedTexture.Mips) {
+                FMemory::Memcpy(SourceData + Offset, Mip.GetData(), Mip.Num());
+                Offset += Mip.Num();
+            }
+            NewTexture->Source.UnlockMip(0);
+        }
 
-    // テクスチャ上書き終了
-    NewTexture->PostEditChange();
+        // テクスチャ上書き終了
+        NewTexture->PostEditChange();
 #endif
-    Package->MarkPackageDirty();
+        Package->MarkPackageDirty();
 
-    check(IsValid(NewTexture));
+        check(IsValid(NewTexture));
 
-    if (GRHISupportsAsyncTextureCreation)
-        UpdateTextureGPUResourceAsync(UncompressedData, NewTexture, Mip0Size, Width, Height, PixelFormat, ERHIAccess::SRVMask);
+        if (GRHISupportsAsyncTextureCreation)
+            UpdateTextureGPUResourceAsync(DecodedTexture, NewTexture, ERHIAccess::SRVMask);
+    }
+
+    void PrepareTexturePackage(UTexture2D* Texture, const FString& TexturePath, UPackage* Package) {
+        // 3Dファイルエクスポート用にテクスチャファイルのパスを保持
+        Package->SetLoadedPath(FPackagePath::FromLocalPath(TexturePath));
+
+        FAssetRegistryModule::AssetCreated(Texture);
+    }
 
+    bool SaveTexturePackage(UTexture2D* Texture, const FString TexturePath, UPackage* Package, FString PackageName) {
+        PrepareTexturePackage(Texture, TexturePath, Package);
+        const FString PackageFileName = FPackageName::LongPackageNameToFilename(
+            PackageName, FPackageName::GetAssetPackageExtension());
+        FSavePackageArgs Args;
+        Args.SaveFlags = SAVE_NoError;
+        Args.TopLevelFlags = EObjectFlags::RF_Public | EObjectFlags::RF_Standalone;
+        Args.Error = GError;
+        return UPackage::SavePackage(Package, Texture, *PackageFileName, Args);
+    }
+}
+
+bool FPLATEAUTextureLoader::Decode(const FString& TexturePath_SlashOrBackSlash, FPLATEAUDecodedTexture& OutTexture) {
+    if (TexturePath_SlashOrBackSlash.IsEmpty()) return false;
+
+    const auto TexturePath = NormalizeTexturePath(TexturePath_SlashOrBackSlash);
+    OutTexture.Mips.Reset();
+    if (!TryLoadAndUncompressImageFile(TexturePath, OutTexture.Mips.AddDefaulted_GetRef(), OutTexture.Width, OutTexture.Height, OutTexture.PixelFormat))
+        return false;
+
+    FSHA1 Sha;
+    Sha.Update(reinterpret_cast<const uint8*>(&OutTexture.Width), sizeof(OutTexture.Width));
+    Sha.Update(reinterpret_cast<const uint8*>(&OutTexture.Height), sizeof(OutTexture.Height));
+    const uint8 PixelFormat = static_cast<uint8>(OutTexture.PixelFormat);
+    Sha.Update(&PixelFormat, sizeof(PixelFormat));
+    Sha.Update(OutTexture.Mips[0].GetData(), OutTexture.Mips[0].Num());
+    Sha.Final();
+    Sha.GetHash(OutTexture.ContentHash.Hash);
+
+    GenerateMips(OutTexture);
+    return true;
+}
+
+UTexture2D* FPLATEAUTextureLoader::Load(const FString& TexturePath_SlashOrBackSlash, bool OverwriteTextre, bool bCompress) {
+    if (TexturePath_SlashOrBackSlash.IsEmpty()) return nullptr;
+
+    const auto TexturePath = NormalizeTexturePath(TexturePath_SlashOrBackSlash);
+    UPackage* Package;
+    bool bFound;
+    UTexture2D* NewTexture = FindOrCreateTextureAsset(TexturePath, Package, bFound);
+    if (bFound && !OverwriteTextre)
+        return NewTexture;
+
+    FPLATEAUDecodedTexture DecodedTexture;
+    if (!Decode(TexturePath, DecodedTexture))
+        return nullptr;
+
+    ApplyDecodedTexture(NewTexture, Package, TexturePath, DecodedTexture, bCompress);
+    return NewTexture;
+}
+
+UTexture2D* FPLATEAUTextureLoader::Load(const FString& TexturePath_SlashOrBackSlash, const FPLATEAUDecodedTexture& DecodedTexture, bool OverwriteTextre, bool bCompress) {
+    if (TexturePath_SlashOrBackSlash.IsEmpty() || DecodedTexture.Mips.Num() == 0) return nullptr;
+
+    const auto TexturePath = NormalizeTexturePath(TexturePath_SlashOrBackSlash);
+    UPackage* Package;
+    bool bFound;
+    UTexture2D* NewTexture = FindOrCreateTextureAsset(TexturePath, Package, bFound);
+    if (bFound && !OverwriteTextre)
+        return NewTexture;
+
+    ApplyDecodedTexture(NewTexture, Package, TexturePath, DecodedTexture, bCompress);
     return NewTexture;
 }
 
 UTexture2D* FPLATEAUTextureLoader::LoadTransient(const FString& TexturePath) {
-    int32 Width, Height;
-    EPixelFormat PixelFormat;
-    TArray64<uint8> UncompressedData;
-    if (!TryLoadAndUncompressImageFile(TexturePath, UncompressedData, Width, Height, PixelFormat))
+    FPLATEAUDecodedTexture DecodedTexture;
+    if (!Decode(TexturePath, DecodedTexture))
         return nullptr;
 
-    // Mip0Data
-    const int32 Mip0Size = Width * Height * GPixelFormats[PixelFormat].BlockBytes;
-
     // テクスチャ作成
     UTexture2D* NewTexture = nullptr;
     {
@@ -310,9 +432,9 @@ UTexture2D* FPLATEAUTextureLoader::LoadTransient(const FString& TexturePath) {
                 NewTexture->NeverStream = false;
 
                 if (GRHISupportsAsyncTextureCreation)
-                    UpdateTextureGPUResourceWithDummy(NewTexture, PixelFormat);
+                    UpdateTextureGPUResourceWithDummy(NewTexture, DecodedTexture.PixelFormat);
                 else {
-                    SetTexturePlatformData(NewTexture, UncompressedData, Mip0Size, Width, Height, PixelFormat);
+                    SetTexturePlatformData(NewTexture, DecodedTexture);
                     NewTexture->UpdateResource();
                 }
 
@@ -322,7 +444,7 @@ UTexture2D* FPLATEAUTextureLoader::LoadTransient(const FString& TexturePath) {
     check(IsValid(NewTexture));
 
     if (GRHISupportsAsyncTextureCreation)
-        UpdateTextureGPUResourceAsync(UncompressedData, NewTexture, Mip0Size, Width, Height, PixelFormat, ERHIAccess::SRVMask);
+        UpdateTextureGPUResourceAsync(DecodedTexture, NewTexture, ERHIAccess::SRVMask);
 
     return NewTexture;
 }
@@ -334,4 +456,11 @@ bool FPLATEAUTextureLoader::SaveTexture(UTexture2D* Texture, const FString& Text
     UPackage* Package = CreatePackage(*PackageName);
     Package->FullyLoad();
     return SaveTexturePackage(Texture, TexturePath, Package, PackageName);
-}
\ No newline at end of file
+}
+void FPLATEAUTextureLoader::SaveTextureDeferred(UTexture2D* Texture, const FString& TexturePath) {
+    if (!IsValid(Texture))
+        return;
+
+    PrepareTexturePackage(Texture, TexturePath, Texture->GetPackage());
+    FPLATEAUPackageSaver::Get().Enqueue(Texture);
+}
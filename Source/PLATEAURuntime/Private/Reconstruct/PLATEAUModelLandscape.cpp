@@ -3,8 +3,8 @@
 #include <Reconstruct/PLATEAUModelLandscape.h>
 #include "Reconstruct/PLATEAUMeshLoaderForHeightmap.h"
 #include <PLATEAUTextureLoader.h>
+#include "PLATEAUPackageSaver.h"
 #include "Materials/MaterialInstanceConstant.h"
-#include "UObject/SavePackage.h"
 #include "Misc/EngineVersionComparison.h"
 
 namespace {
@@ -129,15 +129,7 @@ ALandscape* FPLATEAUModelLandscape::CreateLandScape(UWorld* World, const int32 N
     }
 
     //Save Material
-    const FString PackageFileName = FPackageName::LongPackageNameToFilename(
-        PackageName, FPackageName::GetAssetPackageExtension());
-    FSavePackageArgs Args;
-    Args.SaveFlags = SAVE_NoError;
-    Args.TopLevelFlags = EObjectFlags::RF_Public | EObjectFlags::RF_Standalone;
-    Args.Error = GError;
-    auto result = UPackage::Save(Package, MatIns, *PackageFileName, Args);
-    if (result.Result != ESavePackageResult::Success)
-        UE_LOG(LogTemp, Warning, TEXT("Save Material Failed: %s %s %d"), *PackageName, *PackageFileName, result.Result);
+    FPLATEAUPackageSaver::Get().Enqueue(MatIns);
 
     Landscape->LandscapeMaterial = MatIns;
 
@@ -56,7 +56,15 @@ std::shared_ptr<plateau::polygonMesh::Model> FPLATEAUModelReconstruct::ConvertMo
     auto OriginalGranularity = ConvGranularity;
     ConvGranularity = Granularity;
 
-    GranularityConvertOption ConvOption(Granularity, bDivideGrid ? 1 : 0);
+    const auto basemodel = CreateBaseModel(TargetCityObjects);
+    auto converted = ConvertBaseModel(*basemodel, Granularity);
+
+    ConvGranularity = OriginalGranularity;
+
+    return converted;
+}
+
+std::shared_ptr<plateau::polygonMesh::Model> FPLATEAUModelReconstruct::CreateBaseModel(const TArray<UPLATEAUCityObjectGroup*>& TargetCityObjects) {
 
     FPLATEAUMeshExportOptions ExtOptions;
     ExtOptions.bExportHiddenObjects = false;
@@ -65,7 +73,6 @@ std::shared_ptr<plateau::polygonMesh::Model> FPLATEAUModelReconstruct::ConvertMo
     ExtOptions.CoordinateSystem = ECoordinateSystem::ESU;
 
     FPLATEAUMeshExporter MeshExporter;
-    GranularityConverter Converter;
 
     //属性情報を覚えておきます。
     CityObjMap = FPLATEAUReconstructUtil::CreateMapFromCityObjectGroups(TargetCityObjects);
@@ -77,12 +84,13 @@ std::shared_ptr<plateau::polygonMesh::Model> FPLATEAUModelReconstruct::ConvertMo
 
     std::shared_ptr<plateau::polygonMesh::Model> basemodel = MeshExporter.CreateModelFromComponents(CityModelActor, TargetCityObjects, ExtOptions);
     CachedMaterials = MeshExporter.GetCachedMaterials();
+    return basemodel;
+}
 
-    std::shared_ptr<plateau::polygonMesh::Model> converted = std::make_shared<plateau::polygonMesh::Model>(Converter.convert(*basemodel, ConvOption));
-
-    ConvGranularity = OriginalGranularity;
-
-    return converted;
+std::shared_ptr<plateau::polygonMesh::Model> FPLATEAUModelReconstruct::ConvertBaseModel(const plateau::polygonMesh::Model& BaseModel, const ConvertGranularity Granularity) const {
+    GranularityConvertOption ConvOption(Granularity, bDivideGrid ? 1 : 0);
+    GranularityConverter Converter;
+    return std::make_shared<plateau::polygonMesh::Model>(Converter.convert(BaseModel, ConvOption));
 }
 
 TArray<USceneComponent*> FPLATEAUModelReconstruct::ReconstructFromConvertedModel(std::shared_ptr<plateau::polygonMesh::Model> Model) {
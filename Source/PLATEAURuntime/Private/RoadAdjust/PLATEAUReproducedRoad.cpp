@@ -8,13 +8,72 @@
 #include "RoadAdjust/RoadMarking/LineGeneratorComponent.h"
 #include "RoadAdjust/RoadMarking/PLATEAUCrosswalkComposer.h"
 #include "RoadAdjust/RoadMarking/PLATEAUMarkedWayListComposerMain.h"
+#include "RoadAdjust/RoadMarking/PLATEAURoadMarkingCache.h"
+#include "RoadAdjust/RoadMarking/PLATEAURoadMarkingMeshBuilder.h"
 #include "RoadAdjust/PLATEAUCrosswalkPlacementRule.h"
 #include "RoadAdjust/RoadNetworkToMesh/PLATEAURrTarget.h"
+#include "RoadAdjust/RoadNetworkToMesh/PLATEAURoadSurfaceMeshBuilder.h"
+#include "Component/PLATEAUCityObjectGroup.h"
 #include "RoadMarking/LineSmoother.h"
 #include "RoadNetwork/Structure/RnModel.h"
+#include "RoadNetwork/Structure/RnModelCloner.h"
+#include "RoadNetwork/Structure/RnIntersection.h"
 #include "RoadNetwork/Structure/PLATEAURnStructureModel.h"
 #include "Misc/ScopedSlowTask.h"
 #include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+
+namespace {
+    // 生成したコンポーネントを子コンポーネントごと削除します
+    void DestroyRoadMarkComponent(AActor* Actor, USceneComponent* Component) {
+        if (!IsValid(Component))
+            return;
+        TArray<USceneComponent*> Children;
+        Component->GetChildrenComponents(true, Children);
+        Children.Add(Component);
+        for (auto* Child : Children) {
+            Actor->RemoveInstanceComponent(Child);
+            Child->DestroyComponent();
+        }
+    }
+
+    // MergedLineComponentsのキー. (チャンクX, チャンクY, 線の種類)
+    FIntVector ToMergedLineKey(EPLATEAURoadLineType Type, const FIntPoint& Chunk) {
+        return FIntVector(Chunk.X, Chunk.Y, static_cast<int32>(Type));
+    }
+
+    // MeshDescriptionからStaticMeshを作成します. ビルドはBuildStaticMeshesでまとめて行います
+    // エディタではPLATEAUMeshLoaderと同様にソースモデルとして持たせるので, レベルを保存して開き直しても形状が残ります
+    UStaticMesh* CreateStaticMesh(UObject* Outer, FName Name, FMeshDescription& MeshDescription, const TArray<FStaticMaterial>& Materials) {
+        const auto StaticMesh = NewObject<UStaticMesh>(Outer, Name);
+        StaticMesh->GetStaticMaterials() = Materials;
+#if WITH_EDITOR
+        auto& SrcModel = StaticMesh->AddSourceModel();
+        // 法線と接線はメッシュ作成時に設定済み
+        SrcModel.BuildSettings.bRecomputeNormals = false;
+        SrcModel.BuildSettings.bRecomputeTangents = false;
+        SrcModel.BuildSettings.bRemoveDegenerates = false;
+        SrcModel.BuildSettings.bGenerateLightmapUVs = false;
+        *StaticMesh->CreateMeshDescription(0) = MoveTemp(MeshDescription);
+        StaticMesh->CommitMeshDescription(0);
+        StaticMesh->ImportVersion = EImportStaticMeshVersion::LastVersion;
+#else
+        // ランタイムではソースモデルを持てないので描画用のデータだけを作ります
+        UStaticMesh::FBuildMeshDescriptionsParams BuildParams;
+        BuildParams.bFastBuild = true;
+        StaticMesh->BuildFromMeshDescriptions({ &MeshDescription }, BuildParams);
+#endif
+        return StaticMesh;
+    }
+
+    void BuildStaticMeshes(const TArray<UStaticMesh*>& StaticMeshes) {
+#if WITH_EDITOR
+        UStaticMesh::BatchBuild(StaticMeshes, true);
+#endif
+    }
+}
 
 APLATEAUReproducedRoad::APLATEAUReproducedRoad() {
     CreateLineTypeMap();
@@ -49,6 +108,7 @@ void APLATEAUReproducedRoad::CreateRoadMarks(APLATEAURnStructureModel* Model, FS
             Actor->Destroy();
         }
     }
+    DestroyRoadMarkComponents();
 
     auto ProgressDialogue = FScopedSlowTask(10, FText::FromString(TEXT("処理中...")));
     ProgressDialogue.MakeDialog(false);
@@ -56,47 +116,263 @@ void APLATEAUReproducedRoad::CreateRoadMarks(APLATEAURnStructureModel* Model, FS
     auto RnModel = Model->Model;
 
     // 道路ネットワークのスムージング。
-    // 道路ネットワークのコピーは未実装なので、スムージングは破壊的変更になります。
+    // スムージングは破壊的変更なので、RestoreRoadNetworkで戻せるように事前にコピーを取っておきます。
     FString ProgressSmooth = FString(TEXT("道路ネットワークのスムージング中"));
     ProgressDialogue.EnterProgressFrame(1, FText::FromString(ProgressSmooth));
-    PLATEAU::RoadAdjust::RoadMarking::FRoadNetworkLineSmoother Smoother;
+    TakeSmoothingSnapshot(RnModel);
+    if (MarkingModel.Get() != RnModel)
+        SmoothedLineStrings.Reset();
+    PLATEAU::RoadAdjust::RoadMarking::FRoadNetworkLineSmoother Smoother(&SmoothedLineStrings);
     Smoother.Smooth(RnModel, PLATEAU::RoadAdjust::RoadMarking::FSmoothingStrategyRespectOriginal());
 
-    // ターゲットとなる道路ネットワークの定義
-    auto TargetModel = NewObject<UPLATEAURrTargetModel>(GetTransientPackage(), UPLATEAURrTargetModel::StaticClass());
-    TargetModel->Initialize(RnModel);
-
     // 白線生成の対象と種類を定義
+    // 横断歩道も含め、道路/交差点ごとに収集してUpdateRoadMarksのために保持します
     FString ProgressMarkedWay = FString(TEXT("白線対象を収集中"));
-    ProgressDialogue.EnterProgressFrame(1, FText::FromString(ProgressMarkedWay));
-    auto WayComposer = NewObject<UPLATEAUMarkedWayListComposerMain>(GetTransientPackage(), UPLATEAUMarkedWayListComposerMain::StaticClass());
-    auto MarkedWays = WayComposer->ComposeFrom(TargetModel).GetMarkedWays();
-
-    // 横断歩道
-    FString ProgressCrosswalk = FString(TEXT("横断歩道の場所を計算中"));
-    ProgressDialogue.EnterProgressFrame(1, FText::FromString(ProgressCrosswalk));
-    auto CrossRoads = NewObject<UPLATEAUCrosswalkComposer>()->Compose(*TargetModel, FPLATEAUCrosswalkFrequencyExtensions::StrToFrequency(CrosswalkFrequency));
-    MarkedWays.Append(CrossRoads.GetMarkedWays());
-    
-    // 白線を生成
-    for(int i=0; i<MarkedWays.Num(); i++)
-    {
-        const auto& MarkedWay = MarkedWays[i];
-        FString ProgressGenMarkedWay = FString::Printf(TEXT("白線を生成中(%d/%d)"), i, MarkedWays.Num()); 
-        ProgressDialogue.EnterProgressFrame(0, FText::FromString(ProgressGenMarkedWay));
-        const auto& Points = MarkedWay.GetLine().GetPoints();
-        const auto Type = MarkedWay.GetRoadLineType();
-        CreateLineComponentByType(Type, Points, FVector2d(0.0f, 0.0f));
+    ProgressDialogue.EnterProgressFrame(2, FText::FromString(ProgressMarkedWay));
+    TArray<URnRoadBase*> RoadBases;
+    RoadBases.Append(RnModel->GetRoads());
+    RoadBases.Append(RnModel->GetIntersections());
+    MarkingCache = MakeShared<FPLATEAURoadMarkingCache>();
+    const auto UpdateResult = MarkingCache->Update(RnModel, RoadBases, FPLATEAUCrosswalkFrequencyExtensions::StrToFrequency(CrosswalkFrequency));
+
+    // 白線と車線矢印を生成
+    FString ProgressGenMarkedWay = FString(TEXT("白線を生成中"));
+    ProgressDialogue.EnterProgressFrame(1, FText::FromString(ProgressGenMarkedWay));
+    GenerateRoadMarks(RnModel, UpdateResult.UpdatedRoadBases, UpdateResult.OldMarkedWays, true);
+}
+
+void APLATEAUReproducedRoad::UpdateRoadMarks(APLATEAURnStructureModel* Model, FString CrosswalkFrequency) {
+    auto RnModel = Model->Model;
+    if (!MarkingCache.IsValid() || MarkingModel.Get() != RnModel || GeneratedOutputMode != MarkingOutputMode || GeneratedChunkSize != MarkingChunkSize) {
+        CreateRoadMarks(Model, CrosswalkFrequency);
+        return;
+    }
+
+    auto ProgressDialogue = FScopedSlowTask(10, FText::FromString(TEXT("処理中...")));
+    ProgressDialogue.MakeDialog(false);
+
+    // 前回の生成から変化した道路/交差点だけをスムージングします
+    FString ProgressSmooth = FString(TEXT("道路ネットワークのスムージング中"));
+    ProgressDialogue.EnterProgressFrame(1, FText::FromString(ProgressSmooth));
+    const auto Frequency = FPLATEAUCrosswalkFrequencyExtensions::StrToFrequency(CrosswalkFrequency);
+    const auto ChangedRoadBases = MarkingCache->FindChangedRoadBases(RnModel, Frequency);
+    TakeSmoothingSnapshot(RnModel);
+    PLATEAU::RoadAdjust::RoadMarking::FRoadNetworkLineSmoother Smoother(&SmoothedLineStrings);
+    Smoother.Smooth(ChangedRoadBases, PLATEAU::RoadAdjust::RoadMarking::FSmoothingStrategyRespectOriginal());
+
+    // 変化した道路/交差点とその周辺の白線対象を収集
+    FString ProgressMarkedWay = FString(TEXT("白線対象を収集中"));
+    ProgressDialogue.EnterProgressFrame(2, FText::FromString(ProgressMarkedWay));
+    const auto UpdateResult = MarkingCache->Update(RnModel, ChangedRoadBases, Frequency);
+    if (UpdateResult.IsEmpty()) {
+        UE_LOG(LogTemp, Log, TEXT("UpdateRoadMarks : No changes."));
+        return;
+    }
+
+    FString ProgressGenMarkedWay = FString(TEXT("白線を生成中"));
+    ProgressDialogue.EnterProgressFrame(1, FText::FromString(ProgressGenMarkedWay));
+    GenerateRoadMarks(RnModel, UpdateResult.UpdatedRoadBases, UpdateResult.OldMarkedWays, false);
+}
+
+bool APLATEAUReproducedRoad::RestoreRoadNetwork(APLATEAURnStructureModel* Model) {
+    auto RnModel = Model ? Model->Model : nullptr;
+    if (RnModel == nullptr || SmoothingSnapshot == nullptr || SnapshotSource.Get() != RnModel) {
+        UE_LOG(LogTemp, Warning, TEXT("RestoreRoadNetwork : No snapshot for this road network."));
+        return false;
+    }
+
+    FRnModelCloner Cloner;
+    Cloner.CopyTo(SmoothingSnapshot, RnModel);
+
+    // 道路/交差点のオブジェクトが入れ替わるので, 次回は全て作り直します
+    MarkingCache.Reset();
+    SmoothedLineStrings.Reset();
+    SmoothingSnapshot = nullptr;
+    SnapshotSource.Reset();
+    return true;
+}
+
+void APLATEAUReproducedRoad::TakeSmoothingSnapshot(URnModel* RnModel) {
+    // 2回目以降はスムージング済みなので, 最初に取ったスムージング前の状態を残します
+    if (SmoothingSnapshot != nullptr && SnapshotSource.Get() == RnModel)
+        return;
+
+    SmoothingSnapshot = FRnModelCloner().Clone(RnModel);
+    SnapshotSource = RnModel;
+}
+
+void APLATEAUReproducedRoad::CreateRoadSurfaces(APLATEAURnStructureModel* Model, bool bHideSourceMeshes) {
+    auto RnModel = Model ? Model->Model : nullptr;
+    if (RnModel == nullptr) {
+        UE_LOG(LogTemp, Warning, TEXT("CreateRoadSurfaces : No road network."));
+        return;
+    }
+
+    auto ProgressDialogue = FScopedSlowTask(3, FText::FromString(TEXT("処理中...")));
+    ProgressDialogue.MakeDialog(false);
+
+    // 前回生成した路面を削除し, 非表示にした元の道路メッシュを戻します
+    for (const auto& Component : SurfaceComponents)
+        DestroyRoadMarkComponent(this, Component);
+    SurfaceComponents.Reset();
+    for (const auto& Component : HiddenSourceComponents) {
+        if (IsValid(Component))
+            Component->SetHiddenInGame(false);
+    }
+    HiddenSourceComponents.Reset();
+
+    FString ProgressCollect = FString(TEXT("路面の輪郭を収集中"));
+    ProgressDialogue.EnterProgressFrame(1, FText::FromString(ProgressCollect));
+    FPLATEAURoadSurfaceMeshBuilder Builder(SurfaceChunkSize);
+    Builder.AddModel(RnModel);
+
+    // 三角形分割とメッシュの頂点作成はUObjectを触らないので並列に行います
+    FString ProgressTriangulate = FString(TEXT("路面を三角形分割中"));
+    ProgressDialogue.EnterProgressFrame(1, FText::FromString(ProgressTriangulate));
+    auto ChunkMeshes = Builder.Build();
+
+    FString ProgressMesh = FString(TEXT("路面メッシュを生成中"));
+    ProgressDialogue.EnterProgressFrame(1, FText::FromString(ProgressMesh));
+    TArray<FStaticMaterial> Materials;
+    for (auto Type = 0; Type < FPLATEAURoadSurfaceMeshBuilder::SurfaceTypeNum; ++Type) {
+        const auto SurfaceType = static_cast<EPLATEAURoadSurfaceType>(Type);
+        Materials.Add(FStaticMaterial(SurfaceMaterials.FindRef(SurfaceType), FPLATEAURoadSurfaceMeshBuilder::GetMaterialSlotName(SurfaceType)));
+    }
+    TArray<UStaticMesh*> StaticMeshes;
+    TArray<UStaticMeshComponent*> Components;
+    for (auto& ChunkMesh : ChunkMeshes) {
+        if (ChunkMesh.MeshDescription.Triangles().Num() == 0)
+            continue;
+
+        const auto Name = FString::Printf(TEXT("RoadSurface_%d_%d_%d"), ChunkMesh.Chunk.X, ChunkMesh.Chunk.Y, NumComponents);
+        const auto StaticMesh = CreateStaticMesh(this, FName(Name + TEXT("_Mesh")), ChunkMesh.MeshDescription, Materials);
+
+        const auto Component = NewObject<UStaticMeshComponent>(this, FName(Name));
+        Component->SetMobility(EComponentMobility::Static);
+        Component->RegisterComponent();
+        this->AddInstanceComponent(Component);
+        Component->AttachToComponent(this->GetRootComponent(), FAttachmentTransformRules::KeepWorldTransform);
+        for (auto Type = 0; Type < FPLATEAURoadSurfaceMeshBuilder::SurfaceTypeNum; ++Type) {
+            if (UMaterialInterface* Material = SurfaceMaterials.FindRef(static_cast<EPLATEAURoadSurfaceType>(Type)))
+                Component->SetMaterial(Type, Material);
+        }
+        SurfaceComponents.Add(Component);
+        StaticMeshes.Add(StaticMesh);
+        Components.Add(Component);
+        NumComponents++;
+    }
+
+    // ビルドが終わってからコンポーネントに設定します
+    BuildStaticMeshes(StaticMeshes);
+    for (auto i = 0; i < Components.Num(); ++i)
+        Components[i]->SetStaticMesh(StaticMeshes[i]);
+
+    // 生成した路面で置き換えるので, 元の道路メッシュをゲーム中は非表示にします.
+    // SetVisibilityで隠すと非表示のものを除外する道路ネットワークの生成対象から外れるので, エディタ上の表示は変えません
+    if (bHideSourceMeshes) {
+        auto Hide = [this](const URnRoadBase* RoadBase) {
+            for (const auto& TargetTran : RoadBase->GetTargetTrans()) {
+                if (!TargetTran.IsValid() || !TargetTran->IsVisible() || HiddenSourceComponents.Contains(TargetTran.Get()))
+                    continue;
+                TargetTran->SetHiddenInGame(true);
+                HiddenSourceComponents.Add(TargetTran.Get());
+            }
+        };
+        for (const auto& Road : RnModel->GetRoads())
+            Hide(Road);
+        for (const auto& Intersection : RnModel->GetIntersections())
+            Hide(Intersection);
+    }
+}
+
+void APLATEAUReproducedRoad::GenerateRoadMarks(URnModel* RnModel, const TArray<TObjectKey<URnRoadBase>>& UpdatedRoadBases, const TArray<FPLATEAUMarkedWay>& OldMarkedWays, bool bAll) {
+    if (MarkingOutputMode == EPLATEAURoadMarkingOutputMode::MergedMesh) {
+        const auto MarkedWays = MarkingCache->GetMarkedWays(RnModel);
+        if (bAll) {
+            CreateMergedLineComponents(MarkedWays);
+        }
+        else {
+            // 変更前後の線が含まれるチャンクだけを作り直します
+            TSet<FIntPoint> TargetChunks;
+            for (const auto& MarkedWay : OldMarkedWays)
+                FPLATEAURoadMarkingMeshBuilder::GetOverlappingChunks(MarkedWay.GetLine().GetPoints(), MarkingChunkSize, TargetChunks);
+            for (const auto& RoadBase : UpdatedRoadBases) {
+                if (const auto* Entry = MarkingCache->Find(RoadBase.ResolveObjectPtr())) {
+                    for (const auto& MarkedWay : Entry->MarkedWays)
+                        FPLATEAURoadMarkingMeshBuilder::GetOverlappingChunks(MarkedWay.GetLine().GetPoints(), MarkingChunkSize, TargetChunks);
+                }
+            }
+
+            TArray<FPLATEAUMarkedWay> TargetMarkedWays;
+            for (const auto& MarkedWay : MarkedWays) {
+                TSet<FIntPoint> Chunks;
+                FPLATEAURoadMarkingMeshBuilder::GetOverlappingChunks(MarkedWay.GetLine().GetPoints(), MarkingChunkSize, Chunks);
+                for (const auto& Chunk : Chunks) {
+                    if (TargetChunks.Contains(Chunk)) {
+                        TargetMarkedWays.Add(MarkedWay);
+                        break;
+                    }
+                }
+            }
+            CreateMergedLineComponents(TargetMarkedWays, &TargetChunks);
+        }
+    }
+    else {
+        // 作り直す道路/交差点と, 参照が切れた道路/交差点の線を削除します
+        TSet<TObjectKey<URnRoadBase>> UpdatedSet;
+        UpdatedSet.Append(UpdatedRoadBases);
+        RoadBaseLineComponents.RemoveAll([this, &UpdatedSet](const FPLATEAUReproducedRoadBaseComponents& Entry) {
+            if (Entry.RoadBase.IsValid() && !UpdatedSet.Contains(Entry.RoadBase.Get()))
+                return false;
+            for (const auto& Component : Entry.Components)
+                DestroyRoadMarkComponent(this, Component);
+            return true;
+        });
+
+        for (const auto& RoadBase : UpdatedRoadBases) {
+            const auto* Entry = MarkingCache->Find(RoadBase.ResolveObjectPtr());
+            if (Entry == nullptr)
+                continue;
+            auto& Components = RoadBaseLineComponents.AddDefaulted_GetRef();
+            Components.RoadBase = RoadBase.ResolveObjectPtr();
+            for (const auto& MarkedWay : Entry->MarkedWays) {
+                const auto& Points = MarkedWay.GetLine().GetPoints();
+                const auto Type = MarkedWay.GetRoadLineType();
+                Components.Components.Add(CreateLineComponentByType(Type, Points, FVector2d(0.0f, 0.0f)));
+            }
+        }
     }
 
     // 車線矢印を生成
-    FString ProgressArrow = FString(TEXT("車線の矢印を生成中"));
-    ProgressDialogue.EnterProgressFrame(1, FText::FromString(ProgressArrow));
+    // 矢印は種類ごとに1つのコンポーネントなので全体を作り直します
+    for (const auto& Component : ArrowComponents)
+        DestroyRoadMarkComponent(this, Component);
+    ArrowComponents.Reset();
     auto ArrowComposer = FPLATEAUDirectionalArrowComposer(RnModel, this);
-    ArrowComposer.Compose();
+    for (const auto& Component : ArrowComposer.Compose())
+        ArrowComponents.Add(Component.Get());
+
+    MarkingModel = RnModel;
+    GeneratedOutputMode = MarkingOutputMode;
+    GeneratedChunkSize = MarkingChunkSize;
 }
 
-void APLATEAUReproducedRoad::CreateLineComponentByType(EPLATEAURoadLineType Type, const TArray<FVector>& LinePoints, FVector2D Offset) {
+void APLATEAUReproducedRoad::DestroyRoadMarkComponents() {
+    for (const auto& Entry : RoadBaseLineComponents) {
+        for (const auto& Component : Entry.Components)
+            DestroyRoadMarkComponent(this, Component);
+    }
+    RoadBaseLineComponents.Reset();
+    for (const auto& [Key, Component] : MergedLineComponents)
+        DestroyRoadMarkComponent(this, Component);
+    MergedLineComponents.Reset();
+    for (const auto& Component : ArrowComponents)
+        DestroyRoadMarkComponent(this, Component);
+    ArrowComponents.Reset();
+    MarkingCache.Reset();
+}
+
+USceneComponent* APLATEAUReproducedRoad::CreateLineComponentByType(EPLATEAURoadLineType Type, const TArray<FVector>& LinePoints, FVector2D Offset) {
     const auto& Param = LineTypeMap[Type];
     const auto& Component = NewObject<ULineGeneratorComponent>(this, FName(TEXT("LineGeneratorComponent_") + StaticEnum<EPLATEAURoadLineType>()->GetDisplayValueAsText(Type).ToString() + TEXT("_") + FString::FromInt(NumComponents)));
     Component->RegisterComponent();
@@ -108,6 +384,56 @@ void APLATEAUReproducedRoad::CreateLineComponentByType(EPLATEAURoadLineType Type
     // メッシュの生成
     Component->CreateSplineMeshFromAssets(this, Param.LineMesh, Param.LineMaterial, Param.LineGap, Param.LineXScale, Param.LineLength);
     NumComponents++;
+    return Component;
+}
+
+void APLATEAUReproducedRoad::CreateMergedLineComponents(const TArray<FPLATEAUMarkedWay>& MarkedWays, const TSet<FIntPoint>* TargetChunks) {
+    FPLATEAURoadMarkingMeshBuilder Builder(LineTypeMap, MarkingChunkSize);
+    for (const auto& MarkedWay : MarkedWays)
+        Builder.AddLine(MarkedWay.GetRoadLineType(), MarkedWay.GetLine().GetPoints());
+
+    // メッシュの頂点作成はUObjectを触らないので並列に行います
+    auto ChunkMeshes = Builder.Build(TargetChunks);
+
+    // 作り直すチャンクのメッシュを削除します
+    for (auto It = MergedLineComponents.CreateIterator(); It; ++It) {
+        if (TargetChunks != nullptr && !TargetChunks->Contains(FIntPoint(It.Key().X, It.Key().Y)))
+            continue;
+        DestroyRoadMarkComponent(this, It.Value());
+        It.RemoveCurrent();
+    }
+
+    TArray<UStaticMesh*> StaticMeshes;
+    TArray<UStaticMeshComponent*> Components;
+    for (auto& ChunkMesh : ChunkMeshes) {
+        if (ChunkMesh.MeshDescription.Triangles().Num() == 0)
+            continue;
+
+        const auto& Param = LineTypeMap[ChunkMesh.Type];
+        const auto Name = FString::Printf(TEXT("MergedLine_%s_%d_%d_%d"),
+            *StaticEnum<EPLATEAURoadLineType>()->GetDisplayValueAsText(ChunkMesh.Type).ToString(), ChunkMesh.Chunk.X, ChunkMesh.Chunk.Y, NumComponents);
+
+        const auto StaticMesh = CreateStaticMesh(this, FName(Name + TEXT("_Mesh")), ChunkMesh.MeshDescription,
+            { FStaticMaterial(Param.LineMaterial, FPLATEAURoadMarkingMeshBuilder::MaterialSlotName) });
+
+        const auto Component = NewObject<UStaticMeshComponent>(this, FName(Name));
+        Component->SetMobility(EComponentMobility::Static);
+        Component->RegisterComponent();
+        this->AddInstanceComponent(Component);
+        Component->AttachToComponent(this->GetRootComponent(), FAttachmentTransformRules::KeepWorldTransform);
+        if (Param.LineMaterial != nullptr)
+            Component->SetMaterial(0, Param.LineMaterial);
+        Component->CastShadow = false;
+        MergedLineComponents.Add(ToMergedLineKey(ChunkMesh.Type, ChunkMesh.Chunk), Component);
+        StaticMeshes.Add(StaticMesh);
+        Components.Add(Component);
+        NumComponents++;
+    }
+
+    // ビルドが終わってからコンポーネントに設定します
+    BuildStaticMeshes(StaticMeshes);
+    for (auto i = 0; i < Components.Num(); ++i)
+        Components[i]->SetStaticMesh(StaticMeshes[i]);
 }
 
 void APLATEAUReproducedRoad::BeginPlay() {
@@ -2,15 +2,13 @@
 
 #include "RoadAdjust/RoadMarking/LineSmoother.h"
 
-#include "Components/SplineComponent.h"
-#include "GameFramework/Actor.h"
 #include "Math/UnrealMathUtility.h"
 #include "RoadNetwork/Structure/RnModel.h"
 #include "RoadNetwork/Structure/RnRoad.h"
 #include "RoadNetwork/Structure/RnIntersection.h"
 #include "RoadNetwork/Structure/RnSideWalk.h"
 #include "RoadNetwork/Structure/RnLane.h"
-#include "Engine/Engine.h"
+#include "RoadNetwork/Util/PLATEAUHermiteSpline.h"
 
 namespace PLATEAU::RoadAdjust::RoadMarking {
 
@@ -91,40 +89,19 @@ namespace PLATEAU::RoadAdjust::RoadMarking {
 
         if (SumDistance <= 0.0f) return Line;
 
-        // 一時的なアクターを作成してSplineComponentを使用
-        UWorld* World = nullptr;
-        if (GEngine && GEngine->GetWorldContexts().Num() > 0)
-        {
-            World = GEngine->GetWorldContexts()[0].World();
-        }
-        if(World == nullptr) return Line;
-
-        AActor* TempActor = World->SpawnActor<AActor>();
-        USplineComponent* SplineComp = NewObject<USplineComponent>(TempActor);
-        SplineComp->RegisterComponent();
-        SplineComp->ClearSplinePoints();
-
-        // スプラインポイントを追加
-        for (int32 i = 0; i < Line.Num(); i++) {
-            SplineComp->AddSplinePoint(Line[i], ESplineCoordinateSpace::World);
-        }
+        // 各点のタンジェントを決める
+        TArray<FVector> Tangents;
+        Tangents.SetNumZeroed(Line.Num());
 
-        // スプラインの補間方式を設定
-        for (int32 i = 0; i < SplineComp->GetNumberOfSplinePoints(); i++) {
-            SplineComp->SetSplinePointType(i, ESplinePointType::Curve);
-        }
-        
         // 端点のタンジェントを隣の点を向くように設定
         if (Line.Num() >= 2) {
             // 最初のポイントのタンジェント設定
-            FVector FirstTangent = (Line[1] - Line[0]).GetSafeNormal() * 20.f; // 長さは経験則から
-            SplineComp->SetTangentAtSplinePoint(0, FirstTangent, ESplineCoordinateSpace::World);
-            
+            Tangents[0] = (Line[1] - Line[0]).GetSafeNormal() * 20.f; // 長さは経験則から
+
             // 最後のポイントのタンジェント設定
             int32 LastIndex = Line.Num() - 1;
             int32 PrevIndex = LastIndex - 1;
-            FVector LastTangent = (Line[LastIndex] - Line[PrevIndex]).GetSafeNormal() * 20.f; // 長さは経験則から
-            SplineComp->SetTangentAtSplinePoint(LastIndex, LastTangent, ESplineCoordinateSpace::World);
+            Tangents[LastIndex] = (Line[LastIndex] - Line[PrevIndex]).GetSafeNormal() * 20.f; // 長さは経験則から
         }
 
         // 中間点のタンジェントも計算して設定
@@ -141,23 +118,21 @@ namespace PLATEAU::RoadAdjust::RoadMarking {
                 FVector::Distance(Line[i], Line[i+1])
             ) * 0.5f; // この係数は0.3～0.7くらいの範囲で調整の余地がある。小さいほど急カーブになる。経験則でこのくらいのほうが綺麗に見える。
     
-            SplineComp->SetTangentAtSplinePoint(i, AvgTangent * TangentLength, ESplineCoordinateSpace::World);
+            Tangents[i] = AvgTangent * TangentLength;
         }
-        
-        SplineComp->UpdateSpline();
+
+        // USplineComponentと同じ補間を行う. アクターを生成しないのでワーカースレッドからも呼び出せる
+        const FPLATEAUHermiteSpline Spline(Line, Tangents);
 
         // 補間された点を生成
         TArray<FVector> NextPoints;
-
-        for (float Dist = 0; Dist < SplineComp->GetSplineLength(); Dist += SmoothResolutionDistance)
+        const float SplineLength = Spline.GetLength();
+        NextPoints.Reserve(FMath::CeilToInt(SplineLength / SmoothResolutionDistance) + 1);
+        for (float Dist = 0; Dist < SplineLength; Dist += SmoothResolutionDistance)
         {
-            const FVector P = SplineComp->GetLocationAtDistanceAlongSpline(Dist, ESplineCoordinateSpace::World);
-            NextPoints.Add(P);
+            NextPoints.Add(Spline.GetLocationAtDistance(Dist));
         }
-        NextPoints.Add(SplineComp->GetLocationAtSplinePoint(SplineComp->GetNumberOfSplinePoints() - 1, ESplineCoordinateSpace::World));
-
-        // 一時的なアクターを削除
-        TempActor->Destroy();
+        NextPoints.Add(Line.Last());
 
         return NextPoints;
     }
@@ -200,49 +175,77 @@ namespace PLATEAU::RoadAdjust::RoadMarking {
         return NextLine;
     }
 
+    FRoadNetworkLineSmoother::FRoadNetworkLineSmoother(TSet<TObjectKey<URnLineString>>* InSmoothedLineStrings)
+        : SmoothedLineStrings(InSmoothedLineStrings) {
+    }
+
     void FRoadNetworkLineSmoother::Smooth(URnModel* Target, const ISmoothingStrategy& SmoothingStrategy) {
         if (Target == nullptr) return;
 
+        TArray<URnRoadBase*> RoadBases;
+        RoadBases.Append(Target->GetRoads());
+        RoadBases.Append(Target->GetIntersections());
+        Smooth(RoadBases, SmoothingStrategy);
+    }
+
+    void FRoadNetworkLineSmoother::Smooth(const TArray<URnRoadBase*>& RoadBases, const ISmoothingStrategy& SmoothingStrategy) {
         auto Smoother = MakeShared<FLineSmoother>(SmoothingStrategy.ShouldSubdivide());
 
-        for (const auto& Road : Target->GetRoads()) {
+        // 滑らかにするたびに形が変わるので, 共有されている線も1回だけ滑らかにします
+        TSet<TObjectKey<URnLineString>> LocalSmoothedLineStrings;
+        auto& Smoothed = SmoothedLineStrings ? *SmoothedLineStrings : LocalSmoothedLineStrings;
+        auto SmoothWay = [&](const TRnRef_T<URnWay>& Way) {
+            if (Way == nullptr || !Way->IsValid())
+                return;
+            bool bAlreadySmoothed = false;
+            Smoothed.Add(Way->GetLineString(), &bAlreadySmoothed);
+            if (!bAlreadySmoothed)
+                Smoother->Smooth(Way);
+        };
+
+        for (const auto& RoadBase : RoadBases) {
+            const auto Road = RoadBase->CastToRoad();
+            if (Road == nullptr) continue;
             const auto RoadSrc = Road->GetTargetTrans().Num() > 0 ? Road->GetTargetTrans()[0] : nullptr;
 
             for (const auto& SideWalk : Road->GetSideWalks()) {
                 const auto Inside = SideWalk->GetInsideWay();
-                if (Inside != nullptr && Inside->IsValid() && SmoothingStrategy.ShouldSmoothRoadSidewalkInside(RoadSrc)) {
-                    Smoother->Smooth(Inside);
+                if (SmoothingStrategy.ShouldSmoothRoadSidewalkInside(RoadSrc)) {
+                    SmoothWay(Inside);
                 }
 
                 const auto Outside = SideWalk->GetOutsideWay();
-                if (Outside != nullptr && Outside->IsValid() && SmoothingStrategy.ShouldSmoothSidewalkOutside()) {
-                    Smoother->Smooth(Outside);
+                if (SmoothingStrategy.ShouldSmoothSidewalkOutside()) {
+                    SmoothWay(Outside);
                 }
             }
 
             for (const auto& Lane : Road->GetAllLanesWithMedian()) {
                 for (const auto& Way : Lane->GetAllWays()) {
-                    Smoother->Smooth(Way);
+                    SmoothWay(Way);
                 }
             }
         }
 
-        for (const auto& Intersection : Target->GetIntersections()) {
+        for (const auto& RoadBase : RoadBases) {
+            const auto Intersection = RoadBase->CastToIntersection();
+            if (Intersection == nullptr) continue;
+
             for (const auto& SideWalk : Intersection->GetSideWalks()) {
                 const auto Inside = SideWalk->GetInsideWay();
-                if (Inside != nullptr && Inside->IsValid() && SmoothingStrategy.ShouldSmoothIntersectionSidewalkInside()) {
-                    Smoother->Smooth(Inside);
+                if (SmoothingStrategy.ShouldSmoothIntersectionSidewalkInside()) {
+                    SmoothWay(Inside);
                 }
 
                 const auto Outside = SideWalk->GetOutsideWay();
-                if (Outside != nullptr && Outside->IsValid() && SmoothingStrategy.ShouldSmoothSidewalkOutside()) {
-                    Smoother->Smooth(Outside);
+                if (SmoothingStrategy.ShouldSmoothSidewalkOutside()) {
+                    SmoothWay(Outside);
                 }
             }
 
             for (const auto& Edge : Intersection->GetEdges()) {
                 if (Edge != nullptr && !Edge->IsBorder()) {
-                    Smoother->Smooth(Edge->GetBorder());
+                    SmoothWay(Edge->GetBorder());
                 }
             }
         }
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
 #include "Component/PLATEAUCityObjectGroup.h"
 #include "RoadNetwork/Structure/RnModel.h"
 #include "RoadNetwork/Structure/RnWay.h"
@@ -74,6 +75,23 @@ namespace PLATEAU::RoadAdjust::RoadMarking {
      */
     class PLATEAURUNTIME_API FRoadNetworkLineSmoother {
     public:
+        FRoadNetworkLineSmoother() = default;
+
+        /**
+         * @param InSmoothedLineStrings 滑らかにした線の記録. 記録済みの線は滑らかにせず, 滑らかにした線を追加します
+         *        一部の道路/交差点だけを滑らかにし直す場合に, 全体を滑らかにした場合と同じ形になるように使います
+         */
+        explicit FRoadNetworkLineSmoother(TSet<TObjectKey<URnLineString>>* InSmoothedLineStrings);
+
         void Smooth(URnModel* Target, const ISmoothingStrategy& SmoothingStrategy);
+
+        /**
+         * @brief 指定した道路/交差点の線だけを滑らかにします
+         *        線は隣接する車線や道路/交差点で共有されることがありますが, 1つの線は1回だけ滑らかにします
+         */
+        void Smooth(const TArray<URnRoadBase*>& RoadBases, const ISmoothingStrategy& SmoothingStrategy);
+
+    private:
+        TSet<TObjectKey<URnLineString>>* SmoothedLineStrings = nullptr;
     };
 }
@@ -2,6 +2,35 @@
 
 #include "RoadAdjust/RoadMarking/PLATEAUCrosswalkComposer.h"
 #include "RoadAdjust/RoadMarking/LineGeneratorComponent.h"
+#include "Async/ParallelFor.h"
+
+namespace {
+    // URnWay::PositionAtDistanceの頂点配列版
+    FVector PositionAtDistance(const TArray<FVector>& Points, float Distance, bool EndSide) {
+        float Len = 0.0f;
+        int32 Index = EndSide ? Points.Num() - 1 : 0;
+        FVector Pos = Points[Index];
+
+        while (Len < Distance) // オフセットの分だけ線上を動かします。
+        {
+            Index += EndSide ? -1 : 1;
+            if (Index < 0 || Index >= Points.Num()) break;
+
+            const FVector NextPos = Points[Index];
+            const float LenDiff = FVector::Dist(NextPos, Pos);
+            if (Len + LenDiff >= Distance)
+            {
+                const float T = (Len + LenDiff - Distance) / LenDiff; // オーバーした割合
+                return FMath::Lerp(Pos, NextPos, 1.0f - T);
+            }
+
+            Pos = NextPos;
+            Len += LenDiff;
+        }
+
+        return Pos;
+    }
+}
 
 UPLATEAUCrosswalkComposer::UPLATEAUCrosswalkComposer() {
 }
@@ -14,41 +43,61 @@ FPLATEAUMarkedWayList UPLATEAUCrosswalkComposer::Compose(
     const EPLATEAUCrosswalkFrequency& CrosswalkFrequency) {
     
     FPLATEAUMarkedWayList Result;
+    TArray<URnRoadBase*> Roads;
+    Roads.Append(Target.GetRoads());
+    for (const auto& Crosswalks : ComposePerRoadBase(Roads, CrosswalkFrequency))
+        Result.AddRange(Crosswalks);
+
+    return Result;
+}
+
+TArray<FPLATEAUMarkedWayList> UPLATEAUCrosswalkComposer::ComposePerRoadBase(
+    const TArray<URnRoadBase*>& RoadBases,
+    const EPLATEAUCrosswalkFrequency& CrosswalkFrequency) {
+
+    TArray<FPLATEAUMarkedWayList> Result;
+    Result.SetNum(RoadBases.Num());
+    // 配置ルールは状態を持たないので全スレッドで共有します
     const auto PlacementRule = FPLATEAUCrosswalkFrequencyExtensions::ToPlacementRule(CrosswalkFrequency);
+    if (!PlacementRule.IsValid())
+        return Result;
 
-    for (const auto& Road : Target.GetRoads()) {
-        if (!PlacementRule->ShouldPlace(Road)) continue;
+    ParallelFor(RoadBases.Num(), [&](int32 Index) {
+        if (auto* Road = Cast<URnRoad>(RoadBases[Index]))
+            ComposeRoad(Road, *PlacementRule, Result[Index]);
+    });
+    return Result;
+}
 
-        auto Next = Road->GetNext();
-        if(Next != nullptr)
-        {
-            if (const auto NextIntersection = Next->CastToIntersection()) {
-                const auto NextBorder = FPLATEAUMWLine(Road->GetMergedBorder(EPLATEAURnLaneBorderType::Next, TOptional<EPLATEAURnDir>()));
-                const auto Crosswalk = GenerateCrosswalk(NextBorder, NextIntersection, Road, EPLATEAUReproducedRoadDirection::Next);
-                Result.AddRange(Crosswalk);
-            }
+void UPLATEAUCrosswalkComposer::ComposeRoad(URnRoad* Road, IPLATEAUCrosswalkPlacementRule& PlacementRule, FPLATEAUMarkedWayList& OutList) const {
+    if (!PlacementRule.ShouldPlace(Road)) return;
+
+    auto Next = Road->GetNext();
+    if(Next != nullptr)
+    {
+        if (const auto NextIntersection = Next->CastToIntersection()) {
+            const auto NextBorder = FPLATEAUMWLine(Road->GetMergedBorderVertices(EPLATEAURnLaneBorderType::Next, TOptional<EPLATEAURnDir>()));
+            const auto Crosswalk = GenerateCrosswalk(NextBorder, NextIntersection, Road, EPLATEAUReproducedRoadDirection::Next);
+            OutList.AddRange(Crosswalk);
         }
-        
-        auto Prev = Road->GetPrev();
-        if(Prev != nullptr)
-        {
-            if (const auto PrevIntersection = Prev->CastToIntersection()) {
-                const auto PrevBorder = FPLATEAUMWLine(Road->GetMergedBorder(EPLATEAURnLaneBorderType::Prev, TOptional<EPLATEAURnDir>()));
-                const auto Crosswalk = GenerateCrosswalk(PrevBorder, PrevIntersection, Road, EPLATEAUReproducedRoadDirection::Prev);
-                Result.AddRange(Crosswalk);
-            }
+    }
+    
+    auto Prev = Road->GetPrev();
+    if(Prev != nullptr)
+    {
+        if (const auto PrevIntersection = Prev->CastToIntersection()) {
+            const auto PrevBorder = FPLATEAUMWLine(Road->GetMergedBorderVertices(EPLATEAURnLaneBorderType::Prev, TOptional<EPLATEAURnDir>()));
+            const auto Crosswalk = GenerateCrosswalk(PrevBorder, PrevIntersection, Road, EPLATEAUReproducedRoadDirection::Prev);
+            OutList.AddRange(Crosswalk);
         }
-        
     }
-
-    return Result;
 }
 
 FPLATEAUMarkedWayList UPLATEAUCrosswalkComposer::GenerateCrosswalk(
     const FPLATEAUMWLine& Border,
     const TRnRef_T<URnIntersection>& Intersection,
     const TRnRef_T<URnRoadBase>& SrcRoad,
-    EPLATEAUReproducedRoadDirection Direction) {
+    EPLATEAUReproducedRoadDirection Direction) const {
 
     auto Result = FPLATEAUMarkedWayList(); 
 
@@ -56,17 +105,9 @@ FPLATEAUMarkedWayList UPLATEAUCrosswalkComposer::GenerateCrosswalk(
     const auto LinePositions = ShiftStopLine(Border, Intersection, PositionOffset);
     if (LinePositions.Num() == 0) return Result;
 
-    auto LineString = NewObject<URnLineString>();
-    for(int i=0; i<LinePositions.Num(); i++)
-    {
-        auto Pos = LinePositions[i];
-        auto Point = NewObject<URnPoint>();
-        Point->Init(Pos);
-        LineString->AddPointOrSkip(TRnRef_T<URnPoint>(Point));
-    }
-    
-    const auto LineWay = NewObject<URnWay>();
-    LineWay->Init(TRnRef_T<URnLineString>(LineString));
+    TArray<FVector> LineWay;
+    for (const auto& Pos : LinePositions)
+        URnLineString::AddVertexOrSkip(LineWay, Pos);
 
     // 横断歩道を車道の中心に配置するための計算です。
     const float LineLen = FVector::Distance(LinePositions[0], LinePositions.Last());
@@ -79,8 +120,8 @@ FPLATEAUMarkedWayList UPLATEAUCrosswalkComposer::GenerateCrosswalk(
     const float CrosswalkOffset = (LineLen - CrosswalkLen) / 2.0f;
 
     TArray<FVector> CrosswalkPositions;
-    CrosswalkPositions.Add(LineWay->PositionAtDistance(CrosswalkOffset, false));
-    CrosswalkPositions.Add(LineWay->PositionAtDistance(CrosswalkOffset, true));
+    CrosswalkPositions.Add(PositionAtDistance(LineWay, CrosswalkOffset, false));
+    CrosswalkPositions.Add(PositionAtDistance(LineWay, CrosswalkOffset, true));
 
     // 高さオフセットを適用
     for (auto& Position : CrosswalkPositions) {
@@ -99,7 +140,7 @@ FPLATEAUMarkedWayList UPLATEAUCrosswalkComposer::GenerateCrosswalk(
 TArray<FVector> UPLATEAUCrosswalkComposer::ShiftStopLine(
     const FPLATEAUMWLine& Border,
     const TRnRef_T<URnIntersection>& Intersection,
-    float PositionOffsetArg) {
+    float PositionOffsetArg) const {
 
     if (Border.Num() <= 1) return TArray<FVector>();
 
@@ -6,6 +6,8 @@
 #include "RoadNetwork/Structure/RnModel.h"
 #include "RoadNetwork/Structure/RnRoad.h"
 #include "RoadNetwork/Structure/RnLane.h"
+#include "Async/ParallelFor.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
 
 
 FPLATEAUDirectionalArrowComposer::FPLATEAUDirectionalArrowComposer(TObjectPtr<URnModel> TargetNetwork,
@@ -26,14 +28,42 @@ FPLATEAUDirectionalArrowComposer::FPLATEAUDirectionalArrowComposer(TObjectPtr<UR
     MeshStraightRight = Cast<UStaticMesh>(StaticLoadObject(UStaticMesh::StaticClass(), nullptr, MeshPathStraightRight));
 }
 
-TArray<TObjectPtr<UStaticMeshComponent>> FPLATEAUDirectionalArrowComposer::Compose()
+TArray<TObjectPtr<UHierarchicalInstancedStaticMeshComponent>> FPLATEAUDirectionalArrowComposer::Compose()
 {
-    TArray<TObjectPtr<UStaticMeshComponent>> Result;
-    RoadArrowIndex = 0;
+    TArray<TObjectPtr<UHierarchicalInstancedStaticMeshComponent>> Result;
+    if (!ReproducedRoad) return Result;
 
+    // 位置と角度は先に全車線分を並列に計算し, 種類ごとにまとめます
+    TMap<EPLATEAUDirectionalArrowType, TArray<FTransform>> TypeTransforms;
+    for (const auto& Placement : ComputeArrowPlacements())
+    {
+        const FRotator NewRotation(0.f, Placement.Angle, 0.f);
+        const FVector NewPosition = Placement.Position + FVector(0.f, 0.f, ArrowMeshHeightOffset);
+        TypeTransforms.FindOrAdd(Placement.Type).Add(FTransform(NewRotation, NewPosition));
+    }
+
+    for (const auto& [Type, Transforms] : TypeTransforms)
+    {
+        auto Arrows = GenerateArrows(Type, Transforms);
+        if (Arrows != nullptr)
+        {
+            Result.Add(Arrows);
+        }
+    }
+
+    return Result;
+}
+
+TArray<FPLATEAUDirectionalArrowComposer::FArrowPlacement> FPLATEAUDirectionalArrowComposer::ComputeArrowPlacements() const
+{
     const auto Roads = TargetNetwork->GetRoads();
-    for (const auto& Road : Roads)
+    TArray<TArray<FArrowPlacement>> RoadPlacements;
+    RoadPlacements.SetNum(Roads.Num());
+
+    // 道路ネットワークは読み取りのみなので道路ごとに並列に計算できます
+    ParallelFor(Roads.Num(), [&](int32 Index)
     {
+        const auto& Road = Roads[Index];
         auto* NextIntersection = Cast<URnIntersection>(Road->Next);
         auto* PrevIntersection = Cast<URnIntersection>(Road->Prev);
 
@@ -47,51 +77,42 @@ TArray<TObjectPtr<UStaticMeshComponent>> FPLATEAUDirectionalArrowComposer::Compo
 
             if (Lane->GetNextBorder())
             {
-                auto* Inter = Lane->GetIsReversed() ? PrevIntersection : NextIntersection;
-                bool bIsSucceedPosition = false;
-                bool bIsSucceedAngle = false;
-                const auto Position = ArrowPosition(Lane, true, bIsSucceedPosition);
-                const auto Angle = ArrowAngle(Lane, true, bIsSucceedAngle);
-
-                if (bIsSucceedPosition && bIsSucceedAngle)
-                {
-                    auto Arrow = GenerateArrow(Lane->GetNextBorder(), Inter, Position, Angle);
-                    if (Arrow != nullptr)
-                    {
-                        Result.Add(Arrow);
-                    }
-                }
+                ComputeLaneArrow(Lane, true, Lane->GetIsReversed() ? PrevIntersection : NextIntersection, RoadPlacements[Index]);
             }
 
             if (Lane->GetPrevBorder())
             {
-                auto* Inter = Lane->GetIsReversed() ? NextIntersection : PrevIntersection;
-                bool bIsSucceedPosition = false;
-                bool bIsSucceedAngle = false;
-                const auto Position = ArrowPosition(Lane, false, bIsSucceedPosition);
-                const auto Angle = ArrowAngle(Lane, false, bIsSucceedAngle);
-
-                if (bIsSucceedPosition && bIsSucceedAngle)
-                {
-                    auto Arrow = GenerateArrow(Lane->GetPrevBorder(), Inter, Position, Angle);
-                    if (Arrow != nullptr)
-                    {
-                        Result.Add(Arrow);
-                    }
-                }
+                ComputeLaneArrow(Lane, false, Lane->GetIsReversed() ? NextIntersection : PrevIntersection, RoadPlacements[Index]);
             }
         }
-    }
+    });
 
+    TArray<FArrowPlacement> Result;
+    for (auto& Placements : RoadPlacements)
+    {
+        Result.Append(MoveTemp(Placements));
+    }
     return Result;
 }
 
-TObjectPtr<UStaticMeshComponent> FPLATEAUDirectionalArrowComposer::GenerateArrow(
-    const URnWay* LaneBorder, const URnIntersection* Intersection, const FVector& Position, float Rotation)
+void FPLATEAUDirectionalArrowComposer::ComputeLaneArrow(const URnLane* Lane, bool bIsNext, const URnIntersection* Intersection,
+                                                        TArray<FArrowPlacement>& OutPlacements) const
 {
-    if (!Intersection || !ReproducedRoad) return nullptr;
+    bool bIsSucceedPosition = false;
+    bool bIsSucceedAngle = false;
+    const auto Position = ArrowPosition(Lane, bIsNext, bIsSucceedPosition);
+    const auto Angle = ArrowAngle(Lane, bIsNext, bIsSucceedAngle);
+    if (!bIsSucceedPosition || !bIsSucceedAngle || !Intersection) return;
+
+    const auto Type = ArrowType(bIsNext ? Lane->GetNextBorder() : Lane->GetPrevBorder(), Intersection);
+    if (Type == EPLATEAUDirectionalArrowType::None) return;
 
-    const auto Type = ArrowType(LaneBorder, Intersection);
+    OutPlacements.Add({ Type, Position, Angle });
+}
+
+TObjectPtr<UHierarchicalInstancedStaticMeshComponent> FPLATEAUDirectionalArrowComposer::GenerateArrows(
+    EPLATEAUDirectionalArrowType Type, const TArray<FTransform>& Transforms)
+{
     auto StaticMesh = ToStaticMesh(Type);
     if (StaticMesh == nullptr)
     {
@@ -121,23 +142,22 @@ TObjectPtr<UStaticMeshComponent> FPLATEAUDirectionalArrowComposer::GenerateArrow
         ArrowMeshesParent->RegisterComponent();
     }
 
-    // 矢印コンポーネントを作成し、ArrowMeshesの子として設定します。
-    const FString ComponentName = FString::Printf(TEXT("RoadArrow_%d"), RoadArrowIndex++);
-    auto* ArrowComponent = NewObject<UStaticMeshComponent>(ReproducedRoad, *ComponentName);
+    // 矢印の種類ごとのコンポーネントを作成し、ArrowMeshesの子として設定します。
+    // 作り直した場合に削除済みのコンポーネントと名前が重ならないようにします
+    const FString ComponentName = FString::Printf(TEXT("RoadArrow_%s"), *StaticMesh->GetName());
+    const auto UniqueName = MakeUniqueObjectName(ReproducedRoad, UHierarchicalInstancedStaticMeshComponent::StaticClass(), FName(ComponentName));
+    auto* ArrowComponent = NewObject<UHierarchicalInstancedStaticMeshComponent>(ReproducedRoad, UniqueName);
     ArrowComponent->SetStaticMesh(StaticMesh);
     ArrowComponent->SetupAttachment(ArrowMeshesParent);
     ReproducedRoad->AddInstanceComponent(ArrowComponent);
     ArrowComponent->RegisterComponent();
 
-    // Set transform
-    const FRotator NewRotation(0.f, Rotation, 0.f);
-    const FVector NewPosition = Position + FVector(0.f, 0.f, ArrowMeshHeightOffset);
-    ArrowComponent->SetWorldLocationAndRotation(NewPosition, NewRotation);
+    ArrowComponent->AddInstances(Transforms, false, true);
 
     return ArrowComponent;
 }
 
-FVector FPLATEAUDirectionalArrowComposer::ArrowPosition(const URnLane* Lane, bool bIsNext, bool& bIsSucceed)
+FVector FPLATEAUDirectionalArrowComposer::ArrowPosition(const URnLane* Lane, bool bIsNext, bool& bIsSucceed) const
 {
     int WayCount = 0;
     FVector PosSum = FVector::ZeroVector;
@@ -167,7 +187,7 @@ FVector FPLATEAUDirectionalArrowComposer::ArrowPosition(const URnLane* Lane, boo
     return PosSum / WayCount;
 }
 
-float FPLATEAUDirectionalArrowComposer::ArrowAngle(const URnLane* Lane, bool bIsNext, bool& bIsSucceed)
+float FPLATEAUDirectionalArrowComposer::ArrowAngle(const URnLane* Lane, bool bIsNext, bool& bIsSucceed) const
 {
     int32 WayCount = 0;
     float AngleSum = 0.f;
@@ -197,7 +217,7 @@ float FPLATEAUDirectionalArrowComposer::ArrowAngle(const URnLane* Lane, bool bIs
     return AngleSum / WayCount;
 }
 
-float FPLATEAUDirectionalArrowComposer::ArrowAngleOneWay(const URnWay* Way, bool bIsNext)
+float FPLATEAUDirectionalArrowComposer::ArrowAngleOneWay(const URnWay* Way, bool bIsNext) const
 {
     // wayの頂点数が2以上であることが前提
     FVector Diff;
@@ -218,7 +238,7 @@ float FPLATEAUDirectionalArrowComposer::ArrowAngleOneWay(const URnWay* Way, bool
 }
 
 EPLATEAUDirectionalArrowType FPLATEAUDirectionalArrowComposer::ArrowType(const URnWay* LaneBorder,
-                                                           const URnIntersection* Intersection)
+                                                           const URnIntersection* Intersection) const
 {
     if (!Intersection) return EPLATEAUDirectionalArrowType::None;
 
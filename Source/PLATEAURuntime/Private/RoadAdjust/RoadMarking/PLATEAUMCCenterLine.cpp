@@ -1,10 +1,9 @@
 // Copyright © 2023 Ministry of Land, Infrastructure and Transport
 
 #include "RoadAdjust/RoadMarking/PLATEAUMCCenterLine.h"
-#include "RoadAdjust/RoadNetworkToMesh/PLATEAURrTarget.h"
+#include "Algo/Reverse.h"
 #include "RoadNetwork/Structure/RnIntersection.h"
 #include "RoadNetwork/Structure/RnLineString.h"
-#include "RoadNetwork/Structure/RnPoint.h"
 #include "RoadAdjust/RoadMarking/PLATEAUMarkedWay.h"
 
 // FPLATEAUIntersectionDistCalc Implementation
@@ -40,12 +39,15 @@ FPLATEAUIntersectionDistCalc::FPLATEAUIntersectionDistCalc(URnRoad* Road)
 
 float FPLATEAUIntersectionDistCalc::NearestDistFromIntersection(const URnWay* Way, int32 WayIndexOrig) const
 {
-    if (Way->Count() <= 1)
+    return NearestDistFromIntersection(Way->GetVertices().ToArray(), Way->IsReversed, WayIndexOrig);
+}
+
+float FPLATEAUIntersectionDistCalc::NearestDistFromIntersection(const TArray<FVector>& Points, bool bIsReversed, int32 WayIndexOrig) const
+{
+    if (Points.Num() <= 1)
         return TNumericLimits<float>::Max();
 
-    const auto& Points = Way->GetVertices().ToArray();
-    const bool bIsReversed = Way->IsReversed;
-    const int32 WayIndex = bIsReversed ? Way->Count() - 1 - WayIndexOrig : WayIndexOrig;
+    const int32 WayIndex = bIsReversed ? Points.Num() - 1 - WayIndexOrig : WayIndexOrig;
 
     float PrevLen = 0.0f;
     for (int32 i = 1; i <= WayIndex && i < Points.Num(); i++)
@@ -105,20 +107,21 @@ EPLATEAUMarkedWayType UPLATEAUMCCenterLine::GetCenterLineTypeOfWidth(const URnRo
     return bIsOver6M ? EPLATEAUMarkedWayType::CenterLineOver6MWidth : EPLATEAUMarkedWayType::CenterLineUnder6MWidth;
 }
 
-URnWay* UPLATEAUMCCenterLine::WayWithMiddlePoint(const URnWay* Way) const
+TArray<FVector> UPLATEAUMCCenterLine::WayWithMiddlePoint(const URnWay* Way) const
 {
     const float WayLength = Way->CalcLength();
     const float HalfWayLength = WayLength / 2.0f;
     float Len = 0.0f;
     
-    URnLineString* DstLine = NewObject<URnLineString>();
-    DstLine->AddPointOrSkip(Way->GetPoint(0));
+    TArray<FVector> DstLine;
+    DstLine.Reserve(Way->Count() + 1);
+    URnLineString::AddVertexOrSkip(DstLine, Way->GetVertex(0));
     
     bool bCenterAdded = false;
     for (int32 j = 1; j < Way->Count(); j++)
     {
-        const FVector& PCurrent = Way->GetPoint(j)->Vertex;
-        const FVector& PPrev = Way->GetPoint(j - 1)->Vertex;
+        const FVector PCurrent = Way->GetVertex(j);
+        const FVector PPrev = Way->GetVertex(j - 1);
         const float LenDiff = (PCurrent - PPrev).Size();
         const float PrevLen = Len;
         Len += LenDiff;
@@ -126,130 +129,107 @@ URnWay* UPLATEAUMCCenterLine::WayWithMiddlePoint(const URnWay* Way) const
         if (!bCenterAdded && Len >= HalfWayLength)
         {
             const FVector Pos = FMath::Lerp(PPrev, PCurrent, (HalfWayLength - PrevLen) / LenDiff);
-            URnPoint* NewPoint = NewObject<URnPoint>();
-            NewPoint->Vertex = Pos;
-            DstLine->AddPointOrSkip(NewPoint);
+            URnLineString::AddVertexOrSkip(DstLine, Pos);
             bCenterAdded = true;
         }
         
-        DstLine->AddPointOrSkip(Way->GetPoint(j));
+        URnLineString::AddVertexOrSkip(DstLine, PCurrent);
     }
 
-    URnWay* NewWay = NewObject<URnWay>();
-    NewWay->Init(DstLine, Way->IsReversed, Way->IsReverseNormal);
-    return NewWay;
+    // 元のWayと同じIsReversedを持つWayとして扱うため、LineStringの並び順に戻します
+    if (Way->IsReversed)
+        Algo::Reverse(DstLine);
+    return DstLine;
 }
 
-FPLATEAUMarkedWayList UPLATEAUMCCenterLine::ComposeFrom(const IPLATEAURrTarget* Target)
+void UPLATEAUMCCenterLine::ComposeRoad(URnRoad* Road, FPLATEAUMarkedWayList& OutList) const
 {
-    FPLATEAUMarkedWayList Result;
+    if (!Road->IsValid())
+        return;
+
+    const auto& CarLanes = Road->GetMainLanes();
+    const auto WidthType = GetCenterLineTypeOfWidth(Road);
+    const FPLATEAUIntersectionDistCalc InterDistCalc(Road);
+    const bool bMedianLaneExist = Road->GetMedianLane() != nullptr;
+    // センターラインの数は道路ごとに数えます
+    const int32 RoadResultStart = OutList.Num();
 
-    const auto& Roads = Target->GetRoads();
-    for (const auto& Road : Roads)
+    for (int32 i = 0; i < CarLanes.Num(); i++)
     {
-        if (!Road->IsValid())
+        const auto& Lane = CarLanes[i];
+        // 隣のレーンと進行方向が異なる場合、Rightwayはセンターラインです
+        bool bIsCenterLane = i < CarLanes.Num() - 1 && Lane->GetIsReversed() != CarLanes[i + 1]->GetIsReversed();
+        
+        // 中央分離帯がある場合、センターラインは2つになるので、隣チェックを両方向で行います
+        if (bMedianLaneExist)
+        {
+            bIsCenterLane |= i >= 1 && Lane->GetIsReversed() != CarLanes[i - 1]->GetIsReversed();
+        }
+
+        if (!bIsCenterLane)
             continue;
 
-        const auto& CarLanes = Road->GetMainLanes();
-        const auto WidthType = GetCenterLineTypeOfWidth(Road);
-        const FPLATEAUIntersectionDistCalc InterDistCalc(Road);
-        const bool bMedianLaneExist = Road->GetMedianLane() != nullptr;
+        // センターラインの場合
+        const auto* RightWay = Lane->GetRightWay();
+        const TArray<FVector> SrcPoints = WayWithMiddlePoint(RightWay);
+        const bool bSrcReversed = RightWay->IsReversed;
+        TArray<FVector> LineString;
+        EPLATEAUMarkedWayType PrevInterType = EPLATEAUMarkedWayType::None;
 
-        for (int32 i = 0; i < CarLanes.Num(); i++)
+        for (int32 j = 0; j < SrcPoints.Num(); j++)
         {
-            const auto& Lane = CarLanes[i];
-            // 隣のレーンと進行方向が異なる場合、Rightwayはセンターラインです
-            bool bIsCenterLane = i < CarLanes.Num() - 1 && Lane->GetIsReversed() != CarLanes[i + 1]->GetIsReversed();
-            
-            // 中央分離帯がある場合、センターラインは2つになるので、隣チェックを両方向で行います
-            if (bMedianLaneExist)
-            {
-                bIsCenterLane |= i >= 1 && Lane->GetIsReversed() != CarLanes[i - 1]->GetIsReversed();
-            }
-
-            if (!bIsCenterLane)
-                continue;
+            const float CurrentDist = InterDistCalc.NearestDistFromIntersection(SrcPoints, bSrcReversed, j);
+            const auto InterType = IsCenterLineYellow(CurrentDist, InterDistCalc.GetLengthBetweenCenterLine())
+                ? EPLATEAUMarkedWayType::CenterLineNearIntersection
+                : WidthType;
 
-            // センターラインの場合
-            URnWay* SrcWay = WayWithMiddlePoint(Lane->GetRightWay());
-            URnLineString* LineString = NewObject<URnLineString>();
-            EPLATEAUMarkedWayType PrevInterType = EPLATEAUMarkedWayType::None;
-
-            for (int32 j = 0; j < SrcWay->Count(); j++)
+            if (PrevInterType != InterType && PrevInterType != EPLATEAUMarkedWayType::None)
             {
-                const float CurrentDist = InterDistCalc.NearestDistFromIntersection(SrcWay, j);
-                const auto InterType = IsCenterLineYellow(CurrentDist, InterDistCalc.GetLengthBetweenCenterLine())
-                    ? EPLATEAUMarkedWayType::CenterLineNearIntersection
-                    : WidthType;
-
-                if (PrevInterType != InterType && PrevInterType != EPLATEAUMarkedWayType::None)
+                // 交差点との距離がしきい値となる点を補間して追加
+                const float PrevDist = InterDistCalc.NearestDistFromIntersection(SrcPoints, bSrcReversed, j - 1);
+                float t;
+                if (FMath::Abs(CurrentDist - PrevDist) < 0.1f)
                 {
-                    // 交差点との距離がしきい値となる点を補間して追加
-                    const float PrevDist = InterDistCalc.NearestDistFromIntersection(SrcWay, j - 1);
-                    float t;
-                    if (FMath::Abs(CurrentDist - PrevDist) < 0.1f)
-                    {
-                        t = 1.0f;
-                    }
-                    else
-                    {
-                        t = (YellowIntersectionThreshold - PrevDist) / (CurrentDist - PrevDist);
-                    }
-
-                    const FVector LerpedPoint = FMath::Lerp(
-                        SrcWay->GetPoint(j - 1)->Vertex,
-                        SrcWay->GetPoint(j)->Vertex,
-                        t);
-
-                    URnPoint* NewPoint = NewObject<URnPoint>();
-                    NewPoint->Vertex = LerpedPoint;
-                    LineString->AddPointOrSkip(NewPoint);
-
-                    // 線を追加
-                    TArray<FVector> Points;
-                    for (const auto& Point : LineString->GetPoints())
-                    {
-                        Points.Add(Point->Vertex);
-                    }
-                    Result.Add(FPLATEAUMarkedWay(
-                        FPLATEAUMWLine(Points),
-                        PrevInterType,
-                        Lane->GetIsReversed()
-                    ));
-
-                    // リセット
-                    LineString = NewObject<URnLineString>();
-                    // 次の始点
-                    NewPoint = NewObject<URnPoint>();
-                    NewPoint->Vertex = LerpedPoint;
-                    LineString->AddPointOrSkip(NewPoint);
+                    t = 1.0f;
                 }
-
-                PrevInterType = InterType;
-                LineString->AddPointOrSkip(SrcWay->GetPoint(j));
-            }
-
-            if (LineString->GetPoints().Num() > 0)
-            {
-                TArray<FVector> Points;
-                for (const auto& Point : LineString->GetPoints())
+                else
                 {
-                    Points.Add(Point->Vertex);
+                    t = (YellowIntersectionThreshold - PrevDist) / (CurrentDist - PrevDist);
                 }
-                Result.Add(FPLATEAUMarkedWay(
-                    FPLATEAUMWLine(Points),
+
+                const FVector LerpedPoint = FMath::Lerp(SrcPoints[j - 1], SrcPoints[j], t);
+                URnLineString::AddVertexOrSkip(LineString, LerpedPoint);
+
+                // 線を追加
+                OutList.Add(FPLATEAUMarkedWay(
+                    FPLATEAUMWLine(LineString),
                     PrevInterType,
                     Lane->GetIsReversed()
                 ));
-            }
 
-            // センターラインの数は、中央分離帯がなければ最大1個、あれば最大2個です
-            if ((Result.Num() == 1 && !bMedianLaneExist) || (Result.Num() == 2 && bMedianLaneExist))
-            {
-                break;
+                // リセットして次の始点を追加
+                LineString.Reset();
+                URnLineString::AddVertexOrSkip(LineString, LerpedPoint);
             }
+
+            PrevInterType = InterType;
+            URnLineString::AddVertexOrSkip(LineString, SrcPoints[j]);
+        }
+
+        if (LineString.Num() > 0)
+        {
+            OutList.Add(FPLATEAUMarkedWay(
+                FPLATEAUMWLine(LineString),
+                PrevInterType,
+                Lane->GetIsReversed()
+            ));
         }
-    }
 
-    return Result;
+        // センターラインの数は、中央分離帯がなければ最大1個、あれば最大2個です
+        const int32 RoadResultNum = OutList.Num() - RoadResultStart;
+        if ((RoadResultNum == 1 && !bMedianLaneExist) || (RoadResultNum == 2 && bMedianLaneExist))
+        {
+            break;
+        }
+    }
 }
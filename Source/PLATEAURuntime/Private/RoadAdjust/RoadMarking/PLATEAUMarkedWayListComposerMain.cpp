@@ -2,38 +2,96 @@
 
 #include "RoadAdjust/RoadMarking/PLATEAUMarkedWayListComposerMain.h"
 
+#include "Async/ParallelFor.h"
 #include "RoadAdjust/RoadMarking/PLATEAUMCCenterLine.h"
 #include "RoadAdjust/RoadMarking/PLATEAUMCIntersection.h"
 #include "RoadAdjust/RoadMarking/PLATEAUMCLaneLine.h"
 #include "RoadAdjust/RoadMarking/PLATEAUMCShoulderLine.h"
 #include "RoadAdjust/RoadMarking/UPLATEAUStopLineComposer.h"
+#include "RoadNetwork/Structure/RnIntersection.h"
 
 
+FPLATEAUMarkedWayList IPLATEAUMarkedWayListComposer::ComposeFrom(const IPLATEAURrTarget* Target)
+{
+    FPLATEAUMarkedWayList Result;
+    for (const auto& Road : Target->GetRoads())
+        ComposeRoad(Road, Result);
+    for (const auto& Intersection : Target->GetIntersections())
+        ComposeIntersection(Intersection, Result);
+    return Result;
+}
+
 FPLATEAUMarkedWayList UPLATEAUMarkedWayListComposerMain::ComposeFrom(const IPLATEAURrTarget* Target)
 {
     // 結果を格納するリスト
     FPLATEAUMarkedWayList Result;
-    
 
+    TArray<URnRoadBase*> RoadBases;
+    RoadBases.Append(Target->GetRoads());
+    RoadBases.Append(Target->GetIntersections());
+    const auto Lists = ComposeEach(RoadBases);
+
+    // 直列に処理していた時と同じ順序になるよう、コンポーザーごとにまとめます
+    const auto ComposerNum = Composers.Num();
+    for (auto ComposerIndex = 0; ComposerIndex < ComposerNum; ++ComposerIndex)
+    {
+        for (auto RoadBaseIndex = 0; RoadBaseIndex < RoadBases.Num(); ++RoadBaseIndex)
+            Result.AddRange(Lists[RoadBaseIndex * ComposerNum + ComposerIndex]);
+    }
+
+    return Result;
+}
+
+TArray<FPLATEAUMarkedWayList> UPLATEAUMarkedWayListComposerMain::ComposePerRoadBase(const TArray<URnRoadBase*>& RoadBases)
+{
+    const auto Lists = ComposeEach(RoadBases);
+
+    TArray<FPLATEAUMarkedWayList> Result;
+    Result.SetNum(RoadBases.Num());
+    const auto ComposerNum = Composers.Num();
+    for (auto RoadBaseIndex = 0; RoadBaseIndex < RoadBases.Num(); ++RoadBaseIndex)
+    {
+        for (auto ComposerIndex = 0; ComposerIndex < ComposerNum; ++ComposerIndex)
+            Result[RoadBaseIndex].AddRange(Lists[RoadBaseIndex * ComposerNum + ComposerIndex]);
+    }
+    return Result;
+}
+
+TArray<FPLATEAUMarkedWayList> UPLATEAUMarkedWayListComposerMain::ComposeEach(const TArray<URnRoadBase*>& RoadBases)
+{
     // 生成したい線の種類を列挙
-    auto Composers = TArray<TScriptInterface<IPLATEAUMarkedWayListComposer>>();
-    Composers.Add(NewObject<UPLATEAUMCLaneLine>()); // 車線の間の線のうち、センターラインでないもの
-    Composers.Add(NewObject<UPLATEAUMCShoulderLine>());  // 路側帯線、すなわち歩道と車道の間の線
-    Composers.Add(NewObject<UPLATEAUMCCenterLine>());    // センターライン
-    Composers.Add(NewObject<UPLATEAUMCIntersection>());  // 交差点の線
-    Composers.Add(NewObject<UPLATEAUStopLineComposer>()); // 停止線
-    
-
-    // 各コンポーザーの結果を収集し、高さオフセットを適用
-    for (const auto Composer : Composers)
+    if (Composers.Num() == 0)
     {
-        if (Composer != nullptr)
-        {
-            FPLATEAUMarkedWayList MarkedWayList = Composer->ComposeFrom(Target);
-            MarkedWayList.Translate(FVector::UpVector * UPLATEAUMarkedWayListComposerMain::HeightOffset);
-            Result.AddRange(MarkedWayList);
-        }
+        Composers.Add(NewObject<UPLATEAUMCLaneLine>(this)); // 車線の間の線のうち、センターラインでないもの
+        Composers.Add(NewObject<UPLATEAUMCShoulderLine>(this));  // 路側帯線、すなわち歩道と車道の間の線
+        Composers.Add(NewObject<UPLATEAUMCCenterLine>(this));    // センターライン
+        Composers.Add(NewObject<UPLATEAUMCIntersection>(this));  // 交差点の線
+        Composers.Add(NewObject<UPLATEAUStopLineComposer>(this)); // 停止線
     }
 
+    // TScriptInterfaceの解決はゲームスレッドで済ませておきます
+    TArray<const IPLATEAUMarkedWayListComposer*> ComposerInterfaces;
+    for (const auto& Composer : Composers)
+        ComposerInterfaces.Add(Composer.GetInterface());
+
+    // 各道路/交差点とコンポーザーの組ごとに線を生成し、高さオフセットを適用
+    const auto ComposerNum = ComposerInterfaces.Num();
+    TArray<FPLATEAUMarkedWayList> Result;
+    Result.SetNum(RoadBases.Num() * ComposerNum);
+    ParallelFor(Result.Num(), [&](int32 Index)
+    {
+        const auto* Composer = ComposerInterfaces[Index % ComposerNum];
+        auto* RoadBase = RoadBases[Index / ComposerNum];
+        if (Composer == nullptr || RoadBase == nullptr)
+            return;
+
+        auto& MarkedWayList = Result[Index];
+        if (auto* Road = Cast<URnRoad>(RoadBase))
+            Composer->ComposeRoad(Road, MarkedWayList);
+        else if (auto* Intersection = Cast<URnIntersection>(RoadBase))
+            Composer->ComposeIntersection(Intersection, MarkedWayList);
+        MarkedWayList.Translate(FVector::UpVector * UPLATEAUMarkedWayListComposerMain::HeightOffset);
+    });
+
     return Result;
 }
@@ -0,0 +1,186 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "RoadAdjust/RoadMarking/PLATEAURoadMarkingCache.h"
+#include "RoadAdjust/RoadMarking/PLATEAUCrosswalkComposer.h"
+#include "RoadAdjust/RoadMarking/PLATEAUMarkedWayListComposerMain.h"
+#include "RoadNetwork/Structure/RnIntersection.h"
+#include "RoadNetwork/Structure/RnLane.h"
+#include "RoadNetwork/Structure/RnPoint.h"
+#include "RoadNetwork/Structure/RnRoad.h"
+#include "RoadNetwork/Structure/RnWay.h"
+
+namespace {
+    uint32 HashWay(uint32 Hash, const URnWay* Way) {
+        if (Way == nullptr)
+            return HashCombineFast(Hash, 0);
+        Hash = HashCombineFast(Hash, Way->Count());
+        for (const auto& Vertex : Way->GetVertices())
+            Hash = HashCombineFast(Hash, GetTypeHash(Vertex));
+        return Hash;
+    }
+
+    uint32 HashLane(uint32 Hash, const URnLane* Lane) {
+        if (Lane == nullptr)
+            return HashCombineFast(Hash, 0);
+        Hash = HashCombineFast(Hash, GetTypeHash(Lane->GetIsReversed()));
+        for (const auto& Way : Lane->GetAllWays())
+            Hash = HashWay(Hash, Way);
+        return Hash;
+    }
+
+    // Fromから見てCurrentの方向へ, 道路以外に行き当たるまで道路をたどります
+    void CollectRoadChain(const URnRoadBase* From, URnRoadBase* Current, TArray<URnRoadBase*>& OutRoadBases) {
+        while (Current != nullptr && !OutRoadBases.Contains(Current)) {
+            OutRoadBases.Add(Current);
+            const auto* Road = Cast<URnRoad>(Current);
+            if (Road == nullptr)
+                break;
+            auto* Neighbor = Road->GetNext() == From ? Road->GetPrev() : Road->GetNext();
+            From = Current;
+            Current = Neighbor;
+        }
+    }
+}
+
+TArray<URnRoadBase*> FPLATEAURoadMarkingCache::FindChangedRoadBases(const URnModel* Model, EPLATEAUCrosswalkFrequency InCrosswalkFrequency) const {
+    TArray<URnRoadBase*> Result;
+    const auto bAll = !CrosswalkFrequency.IsSet() || CrosswalkFrequency.GetValue() != InCrosswalkFrequency;
+    auto Check = [&](URnRoadBase* RoadBase) {
+        const auto* Entry = Entries.Find(RoadBase);
+        if (bAll || Entry == nullptr || Entry->Signature != ComputeSignature(RoadBase))
+            Result.Add(RoadBase);
+    };
+    for (const auto& Road : Model->GetRoads())
+        Check(Road);
+    for (const auto& Intersection : Model->GetIntersections())
+        Check(Intersection);
+    return Result;
+}
+
+FPLATEAURoadMarkingCache::FUpdateResult FPLATEAURoadMarkingCache::Update(URnModel* Model, const TArray<URnRoadBase*>& ChangedRoadBases, EPLATEAUCrosswalkFrequency InCrosswalkFrequency) {
+    FUpdateResult Result;
+
+    TSet<TObjectKey<URnRoadBase>> InModel;
+    for (const auto& Road : Model->GetRoads())
+        InModel.Add(Road);
+    for (const auto& Intersection : Model->GetIntersections())
+        InModel.Add(Intersection);
+
+    // 作り直す道路/交差点を集める(追加順を保つ)
+    TArray<URnRoadBase*> Targets;
+    TSet<URnRoadBase*> TargetSet;
+    auto AddTarget = [&](URnRoadBase* RoadBase) {
+        if (RoadBase == nullptr || !InModel.Contains(RoadBase) || TargetSet.Contains(RoadBase))
+            return;
+        TargetSet.Add(RoadBase);
+        Targets.Add(RoadBase);
+    };
+    // 変更前の接続先も作り直す
+    auto AddDependents = [&](const FEntry& Entry) {
+        for (const auto& Dependent : Entry.Dependents)
+            AddTarget(Dependent.ResolveObjectPtr());
+    };
+
+    for (auto* RoadBase : ChangedRoadBases) {
+        AddTarget(RoadBase);
+        for (auto* Dependent : CollectDependents(RoadBase))
+            AddTarget(Dependent);
+        if (const auto* Entry = Entries.Find(RoadBase))
+            AddDependents(*Entry);
+    }
+
+    // 削除された道路/交差点
+    for (auto It = Entries.CreateIterator(); It; ++It) {
+        if (InModel.Contains(It.Key()))
+            continue;
+        AddDependents(It.Value());
+        Result.UpdatedRoadBases.Add(It.Key());
+        Result.OldMarkedWays.Append(It.Value().MarkedWays);
+        It.RemoveCurrent();
+    }
+
+    // 道路/交差点1つずつを対象にして線を作ります
+    auto* WayComposer = NewObject<UPLATEAUMarkedWayListComposerMain>(GetTransientPackage(), UPLATEAUMarkedWayListComposerMain::StaticClass());
+    auto* CrosswalkComposer = NewObject<UPLATEAUCrosswalkComposer>();
+    const auto WayLists = WayComposer->ComposePerRoadBase(Targets);
+    const auto CrosswalkLists = CrosswalkComposer->ComposePerRoadBase(Targets, InCrosswalkFrequency);
+    for (auto i = 0; i < Targets.Num(); ++i) {
+        auto* RoadBase = Targets[i];
+
+        FEntry NewEntry;
+        NewEntry.Signature = ComputeSignature(RoadBase);
+        for (auto* Dependent : CollectDependents(RoadBase))
+            NewEntry.Dependents.Add(Dependent);
+        NewEntry.MarkedWays = WayLists[i].GetMarkedWays();
+        NewEntry.MarkedWays.Append(CrosswalkLists[i].GetMarkedWays());
+
+        if (const auto* OldEntry = Entries.Find(RoadBase))
+            Result.OldMarkedWays.Append(OldEntry->MarkedWays);
+        Entries.Add(RoadBase, MoveTemp(NewEntry));
+        Result.UpdatedRoadBases.Add(RoadBase);
+    }
+
+    CrosswalkFrequency = InCrosswalkFrequency;
+    return Result;
+}
+
+TArray<FPLATEAUMarkedWay> FPLATEAURoadMarkingCache::GetMarkedWays(const URnModel* Model) const {
+    TArray<FPLATEAUMarkedWay> Result;
+    auto Append = [&](const URnRoadBase* RoadBase) {
+        if (const auto* Entry = Find(RoadBase))
+            Result.Append(Entry->MarkedWays);
+    };
+    for (const auto& Road : Model->GetRoads())
+        Append(Road);
+    for (const auto& Intersection : Model->GetIntersections())
+        Append(Intersection);
+    return Result;
+}
+
+const FPLATEAURoadMarkingCache::FEntry* FPLATEAURoadMarkingCache::Find(const URnRoadBase* RoadBase) const {
+    return Entries.Find(RoadBase);
+}
+
+void FPLATEAURoadMarkingCache::Reset() {
+    Entries.Reset();
+    CrosswalkFrequency.Reset();
+}
+
+uint32 FPLATEAURoadMarkingCache::ComputeSignature(const URnRoadBase* RoadBase) {
+    uint32 Hash = GetTypeHash(RoadBase);
+    if (const auto* Road = Cast<URnRoad>(RoadBase)) {
+        Hash = HashCombineFast(Hash, GetTypeHash(Road->GetPrev()));
+        Hash = HashCombineFast(Hash, GetTypeHash(Road->GetNext()));
+        Hash = HashCombineFast(Hash, Road->GetMainLanes().Num());
+        for (const auto& Lane : Road->GetMainLanes())
+            Hash = HashLane(Hash, Lane);
+        Hash = HashLane(Hash, Road->GetMedianLane());
+    }
+    else if (const auto* Intersection = Cast<URnIntersection>(RoadBase)) {
+        Hash = HashCombineFast(Hash, Intersection->GetEdges().Num());
+        for (const auto& Edge : Intersection->GetEdges()) {
+            Hash = HashCombineFast(Hash, GetTypeHash(Edge->GetRoad()));
+            Hash = HashWay(Hash, Edge->GetBorder());
+        }
+    }
+    return Hash;
+}
+
+TArray<URnRoadBase*> FPLATEAURoadMarkingCache::CollectDependents(const URnRoadBase* RoadBase) {
+    TArray<URnRoadBase*> Result;
+    if (const auto* Road = Cast<URnRoad>(RoadBase)) {
+        // センターラインの色は交差点までの道路の長さで決まるので, 連なる道路と両端の交差点を対象にします
+        Result.Add(const_cast<URnRoadBase*>(RoadBase));
+        CollectRoadChain(RoadBase, Road->GetPrev(), Result);
+        CollectRoadChain(RoadBase, Road->GetNext(), Result);
+        Result.RemoveAt(0);
+    }
+    else if (const auto* Intersection = Cast<URnIntersection>(RoadBase)) {
+        // 停止線と横断歩道は接続する道路側で交差点の形状から作られます
+        for (const auto& Edge : Intersection->GetEdges()) {
+            if (Edge->GetRoad() != nullptr)
+                Result.AddUnique(Edge->GetRoad());
+        }
+    }
+    return Result;
+}
@@ -0,0 +1,212 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "RoadAdjust/RoadMarking/PLATEAURoadMarkingMeshBuilder.h"
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
+#include "Engine/StaticMesh.h"
+#include "StaticMeshAttributes.h"
+
+const FName FPLATEAURoadMarkingMeshBuilder::MaterialSlotName(TEXT("RoadMarking"));
+
+namespace {
+    // ULineGeneratorComponentで線形スプラインの終点ちょうどを指定しないようにずらしている量
+    constexpr float FillEndMargin = 0.01f;
+
+    // 折れ線上で始点からDistanceの位置を返す. CumulativeDistances[i]は頂点iまでの距離
+    FVector GetLocationAtDistance(const TArray<FVector>& Points, const TArray<float>& CumulativeDistances, float Distance) {
+        const auto Index = FMath::Clamp(Algo::UpperBound(CumulativeDistances, Distance) - 1, 0, Points.Num() - 2);
+        const auto SegmentLength = CumulativeDistances[Index + 1] - CumulativeDistances[Index];
+        if (SegmentLength <= 0.f)
+            return Points[Index];
+        const auto T = FMath::Clamp((Distance - CumulativeDistances[Index]) / SegmentLength, 0.f, 1.f);
+        return FMath::Lerp(Points[Index], Points[Index + 1], T);
+    }
+}
+
+FPLATEAURoadMarkingMeshBuilder::FPLATEAURoadMarkingMeshBuilder(const TMap<EPLATEAURoadLineType, FPLATEAURoadLineParam>& InLineTypeMap, float InChunkSize)
+    : ChunkSize(FMath::Max(InChunkSize, 1.f)) {
+    for (const auto& [Type, Param] : InLineTypeMap) {
+        // メッシュが無い場合はULineGeneratorComponentと同様に何も生成しない
+        if (Param.LineMesh == nullptr)
+            continue;
+
+        // USplineMeshComponentはメッシュのX方向をスプラインに沿わせ, Y方向をLineXScale倍する
+        const auto Box = Param.LineMesh->GetBoundingBox();
+        FProfile Profile;
+        Profile.MeshLength = Param.LineLength != 0.f ? Param.LineLength : Param.LineMesh->GetBounds().SphereRadius;
+        Profile.Gap = Param.LineGap > 0.001f ? Param.LineGap : 0.f;
+        Profile.bFillEnd = Param.FillEnd;
+        Profile.HalfWidth = Box.GetExtent().Y * Param.LineXScale;
+        Profile.CenterY = Box.GetCenter().Y * Param.LineXScale;
+        Profile.Height = Box.Max.Z;
+        Profiles.Add(Type, Profile);
+    }
+}
+
+void FPLATEAURoadMarkingMeshBuilder::AddLine(EPLATEAURoadLineType Type, const TArray<FVector>& LinePoints, FVector2D Offset) {
+    if (LinePoints.Num() < 2 || !Profiles.Contains(Type))
+        return;
+    Lines.Add({ Type, LinePoints, Offset });
+}
+
+TArray<FPLATEAURoadMarkingMeshBuilder::FDash> FPLATEAURoadMarkingMeshBuilder::ComputeDashes(const TArray<FVector>& LinePoints, float MeshLength, float Gap, bool bFillEnd) {
+    TArray<FDash> Dashes;
+    if (LinePoints.Num() < 2)
+        return Dashes;
+
+    // 隙間が無い場合は頂点間ごとに1つ(ULineGeneratorComponentのLengthBased)
+    if (Gap <= 0.f) {
+        for (auto i = 0; i < LinePoints.Num() - 1; ++i)
+            Dashes.Add({ LinePoints[i], LinePoints[i + 1] });
+        return Dashes;
+    }
+
+    TArray<float> CumulativeDistances;
+    CumulativeDistances.SetNumUninitialized(LinePoints.Num());
+    CumulativeDistances[0] = 0.f;
+    for (auto i = 1; i < LinePoints.Num(); ++i)
+        CumulativeDistances[i] = CumulativeDistances[i - 1] + FVector::Distance(LinePoints[i - 1], LinePoints[i]);
+
+    // ULineGeneratorComponentのSegmentBasedと同じ区切り方
+    const auto SplineLength = CumulativeDistances.Last();
+    const auto Length = MeshLength + Gap;
+    if (Length <= 0.f)
+        return Dashes;
+    const auto NumLoop = static_cast<int32>(SplineLength / Length);
+    Dashes.Reserve(NumLoop);
+    for (auto Index = 0; Index < NumLoop; ++Index) {
+        const auto StartDistance = Length * Index;
+        auto EndDistance = Length * (Index + 1) - Gap;
+        if (Index == NumLoop - 1 && bFillEnd)
+            EndDistance = SplineLength - FillEndMargin;
+
+        Dashes.Add({
+            GetLocationAtDistance(LinePoints, CumulativeDistances, StartDistance),
+            GetLocationAtDistance(LinePoints, CumulativeDistances, EndDistance) });
+    }
+    return Dashes;
+}
+
+void FPLATEAURoadMarkingMeshBuilder::AppendDash(FMeshDescription& MeshDescription, const FProfile& Profile, const FDash& Dash, const FVector2D& Offset) const {
+    const auto Dir = (Dash.End - Dash.Start).GetSafeNormal2D();
+    if (Dir.IsNearlyZero())
+        return;
+
+    FStaticMeshAttributes Attributes(MeshDescription);
+    const auto VertexPositions = Attributes.GetVertexPositions();
+    const auto Normals = Attributes.GetVertexInstanceNormals();
+    const auto Tangents = Attributes.GetVertexInstanceTangents();
+    const auto BinormalSigns = Attributes.GetVertexInstanceBinormalSigns();
+    const auto UVs = Attributes.GetVertexInstanceUVs();
+
+    const auto Right = FVector::CrossProduct(FVector::UpVector, Dir);
+    const auto Center = Right * (Profile.CenterY + Offset.X) + FVector::UpVector * (Profile.Height + Offset.Y);
+    const auto Side = Right * Profile.HalfWidth;
+    const auto VLength = FVector::Distance(Dash.Start, Dash.End) / FMath::Max(Profile.MeshLength, 1.f);
+
+    // 始点左, 終点左, 終点右, 始点右
+    const FVector Positions[] = {
+        Dash.Start + Center - Side,
+        Dash.End + Center - Side,
+        Dash.End + Center + Side,
+        Dash.Start + Center + Side,
+    };
+    const FVector2f VertexUVs[] = {
+        FVector2f(0.f, 0.f),
+        FVector2f(0.f, VLength),
+        FVector2f(1.f, VLength),
+        FVector2f(1.f, 0.f),
+    };
+
+    FVertexInstanceID Instances[4];
+    for (auto i = 0; i < 4; ++i) {
+        const auto VertexID = MeshDescription.CreateVertex();
+        VertexPositions[VertexID] = FVector3f(Positions[i]);
+        Instances[i] = MeshDescription.CreateVertexInstance(VertexID);
+        Normals[Instances[i]] = FVector3f::UpVector;
+        Tangents[Instances[i]] = FVector3f(Dir);
+        BinormalSigns[Instances[i]] = 1.f;
+        UVs.Set(Instances[i], 0, VertexUVs[i]);
+    }
+
+    // 上から見て時計回りが表
+    const auto PolygonGroupID = FPolygonGroupID(0);
+    MeshDescription.CreateTriangle(PolygonGroupID, { Instances[0], Instances[1], Instances[2] });
+    MeshDescription.CreateTriangle(PolygonGroupID, { Instances[0], Instances[2], Instances[3] });
+}
+
+FIntPoint FPLATEAURoadMarkingMeshBuilder::GetChunk(const FVector& Position, float InChunkSize) {
+    const auto Size = FMath::Max(InChunkSize, 1.f);
+    return FIntPoint(FMath::FloorToInt32(Position.X / Size), FMath::FloorToInt32(Position.Y / Size));
+}
+
+void FPLATEAURoadMarkingMeshBuilder::GetOverlappingChunks(const TArray<FVector>& LinePoints, float InChunkSize, TSet<FIntPoint>& OutChunks) {
+    if (LinePoints.Num() == 0)
+        return;
+    // 破線の中点は線の頂点のバウンディングボックス内にあります
+    const FBox Box(LinePoints);
+    const auto Min = GetChunk(Box.Min, InChunkSize);
+    const auto Max = GetChunk(Box.Max, InChunkSize);
+    for (auto Y = Min.Y; Y <= Max.Y; ++Y) {
+        for (auto X = Min.X; X <= Max.X; ++X)
+            OutChunks.Add(FIntPoint(X, Y));
+    }
+}
+
+TArray<FPLATEAURoadMarkingMeshBuilder::FChunkMesh> FPLATEAURoadMarkingMeshBuilder::Build(const TSet<FIntPoint>* TargetChunks) const {
+    // 線ごとに破線へ分割
+    TArray<TArray<FDash>> LineDashes;
+    LineDashes.SetNum(Lines.Num());
+    ParallelFor(Lines.Num(), [&](int32 Index) {
+        const auto& Line = Lines[Index];
+        const auto& Profile = Profiles[Line.Type];
+        LineDashes[Index] = ComputeDashes(Line.Points, Profile.MeshLength, Profile.Gap, Profile.bFillEnd);
+    });
+
+    // 種類とチャンクごとに振り分け(追加順を保つ)
+    using FChunkKey = TTuple<EPLATEAURoadLineType, FIntPoint>;
+    TMap<FChunkKey, TArray<TTuple<int32, int32>>> ChunkDashes;
+    for (auto LineIndex = 0; LineIndex < Lines.Num(); ++LineIndex) {
+        for (auto DashIndex = 0; DashIndex < LineDashes[LineIndex].Num(); ++DashIndex) {
+            const auto& Dash = LineDashes[LineIndex][DashIndex];
+            const auto Chunk = GetChunk((Dash.Start + Dash.End) * 0.5f, ChunkSize);
+            if (TargetChunks != nullptr && !TargetChunks->Contains(Chunk))
+                continue;
+            ChunkDashes.FindOrAdd(FChunkKey(Lines[LineIndex].Type, Chunk)).Add(MakeTuple(LineIndex, DashIndex));
+        }
+    }
+
+    TArray<FChunkMesh> Result;
+    Result.SetNum(ChunkDashes.Num());
+    TArray<const TArray<TTuple<int32, int32>>*> ChunkDashList;
+    auto ChunkIndex = 0;
+    for (const auto& [Key, Dashes] : ChunkDashes) {
+        Result[ChunkIndex].Type = Key.Get<0>();
+        Result[ChunkIndex].Chunk = Key.Get<1>();
+        Result[ChunkIndex].DashNum = Dashes.Num();
+        ChunkDashList.Add(&Dashes);
+        ++ChunkIndex;
+    }
+
+    // チャンクごとにメッシュを作成
+    ParallelFor(Result.Num(), [&](int32 Index) {
+        auto& ChunkMesh = Result[Index];
+        const auto& Profile = Profiles[ChunkMesh.Type];
+        auto& MeshDescription = ChunkMesh.MeshDescription;
+        FStaticMeshAttributes Attributes(MeshDescription);
+        Attributes.Register();
+
+        const auto DashNum = ChunkDashList[Index]->Num();
+        MeshDescription.ReserveNewVertices(DashNum * 4);
+        MeshDescription.ReserveNewVertexInstances(DashNum * 4);
+        MeshDescription.ReserveNewTriangles(DashNum * 2);
+        MeshDescription.ReserveNewPolygons(DashNum * 2);
+
+        const auto PolygonGroupID = MeshDescription.CreatePolygonGroup();
+        Attributes.GetPolygonGroupMaterialSlotNames()[PolygonGroupID] = MaterialSlotName;
+
+        for (const auto& [LineIndex, DashIndex] : *ChunkDashList[Index])
+            AppendDash(MeshDescription, Profile, LineDashes[LineIndex][DashIndex], Lines[LineIndex].Offset);
+    });
+    return Result;
+}
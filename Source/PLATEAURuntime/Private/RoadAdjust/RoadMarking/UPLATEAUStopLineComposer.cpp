@@ -4,43 +4,39 @@
 #include "RoadNetwork/Structure/RnIntersection.h"
 
 
-FPLATEAUMarkedWayList UPLATEAUStopLineComposer::ComposeFrom(const IPLATEAURrTarget* Target)
+void UPLATEAUStopLineComposer::ComposeRoad(URnRoad* Road, FPLATEAUMarkedWayList& OutList) const
 {
+    if (!Road->IsValid())
+    {
+        return;
+    }
+
     auto WayList = FPLATEAUMarkedWayList();
 
-    const auto& Roads = Target->GetRoads();
-    for (const auto& Road : Roads)
+    // 次のノードが交差点の場合、停止線を追加
+    const auto& Next = Road->GetNext();
+    if (Next != nullptr && Next->CastToIntersection() != nullptr)
+    {
+        const auto NextBorder = FPLATEAUMWLine(
+            Road->GetMergedBorderVertices(EPLATEAURnLaneBorderType::Next, EPLATEAURnDir::Left));
+        AddStopLine(WayList, NextBorder);
+    }
+
+    // 前のノードが交差点の場合、停止線を追加
+    const auto& Prev = Road->GetPrev();
+    if (Prev != nullptr && Prev->CastToIntersection() != nullptr)
     {
-        if (!Road->IsValid())
-        {
-            continue;
-        }
-
-        // 次のノードが交差点の場合、停止線を追加
-        const auto& Next = Road->GetNext();
-        if (Next != nullptr && Next->CastToIntersection() != nullptr)
-        {
-            const auto NextBorder = FPLATEAUMWLine(
-                Road->GetMergedBorder(EPLATEAURnLaneBorderType::Next, EPLATEAURnDir::Left));
-            AddStopLine(WayList, NextBorder);
-        }
-
-        // 前のノードが交差点の場合、停止線を追加
-        const auto& Prev = Road->GetPrev();
-        if (Prev != nullptr && Prev->CastToIntersection() != nullptr)
-        {
-            const auto PrevBorder = FPLATEAUMWLine(
-                Road->GetMergedBorder(EPLATEAURnLaneBorderType::Prev, EPLATEAURnDir::Right));
-            AddStopLine(WayList, PrevBorder);
-        }
+        const auto PrevBorder = FPLATEAUMWLine(
+            Road->GetMergedBorderVertices(EPLATEAURnLaneBorderType::Prev, EPLATEAURnDir::Right));
+        AddStopLine(WayList, PrevBorder);
     }
 
     // 道路にめりこまないよう高さをオフセット
     WayList.Translate(FVector(0.0f, 0.0f, CONST_HeightOffset));
-    return WayList;
+    OutList.AddRange(WayList);
 }
 
-void UPLATEAUStopLineComposer::AddStopLine(FPLATEAUMarkedWayList& WayList, const FPLATEAUMWLine& Border)
+void UPLATEAUStopLineComposer::AddStopLine(FPLATEAUMarkedWayList& WayList, const FPLATEAUMWLine& Border) const
 {
     WayList.Add(FPLATEAUMarkedWay(Border, EPLATEAUMarkedWayType::StopLine, false));
 }
@@ -0,0 +1,346 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "RoadAdjust/RoadNetworkToMesh/PLATEAURoadSurfaceMeshBuilder.h"
+#include "Algo/Reverse.h"
+#include "Async/ParallelFor.h"
+#include "StaticMeshAttributes.h"
+#include "RoadNetwork/Structure/RnModel.h"
+#include "RoadNetwork/Structure/RnRoad.h"
+#include "RoadNetwork/Structure/RnIntersection.h"
+#include "RoadNetwork/Structure/RnSideWalk.h"
+#include "RoadNetwork/Structure/RnLane.h"
+#include "RoadNetwork/Structure/RnWay.h"
+
+namespace {
+    // XY平面でのAB×AC. 正のときABCは上から見て時計回り(メッシュの表)
+    double Cross2D(const FVector& A, const FVector& B, const FVector& C) {
+        return (B.X - A.X) * (C.Y - A.Y) - (B.Y - A.Y) * (C.X - A.X);
+    }
+
+    // 上から見て時計回りになるように三角形を追加します. 面積が無い三角形は追加しません
+    void AddTriangle(TArray<int32>& OutIndices, const FVector& PA, const FVector& PB, const FVector& PC, int32 A, int32 B, int32 C) {
+        const auto Cross = Cross2D(PA, PB, PC);
+        if (FMath::IsNearlyZero(Cross))
+            return;
+        OutIndices.Add(A);
+        OutIndices.Add(Cross > 0 ? B : C);
+        OutIndices.Add(Cross > 0 ? C : B);
+    }
+
+    // 時計回りの多角形RemainingのPrev-Cur-Nextが耳(他の頂点を含まない凸の角)かどうか
+    bool IsEar(TConstArrayView<FVector> Outline, const TArray<int32>& Remaining, int32 Prev, int32 Cur, int32 Next) {
+        const auto& A = Outline[Prev];
+        const auto& B = Outline[Cur];
+        const auto& C = Outline[Next];
+        const auto Cross = Cross2D(A, B, C);
+        if (Cross < 0)
+            return false;
+        // 一直線上の点は三角形を作らずに取り除きます
+        if (Cross == 0)
+            return true;
+
+        for (const auto Index : Remaining) {
+            if (Index == Prev || Index == Cur || Index == Next)
+                continue;
+            const auto& P = Outline[Index];
+            if (P.Equals(A) || P.Equals(B) || P.Equals(C))
+                continue;
+            if (Cross2D(A, B, P) >= 0 && Cross2D(B, C, P) >= 0 && Cross2D(C, A, P) >= 0)
+                return false;
+        }
+        return true;
+    }
+
+    TArray<FVector> ToVertices(const URnWay* Way) {
+        return Way ? Way->GetVertices().ToArray() : TArray<FVector>();
+    }
+}
+
+FName FPLATEAURoadSurfaceMeshBuilder::GetMaterialSlotName(EPLATEAURoadSurfaceType Type) {
+    return FName(*(TEXT("RoadSurface_") + StaticEnum<EPLATEAURoadSurfaceType>()->GetNameStringByValue(static_cast<int64>(Type))));
+}
+
+FPLATEAURoadSurfaceMeshBuilder::FPLATEAURoadSurfaceMeshBuilder(float InChunkSize, float InUVScale)
+    : ChunkSize(FMath::Max(InChunkSize, 1.f))
+    , UVScale(FMath::Max(InUVScale, 1.f)) {
+}
+
+void FPLATEAURoadSurfaceMeshBuilder::AddModel(const URnModel* Model) {
+    if (Model == nullptr)
+        return;
+    for (const auto& Road : Model->GetRoads())
+        AddRoad(Road);
+    for (const auto& Intersection : Model->GetIntersections())
+        AddIntersection(Intersection);
+    for (const auto& SideWalk : Model->GetSideWalks())
+        AddSideWalk(SideWalk);
+}
+
+void FPLATEAURoadSurfaceMeshBuilder::AddRoad(const URnRoad* Road) {
+    if (Road == nullptr)
+        return;
+    for (const auto& Lane : Road->GetMainLanes()) {
+        if (Lane && Lane->IsValidWay())
+            AddStrip(EPLATEAURoadSurfaceType::Lane, ToVertices(Lane->GetLeftWay()), ToVertices(Lane->GetRightWay()));
+    }
+    const auto MedianLane = Road->GetMedianLane();
+    if (MedianLane && MedianLane->IsValidWay())
+        AddStrip(EPLATEAURoadSurfaceType::Median, ToVertices(MedianLane->GetLeftWay()), ToVertices(MedianLane->GetRightWay()));
+}
+
+void FPLATEAURoadSurfaceMeshBuilder::AddIntersection(const URnIntersection* Intersection) {
+    if (Intersection == nullptr)
+        return;
+
+    // Edgeは連結するように並んでいるので, 前のEdgeの終点につながる向きで順に連結して輪郭にします
+    TArray<FVector> Outline;
+    auto EdgeNum = 0;
+    for (const auto& Edge : Intersection->GetEdges()) {
+        auto Vertices = ToVertices(Edge ? Edge->GetBorder() : nullptr);
+        if (Vertices.Num() == 0)
+            continue;
+
+        if (EdgeNum == 1) {
+            // 最初のEdgeの向きは2つ目のEdgeとつながる向きに合わせます
+            const auto ToFirst = FMath::Min(FVector::DistSquared(Outline[0], Vertices[0]), FVector::DistSquared(Outline[0], Vertices.Last()));
+            const auto ToLast = FMath::Min(FVector::DistSquared(Outline.Last(), Vertices[0]), FVector::DistSquared(Outline.Last(), Vertices.Last()));
+            if (ToFirst < ToLast)
+                Algo::Reverse(Outline);
+        }
+        if (Outline.Num() > 0 && FVector::DistSquared(Outline.Last(), Vertices.Last()) < FVector::DistSquared(Outline.Last(), Vertices[0]))
+            Algo::Reverse(Vertices);
+
+        for (const auto& Vertex : Vertices) {
+            if (Outline.Num() == 0 || !Outline.Last().Equals(Vertex))
+                Outline.Add(Vertex);
+        }
+        ++EdgeNum;
+    }
+    AddPolygon(EPLATEAURoadSurfaceType::Intersection, Outline);
+}
+
+void FPLATEAURoadSurfaceMeshBuilder::AddSideWalk(const URnSideWalk* SideWalk) {
+    if (SideWalk == nullptr || !SideWalk->IsValid())
+        return;
+    AddStrip(EPLATEAURoadSurfaceType::SideWalk, ToVertices(SideWalk->GetInsideWay()), ToVertices(SideWalk->GetOutsideWay()));
+}
+
+void FPLATEAURoadSurfaceMeshBuilder::AddStrip(EPLATEAURoadSurfaceType Type, const TArray<FVector>& Left, const TArray<FVector>& Right) {
+    if (Left.Num() == 0 || Right.Num() == 0 || Left.Num() + Right.Num() < 3)
+        return;
+
+    FSurface Surface;
+    Surface.Type = Type;
+    Surface.LeftNum = Left.Num();
+    Surface.Vertices.Reserve(Left.Num() + Right.Num());
+    Surface.Vertices.Append(Left);
+    Surface.Vertices.Append(Right);
+
+    // 始点同士/終点同士を結んだ方が近い向きにそろえます
+    const auto Straight = FVector::Dist(Left[0], Right[0]) + FVector::Dist(Left.Last(), Right.Last());
+    const auto Crossed = FVector::Dist(Left[0], Right.Last()) + FVector::Dist(Left.Last(), Right[0]);
+    if (Crossed < Straight) {
+        auto RightVertices = MakeArrayView(Surface.Vertices).RightChop(Left.Num());
+        Algo::Reverse(RightVertices);
+    }
+    Surfaces.Add(MoveTemp(Surface));
+}
+
+void FPLATEAURoadSurfaceMeshBuilder::AddPolygon(EPLATEAURoadSurfaceType Type, const TArray<FVector>& Outline) {
+    if (Outline.Num() < 3)
+        return;
+    Surfaces.Add({ Type, Outline, INDEX_NONE });
+}
+
+FIntPoint FPLATEAURoadSurfaceMeshBuilder::GetChunk(const TArray<FVector>& Vertices, float InChunkSize) {
+    const auto Size = FMath::Max(InChunkSize, 1.f);
+    const auto Center = FBox(Vertices).GetCenter();
+    return FIntPoint(FMath::FloorToInt32(Center.X / Size), FMath::FloorToInt32(Center.Y / Size));
+}
+
+TArray<int32> FPLATEAURoadSurfaceMeshBuilder::TriangulateStrip(TConstArrayView<FVector> Left, TConstArrayView<FVector> Right) {
+    TArray<int32> Result;
+    const auto LeftNum = Left.Num();
+    const auto RightNum = Right.Num();
+    if (LeftNum == 0 || RightNum == 0)
+        return Result;
+
+    // 両側の線を先頭から進み, 対角線が短くなる側を1つずつ進めます
+    Result.Reserve((LeftNum + RightNum - 2) * 3);
+    auto i = 0;
+    auto j = 0;
+    while (i < LeftNum - 1 || j < RightNum - 1) {
+        bool bAdvanceLeft;
+        if (i == LeftNum - 1)
+            bAdvanceLeft = false;
+        else if (j == RightNum - 1)
+            bAdvanceLeft = true;
+        else
+            bAdvanceLeft = FVector::DistSquared(Left[i + 1], Right[j]) <= FVector::DistSquared(Left[i], Right[j + 1]);
+
+        if (bAdvanceLeft) {
+            AddTriangle(Result, Left[i], Left[i + 1], Right[j], i, i + 1, LeftNum + j);
+            ++i;
+        }
+        else {
+            AddTriangle(Result, Left[i], Right[j + 1], Right[j], i, LeftNum + j + 1, LeftNum + j);
+            ++j;
+        }
+    }
+    return Result;
+}
+
+TArray<int32> FPLATEAURoadSurfaceMeshBuilder::TriangulatePolygon(TConstArrayView<FVector> Outline) {
+    TArray<int32> Result;
+    auto Num = Outline.Num();
+    // 閉じた輪郭の終点は始点と同じなので除きます
+    if (Num > 1 && Outline[0].Equals(Outline[Num - 1]))
+        --Num;
+    if (Num < 3)
+        return Result;
+
+    // 上から見て時計回りの順に並べます
+    double Area = 0.0;
+    for (auto i = 0; i < Num; ++i) {
+        const auto& A = Outline[i];
+        const auto& B = Outline[(i + 1) % Num];
+        Area += A.X * B.Y - B.X * A.Y;
+    }
+    TArray<int32> Remaining;
+    Remaining.Reserve(Num);
+    for (auto i = 0; i < Num; ++i)
+        Remaining.Add(Area >= 0.0 ? i : Num - 1 - i);
+
+    Result.Reserve((Num - 2) * 3);
+    auto Cur = 0;
+    auto FailCount = 0;
+    while (Remaining.Num() > 3) {
+        const auto Count = Remaining.Num();
+        // 一周しても耳が見つからない場合(自己交差など)は残りを扇状に分割します
+        if (FailCount >= Count)
+            break;
+
+        const auto Prev = Remaining[(Cur + Count - 1) % Count];
+        const auto Next = Remaining[(Cur + 1) % Count];
+        if (IsEar(Outline, Remaining, Prev, Remaining[Cur], Next)) {
+            AddTriangle(Result, Outline[Prev], Outline[Remaining[Cur]], Outline[Next], Prev, Remaining[Cur], Next);
+            Remaining.RemoveAt(Cur);
+            if (Cur >= Remaining.Num())
+                Cur = 0;
+            FailCount = 0;
+        }
+        else {
+            Cur = (Cur + 1) % Count;
+            ++FailCount;
+        }
+    }
+
+    for (auto i = 1; i + 1 < Remaining.Num(); ++i)
+        AddTriangle(Result, Outline[Remaining[0]], Outline[Remaining[i]], Outline[Remaining[i + 1]], Remaining[0], Remaining[i], Remaining[i + 1]);
+    return Result;
+}
+
+void FPLATEAURoadSurfaceMeshBuilder::AppendSurface(FMeshDescription& MeshDescription, const FSurface& Surface, const TArray<int32>& Indices) const {
+    FStaticMeshAttributes Attributes(MeshDescription);
+    const auto VertexPositions = Attributes.GetVertexPositions();
+    const auto Normals = Attributes.GetVertexInstanceNormals();
+    const auto Tangents = Attributes.GetVertexInstanceTangents();
+    const auto BinormalSigns = Attributes.GetVertexInstanceBinormalSigns();
+    const auto UVs = Attributes.GetVertexInstanceUVs();
+
+    TArray<FVertexID> VertexIDs;
+    VertexIDs.Reserve(Surface.Vertices.Num());
+    for (const auto& Vertex : Surface.Vertices) {
+        const auto VertexID = MeshDescription.CreateVertex();
+        VertexPositions[VertexID] = FVector3f(Vertex);
+        VertexIDs.Add(VertexID);
+    }
+
+    const auto PolygonGroupID = FPolygonGroupID(static_cast<int32>(Surface.Type));
+    for (auto i = 0; i + 2 < Indices.Num(); i += 3) {
+        const auto& A = Surface.Vertices[Indices[i]];
+        const auto& B = Surface.Vertices[Indices[i + 1]];
+        const auto& C = Surface.Vertices[Indices[i + 2]];
+        // 三角形ごとの法線(上向き)とし, 接線はUのX方向に合わせます
+        auto Normal = FVector::CrossProduct(B - A, C - A).GetSafeNormal();
+        if (Normal.IsNearlyZero())
+            Normal = FVector::UpVector;
+        const auto Tangent = (FVector::ForwardVector - Normal * Normal.X).GetSafeNormal();
+
+        FVertexInstanceID Instances[3];
+        for (auto k = 0; k < 3; ++k) {
+            const auto Index = Indices[i + k];
+            const auto& Position = Surface.Vertices[Index];
+            Instances[k] = MeshDescription.CreateVertexInstance(VertexIDs[Index]);
+            Normals[Instances[k]] = FVector3f(Normal);
+            Tangents[Instances[k]] = FVector3f(Tangent);
+            BinormalSigns[Instances[k]] = 1.f;
+            UVs.Set(Instances[k], 0, FVector2f(Position.X / UVScale, Position.Y / UVScale));
+        }
+        MeshDescription.CreateTriangle(PolygonGroupID, { Instances[0], Instances[1], Instances[2] });
+    }
+}
+
+TArray<FPLATEAURoadSurfaceMeshBuilder::FChunkMesh> FPLATEAURoadSurfaceMeshBuilder::Build() const {
+    // 面ごとに三角形分割
+    TArray<TArray<int32>> SurfaceIndices;
+    SurfaceIndices.SetNum(Surfaces.Num());
+    ParallelFor(Surfaces.Num(), [&](int32 Index) {
+        const auto& Surface = Surfaces[Index];
+        const TConstArrayView<FVector> Vertices(Surface.Vertices);
+        if (Surface.LeftNum == INDEX_NONE)
+            SurfaceIndices[Index] = TriangulatePolygon(Vertices);
+        else
+            SurfaceIndices[Index] = TriangulateStrip(Vertices.Left(Surface.LeftNum), Vertices.RightChop(Surface.LeftNum));
+    });
+
+    // チャンクごとに振り分け(追加順を保つ)
+    TMap<FIntPoint, TArray<int32>> ChunkSurfaces;
+    for (auto Index = 0; Index < Surfaces.Num(); ++Index) {
+        if (SurfaceIndices[Index].Num() > 0)
+            ChunkSurfaces.FindOrAdd(GetChunk(Surfaces[Index].Vertices, ChunkSize)).Add(Index);
+    }
+
+    TArray<FChunkMesh> Result;
+    Result.SetNum(ChunkSurfaces.Num());
+    TArray<const TArray<int32>*> ChunkSurfaceList;
+    auto ChunkIndex = 0;
+    for (const auto& [Chunk, SurfaceList] : ChunkSurfaces) {
+        Result[ChunkIndex].Chunk = Chunk;
+        Result[ChunkIndex].SurfaceNum = SurfaceList.Num();
+        ChunkSurfaceList.Add(&SurfaceList);
+        ++ChunkIndex;
+    }
+
+    TArray<FName> SlotNames;
+    for (auto Type = 0; Type < SurfaceTypeNum; ++Type)
+        SlotNames.Add(GetMaterialSlotName(static_cast<EPLATEAURoadSurfaceType>(Type)));
+
+    // チャンクごとにメッシュを作成
+    ParallelFor(Result.Num(), [&](int32 Index) {
+        auto& MeshDescription = Result[Index].MeshDescription;
+        FStaticMeshAttributes Attributes(MeshDescription);
+        Attributes.Register();
+
+        auto VertexNum = 0;
+        auto IndexNum = 0;
+        for (const auto SurfaceIndex : *ChunkSurfaceList[Index]) {
+            VertexNum += Surfaces[SurfaceIndex].Vertices.Num();
+            IndexNum += SurfaceIndices[SurfaceIndex].Num();
+        }
+        MeshDescription.ReserveNewVertices(VertexNum);
+        MeshDescription.ReserveNewVertexInstances(IndexNum);
+        MeshDescription.ReserveNewTriangles(IndexNum / 3);
+        MeshDescription.ReserveNewPolygons(IndexNum / 3);
+
+        // 面の種類ごとのポリゴングループ. IDは面の種類の値と同じになります
+        for (const auto& SlotName : SlotNames) {
+            const auto PolygonGroupID = MeshDescription.CreatePolygonGroup();
+            Attributes.GetPolygonGroupMaterialSlotNames()[PolygonGroupID] = SlotName;
+        }
+
+        for (const auto SurfaceIndex : *ChunkSurfaceList[Index])
+            AppendSurface(MeshDescription, Surfaces[SurfaceIndex], SurfaceIndices[SurfaceIndex]);
+    });
+    return Result;
+}
@@ -2,6 +2,7 @@
 
 #include "RoadNetwork/CityObject/SubDividedCityObject.h"
 #include "Component/PLATEAUCityObjectGroup.h"
+#include "RoadNetwork/GeoGraph/GeoGraph2d.h"
 #include "RoadNetwork/Util/PLATEAURnDebugEx.h"
 
 TArray<FSubDividedCityObjectSubMesh> FSubDividedCityObjectSubMesh::Separate() const{
@@ -10,49 +11,53 @@ TArray<FSubDividedCityObjectSubMesh> FSubDividedCityObjectSubMesh::Separate() co
         return Result;
     }
 
-    TArray<bool> Used;
-    Used.SetNum(Triangles.Num() / 3);
-
-    for (int32 i = 0; i < Used.Num(); ++i) {
-        if (Used[i]) continue;
-
-        FSubDividedCityObjectSubMesh NewMesh;
-        TArray<int32> Stack = { i };
-        while (Stack.Num() > 0) {
-            int32 Current = Stack.Pop();
-            if (Used[Current]) continue;
-
-            Used[Current] = true;
+    // 頂点を共有する三角形同士を同じグループにする(Union-Find)
+    // 根は常にグループ内で最小の三角形インデックスにする
+    const int32 TriangleNum = Triangles.Num() / 3;
+    TArray<int32> Parents;
+    Parents.SetNumUninitialized(TriangleNum);
+    for (int32 i = 0; i < TriangleNum; ++i)
+        Parents[i] = i;
+
+    auto FindRoot = [&Parents](int32 X) {
+        while (Parents[X] != X) {
+            Parents[X] = Parents[Parents[X]];
+            X = Parents[X];
+        }
+        return X;
+    };
 
-            for (int32 j = 0; j < 3; ++j) {
-                NewMesh.Triangles.Add(Triangles[Current * 3 + j]);
+    // Key : 頂点インデックス, Value : その頂点を最初に使った三角形
+    TMap<int32, int32> Vertex2Triangle;
+    Vertex2Triangle.Reserve(Triangles.Num());
+    for (int32 i = 0; i < TriangleNum; ++i) {
+        for (int32 j = 0; j < 3; ++j) {
+            const auto Vertex = Triangles[i * 3 + j];
+            if (const auto Other = Vertex2Triangle.Find(Vertex)) {
+                const auto A = FindRoot(*Other);
+                const auto B = FindRoot(i);
+                if (A != B)
+                    Parents[FMath::Max(A, B)] = FMath::Min(A, B);
             }
-
-            for (int32 j = 0; j < Used.Num(); ++j) {
-                if (Used[j]) continue;
-
-                bool IsConnected = false;
-                for (int32 k = 0; k < 3; ++k) {
-                    int32 CurrentIndex = Triangles[Current * 3 + k];
-                    for (int32 l = 0; l < 3; ++l) {
-                        if (CurrentIndex == Triangles[j * 3 + l]) {
-                            IsConnected = true;
-                            break;
-                        }
-                    }
-                    if (IsConnected) break;
-                }
-
-                if (IsConnected) {
-                    Stack.Add(j);
-                }
+            else {
+                Vertex2Triangle.Add(Vertex, i);
             }
         }
-        Result.Add(NewMesh);
+    }
+
+    // グループは先頭の三角形の順, グループ内の三角形はインデックス順に並べる
+    TArray<int32> Root2Group;
+    Root2Group.Init(INDEX_NONE, TriangleNum);
+    for (int32 i = 0; i < TriangleNum; ++i) {
+        auto& Group = Root2Group[FindRoot(i)];
+        if (Group == INDEX_NONE)
+            Group = Result.AddDefaulted();
+        Result[Group].Triangles.Append(Triangles.GetData() + i * 3, 3);
     }
 
     return Result;
 }
+
 TArray<TArray<int32>> FSubDividedCityObjectSubMesh::CreateOutlineIndices() const
 {
     TArray<TArray<int32>> Result;
@@ -100,23 +105,28 @@ TArray<TArray<int32>> FSubDividedCityObjectSubMesh::CreateOutlineIndices() const
         }
     }
 
+    // 頂点ごとの外周辺リスト(OutlineEdgesの順)
+    int32 VertexNum = 0;
+    for (const auto& E : OutlineEdges)
+        VertexNum = FMath::Max(VertexNum, E.Key + 1);
+    FGeoGraph2D::FOutlineEdgeAdjacency Adjacency(OutlineEdges, VertexNum);
+
     // Convert to continuous outlines
-    while (OutlineEdges.Num() > 0) 
+    for (int32 StartEdge = 0; StartEdge < OutlineEdges.Num(); ++StartEdge) 
     {
-        TArray<int32> Outline;
-        auto Edge = OutlineEdges[0];
-        OutlineEdges.RemoveAt(0);
+        if (!Adjacency.MarkUsed(StartEdge))
+            continue;
+        const auto& Edge = OutlineEdges[StartEdge];
 
         auto Indices = TArray<int32>{ Edge.Key, Edge.Value };
-        while(OutlineEdges.Num() > 0)
+        while(true)
         {
             auto V0 = Indices[0];
             auto LastV = Indices[Indices.Num() - 1];
-            auto Index = OutlineEdges.IndexOfByPredicate([LastV](const TTuple<int32, int32>& E) { return E.Key == LastV || E.Value == LastV; });
+            auto Index = Adjacency.PopFirstEdge(LastV);
             if (Index < 0)
                 break;
-            auto E = OutlineEdges[Index];
-            OutlineEdges.RemoveAt(Index);
+            const auto& E = OutlineEdges[Index];
             // 1周した
             if (E.Key == V0 || E.Value == V0)
                 break;
@@ -290,6 +300,13 @@ void FSubDividedCityObject::SetCityObjectGroup(UPLATEAUCityObjectGroup* Group) {
     }
 }
 
+void FSubDividedCityObject::SetCityObjectGroup(const TWeakObjectPtr<UPLATEAUCityObjectGroup>& Group) {
+    CityObjectGroup = Group;
+    for (auto& Child : Children) {
+        Child.SetCityObjectGroup(Group);
+    }
+}
+
 TSharedPtr<FSubDividedCityObject> FSubDividedCityObject::DeepCopy()
 {
     auto Result = MakeShared<FSubDividedCityObject>();
@@ -4,9 +4,12 @@
 #include "PLATEAUExportSettings.h"
 #include "PLATEAUMeshExporter.h"
 #include "CityGML/PLATEAUCityObject.h"
+#include "Component/PLATEAUCityObjectGroup.h"
 #include "Reconstruct/PLATEAUModelReconstruct.h"
 #include "RoadNetwork/Factory/RoadNetworkFactory.h"
 #include "Util/PLATEAUReconstructUtil.h"
+#include "Async/ParallelFor.h"
+#include <atomic>
 
 namespace
 {
@@ -25,35 +28,96 @@ namespace
         }
     };
 }
-TSharedPtr<FSubDividedCityObjectFactory::FConvertCityObjectResult>
-FSubDividedCityObjectFactory::ConvertCityObjectsAsync(
+TArray<FSubDividedCityObjectFactory::FConvertInput>
+FSubDividedCityObjectFactory::GatherConvertInputs(
     APLATEAUInstancedCityModel* Actor,
-    const TArray<UPLATEAUCityObjectGroup*>& CityObjectGroups,
-    float Epsilon,
-    bool UseContourMesh)
+    const TArray<UPLATEAUCityObjectGroup*>& CityObjectGroups)
 {
-    auto Result = MakeShared<FConvertCityObjectResult>();
+    check(IsInGameThread());
     auto Granularity = FPLATEAUReconstructUtil::GetConvertGranularityFromReconstructType(EPLATEAUMeshGranularity::PerAtomicFeatureObject);
-    ::TmpLoader Loader(Actor, Granularity);
 
-    for (auto CityObjectGroup : CityObjectGroups) 
-    {
-        // 生成対象チェック
+    // メッシュと属性情報(親の分も含む)はここで読み出しておき, 変換ではUObjectに触らない
+    TArray<FConvertInput> Inputs;
+    for (auto CityObjectGroup : CityObjectGroups) {
         if (FRoadNetworkFactoryEx::IsConvertTarget(CityObjectGroup) == false)
             continue;
 
+        ::TmpLoader Loader(Actor, Granularity);
         TArray<UPLATEAUCityObjectGroup*> Tmp;
         Tmp.Add(CityObjectGroup);
-        auto model = Loader.ConvertModelForReconstruct(Tmp);
+        auto& Input = Inputs.AddDefaulted_GetRef();
+        Input.CityObjectGroup = CityObjectGroup;
+        Input.BaseModel = Loader.CreateBaseModel(Tmp);
+        Input.CityObjMap = MoveTemp(Loader.GetCityObjMap());
+    }
+    return Inputs;
+}
+
+TSharedPtr<FSubDividedCityObjectFactory::FConvertCityObjectResult>
+FSubDividedCityObjectFactory::ConvertCityObjects(
+    TArray<FConvertInput>& Inputs,
+    TAtomic<bool>* bCanceled,
+    TFunction<void(int32, int32)> OnProgress)
+{
+    auto Result = MakeShared<FConvertCityObjectResult>();
+    auto Granularity = FPLATEAUReconstructUtil::GetConvertGranularityFromReconstructType(EPLATEAUMeshGranularity::PerAtomicFeatureObject);
+
+    // CityObjectGroupごとに独立しているので並列に変換する
+    TArray<TArray<TSharedPtr<FSubDividedCityObject>>> ConvertedPerGroup;
+    ConvertedPerGroup.SetNum(Inputs.Num());
+    std::atomic<int32> ConvertedCount = 0;
+    ParallelFor(Inputs.Num(), [&](int32 Index)
+    {
+        if (bCanceled && bCanceled->Load(EMemoryOrder::Relaxed))
+            return;
+
+        auto& Input = Inputs[Index];
+        auto model = FPLATEAUModelReconstruct().ConvertBaseModel(*Input.BaseModel, Granularity);
 
         for (auto i = 0; i < model->getRootNodeCount(); ++i) {
             auto& Node = model->getRootNodeAt(i);
-            auto SO = MakeShared<FSubDividedCityObject>(CityObjectGroup, Node, Loader.GetCityObjMap(), ERRoadTypeMask::Empty);
-            Result->ConvertedCityObjects.Add(SO);
+            // CityObjectGroupは参照を持たせるだけなので弱参照をそのままコピーする
+            auto SO = MakeShared<FSubDividedCityObject>(nullptr, Node, Input.CityObjMap, ERRoadTypeMask::Empty);
+            SO->SetCityObjectGroup(Input.CityObjectGroup);
+            ConvertedPerGroup[Index].Add(SO);
         }
-    }
 
-   
+        const auto Count = ++ConvertedCount;
+        if (OnProgress)
+            OnProgress(Count, Inputs.Num());
+    });
+
+    // 結果は入力の順に並べる
+    for (auto& Converted : ConvertedPerGroup)
+        Result->ConvertedCityObjects.Append(MoveTemp(Converted));
 
     return Result;
 }
+
+TSharedPtr<FSubDividedCityObjectFactory::FConvertCityObjectResult>
+FSubDividedCityObjectFactory::ConvertCityObjects(
+    APLATEAUInstancedCityModel* Actor,
+    const TArray<UPLATEAUCityObjectGroup*>& CityObjectGroups,
+    float Epsilon,
+    bool UseContourMesh,
+    TAtomic<bool>* bCanceled,
+    TFunction<void(int32, int32)> OnProgress)
+{
+    auto Inputs = GatherConvertInputs(Actor, CityObjectGroups);
+    return ConvertCityObjects(Inputs, bCanceled, OnProgress);
+}
+
+UE::Tasks::TTask<TSharedPtr<FSubDividedCityObjectFactory::FConvertCityObjectResult>>
+FSubDividedCityObjectFactory::ConvertCityObjectsAsync(
+    APLATEAUInstancedCityModel* Actor,
+    const TArray<UPLATEAUCityObjectGroup*>& CityObjectGroups,
+    float Epsilon,
+    bool UseContourMesh,
+    TAtomic<bool>* bCanceled)
+{
+    // 入力の収集はゲームスレッドで行い, 変換だけをワーカースレッドで行う
+    auto Inputs = GatherConvertInputs(Actor, CityObjectGroups);
+    return UE::Tasks::Launch(TEXT("ConvertCityObjectsTask"), [Inputs = MoveTemp(Inputs), bCanceled]() mutable {
+        return FSubDividedCityObjectFactory().ConvertCityObjects(Inputs, bCanceled);
+    });
+}
@@ -0,0 +1,197 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#include "RoadNetwork/CityObject/SubDividedCityObjectFixture.h"
+#include "Component/PLATEAUCityObjectGroup.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+    // ファイル先頭の識別子 "RNFX"
+    constexpr uint32 Magic = 0x58464E52;
+
+    // 子の入れ子の上限. 壊れたデータで再帰が深くなりすぎないようにします
+    constexpr int32 MaxDepth = 64;
+
+    // 配列の要素数を読み込みます. 残りのバイト数より多い場合は壊れているとみなします
+    int32 ReadNum(FArchive& Ar) {
+        int32 Num = 0;
+        Ar << Num;
+        if (Num < 0 || Num > Ar.TotalSize() - Ar.Tell()) {
+            Ar.SetError();
+            return 0;
+        }
+        return Num;
+    }
+
+    template<class T>
+    void ReadArray(FArchive& Ar, TArray<T>& OutArray) {
+        const auto Num = ReadNum(Ar);
+        OutArray.SetNum(Num);
+        for (auto i = 0; i < Num && !Ar.IsError(); ++i)
+            Ar << OutArray[i];
+    }
+
+    class FWriter {
+    public:
+        explicit FWriter(FArchive& InAr)
+            : Ar(InAr) {
+        }
+
+        void Write(const TArray<FSubDividedCityObject>& CityObjects) {
+            // 先に参照しているCityObjectGroupを集めて一覧として書く
+            for (const auto& CityObject : CityObjects)
+                CollectGroups(CityObject);
+            auto GroupNum = Groups.Num();
+            Ar << GroupNum;
+            for (const auto* Group : Groups) {
+                auto Name = Group->GetName();
+                int32 MinLOD = Group->MinLOD;
+                auto Transform = Group->GetComponentTransform();
+                Ar << Name << MinLOD << Transform;
+            }
+
+            WriteObjects(CityObjects);
+        }
+
+    private:
+        void CollectGroups(const FSubDividedCityObject& CityObject) {
+            if (const auto* Group = CityObject.CityObjectGroup.Get()) {
+                if (!GroupIndices.Contains(Group))
+                    GroupIndices.Add(Group, Groups.Add(Group));
+            }
+            for (const auto& Child : CityObject.Children)
+                CollectGroups(Child);
+        }
+
+        void WriteObjects(const TArray<FSubDividedCityObject>& CityObjects) {
+            auto Num = CityObjects.Num();
+            Ar << Num;
+            for (const auto& CityObject : CityObjects) {
+                auto Name = CityObject.Name;
+                const auto* Group = CityObject.CityObjectGroup.Get();
+                int32 GroupIndex = Group ? GroupIndices[Group] : INDEX_NONE;
+                auto SelfRoadType = static_cast<uint8>(CityObject.SelfRoadType);
+                auto ParentRoadType = static_cast<uint8>(CityObject.ParentRoadType);
+                Ar << Name << GroupIndex << SelfRoadType << ParentRoadType;
+
+                auto MeshNum = CityObject.Meshes.Num();
+                Ar << MeshNum;
+                for (const auto& Mesh : CityObject.Meshes) {
+                    auto Vertices = Mesh.Vertices;
+                    Ar << Vertices;
+                    auto SubMeshNum = Mesh.SubMeshes.Num();
+                    Ar << SubMeshNum;
+                    for (const auto& SubMesh : Mesh.SubMeshes) {
+                        auto Triangles = SubMesh.Triangles;
+                        Ar << Triangles;
+                    }
+                }
+                WriteObjects(CityObject.Children);
+            }
+        }
+
+        FArchive& Ar;
+        TArray<const UPLATEAUCityObjectGroup*> Groups;
+        TMap<const UPLATEAUCityObjectGroup*, int32> GroupIndices;
+    };
+
+    bool ReadObjects(FArchive& Ar, const TArray<UPLATEAUCityObjectGroup*>& Groups, TArray<FSubDividedCityObject>& OutCityObjects, int32 Depth) {
+        if (Depth > MaxDepth)
+            return false;
+        const auto Num = ReadNum(Ar);
+        OutCityObjects.SetNum(Num);
+        for (auto& CityObject : OutCityObjects) {
+            int32 GroupIndex = INDEX_NONE;
+            uint8 SelfRoadType = 0;
+            uint8 ParentRoadType = 0;
+            Ar << CityObject.Name << GroupIndex << SelfRoadType << ParentRoadType;
+            if (Ar.IsError() || (GroupIndex != INDEX_NONE && !Groups.IsValidIndex(GroupIndex)))
+                return false;
+            CityObject.CityObjectGroup = GroupIndex == INDEX_NONE ? nullptr : Groups[GroupIndex];
+            CityObject.SelfRoadType = static_cast<ERRoadTypeMask>(SelfRoadType);
+            CityObject.ParentRoadType = static_cast<ERRoadTypeMask>(ParentRoadType);
+
+            CityObject.Meshes.SetNum(ReadNum(Ar));
+            for (auto& Mesh : CityObject.Meshes) {
+                ReadArray(Ar, Mesh.Vertices);
+                Mesh.SubMeshes.SetNum(ReadNum(Ar));
+                for (auto& SubMesh : Mesh.SubMeshes) {
+                    ReadArray(Ar, SubMesh.Triangles);
+                    // 範囲外の頂点を参照している場合は壊れているとみなす
+                    for (const auto Index : SubMesh.Triangles) {
+                        if (!Mesh.Vertices.IsValidIndex(Index))
+                            return false;
+                    }
+                }
+                if (Ar.IsError())
+                    return false;
+            }
+
+            if (!ReadObjects(Ar, Groups, CityObject.Children, Depth + 1))
+                return false;
+        }
+        return !Ar.IsError();
+    }
+}
+
+void FSubDividedCityObjectFixture::Write(const TArray<FSubDividedCityObject>& CityObjects, TArray<uint8>& OutData) {
+    OutData.Reset();
+    FMemoryWriter Ar(OutData);
+    uint32 HeaderMagic = Magic;
+    uint32 HeaderVersion = Version;
+    Ar << HeaderMagic << HeaderVersion;
+    FWriter(Ar).Write(CityObjects);
+}
+
+bool FSubDividedCityObjectFixture::Read(TConstArrayView<uint8> Data, UObject* Outer, TArray<FSubDividedCityObject>& OutCityObjects) {
+    OutCityObjects.Reset();
+    FMemoryReaderView Ar(Data);
+    uint32 HeaderMagic = 0;
+    uint32 HeaderVersion = 0;
+    Ar << HeaderMagic << HeaderVersion;
+    if (Ar.IsError() || HeaderMagic != Magic || HeaderVersion != Version) {
+        UE_LOG(LogTemp, Warning, TEXT("FSubDividedCityObjectFixture::Read : invalid header (version %u)"), HeaderVersion);
+        return false;
+    }
+
+    // CityObjectGroupを作り直す. RGraphの作成ではMinLODとTransformしか使わない
+    TArray<UPLATEAUCityObjectGroup*> Groups;
+    const auto GroupNum = ReadNum(Ar);
+    for (auto i = 0; i < GroupNum && !Ar.IsError(); ++i) {
+        FString Name;
+        int32 MinLOD = 0;
+        FTransform Transform;
+        Ar << Name << MinLOD << Transform;
+        if (Ar.IsError())
+            break;
+        auto* Group = NewObject<UPLATEAUCityObjectGroup>(Outer, MakeUniqueObjectName(Outer, UPLATEAUCityObjectGroup::StaticClass(), FName(*Name)));
+        Group->MinLOD = MinLOD;
+        Group->SetWorldTransform(Transform);
+        Group->UpdateComponentToWorld();
+        Groups.Add(Group);
+    }
+
+    if (Ar.IsError() || !ReadObjects(Ar, Groups, OutCityObjects, 0) || !Ar.AtEnd()) {
+        UE_LOG(LogTemp, Warning, TEXT("FSubDividedCityObjectFixture::Read : broken data"));
+        OutCityObjects.Reset();
+        return false;
+    }
+    return true;
+}
+
+bool FSubDividedCityObjectFixture::SaveToFile(const TArray<FSubDividedCityObject>& CityObjects, const FString& Path) {
+    TArray<uint8> Data;
+    Write(CityObjects, Data);
+    return FFileHelper::SaveArrayToFile(Data, *Path);
+}
+
+bool FSubDividedCityObjectFixture::LoadFromFile(const FString& Path, UObject* Outer, TArray<FSubDividedCityObject>& OutCityObjects) {
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *Path)) {
+        UE_LOG(LogTemp, Warning, TEXT("FSubDividedCityObjectFixture::LoadFromFile : failed to load %s"), *Path);
+        return false;
+    }
+    return Read(Data, Outer, OutCityObjects);
+}
@@ -5,8 +5,14 @@
 #include <plateau/dataset/i_dataset_accessor.h>
 
 #include "Algo/Count.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+#include "UObject/GarbageCollection.h"
+#include "UObject/UObjectArray.h"
 #include "RoadNetwork/CityObject/PLATEAUSubDividedCityObjectGroup.h"
 #include "RoadNetwork/CityObject/SubDividedCityObjectFactory.h"
+#include "RoadNetwork/CityObject/SubDividedCityObjectFixture.h"
 #include "RoadNetwork/GeoGraph/GeoGraph2d.h"
 #include "RoadNetwork/RGraph/PLATEAURGraph.h"
 #include "RoadNetwork/RGraph/RGraph.h"
@@ -20,7 +26,9 @@
 #include "RoadNetwork/Structure/RnLineString.h"
 #include "RoadNetwork/Structure/RnRoadGroup.h"
 #include "RoadNetwork/Structure/RnWay.h"
+#include "RoadNetwork/Structure/RnTrackBuilder.h"
 #include "RoadNetwork/Util/PLATEAURnLinq.h"
+#include "RoadNetwork/Util/PLATEAURnStageProfiler.h"
 
 
 const FString FRoadNetworkFactory::FactoryVersion = TEXT("1.0.0");
@@ -834,14 +842,34 @@ TRnRef_T<URnModel> FRoadNetworkFactoryEx::CreateRnModel(
     const FRoadNetworkFactory& Self
     , RGraphRef_t<URGraph> Graph
     , URnModel* Model
+    , TAtomic<bool>* bCanceled
+    , FPLATEAURnStageProfiler* Profiler
 )
 {
     if (!Model)
         return Model;
     Model->Init();
+    if (Profiler) {
+        Profiler->SetCounter([Model](TArray<TPair<FString, int64>>& Counts) {
+            Counts.Emplace(TEXT("Roads"), Model->GetRoads().Num());
+            Counts.Emplace(TEXT("Intersections"), Model->GetIntersections().Num());
+            Counts.Emplace(TEXT("SideWalks"), Model->GetSideWalks().Num());
+        });
+    }
+    ON_SCOPE_EXIT{
+        if (Profiler)
+            Profiler->SetCounter(nullptr);
+    };
+
+    // 中断された場合は途中までの状態で返す(呼び出し側で破棄する)
+    auto IsCanceled = [bCanceled] {
+        return bCanceled && bCanceled->Load(EMemoryOrder::Relaxed);
+    };
     try {
         // 道路/中央分離帯は一つのfaceGroupとしてまとめる
         auto mask = ~(::RoadPackTypes);
+        TOptional<FPLATEAURnStageProfiler::FScope> Stage;
+        Stage.Emplace(Profiler, TEXT("GroupFaces"));
         auto&& faceGroups = FRGraphEx::GroupBy(Graph, [mask](const RGraphRef_t<URFace>& F0, const RGraphRef_t<URFace>& F1) {
             auto&& M0 = F0->GetRoadTypes() & mask;
             auto&& M1 = F1->GetRoadTypes() & mask;
@@ -854,7 +882,8 @@ TRnRef_T<URnModel> FRoadNetworkFactoryEx::CreateRnModel(
         work.TerminateAllowEdgeAngle = Self.TerminateAllowEdgeAngle;
         work.TerminateSkipAngleDeg = Self.TerminateSkipAngle;
     
-        
+        Stage.Reset();
+        Stage.Emplace(Profiler, TEXT("BuildRoads"));
         for(auto&& faceGroup : faceGroups) {
             auto&& roadType = faceGroup->GetRoadTypes();
 
@@ -885,8 +914,13 @@ TRnRef_T<URnModel> FRoadNetworkFactoryEx::CreateRnModel(
             tran->BuildConnection();
         }
 
+        Stage.Reset();
+        if (IsCanceled())
+            return Model;
+
         if (Self.bAddSideWalk) 
         {
+            FPLATEAURnStageProfiler::FScope SideWalkStage(Profiler, TEXT("SideWalks"));
             // 歩道を作成する
             auto&& sideWalks = work.CreateSideWalk(Self.Lod1SideWalkThresholdRoadWidth, Self.Lod1SideWalkSize);
             for (auto&& sideWalk : sideWalks)
@@ -964,13 +998,19 @@ TRnRef_T<URnModel> FRoadNetworkFactoryEx::CreateRnModel(
         }
 
         // 道路で境界線が直接つながっているような場合に微小な線を追加する
-        if (Self.bSeparateContinuousBorder)
+        if (Self.bSeparateContinuousBorder) {
+            FPLATEAURnStageProfiler::FScope SeparateStage(Profiler, TEXT("SeparateContinuousBorder"));
             Model->SeparateContinuousBorder();
+        }
+
+        if (IsCanceled())
+            return Model;
 
         // 中央分離帯の幅で道路を分割する
 
         TSet<URnRoad*> IsLaneSplitRoads;
         {
+            FPLATEAURnStageProfiler::FScope LaneCountStage(Profiler, TEXT("SetLaneCount"));
             TSet<URnRoad*> Visited;
             for(auto&& Item : work.TranMap) 
             {
@@ -1025,17 +1065,23 @@ TRnRef_T<URnModel> FRoadNetworkFactoryEx::CreateRnModel(
 
         // 連続した道路を一つにまとめる
         if (Self.bMergeRoadGroup) {
+            FPLATEAURnStageProfiler::FScope MergeStage(Profiler, TEXT("MergeRoadGroup"));
             Model->MergeRoadGroup();
         }
 
 
+        if (IsCanceled())
+            return Model;
+
         // 交差点との境界線が垂直になるようにする
         if (Self.bCalibrateIntersection) {
+            FPLATEAURnStageProfiler::FScope CalibrateStage(Profiler, TEXT("CalibrateIntersectionBorder"));
             Model->CalibrateIntersectionBorderForAllRoad(Self.CalibrateIntersectionOption);
         }
 
         // 道路を分割する
         if (Self.bSplitLane) {
+            FPLATEAURnStageProfiler::FScope SplitStage(Profiler, TEXT("SplitLane"));
             TArray<FString> FailedRoads;
             Model->SplitLaneByWidth(Self.RoadSize, false, FailedRoads, [&](URnRoadGroup* Rg)
             {
@@ -1046,12 +1092,18 @@ TRnRef_T<URnModel> FRoadNetworkFactoryEx::CreateRnModel(
             });
         }
 
+        if (IsCanceled())
+            return Model;
+
         if(Self.bBuildTracks)
         {
-            for (auto Inter : Model->GetIntersections())
-                Inter->BuildTracks();
+            // 経路の計算は交差点ごとに並列で行う
+            FPLATEAURnStageProfiler::FScope TrackStage(Profiler, TEXT("BuildTracks"));
+            FRnTracksBuilder TracksBuilder;
+            TracksBuilder.BuildTracks(Model->GetIntersections(), FBuildTrackOption::Default());
         }
 
+        FPLATEAURnStageProfiler::FScope CheckStage(Profiler, TEXT("Check"));
         Model->Check();
     }
     catch(std::exception e)
@@ -1063,6 +1115,21 @@ TRnRef_T<URnModel> FRoadNetworkFactoryEx::CreateRnModel(
     return Model;
 }
 
+TRnRef_T<URnModel> FRoadNetworkFactoryEx::CreateRnModelFromSubDividedCityObjects(
+    const FRoadNetworkFactory& Self
+    , const TArray<FSubDividedCityObject>& SubDividedCityObjects
+    , URnModel* OutModel
+    , FPLATEAURnStageProfiler* Profiler)
+{
+    RGraphRef_t<URGraph> Graph = nullptr;
+    {
+        FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("CreateGraph"));
+        Graph = FRGraphFactoryEx::CreateGraph(Self.GraphFactory, SubDividedCityObjects, Profiler);
+    }
+    FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("CreateRnModel"));
+    return CreateRnModel(Self, Graph, OutModel, nullptr, Profiler);
+}
+
 void FRoadNetworkFactoryEx::CreateSubDividedCityObjects(
     const FRoadNetworkFactory& Self
     , APLATEAUInstancedCityModel* Actor
@@ -1071,9 +1138,18 @@ void FRoadNetworkFactoryEx::CreateSubDividedCityObjects(
     , TArray<UPLATEAUCityObjectGroup*>& CityObjectGroups
     , TArray<FSubDividedCityObject>& OutSubDividedCityObjects)
 {
-    // 一番子のオブジェクトだけが必要なのでそれを抽出する
+    auto Inputs = FSubDividedCityObjectFactory::GatherConvertInputs(Actor, CityObjectGroups);
+    ConvertSubDividedCityObjects(Inputs, OutSubDividedCityObjects);
+    SaveSubDividedCityObjects(Self, Actor, DestActor, Root, OutSubDividedCityObjects);
+}
 
-    TArray<FSubDividedCityObject> Result;
+void FRoadNetworkFactoryEx::ConvertSubDividedCityObjects(
+    TArray<FSubDividedCityObjectFactory::FConvertInput>& Inputs
+    , TArray<FSubDividedCityObject>& OutSubDividedCityObjects
+    , TAtomic<bool>* bCanceled
+    , TFunction<void(int32, int32)> OnProgress)
+{
+    // 一番子のオブジェクトだけが必要なのでそれを抽出する
     struct FSubDividedObjectVisitor {
         static void Visit(FSubDividedCityObject& So, TArray<FSubDividedCityObject>& Result) {
             if (So.Children.Num() == 0) {
@@ -1090,12 +1166,26 @@ void FRoadNetworkFactoryEx::CreateSubDividedCityObjects(
     };
    
     FSubDividedCityObjectFactory Factory;
-    auto SubDividedObjectResult = Factory.ConvertCityObjectsAsync(Actor, CityObjectGroups, true);
+    auto SubDividedObjectResult = Factory.ConvertCityObjects(Inputs, bCanceled, OnProgress);
     for (auto C : SubDividedObjectResult->ConvertedCityObjects) {
         FSubDividedObjectVisitor::Visit(*C, OutSubDividedCityObjects);
     }
+}
 
+void FRoadNetworkFactoryEx::SaveSubDividedCityObjects(
+    const FRoadNetworkFactory& Self
+    , APLATEAUInstancedCityModel* Actor
+    , AActor* DestActor
+    , USceneComponent* Root
+    , const TArray<FSubDividedCityObject>& SubDividedCityObjects)
+{
     const auto SubDividedObjectName = TEXT("SubDivided");
+
+    if (Self.bSaveBenchmarkFixture) {
+        const auto Path = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("PLATEAU"), TEXT("RoadNetwork"), Actor->GetName() + TEXT(".rnfixture"));
+        if (FSubDividedCityObjectFixture::SaveToFile(SubDividedCityObjects, Path))
+            UE_LOG(LogTemp, Log, TEXT("Saved road network benchmark fixture : %s"), *Path);
+    }
     
     if(Self.bSaveTmpData)
     {
@@ -1108,7 +1198,7 @@ void FRoadNetworkFactoryEx::CreateSubDividedCityObjects(
             DestActor->RemoveInstanceComponent(C);
         }
 
-        for (auto& So : OutSubDividedCityObjects) 
+        for (auto& So : SubDividedCityObjects) 
         {
             auto UniqueName = MakeUniqueObjectName(Actor, UPLATEAUSubDividedCityObject::StaticClass(), FName(So.Name));
             auto NewCityObject = NewObject<UPLATEAUSubDividedCityObject>(DestActor, UniqueName);
@@ -1130,7 +1220,11 @@ void FRoadNetworkFactoryEx::CreateRGraph(const FRoadNetworkFactory& Self, APLATE
     RGraphRef_t<URGraph>& OutGraph)
 {
     OutGraph = FRGraphFactoryEx::CreateGraph(Self.GraphFactory, SubDividedCityObjects);
+    SaveRGraph(Self, DestActor, Root, OutGraph);
+}
 
+void FRoadNetworkFactoryEx::SaveRGraph(const FRoadNetworkFactory& Self, AActor* DestActor, USceneComponent* Root, RGraphRef_t<URGraph> Graph)
+{
     const auto RGraphName = TEXT("RGaph");
     if(Self.bSaveTmpData)
     {
@@ -1139,7 +1233,7 @@ void FRoadNetworkFactoryEx::CreateRGraph(const FRoadNetworkFactory& Self, APLATE
             RGraphObject = NewObject<UPLATEAURGraph>(DestActor, RGraphName);
             FPLATEAURnEx::AddChildInstanceComponent(DestActor, Root, RGraphObject);
         }
-        RGraphObject->RGraph = OutGraph;
+        RGraphObject->RGraph = Graph;
     }
     else
     {
@@ -1150,6 +1244,10 @@ void FRoadNetworkFactoryEx::CreateRGraph(const FRoadNetworkFactory& Self, APLATE
 }
 
 bool FPLATEAULineStringFactoryWork::IsEqual(const TArray<URnPoint*>& A, const TArray<URnPoint*>& B, bool& bIsReversed) {
+    return IsEqual(TArrayView<URnPoint* const>(A), TArrayView<URnPoint* const>(B), bIsReversed);
+}
+
+bool FPLATEAULineStringFactoryWork::IsEqual(TArrayView<URnPoint* const> A, TArrayView<URnPoint* const> B, bool& bIsReversed) {
     bIsReversed = false;
     if (A.Num() != B.Num()) {
         return false;
@@ -1175,6 +1273,26 @@ bool FPLATEAULineStringFactoryWork::IsEqual(const TArray<URnPoint*>& A, const TA
     return true;
 }
 
+uint32 FPLATEAULineStringFactoryWork::GetDirectionNormalizedHash(TArrayView<URnPoint* const> Points) {
+    const auto Num = Points.Num();
+
+    // 先頭/末尾から見て最初に異なる要素で向きを決める(回文の場合はどちらでも同じ)
+    bool bReverse = false;
+    for (auto i = 0; i < Num / 2; ++i) {
+        const auto* Front = Points[i];
+        const auto* Back = Points[Num - 1 - i];
+        if (Front != Back) {
+            bReverse = Back < Front;
+            break;
+        }
+    }
+
+    uint32 Hash = GetTypeHash(Num);
+    for (auto i = 0; i < Num; ++i)
+        Hash = HashCombineFast(Hash, GetTypeHash(Points[bReverse ? Num - 1 - i : i]));
+    return Hash;
+}
+
 URnLineString* FPLATEAULineStringFactoryWork::CreateLineString(const TArray<URnPoint*>& Points, bool& bIsCached,
     bool& bIsReversed, bool bUseCache, TFunction<URnLineString* (const TArray<URnPoint*>&)> CreateLineStringFunc) {
     bIsCached = false;
@@ -1198,38 +1316,30 @@ URnLineString* FPLATEAULineStringFactoryWork::CreateLineString(const TArray<URnP
         return LS;
     }
 
-    // 各URnPointの ポインタ を XOR してキーを算出
-    uint64 Key = 0;
-    for (URnPoint* Point : Points) {
-        Key ^= (uint64_t)Point;
-    }
+    // 向きを揃えたpoint列のハッシュをキーにする(逆順のpoint列も同じキーになる)
+    const auto Key = GetDirectionNormalizedHash(Points);
 
     // キャッシュから該当するエントリを検索
-    TArray<FPointCache>* FoundArray = RnPointList2LineStringMap.Find(Key);
-    if (FoundArray) {
-        for (FPointCache& Entry : *FoundArray) {
-            bool bLocalIsReversed = false;
-            if (IsEqual(Entry.Points, Points, bLocalIsReversed)) {
-                bIsCached = true;
-                bIsReversed = bLocalIsReversed;
-                return Entry.LineString;
-            }
+    for (auto It = PointCacheIndices.CreateConstKeyIterator(Key); It; ++It) {
+        const auto& Entry = PointCaches[It.Value()];
+        bool bLocalIsReversed = false;
+        const TArrayView<URnPoint* const> EntryPoints(CachedPoints.GetData() + Entry.PointOffset, Entry.PointNum);
+        if (IsEqual(EntryPoints, Points, bLocalIsReversed)) {
+            bIsCached = true;
+            bIsReversed = bLocalIsReversed;
+            return Entry.LineString;
         }
     }
-    else {
-        // キーが未登録の場合、新たに配列を作成
-        TArray<FPointCache> NewArray;
-        RnPointList2LineStringMap.Add(Key, NewArray);
-        FoundArray = RnPointList2LineStringMap.Find(Key);
-    }
 
     // キャッシュに存在しなかったので新規に生成
     bIsReversed = false;
     URnLineString* NewLineString = CreateLineStringFunc(Points);
     FPointCache NewCacheEntry;
-    NewCacheEntry.Points = Points; // 必要に応じてディープコピーに変更してください
+    NewCacheEntry.PointOffset = CachedPoints.Num();
+    NewCacheEntry.PointNum = Points.Num();
     NewCacheEntry.LineString = NewLineString;
-    FoundArray->Add(NewCacheEntry);
+    CachedPoints.Append(Points);
+    PointCacheIndices.Add(Key, PointCaches.Add(NewCacheEntry));
     return NewLineString;
 }
 
@@ -1254,3 +1364,240 @@ void FRoadNetworkFactoryEx::CreateRnModel(const FRoadNetworkFactory& Self, APLAT
     Actor->GetComponents(CityObjectGroups);
     auto res = CreateRoadNetwork(Self, Actor, DestActor, CityObjectGroups);
 }
+
+#define LOCTEXT_NAMESPACE "RoadNetworkFactory"
+
+namespace {
+    /**
+     * @brief 生成タスクのワーカースレッドで作られた道路構造のUObjectを記録します.
+     *        ゲームスレッド以外で作られたUObjectにはEInternalObjectFlags::Asyncが付き, GCの対象外になります.
+     *        そのため生成途中のRGraph/RnModelは回収されずに済みますが, 完了時にゲームスレッドでフラグを外す必要があります.
+     *        同じ時間に他の処理が作ったUObjectに触れないよう, Outerを辿ってRootsのいずれかに属するものだけを記録します.
+     */
+    class FAsyncCreatedObjectCollector : public FUObjectArray::FUObjectCreateListener {
+    public:
+        explicit FAsyncCreatedObjectCollector(TArray<const UObject*> InRoots)
+            : Roots(MoveTemp(InRoots)) {
+            GUObjectArray.AddUObjectCreateListener(this);
+        }
+
+        virtual ~FAsyncCreatedObjectCollector() override {
+            Stop();
+        }
+
+        virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override {
+            // ゲームスレッドで作られたものはAsyncが付かない
+            if (IsInGameThread() || !IsInRoots(Object))
+                return;
+            FScopeLock Lock(&Section);
+            Objects.Add(static_cast<UObject*>(const_cast<UObjectBase*>(Object)));
+        }
+
+        virtual void OnUObjectArrayShutdown() override {
+            Stop();
+        }
+
+        /**
+         * @brief 記録を終了し, 記録したUObjectを通常のUObjectとして扱えるようにします(ゲームスレッド)
+         */
+        void Finish() {
+            check(IsInGameThread());
+            Stop();
+            FScopeLock Lock(&Section);
+            for (auto Object : Objects)
+                Object->ClearInternalFlags(EInternalObjectFlags::Async);
+            Objects.Reset();
+        }
+
+    private:
+        bool IsInRoots(const UObjectBase* Object) const {
+            // 作成中のオブジェクトでもOuterは設定済み
+            for (auto Outer = Object->GetOuter(); Outer; Outer = Outer->GetOuter()) {
+                if (Roots.Contains(Outer))
+                    return true;
+            }
+            return false;
+        }
+
+        void Stop() {
+            if (bListening) {
+                GUObjectArray.RemoveUObjectCreateListener(this);
+                bListening = false;
+            }
+        }
+
+        const TArray<const UObject*> Roots;
+        bool bListening = true;
+        FCriticalSection Section;
+        TArray<UObject*> Objects;
+    };
+
+    /**
+     * @brief CreateRnModelAsyncの各段階で共有する状態. 段階ごとのタスクで引き継ぎます
+     */
+    struct FCreateRnModelAsyncState {
+        FCreateRnModelAsyncState(const FRoadNetworkFactory& InSelf, URnModel* InNewModel, URGraph* InGraphOuter)
+            : Self(InSelf)
+            , NewModel(InNewModel)
+            , GraphOuter(InGraphOuter)
+            , Collector({ InNewModel, InGraphOuter }) {
+        }
+
+        bool IsCanceled() const {
+            return bCanceled->Load(EMemoryOrder::Relaxed);
+        }
+
+        void ReportProgress(float Progress, const FText& Message) const {
+            if (!OnProgress)
+                return;
+            FFunctionGraphTask::CreateAndDispatchWhenReady([OnProgress = OnProgress, Progress, Message] {
+                OnProgress(Progress, Message);
+            }, TStatId(), nullptr, ENamedThreads::GameThread);
+        }
+
+        // ゲームスレッドでアクターを取得する. 破棄されていた場合は中断する
+        bool ResolveActors(APLATEAUInstancedCityModel*& OutActor, APLATEAURnStructureModel*& OutDestActor) const {
+            check(IsInGameThread());
+            OutActor = WeakActor.Get();
+            OutDestActor = WeakDestActor.Get();
+            if (OutActor && OutDestActor)
+                return true;
+            bCanceled->Store(true, EMemoryOrder::Relaxed);
+            return false;
+        }
+
+        const FRoadNetworkFactory Self;
+        TWeakObjectPtr<APLATEAUInstancedCityModel> WeakActor;
+        TWeakObjectPtr<APLATEAURnStructureModel> WeakDestActor;
+        TSharedPtr<TAtomic<bool>> bCanceled;
+        TFunction<void(float, const FText&)> OnProgress;
+
+        // 構築先のRnModel. 構築中はどこからも参照されないのでRootに追加しておく
+        URnModel* const NewModel;
+        // RGraphのオブジェクトのOuter. RGraphは構築のためだけに使うのでTransientPackageに置く
+        URGraph* const GraphOuter;
+        FAsyncCreatedObjectCollector Collector;
+
+        TArray<FSubDividedCityObjectFactory::FConvertInput> ConvertInputs;
+        TArray<FSubDividedCityObject> SubDividedCityObjects;
+        RGraphRef_t<URGraph> Graph = nullptr;
+    };
+
+    template<typename TaskBodyType, typename PrerequisiteType>
+    auto LaunchInGameThread(const TCHAR* DebugName, TaskBodyType&& TaskBody, PrerequisiteType&& Prerequisite) {
+        return UE::Tasks::Launch(DebugName, Forward<TaskBodyType>(TaskBody), UE::Tasks::Prerequisites(Forward<PrerequisiteType>(Prerequisite))
+            , UE::Tasks::ETaskPriority::Normal, UE::Tasks::EExtendedTaskPriority::GameThreadNormalPri);
+    }
+}
+
+UE::Tasks::TTask<URnModel*> FRoadNetworkFactoryEx::CreateRnModelAsync(
+    const FRoadNetworkFactory& Self
+    , APLATEAUInstancedCityModel* Actor
+    , APLATEAURnStructureModel* DestActor
+    , TSharedRef<TAtomic<bool>> bCanceled
+    , TFunction<void(float, const FText&)> OnProgress)
+{
+    check(IsInGameThread());
+
+    // コンポーネントの表示状態などを見るので対象の抽出はゲームスレッドで行う
+    TArray<UPLATEAUCityObjectGroup*> CityObjectGroups;
+    Actor->GetComponents(CityObjectGroups);
+    CityObjectGroups = CityObjectGroups.FilterByPredicate([](UPLATEAUCityObjectGroup* Cog) {
+        return IsConvertTarget(Cog);
+    });
+
+    // DestActorのRnModelには触らず, 新しいRnModelに構築して完了時に置き換える
+    auto NewModel = NewObject<URnModel>(GetTransientPackage(), MakeUniqueObjectName(GetTransientPackage(), URnModel::StaticClass(), TEXT("RnModel")));
+    auto GraphOuter = NewObject<URGraph>(GetTransientPackage(), MakeUniqueObjectName(GetTransientPackage(), URGraph::StaticClass(), TEXT("RGraphOuter")));
+    NewModel->AddToRoot();
+    GraphOuter->AddToRoot();
+
+    auto State = MakeShared<FCreateRnModelAsyncState>(Self, NewModel, GraphOuter);
+    State->WeakActor = Actor;
+    State->WeakDestActor = DestActor;
+    State->bCanceled = bCanceled;
+    State->OnProgress = MoveTemp(OnProgress);
+
+#if WITH_EDITOR
+    // 最小地物への分解に必要なメッシュと属性情報はゲームスレッドで読み出しておく
+    State->ConvertInputs = FSubDividedCityObjectFactory::GatherConvertInputs(Actor, CityObjectGroups);
+
+    // 最小地物に分解する
+    auto ConvertTask = UE::Tasks::Launch(TEXT("CreateRnModelTask.SubDivide"), [State] {
+        if (State->IsCanceled())
+            return;
+        ConvertSubDividedCityObjects(State->ConvertInputs, State->SubDividedCityObjects, &State->bCanceled.Get(), [&](int32 Index, int32 Num) {
+            State->ReportProgress(0.4f * Index / Num, FText::Format(LOCTEXT("SubDivide", "最小地物に分解しています ({0}/{1})"), Index, Num));
+        });
+    });
+
+    auto SaveSubDividedTask = LaunchInGameThread(TEXT("CreateRnModelTask.SaveSubDivided"), [State] {
+        APLATEAUInstancedCityModel* CityModel;
+        APLATEAURnStructureModel* StructureModel;
+        if (State->IsCanceled() || !State->ResolveActors(CityModel, StructureModel))
+            return;
+        SaveSubDividedCityObjects(State->Self, CityModel, StructureModel, StructureModel->GetRootComponent(), State->SubDividedCityObjects);
+    }, ConvertTask);
+
+    // RGraphを作成する. UObjectを作るのでGCを止め, OuterをGraphOuterにする
+    auto GraphTask = UE::Tasks::Launch(TEXT("CreateRnModelTask.CreateGraph"), [State] {
+        if (State->IsCanceled())
+            return;
+        State->ReportProgress(0.4f, LOCTEXT("CreateGraph", "道路グラフを作成しています"));
+        FGCScopeGuard GCGuard;
+        FPLATEAURnDef::FNewObjectOuterScope OuterScope(State->GraphOuter);
+        State->Graph = FRGraphFactoryEx::CreateGraph(State->Self.GraphFactory, State->SubDividedCityObjects);
+    }, UE::Tasks::Prerequisites(SaveSubDividedTask));
+
+    auto SaveGraphTask = LaunchInGameThread(TEXT("CreateRnModelTask.SaveGraph"), [State] {
+        APLATEAUInstancedCityModel* CityModel;
+        APLATEAURnStructureModel* StructureModel;
+        if (State->IsCanceled() || !State->ResolveActors(CityModel, StructureModel))
+            return;
+        SaveRGraph(State->Self, StructureModel, StructureModel->GetRootComponent(), State->Graph);
+    }, GraphTask);
+
+    // 新しいRnModelに道路構造を作成する. 作成するオブジェクトのOuterはNewModel
+    auto ModelTask = UE::Tasks::Launch(TEXT("CreateRnModelTask.CreateModel"), [State] {
+        if (State->IsCanceled())
+            return;
+        State->ReportProgress(0.6f, LOCTEXT("CreateModel", "道路構造を作成しています"));
+        FGCScopeGuard GCGuard;
+        FPLATEAURnDef::FNewObjectOuterScope OuterScope(State->NewModel);
+        CreateRnModel(State->Self, State->Graph, State->NewModel, &State->bCanceled.Get());
+    }, UE::Tasks::Prerequisites(SaveGraphTask));
+#else
+    auto ModelTask = UE::Tasks::MakeCompletedTask<void>();
+#endif
+
+    // 作成したUObjectの確定とRnModelの置き換えはゲームスレッドで行う
+    return LaunchInGameThread(TEXT("CreateRnModelTask.Finish"), [State]() -> URnModel* {
+        State->Collector.Finish();
+        State->NewModel->RemoveFromRoot();
+        State->GraphOuter->RemoveFromRoot();
+
+        URnModel* Result = nullptr;
+        APLATEAUInstancedCityModel* CityModel;
+        APLATEAURnStructureModel* StructureModel;
+        // 中断した場合は既存のRnModelをそのまま残し, 作成途中のものはGCに任せる
+        if (!State->IsCanceled() && State->ResolveActors(CityModel, StructureModel)) {
+#if WITH_EDITOR
+            if (auto OldModel = StructureModel->GetComponentByClass<URnModel>()) {
+                OldModel->DestroyComponent(false);
+                StructureModel->RemoveInstanceComponent(OldModel);
+            }
+            const auto NewModel = State->NewModel;
+            const auto ModelName = MakeUniqueObjectName(StructureModel, URnModel::StaticClass(), TEXT("RnModel"));
+            NewModel->Rename(*ModelName.ToString(), StructureModel, REN_DontCreateRedirectors);
+            FPLATEAURnEx::AddChildInstanceComponent(StructureModel, StructureModel->GetRootComponent(), NewModel);
+            StructureModel->Model = NewModel;
+            Result = NewModel;
+#endif
+        }
+
+        State->ReportProgress(1.f, Result ? LOCTEXT("Finished", "道路構造の作成が完了しました") : LOCTEXT("Canceled", "キャンセルされました"));
+        return Result;
+    }, ModelTask);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -344,6 +344,46 @@ TArray<FVector2D> FGeoGraph2D::ComputeConvexVolume(const TArray<FVector2D>& Vert
     return Points;
 }
 
+FGeoGraph2D::FOutlineEdgeAdjacency::FOutlineEdgeAdjacency(const TArray<TTuple<int32, int32>>& Edges, int32 VertexNum) {
+    Offsets.SetNumZeroed(VertexNum + 1);
+    for (const auto& Edge : Edges) {
+        Offsets[Edge.Get<0>() + 1]++;
+        if (Edge.Get<1>() != Edge.Get<0>())
+            Offsets[Edge.Get<1>() + 1]++;
+    }
+    for (int32 i = 0; i < VertexNum; ++i)
+        Offsets[i + 1] += Offsets[i];
+
+    Cursors = TArray<int32>(Offsets.GetData(), VertexNum);
+    EdgeIndices.SetNumUninitialized(Offsets[VertexNum]);
+    for (int32 i = 0; i < Edges.Num(); ++i) {
+        EdgeIndices[Cursors[Edges[i].Get<0>()]++] = i;
+        if (Edges[i].Get<1>() != Edges[i].Get<0>())
+            EdgeIndices[Cursors[Edges[i].Get<1>()]++] = i;
+    }
+    Cursors = TArray<int32>(Offsets.GetData(), VertexNum);
+    Used.SetNumZeroed(Edges.Num());
+}
+
+bool FGeoGraph2D::FOutlineEdgeAdjacency::MarkUsed(int32 EdgeIndex) {
+    if (Used[EdgeIndex])
+        return false;
+    Used[EdgeIndex] = true;
+    return true;
+}
+
+int32 FGeoGraph2D::FOutlineEdgeAdjacency::PopFirstEdge(int32 Vertex) {
+    auto& Cursor = Cursors[Vertex];
+    while (Cursor < Offsets[Vertex + 1]) {
+        const auto EdgeIndex = EdgeIndices[Cursor++];
+        if (Used[EdgeIndex] == false) {
+            Used[EdgeIndex] = true;
+            return EdgeIndex;
+        }
+    }
+    return INDEX_NONE;
+}
+
 TArray<int32> FGeoGraph2D::GetNearVertexTable(
     const TArray<FVector>& Vertices,
     TFunction<float(const FVector&, const FVector&)> CalcDistance,
@@ -370,6 +410,58 @@ TArray<int32> FGeoGraph2D::GetNearVertexTable(
     return Result;
 }
 
+TArray<int32> FGeoGraph2D::GetNearVertexTable(
+    const TArray<FVector>& Vertices,
+    float Epsilon) {
+    TArray<int32> Result;
+    Result.SetNumUninitialized(Vertices.Num());
+    for (int32 i = 0; i < Vertices.Num(); ++i)
+        Result[i] = i;
+
+    if (Epsilon <= 0.f)
+        return Result;
+
+    // Epsilonサイズのセルに分けると, 距離がEpsilon未満の頂点は隣接する3x3x3セルのどこかに入っている
+    auto ToCell = [Epsilon](const FVector& V) {
+        return FIntVector(
+            FMath::FloorToInt32(V.X / Epsilon),
+            FMath::FloorToInt32(V.Y / Epsilon),
+            FMath::FloorToInt32(V.Z / Epsilon));
+    };
+
+    // 頂点はインデックス順に追加するので, 検索時にセルに入っているのは自分より前の頂点だけ
+    TMap<FIntVector, TArray<int32, TInlineAllocator<4>>> Cells;
+    Cells.Reserve(Vertices.Num());
+    for (int32 i = 0; i < Vertices.Num(); ++i) {
+        const auto Cell = ToCell(Vertices[i]);
+        float MinDistance = MAX_flt;
+        int32 MinIndex = i;
+        for (auto X = -1; X <= 1; ++X) {
+            for (auto Y = -1; Y <= 1; ++Y) {
+                for (auto Z = -1; Z <= 1; ++Z) {
+                    const auto* Indices = Cells.Find(Cell + FIntVector(X, Y, Z));
+                    if (!Indices)
+                        continue;
+                    for (const auto j : *Indices) {
+                        const float Distance = FVector::Distance(Vertices[i], Vertices[j]);
+                        if (Distance >= Epsilon)
+                            continue;
+                        // 全探索版と同じく距離が同じ場合はインデックスの小さい方を優先する
+                        if (Distance < MinDistance || (Distance == MinDistance && j < MinIndex)) {
+                            MinDistance = Distance;
+                            MinIndex = j;
+                        }
+                    }
+                }
+            }
+        }
+        Result[i] = MinIndex;
+        Cells.FindOrAdd(Cell).Add(i);
+    }
+
+    return Result;
+}
+
 TArray<FVector> FGeoGraph2D::ComputeMeshOutlineVertices(
     const TArray<FVector>& Vert,
     const TArray<int32>& Triangles,
@@ -377,6 +469,7 @@ TArray<FVector> FGeoGraph2D::ComputeMeshOutlineVertices(
     float Epsilon) {
     // Create edge list from triangles
     TArray<TTuple<int32, int32>> Edges;
+    Edges.Reserve(Triangles.Num());
     for (int32 i = 0; i < Triangles.Num(); i += 3) {
         Edges.Add(MakeTuple(Triangles[i], Triangles[i + 1]));
         Edges.Add(MakeTuple(Triangles[i + 1], Triangles[i + 2]));
@@ -385,9 +478,10 @@ TArray<FVector> FGeoGraph2D::ComputeMeshOutlineVertices(
 
     // Count edge occurrences
     TMap<TTuple<int32, int32>, int32> EdgeCount;
+    EdgeCount.Reserve(Edges.Num());
     for (const auto& Edge : Edges) {
         auto NormalizedEdge = Edge.Get<0>() < Edge.Get<1>() ? Edge : MakeTuple(Edge.Get<1>(), Edge.Get<0>());
-        EdgeCount.Add(NormalizedEdge, EdgeCount.FindRef(NormalizedEdge) + 1);
+        EdgeCount.FindOrAdd(NormalizedEdge)++;
     }
 
     // Find outline edges (edges that appear only once)
@@ -405,31 +499,20 @@ TArray<FVector> FGeoGraph2D::ComputeMeshOutlineVertices(
         return Result;
     }
 
+    // 現在の頂点を含む辺のうち, OutlineEdgesで最も前にある未使用の辺をたどる
+    FOutlineEdgeAdjacency Adjacency(OutlineEdges, Vert.Num());
     int32 CurrentVertex = OutlineEdges[0].Get<0>();
     Result.Add(Vert[CurrentVertex]);
 
-    while (OutlineEdges.Num() > 0) {
-        bool Found = false;
-        for (int32 i = 0; i < OutlineEdges.Num(); ++i) {
-            if (OutlineEdges[i].Get<0>() == CurrentVertex) {
-                CurrentVertex = OutlineEdges[i].Get<1>();
-                Result.Add(Vert[CurrentVertex]);
-                OutlineEdges.RemoveAt(i);
-                Found = true;
-                break;
-            }
-            if (OutlineEdges[i].Get<1>() == CurrentVertex) {
-                CurrentVertex = OutlineEdges[i].Get<0>();
-                Result.Add(Vert[CurrentVertex]);
-                OutlineEdges.RemoveAt(i);
-                Found = true;
-                break;
-            }
-        }
-
-        if (!Found) {
+    while (true) {
+        const auto EdgeIndex = Adjacency.PopFirstEdge(CurrentVertex);
+        if (EdgeIndex == INDEX_NONE) {
             break;
         }
+
+        const auto& Edge = OutlineEdges[EdgeIndex];
+        CurrentVertex = Edge.Get<0>() == CurrentVertex ? Edge.Get<1>() : Edge.Get<0>();
+        Result.Add(Vert[CurrentVertex]);
     }
 
     return Result;
@@ -19,8 +19,15 @@ EPLATEAURnLaneBorderDir FPLATEAURnLaneBorderDirEx::GetOpposite(EPLATEAURnLaneBor
     return dir == EPLATEAURnLaneBorderDir::Left2Right ? EPLATEAURnLaneBorderDir::Right2Left : EPLATEAURnLaneBorderDir::Left2Right;
 }
 
+namespace {
+    // FNewObjectOuterScopeで指定されたOuter
+    thread_local UObject* ScopedNewObjectOuter = nullptr;
+}
+
 UObject* FPLATEAURnDef::GetNewObjectWorld()
 {
+    if (ScopedNewObjectOuter)
+        return ScopedNewObjectOuter;
     if (NewObjectWorld)
         return NewObjectWorld;
     return Cast<UObject>(GetTransientPackage());
@@ -31,6 +38,22 @@ void FPLATEAURnDef::SetNewObjectWorld(UObject* World)
     NewObjectWorld = World;
 }
 
+UObject* FPLATEAURnDef::GetScopedNewObjectOuter()
+{
+    return ScopedNewObjectOuter;
+}
+
+FPLATEAURnDef::FNewObjectOuterScope::FNewObjectOuterScope(UObject* Outer)
+    : PrevOuter(ScopedNewObjectOuter)
+{
+    ScopedNewObjectOuter = Outer;
+}
+
+FPLATEAURnDef::FNewObjectOuterScope::~FNewObjectOuterScope()
+{
+    ScopedNewObjectOuter = PrevOuter;
+}
+
 FVector2D FPLATEAURnDef::To2D(const FVector& Vector) {
     return FAxisPlaneEx::ToVector2D(Vector, Plane);
 }
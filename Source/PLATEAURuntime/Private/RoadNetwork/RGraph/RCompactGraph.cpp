@@ -0,0 +1,373 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#include "RoadNetwork/RGraph/RCompactGraph.h"
+
+#include "Algo/Unique.h"
+#include "Component/PLATEAUCityObjectGroup.h"
+#include "RoadNetwork/GeoGraph/GeoGraphEx.h"
+#include "RoadNetwork/GeoGraph/LineSegment3D.h"
+
+int32 FRCompactGraph::FindOrAddVertex(const FVector& Position) {
+    if (const auto Found = VertexMap.Find(Position))
+        return *Found;
+
+    const auto Index = Positions.Add(Position);
+    VertexRemap.Add(Index);
+    VertexMap.Add(Position, Index);
+    return Index;
+}
+
+int32 FRCompactGraph::AddFace(UPLATEAUCityObjectGroup* CityObjectGroup, ERRoadTypeMask RoadType, int32 LodLevel) {
+    FaceEdgeOffsets.Add(FaceEdges.Num());
+    FaceCityObjectGroups.Add(CityObjectGroup);
+    FaceRoadTypes.Add(RoadType);
+    return FaceLodLevels.Add(LodLevel);
+}
+
+void FRCompactGraph::AddFaceEdge(int32 V0, int32 V1) {
+    const auto Key = MakeEdgeKey(V0, V1);
+    auto Edge = EdgeMap.Find(Key);
+    if (Edge == nullptr) {
+        const auto Index = EdgeV0.Add(FMath::Min(V0, V1));
+        EdgeV1.Add(FMath::Max(V0, V1));
+        EdgeRemap.Add(Index);
+        Edge = &EdgeMap.Add(Key, Index);
+    }
+    FaceEdges.Add(*Edge);
+    FaceEdgeOffsets.Last() = FaceEdges.Num();
+}
+
+void FRCompactGraph::AdjustSmallLodHeight(float MergeCellSizeMeter, float HeightToleranceMeter) {
+    Compact();
+
+    // 頂点を参照する面の最大LOD
+    TArray<int32> MaxLodLevels;
+    MaxLodLevels.Init(-1, Positions.Num());
+    for (auto f = 0; f < GetFaceCount(); ++f) {
+        for (auto i = FaceEdgeOffsets[f]; i < FaceEdgeOffsets[f + 1]; ++i) {
+            const auto E = FaceEdges[i];
+            MaxLodLevels[EdgeV0[E]] = FMath::Max(MaxLodLevels[EdgeV0[E]], FaceLodLevels[f]);
+            MaxLodLevels[EdgeV1[E]] = FMath::Max(MaxLodLevels[EdgeV1[E]], FaceLodLevels[f]);
+        }
+    }
+
+    auto MergeCellSize = MergeCellSizeMeter * FPLATEAURnDef::Meter2Unit;
+    auto HeightTolerance = HeightToleranceMeter * FPLATEAURnDef::Meter2Unit;
+    TMap<FIntVector2, TArray<int32>> Grid;
+    for (auto v = 0; v < Positions.Num(); ++v) {
+        FVector2D Pos2D = FPLATEAURnDef::To2D(Positions[v]);
+        FIntVector2 GridPos(
+            FMath::FloorToInt(Pos2D.X / MergeCellSize),
+            FMath::FloorToInt(Pos2D.Y / MergeCellSize)
+        );
+        Grid.FindOrAdd(GridPos).Add(v);
+    }
+
+    for (auto& GridPair : Grid) {
+        auto& CellVertices = GridPair.Value;
+        if (CellVertices.Num() <= 1) continue;
+
+        TMap<int32, TArray<int32>> LodGroups;
+        for (auto v : CellVertices)
+            LodGroups.FindOrAdd(MaxLodLevels[v]).Add(v);
+
+        for (auto& LodPair : LodGroups) {
+            if (LodPair.Value.Num() <= 1) continue;
+
+            float AverageHeight = 0.0f;
+            for (auto v : LodPair.Value)
+                AverageHeight += Positions[v].Z;
+            AverageHeight /= LodPair.Value.Num();
+
+            for (auto v : LodPair.Value) {
+                if (FMath::Abs(Positions[v].Z - AverageHeight) <= HeightTolerance)
+                    Positions[v].Z = AverageHeight;
+            }
+        }
+    }
+}
+
+void FRCompactGraph::EdgeReduction() {
+    // 同じ頂点からなる辺はCompactで統合される
+    Compact();
+}
+
+void FRCompactGraph::VertexReduction(float MergeCellSizeMeter, int32 MergeCellLength, float MidPointToleranceMeter) {
+    auto MergeCellSize = MergeCellSizeMeter * FPLATEAURnDef::Meter2Unit;
+    auto MidPointTolerance = MidPointToleranceMeter * FPLATEAURnDef::Meter2Unit;
+
+    // 近い頂点を統合する. 統合先の座標は最初に見つかった頂点に持たせる
+    while (true) {
+        Compact();
+        auto Map = FGeoGraphEx::MergeVertices(Positions, MergeCellSize, MergeCellLength);
+
+        TMap<FVector, int32> Representatives;
+        auto MergedCount = 0;
+        for (auto v = 0; v < Positions.Num(); ++v) {
+            const auto Found = Map.Find(Positions[v]);
+            if (Found == nullptr)
+                continue;
+
+            auto& Representative = Representatives.FindOrAdd(*Found, INDEX_NONE);
+            if (Representative == INDEX_NONE) {
+                Representative = v;
+                Positions[v] = *Found;
+            }
+            else {
+                VertexRemap[v] = Representative;
+                MergedCount++;
+            }
+        }
+
+        if (MergedCount == 0)
+            break;
+    }
+
+    // a-b-cのような直線状の頂点を削除する
+    const auto SqrLen = MidPointTolerance * MidPointTolerance;
+    while (true) {
+        Compact();
+
+        TArray<TArray<int32>> VertexEdges;
+        VertexEdges.SetNum(Positions.Num());
+        for (auto e = 0; e < EdgeV0.Num(); ++e) {
+            VertexEdges[EdgeV0[e]].Add(e);
+            VertexEdges[EdgeV1[e]].Add(e);
+        }
+
+        auto Count = 0;
+        for (auto v = 0; v < Positions.Num(); ++v) {
+            // 2つのエッジにしか繋がっていない頂点を探す
+            auto& Edges = VertexEdges[v];
+            if (Edges.Num() != 2)
+                continue;
+
+            const auto E0 = Edges[0];
+            const auto E1 = Edges[1];
+            const auto N0 = GetOppositeVertex(E0, v);
+            const auto N1 = GetOppositeVertex(E1, v);
+            // 中間点があってもほぼ直線だった場合は中間点は削除する
+            auto Segment = FLineSegment3D(Positions[N0], Positions[N1]);
+            auto P = Segment.GetNearestPoint(Positions[v]);
+            if ((P - Positions[v]).SquaredLength() >= SqrLen)
+                continue;
+
+            // とりあえずN0にマージする. v-N0は消え, v-N1はN0-N1になる(既にあればそちらに統合する)
+            EdgeRemap[E0] = INDEX_NONE;
+            VertexEdges[N0].Remove(E0);
+            const auto Existing = VertexEdges[N0].IndexOfByPredicate([&](int32 E) {
+                return GetOppositeVertex(E, N0) == N1;
+            });
+            if (Existing != INDEX_NONE) {
+                EdgeRemap[E1] = VertexEdges[N0][Existing];
+                VertexEdges[N1].Remove(E1);
+            }
+            else {
+                (EdgeV0[E1] == v ? EdgeV0[E1] : EdgeV1[E1]) = N0;
+                VertexEdges[N0].Add(E1);
+            }
+            VertexRemap[v] = N0;
+            Edges.Reset();
+            Count++;
+        }
+        if (Count == 0)
+            break;
+    }
+}
+
+void FRCompactGraph::Compact() {
+    // 辺の端点を統合先の頂点に置き換え, 両端が同じになった辺は削除, 同じ頂点からなる辺は統合する
+    TMap<uint64, int32> Edges;
+    Edges.Reserve(EdgeV0.Num());
+    for (auto e = 0; e < EdgeV0.Num(); ++e) {
+        if (EdgeRemap[e] != e)
+            continue;
+
+        EdgeV0[e] = FindVertex(EdgeV0[e]);
+        EdgeV1[e] = FindVertex(EdgeV1[e]);
+        if (EdgeV0[e] == EdgeV1[e]) {
+            EdgeRemap[e] = INDEX_NONE;
+            continue;
+        }
+
+        const auto Key = MakeEdgeKey(EdgeV0[e], EdgeV1[e]);
+        if (const auto Found = Edges.Find(Key))
+            EdgeRemap[e] = *Found;
+        else
+            Edges.Add(Key, e);
+    }
+
+    // 残った辺と, それらから参照される頂点に新しいインデックスを振る
+    TArray<int32> NewEdgeIndices;
+    NewEdgeIndices.Init(INDEX_NONE, EdgeV0.Num());
+    TArray<int32> NewVertexIndices;
+    NewVertexIndices.Init(INDEX_NONE, Positions.Num());
+    auto NewEdgeCount = 0;
+    for (auto e = 0; e < EdgeV0.Num(); ++e) {
+        if (EdgeRemap[e] != e)
+            continue;
+        NewEdgeIndices[e] = NewEdgeCount++;
+        NewVertexIndices[EdgeV0[e]] = 0;
+        NewVertexIndices[EdgeV1[e]] = 0;
+    }
+
+    TArray<FVector> NewPositions;
+    for (auto v = 0; v < Positions.Num(); ++v) {
+        if (NewVertexIndices[v] != INDEX_NONE)
+            NewVertexIndices[v] = NewPositions.Add(Positions[v]);
+    }
+
+    TArray<int32> NewEdgeV0;
+    TArray<int32> NewEdgeV1;
+    NewEdgeV0.Reserve(NewEdgeCount);
+    NewEdgeV1.Reserve(NewEdgeCount);
+    for (auto e = 0; e < EdgeV0.Num(); ++e) {
+        if (NewEdgeIndices[e] == INDEX_NONE)
+            continue;
+        NewEdgeV0.Add(NewVertexIndices[EdgeV0[e]]);
+        NewEdgeV1.Add(NewVertexIndices[EdgeV1[e]]);
+    }
+
+    // 面の辺を置き換える. 辺の統合が起きた面は同じ辺を持つ面と統合する候補になる
+    TArray<int32> NewFaceEdgeOffsets = { 0 };
+    TArray<int32> NewFaceEdges;
+    NewFaceEdges.Reserve(FaceEdges.Num());
+    TArray<bool> MergedFaces;
+    MergedFaces.Init(false, GetFaceCount());
+    for (auto f = 0; f < GetFaceCount(); ++f) {
+        const auto Start = NewFaceEdges.Num();
+        for (auto i = FaceEdgeOffsets[f]; i < FaceEdgeOffsets[f + 1]; ++i) {
+            const auto E = FindEdge(FaceEdges[i]);
+            if (E == INDEX_NONE)
+                continue;
+            MergedFaces[f] |= E != FaceEdges[i];
+            NewFaceEdges.Add(NewEdgeIndices[E]);
+        }
+        // 面の辺は集合として扱う
+        auto FaceView = MakeArrayView(NewFaceEdges.GetData() + Start, NewFaceEdges.Num() - Start);
+        FaceView.Sort();
+        NewFaceEdges.SetNum(Start + Algo::Unique(FaceView), EAllowShrinking::No);
+        NewFaceEdgeOffsets.Add(NewFaceEdges.Num());
+    }
+
+    // 辺 -> 面の逆引き
+    TArray<int32> EdgeFaceOffsets;
+    EdgeFaceOffsets.Init(0, NewEdgeCount + 1);
+    for (auto E : NewFaceEdges)
+        EdgeFaceOffsets[E + 1]++;
+    for (auto e = 0; e < NewEdgeCount; ++e)
+        EdgeFaceOffsets[e + 1] += EdgeFaceOffsets[e];
+    TArray<int32> EdgeFaces;
+    EdgeFaces.SetNumUninitialized(NewFaceEdges.Num());
+    {
+        auto Cursor = EdgeFaceOffsets;
+        for (auto f = 0; f < GetFaceCount(); ++f) {
+            for (auto i = NewFaceEdgeOffsets[f]; i < NewFaceEdgeOffsets[f + 1]; ++i)
+                EdgeFaces[Cursor[NewFaceEdges[i]]++] = f;
+        }
+    }
+
+    auto GetFaceEdges = [&](int32 Face) {
+        return MakeArrayView(NewFaceEdges.GetData() + NewFaceEdgeOffsets[Face], NewFaceEdgeOffsets[Face + 1] - NewFaceEdgeOffsets[Face]);
+    };
+    auto IsSameEdges = [&](int32 A, int32 B) {
+        const auto EdgesA = GetFaceEdges(A);
+        const auto EdgesB = GetFaceEdges(B);
+        return EdgesA.Num() == EdgesB.Num() && FMemory::Memcmp(EdgesA.GetData(), EdgesB.GetData(), EdgesA.Num() * sizeof(int32)) == 0;
+    };
+    TArray<bool> RemovedFaces;
+    RemovedFaces.Init(false, GetFaceCount());
+    for (auto f = 0; f < GetFaceCount(); ++f) {
+        const auto Edges0 = GetFaceEdges(f);
+        if (MergedFaces[f] == false || Edges0.Num() == 0)
+            continue;
+        for (auto i = EdgeFaceOffsets[Edges0[0]]; i < EdgeFaceOffsets[Edges0[0] + 1]; ++i) {
+            const auto Other = EdgeFaces[i];
+            if (Other != f && RemovedFaces[Other] == false && IsSameEdges(f, Other)) {
+                RemovedFaces[f] = true;
+                break;
+            }
+        }
+    }
+
+    // 面の配列を詰める
+    FaceEdgeOffsets = { 0 };
+    FaceEdges.Reset();
+    auto WriteIndex = 0;
+    for (auto f = 0; f < RemovedFaces.Num(); ++f) {
+        if (RemovedFaces[f])
+            continue;
+        FaceEdges.Append(GetFaceEdges(f));
+        FaceEdgeOffsets.Add(FaceEdges.Num());
+        FaceCityObjectGroups[WriteIndex] = FaceCityObjectGroups[f];
+        FaceRoadTypes[WriteIndex] = FaceRoadTypes[f];
+        FaceLodLevels[WriteIndex] = FaceLodLevels[f];
+        WriteIndex++;
+    }
+    FaceCityObjectGroups.SetNum(WriteIndex);
+    FaceRoadTypes.SetNum(WriteIndex);
+    FaceLodLevels.SetNum(WriteIndex);
+
+    Positions = MoveTemp(NewPositions);
+    VertexRemap.SetNumUninitialized(Positions.Num());
+    for (auto v = 0; v < Positions.Num(); ++v)
+        VertexRemap[v] = v;
+    EdgeV0 = MoveTemp(NewEdgeV0);
+    EdgeV1 = MoveTemp(NewEdgeV1);
+    EdgeRemap.SetNumUninitialized(EdgeV0.Num());
+    for (auto e = 0; e < EdgeV0.Num(); ++e)
+        EdgeRemap[e] = e;
+
+    // インデックスが変わったので構築用のマップを作り直す
+    VertexMap.Reset();
+    for (auto v = 0; v < Positions.Num(); ++v)
+        VertexMap.FindOrAdd(Positions[v], v);
+    EdgeMap.Reset();
+    for (auto e = 0; e < EdgeV0.Num(); ++e)
+        EdgeMap.Add(MakeEdgeKey(EdgeV0[e], EdgeV1[e]), e);
+}
+
+RGraphRef_t<URGraph> FRCompactGraph::ToGraph() {
+    Compact();
+
+    auto Graph = RGraphNew<URGraph>();
+    TArray<RGraphRef_t<URVertex>> Vertices;
+    Vertices.Reserve(Positions.Num());
+    for (auto& Position : Positions)
+        Vertices.Add(RGraphNew<URVertex>(Position));
+
+    TArray<RGraphRef_t<UREdge>> Edges;
+    Edges.Reserve(EdgeV0.Num());
+    for (auto e = 0; e < EdgeV0.Num(); ++e)
+        Edges.Add(RGraphNew<UREdge>(Vertices[EdgeV0[e]], Vertices[EdgeV1[e]]));
+
+    for (auto f = 0; f < GetFaceCount(); ++f) {
+        auto Face = RGraphNew<URFace>(Graph, FaceCityObjectGroups[f].Get(), FaceRoadTypes[f], FaceLodLevels[f]);
+        for (auto i = FaceEdgeOffsets[f]; i < FaceEdgeOffsets[f + 1]; ++i)
+            Face->AddEdge(Edges[FaceEdges[i]]);
+        Graph->AddFace(Face);
+    }
+    return Graph;
+}
+
+int32 FRCompactGraph::FindVertex(int32 Vertex) {
+    while (VertexRemap[Vertex] != Vertex) {
+        VertexRemap[Vertex] = VertexRemap[VertexRemap[Vertex]];
+        Vertex = VertexRemap[Vertex];
+    }
+    return Vertex;
+}
+
+int32 FRCompactGraph::FindEdge(int32 Edge) const {
+    while (Edge != INDEX_NONE && EdgeRemap[Edge] != Edge)
+        Edge = EdgeRemap[Edge];
+    return Edge;
+}
+
+int32 FRCompactGraph::GetOppositeVertex(int32 Edge, int32 Vertex) const {
+    return EdgeV0[Edge] == Vertex ? EdgeV1[Edge] : EdgeV0[Edge];
+}
+
+uint64 FRCompactGraph::MakeEdgeKey(int32 V0, int32 V1) {
+    return (static_cast<uint64>(FMath::Min(V0, V1)) << 32) | static_cast<uint32>(FMath::Max(V0, V1));
+}
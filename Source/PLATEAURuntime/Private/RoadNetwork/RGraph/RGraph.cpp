@@ -2,6 +2,15 @@
 
 #include "RoadNetwork/RGraph/RGraph.h"
 #include "Component/PLATEAUCityObjectGroup.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+    TAutoConsoleVariable<bool> CVarValidateGraphCache(
+        TEXT("plateau.RoadNetwork.ValidateGraphCache"),
+        false,
+        TEXT("URGraphの辺/頂点キャッシュを参照する度に, 面から作り直したものと比較します(デバッグ用)"));
+}
 
 URVertex::URVertex(const FVector& InPosition)
 {
@@ -216,6 +225,17 @@ void UREdge::SetVertex(EVertexType Type, RGraphRef_t<URVertex> Vertex) {
     if (Vertex) {
         Vertex->AddEdge(RGraphRef_t<UREdge>(this));
     }
+
+    // 辺を含むグラフの頂点キャッシュを更新する(同じグラフには1度だけ通知する)
+    TArray<RGraphRef_t<URGraph>, TInlineAllocator<2>> Graphs;
+    for (auto Face : Faces) {
+        if (RGraphRef_t<URGraph> Graph = Face->GetGraph()) {
+            if (Graphs.Contains(Graph) == false) {
+                Graphs.Add(Graph);
+                Graph->OnEdgeVertexChanged(this, OldVertex, Vertex);
+            }
+        }
+    }
 }
 
 void UREdge::ChangeVertex(RGraphRef_t<URVertex> From, RGraphRef_t<URVertex> To) {
@@ -400,8 +420,11 @@ void URFace::Init(RGraphRef_t<URGraph> InGraph, UPLATEAUCityObjectGroup* InCityO
 
 void URFace::AddEdge(RGraphRef_t<UREdge> Edge) {
     if (Edge) {
-        Edges.Add(Edge);
+        bool bIsAlreadyInSet = false;
+        Edges.Add(Edge, &bIsAlreadyInSet);
         Edge->AddFace(RGraphRef_t<URFace>(this));
+        if (Graph && !bIsAlreadyInSet)
+            Graph->OnFaceEdgeAdded(this, Edge);
     }
 }
 
@@ -425,8 +448,10 @@ void URFace::SetGraph(RGraphRef_t<URGraph> G) {
 
 void URFace::RemoveEdge(RGraphRef_t<UREdge> Edge) {
     if (Edge) {
-        Edges.Remove(Edge);
+        const auto bRemoved = Edges.Remove(Edge) > 0;
         Edge->RemoveFace(RGraphRef_t<URFace>(this));
+        if (Graph && bRemoved)
+            Graph->OnFaceEdgeRemoved(this, Edge);
     }
 }
 
@@ -473,34 +498,134 @@ URGraph::URGraph()
 {
 }
 
+void URGraph::PostLoad() {
+    Super::PostLoad();
+    RebuildCache();
+}
+
+const TSet<RGraphRef_t<UREdge>>& URGraph::GetEdges() const {
+    if (CVarValidateGraphCache.GetValueOnAnyThread())
+        ValidateCache();
+    return Edges;
+}
+
+const TSet<RGraphRef_t<URVertex>>& URGraph::GetVertices() const {
+    if (CVarValidateGraphCache.GetValueOnAnyThread())
+        ValidateCache();
+    return Vertices;
+}
+
 TSet<RGraphRef_t<UREdge>> URGraph::GetAllEdges() {
-    TSet<RGraphRef_t<UREdge>> Result;
-    for (auto Face : Faces) {
-        for (auto Edge : Face->GetEdges())
-            Result.Add(Edge);
-    }
-    return Result;
+    return GetEdges();
 }
 
 TSet<RGraphRef_t<URVertex>> URGraph::GetAllVertices() {
-    TSet<RGraphRef_t<URVertex>> Result;
-    for (auto Edge : GetAllEdges()) {
-        Result.Add(Edge->GetV0());
-        Result.Add(Edge->GetV1());
-    }
-    return Result;
+    return GetVertices();
 }
 
 void URGraph::AddFace(RGraphRef_t<URFace> Face) {
     if (Face && !Faces.Contains(Face)) {
         Faces.Add(Face);
+        for (auto Edge : Face->GetEdges())
+            AddEdgeRef(Edge);
     }
 }
 
 void URGraph::RemoveFace(RGraphRef_t<URFace> Face) {
-    if (Face) {
-        Faces.Remove(Face);
+    if (Face && Faces.Remove(Face) > 0) {
+        for (auto Edge : Face->GetEdges())
+            RemoveEdgeRef(Edge);
+    }
+}
+
+bool URGraph::ValidateCache() const {
+    TSet<RGraphRef_t<UREdge>> ExpectedEdges;
+    TSet<RGraphRef_t<URVertex>> ExpectedVertices;
+    for (auto Face : Faces) {
+        for (auto Edge : Face->GetEdges()) {
+            ExpectedEdges.Add(Edge);
+            for (auto Vertex : Edge->GetVertices()) {
+                if (Vertex)
+                    ExpectedVertices.Add(Vertex);
+            }
+        }
     }
+
+    const auto IsSame = [](const auto& A, const auto& B) {
+        return A.Num() == B.Num() && A.Includes(B);
+    };
+    if (IsSame(ExpectedEdges, Edges) && IsSame(ExpectedVertices, Vertices))
+        return true;
+
+    UE_LOG(LogTemp, Error, TEXT("URGraph cache mismatch : edges %d (expected %d), vertices %d (expected %d)"),
+        Edges.Num(), ExpectedEdges.Num(), Vertices.Num(), ExpectedVertices.Num());
+    return false;
+}
+
+void URGraph::OnFaceEdgeAdded(RGraphRef_t<URFace> Face, RGraphRef_t<UREdge> Edge) {
+    if (Faces.Contains(Face))
+        AddEdgeRef(Edge);
+}
+
+void URGraph::OnFaceEdgeRemoved(RGraphRef_t<URFace> Face, RGraphRef_t<UREdge> Edge) {
+    if (Faces.Contains(Face))
+        RemoveEdgeRef(Edge);
+}
+
+void URGraph::OnEdgeVertexChanged(RGraphRef_t<UREdge> Edge, RGraphRef_t<URVertex> From, RGraphRef_t<URVertex> To) {
+    if (EdgeRefCounts.Contains(Edge) == false)
+        return;
+    RemoveVertexRef(From);
+    AddVertexRef(To);
+}
+
+void URGraph::RebuildCache() {
+    EdgeRefCounts.Reset();
+    VertexRefCounts.Reset();
+    Edges.Reset();
+    Vertices.Reset();
+    for (auto Face : Faces) {
+        if (!Face)
+            continue;
+        for (auto Edge : Face->GetEdges())
+            AddEdgeRef(Edge);
+    }
+}
+
+void URGraph::AddEdgeRef(RGraphRef_t<UREdge> Edge) {
+    if (!Edge)
+        return;
+    if (EdgeRefCounts.FindOrAdd(Edge)++ > 0)
+        return;
+
+    Edges.Add(Edge);
+    for (auto Vertex : Edge->GetVertices())
+        AddVertexRef(Vertex);
+}
+
+void URGraph::RemoveEdgeRef(RGraphRef_t<UREdge> Edge) {
+    auto Count = EdgeRefCounts.Find(Edge);
+    if (!Count || --(*Count) > 0)
+        return;
+
+    EdgeRefCounts.Remove(Edge);
+    Edges.Remove(Edge);
+    for (auto Vertex : Edge->GetVertices())
+        RemoveVertexRef(Vertex);
+}
+
+void URGraph::AddVertexRef(RGraphRef_t<URVertex> Vertex) {
+    if (Vertex && VertexRefCounts.FindOrAdd(Vertex)++ == 0)
+        Vertices.Add(Vertex);
+}
+
+void URGraph::RemoveVertexRef(RGraphRef_t<URVertex> Vertex) {
+    auto Count = Vertex ? VertexRefCounts.Find(Vertex) : nullptr;
+    if (!Count || --(*Count) > 0)
+        return;
+
+    VertexRefCounts.Remove(Vertex);
+    Vertices.Remove(Vertex);
 }
 
 // Face Group implementations
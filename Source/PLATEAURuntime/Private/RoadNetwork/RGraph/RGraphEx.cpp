@@ -16,6 +16,188 @@
 
 namespace
 {
+    /*
+     * 辺(FPLATEAURnDef::Planeに投影)を, Margin以内にあるセルだけに登録する一様グリッド
+     * 近傍の辺の候補を局所的に検索するために使用する
+     */
+    class FEdgeGrid {
+    public:
+        FEdgeGrid(const TArray<RGraphRef_t<UREdge>>& InEdges, float Margin)
+            : Edges(InEdges)
+            , Margin(Margin)
+        {
+            // セルサイズは辺の平均長さ(最低でもMargin)にする. 長い辺は複数のセルに登録される
+            double TotalLength = 0.0;
+            for (auto&& E : Edges)
+                TotalLength += FPLATEAURnDef::To2D(E->GetV1()->GetPosition() - E->GetV0()->GetPosition()).Size();
+            CellSize = FMath::Max3(Edges.Num() > 0 ? TotalLength / Edges.Num() : 0.0, static_cast<double>(Margin), 1.0);
+
+            // 斜めの長い辺をAABB全体に登録するとセル数が長さの2乗で増えるので, 辺が通過するセルだけをたどる
+            TSet<FIntPoint> EdgeCells;
+            for (auto i = 0; i < Edges.Num(); ++i) {
+                const auto P0 = FPLATEAURnDef::To2D(Edges[i]->GetV0()->GetPosition());
+                const auto P1 = FPLATEAURnDef::To2D(Edges[i]->GetV1()->GetPosition());
+                EdgeCells.Reset();
+                ForEachSegmentCell(P0, P1, [&](const FIntPoint& Cell) {
+                    EdgeCells.Add(Cell);
+                });
+                for (const auto& Cell : EdgeCells)
+                    Cells.FindOrAdd(Cell).Add(i);
+            }
+            VisitStamps.Init(0, Edges.Num());
+        }
+
+        // Marginで拡張したEdgeのAABB
+        void GetBounds(RGraphRef_t<UREdge> Edge, FVector2D& OutMin, FVector2D& OutMax) const {
+            const auto P0 = FPLATEAURnDef::To2D(Edge->GetV0()->GetPosition());
+            const auto P1 = FPLATEAURnDef::To2D(Edge->GetV1()->GetPosition());
+            OutMin = FVector2D(FMath::Min(P0.X, P1.X), FMath::Min(P0.Y, P1.Y)) - FVector2D(Margin);
+            OutMax = FVector2D(FMath::Max(P0.X, P1.X), FMath::Max(P0.Y, P1.Y)) + FVector2D(Margin);
+        }
+
+        // [Min, Max]と重なるセルに登録されている辺を重複なく列挙する
+        template<typename TFunc>
+        void ForEachCandidate(const FVector2D& Min, const FVector2D& Max, TFunc&& Func) {
+            ++CurrentStamp;
+            ForEachCell(Min, Max, [&](const FIntPoint& Cell) {
+                const auto Found = Cells.Find(Cell);
+                if (!Found)
+                    return;
+                for (const auto Index : *Found) {
+                    if (VisitStamps[Index] == CurrentStamp)
+                        continue;
+                    VisitStamps[Index] = CurrentStamp;
+                    Func(Edges[Index]);
+                }
+            });
+        }
+
+    private:
+        FIntPoint ToCell(const FVector2D& P) const {
+            return FIntPoint(FMath::FloorToInt32(P.X / CellSize), FMath::FloorToInt32(P.Y / CellSize));
+        }
+
+        // 線分P0-P1からMargin以内にあるセルを列挙する(重複して呼ばれることがある)
+        // 線分が通過するセルをAmanatides-Wooの方法でたどり, その周囲のセルのうち線分との距離がMargin以内のものを返す
+        template<typename TFunc>
+        void ForEachSegmentCell(const FVector2D& P0, const FVector2D& P1, TFunc&& Func) const {
+            // CellSize >= Marginなので周囲1セルまで見れば十分
+            const auto VisitAround = [&](const FIntPoint& Center) {
+                for (auto dx = -1; dx <= 1; ++dx) {
+                    for (auto dy = -1; dy <= 1; ++dy) {
+                        const FIntPoint Cell(Center.X + dx, Center.Y + dy);
+                        if ((dx == 0 && dy == 0) || GetSegmentCellDistance(P0, P1, Cell) <= Margin)
+                            Func(Cell);
+                    }
+                }
+            };
+
+            auto Cell = ToCell(P0);
+            const auto EndCell = ToCell(P1);
+            const auto Dir = P1 - P0;
+            const int32 StepX = Dir.X > 0 ? 1 : -1;
+            const int32 StepY = Dir.Y > 0 ? 1 : -1;
+            // 次のセル境界までのパラメータtと, 1セル進むごとのtの増分
+            const auto InitT = [&](double P, double D, int32 C, int32 Step) {
+                if (FMath::IsNearlyZero(D))
+                    return TNumericLimits<double>::Max();
+                const auto Boundary = (C + (Step > 0 ? 1 : 0)) * CellSize;
+                return (Boundary - P) / D;
+            };
+            auto TMaxX = InitT(P0.X, Dir.X, Cell.X, StepX);
+            auto TMaxY = InitT(P0.Y, Dir.Y, Cell.Y, StepY);
+            const auto TDeltaX = FMath::IsNearlyZero(Dir.X) ? TNumericLimits<double>::Max() : CellSize / FMath::Abs(Dir.X);
+            const auto TDeltaY = FMath::IsNearlyZero(Dir.Y) ? TNumericLimits<double>::Max() : CellSize / FMath::Abs(Dir.Y);
+
+            // 浮動小数点誤差で終点のセルを通り過ぎないように, たどるセル数をマンハッタン距離で制限する
+            const auto MaxSteps = FMath::Abs(EndCell.X - Cell.X) + FMath::Abs(EndCell.Y - Cell.Y);
+            VisitAround(Cell);
+            for (auto Step = 0; Step < MaxSteps && Cell != EndCell; ++Step) {
+                if (TMaxX < TMaxY) {
+                    Cell.X += StepX;
+                    TMaxX += TDeltaX;
+                }
+                else {
+                    Cell.Y += StepY;
+                    TMaxY += TDeltaY;
+                }
+                VisitAround(Cell);
+            }
+            if (Cell != EndCell)
+                VisitAround(EndCell);
+        }
+
+        // 線分P0-P1とセルの矩形との距離
+        double GetSegmentCellDistance(const FVector2D& P0, const FVector2D& P1, const FIntPoint& Cell) const {
+            const FBox2D Box(FVector2D(Cell.X, Cell.Y) * CellSize, FVector2D(Cell.X + 1, Cell.Y + 1) * CellSize);
+            // 端点が矩形内にある, もしくは線分が矩形の辺と交差する場合は0
+            if (Box.IsInsideOrOn(P0) || Box.IsInsideOrOn(P1))
+                return 0.0;
+            const FVector2D Corners[4] = { Box.Min, FVector2D(Box.Max.X, Box.Min.Y), Box.Max, FVector2D(Box.Min.X, Box.Max.Y) };
+            auto MinDistSq = TNumericLimits<double>::Max();
+            for (auto i = 0; i < 4; ++i) {
+                const auto& C0 = Corners[i];
+                const auto& C1 = Corners[(i + 1) % 4];
+                FVector Intersection;
+                if (FMath::SegmentIntersection2D(FVector(P0, 0.0), FVector(P1, 0.0), FVector(C0, 0.0), FVector(C1, 0.0), Intersection))
+                    return 0.0;
+                MinDistSq = FMath::Min(MinDistSq, (FMath::ClosestPointOnSegment2D(C0, P0, P1) - C0).SizeSquared());
+            }
+            MinDistSq = FMath::Min(MinDistSq, Box.ComputeSquaredDistanceToPoint(P0));
+            MinDistSq = FMath::Min(MinDistSq, Box.ComputeSquaredDistanceToPoint(P1));
+            return FMath::Sqrt(MinDistSq);
+        }
+
+        template<typename TFunc>
+        void ForEachCell(const FVector2D& Min, const FVector2D& Max, TFunc&& Func) const {
+            const int32 MinX = FMath::FloorToInt32(Min.X / CellSize);
+            const int32 MinY = FMath::FloorToInt32(Min.Y / CellSize);
+            const int32 MaxX = FMath::FloorToInt32(Max.X / CellSize);
+            const int32 MaxY = FMath::FloorToInt32(Max.Y / CellSize);
+            for (auto x = MinX; x <= MaxX; ++x) {
+                for (auto y = MinY; y <= MaxY; ++y)
+                    Func(FIntPoint(x, y));
+            }
+        }
+
+        TArray<RGraphRef_t<UREdge>> Edges;
+        float Margin;
+        double CellSize = 1.0;
+        TMap<FIntPoint, TArray<int32>> Cells;
+        TArray<int32> VisitStamps;
+        int32 CurrentStamp = 0;
+    };
+
+    /*
+     * 頂点をVector3Comparerでソートした配列と, 各頂点の順位を返す
+     * 平面走査で「辺の始点 < 頂点 < 辺の終点」となる辺(走査中の辺)を判定するために使用する
+     */
+    TArray<RGraphRef_t<URVertex>> CreateSortedVertices(RGraphRef_t<URGraph> Graph, TMap<RGraphRef_t<URVertex>, int32>& OutRank) {
+        auto&& Vertices = Graph->GetVertices().Array();
+
+        constexpr auto Comp = FPLATEAURnDef::Vector3Comparer();
+        // #NOTE : UEのバグ？ ポインタのTArrayをソートしようとするとラムダ式にはポインタを消したうえで行う必要がある模様
+        Vertices.Sort([&](const URVertex& A, const URVertex& B) {
+            return Comp(A.Position, B.Position) < 0;
+            });
+
+        OutRank.Reset();
+        OutRank.Reserve(Vertices.Num());
+        for (auto i = 0; i < Vertices.Num(); ++i)
+            OutRank.Add(Vertices[i], i);
+        return Vertices;
+    }
+
+    // Edgeの始点/終点(ソート順で前/後の頂点)の順位を返す. 同じ位置の頂点からなる辺は走査対象にならないのでfalse
+    bool TryGetEdgeRank(RGraphRef_t<UREdge> Edge, const TMap<RGraphRef_t<URVertex>, int32>& Rank, int32& OutStart, int32& OutEnd) {
+        constexpr auto Comp = FPLATEAURnDef::Vector3Comparer();
+        const auto D = Comp(Edge->GetV0()->Position, Edge->GetV1()->Position);
+        if (D == 0)
+            return false;
+        OutStart = Rank[D < 0 ? Edge->GetV0() : Edge->GetV1()];
+        OutEnd = Rank[D < 0 ? Edge->GetV1() : Edge->GetV0()];
+        return true;
+    }
 }
 
 void FRGraphEx::RemoveInnerVertex(RGraphRef_t<URFace> Face) {
@@ -50,7 +232,7 @@ TSet<RGraphRef_t<URVertex>> FRGraphEx::AdjustSmallLodHeight(
     if (!Graph) return TSet<RGraphRef_t<URVertex>>();
 
     TSet<RGraphRef_t<URVertex>> Result;
-    auto&& Vertices = Graph->GetAllVertices();
+    auto&& Vertices = Graph->GetVertices();
 
     auto MergeCellSize = MergeCellSizeMeter * FPLATEAURnDef::Meter2Unit;
     auto HeightTolerance = HeightToleranceMeter * FPLATEAURnDef::Meter2Unit;
@@ -274,48 +456,24 @@ void FRGraphEx::InsertVertexInNearEdge(RGraphRef_t<URGraph> Graph, float Toleran
         return;
     auto Tolerance = ToleranceMeter * FPLATEAURnDef::Meter2Unit;
 
-    auto&& Vertices = Graph->GetAllVertices().Array();
-
-    constexpr auto Comp = FPLATEAURnDef::Vector3Comparer();
-
-    auto Comparer = [&](const RGraphRef_t<URVertex>& A, const RGraphRef_t<URVertex>& B) {
-        return Comp(A->Position, B->Position);
-        };
-    // #NOTE : UEのバグ？ ポインタのTArrayをソートしようとするとラムダ式にはポインタを消したうえで行う必要がある模様
-    Vertices.Sort([&](const URVertex& A, const URVertex& B)
-    {
-            return Comp(A.Position, B.Position) < 0;
-    });
-
-    TSet<RGraphRef_t<UREdge>> queue;
+    // 頂点をソートし, 各頂点についてその頂点をまたぐ辺(始点 < 頂点 < 終点)との距離を調べる.
+    // 候補となる辺はグリッドから頂点の近傍だけを取り出す
+    TMap<RGraphRef_t<URVertex>, int32> Rank;
+    auto&& Vertices = CreateSortedVertices(Graph, Rank);
+    FEdgeGrid Grid(Graph->GetEdges().Array(), Tolerance);
 
     TMap<RGraphRef_t<UREdge>, TSet<RGraphRef_t<URVertex>>> edgeInsertMap;
     auto Threshold = Tolerance * Tolerance;
 
     for (auto i = 0; i < Vertices.Num(); i++) {
         auto V = Vertices[i];
-        // 新規追加分
-        TArray<RGraphRef_t<UREdge>> addEdges;
-        TSet<RGraphRef_t<UREdge>> removeEdges;
-        for(auto&& E : V->GetEdges()) 
-        {
-            // vと反対側の点を見る
-            auto o = E->GetOppositeVertex(V);
-            auto d = Comparer(V, o);
-            // vが開始点の辺を追加する
-            if (d < 0)
-                addEdges.Add(E);
-            // vが終了点の辺を取り出す
-            else if (d > 0)
-                removeEdges.Add(E);
-        }
-        for(auto&& remove : removeEdges)
-            queue.Remove(remove);
-
-        for(auto e : queue) 
-        {
+        const auto P = FPLATEAURnDef::To2D(V->GetPosition());
+        Grid.ForEachCandidate(P, P, [&](RGraphRef_t<UREdge> e) {
+            int32 Start, End;
+            if (!TryGetEdgeRank(e, Rank, Start, End) || Start >= i || End <= i)
+                return;
             if (e->GetV0() == V || e->GetV1() == V)
-                continue;
+                return;
 
             auto s = FLineSegment3D(e->GetV0()->GetPosition(), e->GetV1()->GetPosition());
             auto near = s.GetNearestPoint(V->GetPosition());
@@ -323,10 +481,7 @@ void FRGraphEx::InsertVertexInNearEdge(RGraphRef_t<URGraph> Graph, float Toleran
             {
                 edgeInsertMap.FindOrAdd(e).Add(V);
             }
-        }
-
-        for(auto&& add : addEdges)
-            queue.Add(add);
+        });
     }
 
     for(auto&& e : edgeInsertMap) {
@@ -340,71 +495,47 @@ void FRGraphEx::InsertVerticesInEdgeIntersection(RGraphRef_t<URGraph> Graph, flo
 
     auto HeightTolerance = HeightToleranceMeter * FPLATEAURnDef::Meter2Unit;
 
-    auto&& Vertices = Graph->GetAllVertices().Array();
-
-    constexpr auto Comp = FPLATEAURnDef::Vector3Comparer();
-
-    auto Comparer = [&](const RGraphRef_t<URVertex>& A, const RGraphRef_t<URVertex>& B) {
-        return Comp(A->Position, B->Position);
-        };
-    // #NOTE : UEのバグ？ ポインタのTArrayをソートしようとするとラムダ式にはポインタを消したうえで行う必要がある模様
-    Vertices.Sort([&](const URVertex& A, const URVertex& B) {
-        return Comp(A.Position, B.Position) < 0;
-        });
-
-    TSet<RGraphRef_t<UREdge>> queue;
+    // 頂点をソートし, 各頂点Vで終わる辺e0と, Vをまたぐ辺e1(始点 < V < 終点)の交差を調べる.
+    // e1の候補はグリッドからe0のAABBと重なるものだけを取り出す
+    TMap<RGraphRef_t<URVertex>, int32> Rank;
+    auto&& Vertices = CreateSortedVertices(Graph, Rank);
+    // 交差判定の誤差を考慮して1cmだけAABBを広げる
+    FEdgeGrid Grid(Graph->GetEdges().Array(), 0.01f * FPLATEAURnDef::Meter2Unit);
 
     TMap<RGraphRef_t<UREdge>, TSet<RGraphRef_t<URVertex>>> edgeInsertMap;
 
     TMap<FVector, RGraphRef_t<URVertex>> vertexMap;
+    auto NearlyEqual = [](float a, float b) {
+        return FMath::Abs(a - b) < 1e-3f;
+        };
     for (auto i = 0; i < Vertices.Num(); i++) {
         auto V = Vertices[i];
-        // 新規追加分
-        TArray<RGraphRef_t<UREdge>> addEdges;
+        // vが終了点の辺
         TSet<RGraphRef_t<UREdge>> removeEdges;
         for (auto&& E : V->GetEdges()) {
-            // vと反対側の点を見る
-            auto o = E->GetOppositeVertex(V);
-            auto d = Comparer(V, o);
-            // vが開始点の辺を追加する
-            if (d < 0)
-                addEdges.Add(E);
-            // vが終了点の辺を取り出す
-            else if (d > 0)
+            int32 Start, End;
+            if (TryGetEdgeRank(E, Rank, Start, End) && End == i)
                 removeEdges.Add(E);
         }
 
-        auto NearlyEqual = [](float a, float b) {
-            return FMath::Abs(a - b) < 1e-3f;
-            };
-        TArray<RGraphRef_t<UREdge>> targets;
-        for(auto&& t : queue)
-        {
-            // vを端点に持つ辺は無視
-            if (t->GetV0() == V || t->GetV1() == V)
-                continue;
-            if (removeEdges.Contains(t))
-                continue;
-            targets.Add(t);
-        }
-
         for(auto e0 : removeEdges) {
             auto s0 = FLineSegment3D(e0->GetV0()->GetPosition(), e0->GetV1()->GetPosition());
-            for(auto e1 : targets) {
+            FVector2D Min, Max;
+            Grid.GetBounds(e0, Min, Max);
+            Grid.ForEachCandidate(Min, Max, [&](RGraphRef_t<UREdge> e1) {
+                int32 Start, End;
+                if (!TryGetEdgeRank(e1, Rank, Start, End) || Start >= i || End <= i)
+                    return;
+                // vを端点に持つ辺は無視
+                if (e1->GetV0() == V || e1->GetV1() == V)
+                    return;
+
                 auto s1 = FLineSegment3D(e1->GetV0()->GetPosition(), e1->GetV1()->Position);
                 // e0とe1が共有している頂点がある場合は無視
                 RGraphRef_t<URVertex> shareV;
-                if (e0->IsShareAnyVertex(e1, shareV)) {
-                    //auto (sv, s) = s0.Magnitude < s1.Magnitude
-                    //    ? (e0->GetOppositeVertex(shareV), s1)
-                    //    : (e1->GetOppositeVertex(shareV), s0);
-                    //if ((s.GetNearestPoint(sv.Position) - sv.Position).sqrMagnitude < shareMid)
-                    //{
-                    //    edgeInsertMap.GetValueOrCreate(e0).Add(sv);
-                    //}
+                if (e0->IsShareAnyVertex(e1, shareV))
+                    return;
 
-                    continue;
-                }
                 FVector intersection;
                 float t1;
                 float t2;
@@ -412,7 +543,7 @@ void FRGraphEx::InsertVerticesInEdgeIntersection(RGraphRef_t<URGraph> Graph, flo
                 {
                     // お互いの端点で交差している場合は無視
                     if ((NearlyEqual(t1, 0) || NearlyEqual(t1, 1)) && (NearlyEqual(t2, 0) || NearlyEqual(t2, 1)))
-                        continue;
+                        return;
                     if(vertexMap.Contains(intersection) == false)
                         vertexMap.Add(intersection, RGraphNew<URVertex>(intersection));
                     auto p = vertexMap[intersection];
@@ -420,15 +551,8 @@ void FRGraphEx::InsertVerticesInEdgeIntersection(RGraphRef_t<URGraph> Graph, flo
                     edgeInsertMap.FindOrAdd(e0).Add(p);
                     edgeInsertMap.FindOrAdd(e1).Add(p);
                 }
-            }
+            });
         }
-
-        for (auto&& add : addEdges)
-            queue.Add(add);
-
-        for (auto&& remove : removeEdges)
-            queue.Remove(remove);
-
     }
 
     for (auto&& e : edgeInsertMap) {
@@ -1172,41 +1296,33 @@ int32 FRGraphEx::FaceReduction(URGraph* Graph)
 {
     int32 RemovedFaceCount = 0;
 
-    // キー: Face の Edge 数, 値: 該当する URFace* の配列
-    TMap<int32, TArray<URFace*>> FaceMap;
-
-    // Graph 内の全 Face を、Edge 数でグループ化する
-    for (URFace* Face : Graph->GetFaces()) {
-        int32 NumEdges = Face->GetEdges().Num();
-        FaceMap.FindOrAdd(NumEdges).Add(Face);
-    }
-
-    // グループ内の Face 同士で、同一の Edge 群かどうかをチェックする
-    for (auto& Pair : FaceMap) {
-        TArray<URFace*>& Faces = Pair.Value;
-        // インデックス i, j の組み合わせで比較
-        for (int32 i = 0; i < Faces.Num(); i++) {
-            URFace* Face1 = Faces[i];
-            for (int32 j = i + 1; j < Faces.Num(); j++) {
-                URFace* Face2 = Faces[j];
-                bool bAllContained = true;
-                // Face1 の全エッジが Face2 に含まれているかを確認する
-                for (UREdge* Edge : Face1->GetEdges()) {
-                    if (!Face2->GetEdges().Contains(Edge)) {
-                        bAllContained = false;
-                        break;
-                    }
-                }
-                // Face1 のすべての Edge が Face2 に含まれる場合、Face2 を Face1 にマージ
-                if (bAllContained) {
-                    if (Face2->TryMergeTo(Face1)) {
-                        Faces.RemoveAt(j);
-                        j--;
-                        RemovedFaceCount++;
-                    }
-                }
-            }
+    // キー: Face の Edge 集合のハッシュ(順不同), 値: そのハッシュを持つ Face のうち残すもの
+    TMap<uint32, TArray<URFace*, TInlineAllocator<1>>> FaceMap;
+    FaceMap.Reserve(Graph->GetFaces().Num());
+
+    // マージで Graph->GetFaces() が変わるのでコピーしておく
+    auto Faces = Graph->GetFaces().Array();
+    TArray<UPTRINT, TInlineAllocator<16>> SortedEdges;
+    for (URFace* Face : Faces) {
+        SortedEdges.Reset();
+        for (UREdge* Edge : Face->GetEdges())
+            SortedEdges.Add(reinterpret_cast<UPTRINT>(Edge));
+        SortedEdges.Sort();
+        uint32 Hash = GetTypeHash(SortedEdges.Num());
+        for (auto Edge : SortedEdges)
+            Hash = HashCombineFast(Hash, GetTypeHash(Edge));
+
+        // ハッシュが衝突している場合もあるので Edge 集合が一致するものを探す
+        // 同じ Edge 群を持つ Face が先にあれば, そちらにマージする
+        auto& Candidates = FaceMap.FindOrAdd(Hash);
+        auto Dst = Candidates.FindByPredicate([Face](URFace* Candidate) {
+            return Face->IsSameEdges(Candidate);
+        });
+        if (Dst && Face->TryMergeTo(*Dst)) {
+            RemovedFaceCount++;
+            continue;
         }
+        Candidates.Add(Face);
     }
 
     UE_LOG(LogTemp, Log, TEXT("MergeFaces: %d"), RemovedFaceCount);
@@ -5,8 +5,15 @@
 #include "Component/PLATEAUCityObjectGroup.h"
 #include "RoadNetwork/PLATEAURnDef.h"
 #include "RoadNetwork/CityObject/SubDividedCityObject.h"
+#include "RoadNetwork/RGraph/RCompactGraph.h"
 #include "RoadNetwork/RGraph/RGraph.h"
 #include "RoadNetwork/RGraph/RGraphEx.h"
+#include "RoadNetwork/Util/PLATEAURnStageProfiler.h"
+
+DECLARE_STATS_GROUP(TEXT("PLATEAURoadNetwork"), STATGROUP_PLATEAURoadNetwork, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("RGraph.Build"), STAT_RGraph_Build, STATGROUP_PLATEAURoadNetwork);
+DECLARE_CYCLE_STAT(TEXT("RGraph.Optimize"), STAT_RGraph_Optimize, STATGROUP_PLATEAURoadNetwork);
+DECLARE_CYCLE_STAT(TEXT("RGraph.ToGraph"), STAT_RGraph_ToGraph, STATGROUP_PLATEAURoadNetwork);
 
 namespace
 {
@@ -30,151 +37,203 @@ namespace
             return HashCombine(GetTypeHash(Key.V0), GetTypeHash(Key.V1));
         }
     };
-}
-
-RGraphRef_t<URGraph> FRGraphFactoryEx::CreateGraph(const FRGraphFactory& Factory,
-    const TArray<FSubDividedCityObject>& CityObjects)
-{
-    auto Graph = RGraphNew<URGraph>();
-
-    TMap<FVector, RGraphRef_t<URVertex>> VertexMap;
-    TMap<FEdgeKey, RGraphRef_t<UREdge>> EdgeMap;
-    auto OrigVertexCount = 0;
-    auto OrigEdgeCount = 0;
-    for (auto& CityObject : CityObjects) {
-        if (CityObject.CityObjectGroup == nullptr) {
-            continue;
-        }
-
-        auto&& LODLevel = CityObject.CityObjectGroup->MinLOD;
-        auto&& RoadType = CityObject.GetRoadType(true);
-        // transformを適用する
-        auto&& tr = CityObject.CityObjectGroup->GetComponentTransform();
-        for (auto&& mesh : CityObject.Meshes) {
-            auto&& face = RGraphNew<URFace>(Graph, CityObject.CityObjectGroup.Get(), RoadType, LODLevel);
 
-            TArray<RGraphRef_t<URVertex>> vertices;
-            for (auto&& LocalPos : mesh.Vertices) {
-                auto WorldPos = tr.TransformPosition(LocalPos);
+    // 各メッシュについて, 頂点座標(ワールド座標)と辺(頂点インデックスの組)を列挙する
+    template<typename TFunc>
+    void ForEachFace(const FRGraphFactory& Factory, const TArray<FSubDividedCityObject>& CityObjects, TFunc&& Func) {
+        for (auto& CityObject : CityObjects) {
+            if (CityObject.CityObjectGroup == nullptr) {
+                continue;
+            }
 
-                if (VertexMap.Contains(WorldPos) == false) {
-                    VertexMap.Add(WorldPos, RGraphNew<URVertex>(WorldPos));
+            auto&& LODLevel = CityObject.CityObjectGroup->MinLOD;
+            auto&& RoadType = CityObject.GetRoadType(true);
+            // transformを適用する
+            auto&& tr = CityObject.CityObjectGroup->GetComponentTransform();
+            for (auto&& mesh : CityObject.Meshes) {
+                TArray<FVector> vertices;
+                vertices.Reserve(mesh.Vertices.Num());
+                for (auto&& LocalPos : mesh.Vertices) {
+                    vertices.Add(tr.TransformPosition(LocalPos));
                 }
 
-                vertices.Add(VertexMap[WorldPos]);
-            }
-            OrigVertexCount += mesh.Vertices.Num();
-            for (auto&& s : mesh.SubMeshes) {
-                auto AddEdge = [&EdgeMap, &face, &OrigEdgeCount](RGraphRef_t<URVertex> V0, RGraphRef_t<URVertex> V1) {
-
-                    auto key = FEdgeKey(V0, V1);
-                    if (EdgeMap.Contains(key) == false) {
-                        auto Found = false;
-                        for(auto& Pair : EdgeMap)
-                        {
-                            auto K = Pair.Key;
-
-                            if((K.V0 == V0 && K.V1 == V1)
-                                || (K.V0 == V1 && K.V1 == V0))
-                            {
-                                Found = true;
-                                break;
+                TArray<TPair<int32, int32>> edges;
+                for (auto&& s : mesh.SubMeshes) {
+                    if (Factory.bUseCityObjectOutline) {
+                        auto&& indexTable = s.CreateOutlineIndices();
+                        for (auto&& indices : indexTable) {
+                            for (auto&& i = 0; i < indices.Num(); i++) {
+                                edges.Emplace(indices[i], indices[(i + 1) % indices.Num()]);
                             }
                         }
-
-                        if(Found)
-                        {
-                            auto Tmp = 0;
-                        }
-                        EdgeMap.Add(key, RGraphNew<UREdge>(key.V0, key.V1));
                     }
-                    face->AddEdge(EdgeMap[key]);
-                    OrigEdgeCount++;
-                    };
-
-                if (Factory.bUseCityObjectOutline) {
-                    auto&& indexTable = s.CreateOutlineIndices();
-                    for (auto&& indices : indexTable) {
-                        for (auto&& i = 0; i < indices.Num(); i++) {
-                            AddEdge(vertices[indices[i]], vertices[indices[(i + 1) % indices.Num()]]);
+                    else {
+                        for (auto&& i = 0; i < s.Triangles.Num(); i += 3) {
+                            edges.Emplace(s.Triangles[i + 0], s.Triangles[i + 1]);
+                            edges.Emplace(s.Triangles[i + 1], s.Triangles[i + 2]);
+                            edges.Emplace(s.Triangles[i + 2], s.Triangles[i]);
                         }
                     }
                 }
-                else {
-                    for (auto&& i = 0; i < s.Triangles.Num(); i += 3) {
-                        AddEdge(vertices[s.Triangles[i + 0]], vertices[s.Triangles[i + 1]]);
-                        AddEdge(vertices[s.Triangles[i + 1]], vertices[s.Triangles[i + 2]]);
-                        AddEdge(vertices[s.Triangles[i + 2]], vertices[s.Triangles[i]]);
-                    }
-                }
-
+                Func(CityObject, RoadType, LODLevel, vertices, edges);
             }
-            Graph->AddFace(face);
         }
     }
-#if false
-    auto CheckVertices = [&]() {
-        auto Vertices = Graph->GetAllVertices().Array();
-        for (auto i = 0; i < Vertices.Num() - 1; ++i) {
-            auto V1 = Vertices[i];
-            for (auto j = i + 1; j < Vertices.Num(); ++j) {
-                auto V2 = Vertices[j];
-                auto Dist = FVector::Distance(V1->GetPosition(), V2->GetPosition());
-                if (Dist < 1e-3f) {
-                    auto Tmp = 0;
-                }
 
-            }
+    void SetGraphCounter(FPLATEAURnStageProfiler* Profiler, const RGraphRef_t<URGraph>& Graph) {
+        if (!Profiler)
+            return;
+        Profiler->SetCounter([Graph](TArray<TPair<FString, int64>>& Counts) {
+            Counts.Emplace(TEXT("Faces"), Graph->GetFaces().Num());
+            Counts.Emplace(TEXT("Edges"), Graph->GetEdges().Num());
+            Counts.Emplace(TEXT("Vertices"), Graph->GetVertices().Num());
+        });
+    }
+
+    // 面の追加と, 頂点・辺の統合までをUObjectを作らずに行う
+    RGraphRef_t<URGraph> CreateGraphByCompactGraph(const FRGraphFactory& Factory, const TArray<FSubDividedCityObject>& CityObjects, FPLATEAURnStageProfiler* Profiler) {
+        FRCompactGraph Graph;
+        if (Profiler) {
+            Profiler->SetCounter([&Graph](TArray<TPair<FString, int64>>& Counts) {
+                Counts.Emplace(TEXT("Faces"), Graph.GetFaceCount());
+                Counts.Emplace(TEXT("Edges"), Graph.GetEdgeCount());
+                Counts.Emplace(TEXT("Vertices"), Graph.GetVertexCount());
+            });
         }
-    };
-    auto CheckEdge = [&]() {
-        auto Edges = Graph->GetAllEdges().Array();
-        for (auto i = 0; i < Edges.Num() - 1; ++i) {
-            auto E1 = Edges[i];
-            for (auto j = i + 1; j < Edges.Num(); ++j) {
-                auto E2 = Edges[j];
-                if (E1->IsSameVertex(E2)) {
-                    auto Tmp = 0;
+        {
+            SCOPE_CYCLE_COUNTER(STAT_RGraph_Build);
+            FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("Build"));
+            ForEachFace(Factory, CityObjects, [&Graph](const FSubDividedCityObject& CityObject, ERRoadTypeMask RoadType, int32 LODLevel
+                , const TArray<FVector>& Vertices, const TArray<TPair<int32, int32>>& Edges) {
+                Graph.AddFace(CityObject.CityObjectGroup.Get(), RoadType, LODLevel);
+                TArray<int32> vertices;
+                vertices.Reserve(Vertices.Num());
+                for (auto&& Pos : Vertices) {
+                    vertices.Add(Graph.FindOrAddVertex(Pos));
                 }
+                for (auto&& E : Edges) {
+                    Graph.AddFaceEdge(vertices[E.Key], vertices[E.Value]);
+                }
+            });
+        }
+        {
+            SCOPE_CYCLE_COUNTER(STAT_RGraph_Optimize);
+            if (Factory.bOptAdjustSmallLodHeight) {
+                FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("AdjustSmallLodHeight"));
+                Graph.AdjustSmallLodHeight(Factory.MergeCellSize, Factory.RemoveMidPointTolerance);
+            }
+            if (Factory.bOptEdgeReduction) {
+                FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("EdgeReduction"));
+                Graph.EdgeReduction();
+            }
+            if (Factory.bOptVertexReduction) {
+                FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("VertexReduction"));
+                Graph.VertexReduction(Factory.MergeCellSize, Factory.MergeCellLength, Factory.RemoveMidPointTolerance);
             }
         }
-    };
-#endif
-    if (Factory.bOptAdjustSmallLodHeight) {
-        FRGraphEx::AdjustSmallLodHeight(Graph, Factory.MergeCellSize, Factory.MergeCellLength, Factory.RemoveMidPointTolerance);
-    }
-    if (Factory.bOptEdgeReduction) {
-        FRGraphEx::EdgeReduction(Graph);
+        SCOPE_CYCLE_COUNTER(STAT_RGraph_ToGraph);
+        RGraphRef_t<URGraph> Result = nullptr;
+        {
+            FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("ToGraph"));
+            Result = Graph.ToGraph();
+            SetGraphCounter(Profiler, Result);
+        }
+        return Result;
     }
-    if (Factory.bOptVertexReduction) {
-        FRGraphEx::VertexReduction(Graph, Factory.MergeCellSize, Factory.MergeCellLength, Factory.RemoveMidPointTolerance);
+
+    RGraphRef_t<URGraph> CreateGraphByObject(const FRGraphFactory& Factory, const TArray<FSubDividedCityObject>& CityObjects, FPLATEAURnStageProfiler* Profiler) {
+        RGraphRef_t<URGraph> Graph = nullptr;
+        {
+            SCOPE_CYCLE_COUNTER(STAT_RGraph_Build);
+            FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("Build"));
+            Graph = RGraphNew<URGraph>();
+            SetGraphCounter(Profiler, Graph);
+            TMap<FVector, RGraphRef_t<URVertex>> VertexMap;
+            TMap<FEdgeKey, RGraphRef_t<UREdge>> EdgeMap;
+            ForEachFace(Factory, CityObjects, [&](const FSubDividedCityObject& CityObject, ERRoadTypeMask RoadType, int32 LODLevel
+                , const TArray<FVector>& Vertices, const TArray<TPair<int32, int32>>& Edges) {
+                auto&& face = RGraphNew<URFace>(Graph, CityObject.CityObjectGroup.Get(), RoadType, LODLevel);
+
+                TArray<RGraphRef_t<URVertex>> vertices;
+                for (auto&& WorldPos : Vertices) {
+                    if (VertexMap.Contains(WorldPos) == false) {
+                        VertexMap.Add(WorldPos, RGraphNew<URVertex>(WorldPos));
+                    }
+                    vertices.Add(VertexMap[WorldPos]);
+                }
+                for (auto&& E : Edges) {
+                    auto key = FEdgeKey(vertices[E.Key], vertices[E.Value]);
+                    if (EdgeMap.Contains(key) == false) {
+                        EdgeMap.Add(key, RGraphNew<UREdge>(key.V0, key.V1));
+                    }
+                    face->AddEdge(EdgeMap[key]);
+                }
+                Graph->AddFace(face);
+            });
+        }
+
+        SCOPE_CYCLE_COUNTER(STAT_RGraph_Optimize);
+        if (Factory.bOptAdjustSmallLodHeight) {
+            FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("AdjustSmallLodHeight"));
+            FRGraphEx::AdjustSmallLodHeight(Graph, Factory.MergeCellSize, Factory.MergeCellLength, Factory.RemoveMidPointTolerance);
+        }
+        if (Factory.bOptEdgeReduction) {
+            FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("EdgeReduction"));
+            FRGraphEx::EdgeReduction(Graph);
+        }
+        if (Factory.bOptVertexReduction) {
+            FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("VertexReduction"));
+            FRGraphEx::VertexReduction(Graph, Factory.MergeCellSize, Factory.MergeCellLength, Factory.RemoveMidPointTolerance);
+        }
+        return Graph;
     }
+}
+
+RGraphRef_t<URGraph> FRGraphFactoryEx::CreateGraph(const FRGraphFactory& Factory,
+    const TArray<FSubDividedCityObject>& CityObjects, FPLATEAURnStageProfiler* Profiler)
+{
+    auto Graph = Factory.bUseCompactGraph
+        ? CreateGraphByCompactGraph(Factory, CityObjects, Profiler)
+        : CreateGraphByObject(Factory, CityObjects, Profiler);
+    SetGraphCounter(Profiler, Graph);
+
+    SCOPE_CYCLE_COUNTER(STAT_RGraph_Optimize);
     if (Factory.bOptRemoveIsolatedEdgeFromFace) {
+        FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("RemoveIsolatedEdgeFromFace"));
         FRGraphEx::RemoveIsolatedEdgeFromFace(Graph);
     }
     if (Factory.bOptEdgeReduction) {
+        FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("EdgeReduction"));
         FRGraphEx::EdgeReduction(Graph);
     }
     if (Factory.bOptInsertVertexInNearEdge) {
+        FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("InsertVertexInNearEdge"));
         FRGraphEx::InsertVertexInNearEdge(Graph, Factory.RemoveMidPointTolerance);
     }
     if (Factory.bOptEdgeReduction) {
+        FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("EdgeReduction"));
         FRGraphEx::EdgeReduction(Graph);
     }
     if (Factory.bOptSeparateFaces) {
+        FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("SeparateFaces"));
         FRGraphEx::SeparateFaces(Graph);
     }
 
     if (Factory.bOptRemoveIsolatedEdgeFromFace) {
+        FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("RemoveIsolatedEdgeFromFace"));
         FRGraphEx::RemoveIsolatedEdgeFromFace(Graph);
     }
 
     if (Factory.bOptModifySideWalkShape) {
+        FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("ModifySideWalkShape"));
         FRGraphEx::ModifySideWalkShape(Graph);
     }
 
     if(Factory.bFaceReduction) {
+        FPLATEAURnStageProfiler::FScope Stage(Profiler, TEXT("FaceReduction"));
         FRGraphEx::FaceReduction(Graph);
     }
+    if (Profiler)
+        Profiler->SetCounter(nullptr);
     return Graph;
 }
@@ -574,7 +574,19 @@ namespace
                 if (Option.showTrackColor.Contains(Track->TurnType) == false)
                     continue;
                 auto V = Option.showTrackColor[Track->TurnType];
-                FPLATEAURnDebugEx::DrawArrow(Track->FromBorder->GetLerpPoint(0.5f), Track->ToBorder->GetLerpPoint(0.5f), V);
+                if (Track->Curve.IsValid()) {
+                    // 経路の曲線を折れ線にして描画
+                    TArray<FVector> Vertices;
+                    const auto Length = Track->Curve.GetLength();
+                    const auto Num = FMath::Clamp(FMath::CeilToInt32(Length / 100.f), 1, 32);
+                    for (auto i = 0; i < Num; ++i)
+                        Vertices.Add(Track->Curve.GetLocationAtDistance(Length * i / Num));
+                    FPLATEAURnDebugEx::DrawLines(Vertices, false, V);
+                    FPLATEAURnDebugEx::DrawArrow(Vertices.Last(), Track->Curve.GetLocationAtDistance(Length), V);
+                }
+                else {
+                    FPLATEAURnDebugEx::DrawArrow(Track->FromBorder->GetLerpPoint(0.5f), Track->ToBorder->GetLerpPoint(0.5f), V);
+                }
             }
         }
 
@@ -22,28 +22,45 @@ void APLATEAURnStructureModel::Tick(float DeltaTime)
 
 UE::Tasks::TTask<APLATEAURnStructureModel*> APLATEAURnStructureModel::CreateRnModelAsync(APLATEAUInstancedCityModel* TargetActor)
 {
-#if true
-    // 別スレッドで呼び出すとSubDivided周りでアクター生成時にエラーになるので一旦同期タスクにする
-    FRoadNetworkFactoryEx::CreateRnModel(Factory, TargetActor, this);
-    //終了イベント通知
-    OnCreateRnModelFinished.Broadcast();
-    UE::Tasks::TTask<APLATEAURnStructureModel*> CreateRnModelTask = UE::Tasks::Launch(
-        TEXT("CreateRnModelTask")
-        , [this, TargetActor]() {           
-            return this;
+    if (bIsCreatingRnModel) {
+        UE_LOG(LogTemp, Warning, TEXT("CreateRnModelAsync : already creating road network"));
+        return UE::Tasks::MakeCompletedTask<APLATEAURnStructureModel*>(this);
+    }
+
+    bIsCreatingRnModel = true;
+    bCanceled = MakeShared<TAtomic<bool>>(false);
+
+    TWeakObjectPtr<APLATEAURnStructureModel> WeakThis(this);
+    const auto CreateTask = FRoadNetworkFactoryEx::CreateRnModelAsync(Factory, TargetActor, this, bCanceled.ToSharedRef()
+        , [WeakThis](float Progress, const FText& Message) {
+            if (WeakThis.IsValid())
+                WeakThis->OnCreateRnModelProgress.Broadcast(Progress, Message);
         });
-    return CreateRnModelTask;
-#else
-    UE::Tasks::TTask<APLATEAURnStructureModel*> CreateRnModelTask = UE::Tasks::Launch(
+
+    // 生成中に破棄された場合はnullptrを返す
+    return UE::Tasks::Launch(
         TEXT("CreateRnModelTask")
-        , [this, TargetActor]() {
-            FRoadNetworkFactoryEx::CreateRnModel(Factory, TargetActor, this);
-            FFunctionGraphTask::CreateAndDispatchWhenReady([&]() {
-                //終了イベント通知
-                OnCreateRnModelFinished.Broadcast();
-                }, TStatId(), NULL, ENamedThreads::GameThread);
-            return this;
-        });
-    return CreateRnModelTask;
-#endif
-}
\ No newline at end of file
+        , [WeakThis]() -> APLATEAURnStructureModel* {
+            const auto This = WeakThis.Get();
+            if (!This)
+                return nullptr;
+            This->bIsCreatingRnModel = false;
+            //終了イベント通知
+            This->OnCreateRnModelFinished.Broadcast();
+            return This;
+        }
+        , UE::Tasks::Prerequisites(CreateTask)
+        , UE::Tasks::ETaskPriority::Normal
+        , UE::Tasks::EExtendedTaskPriority::GameThreadNormalPri);
+}
+
+void APLATEAURnStructureModel::CancelCreateRnModel()
+{
+    if (bCanceled)
+        bCanceled->Store(true, EMemoryOrder::Relaxed);
+}
+
+bool APLATEAURnStructureModel::IsCreatingRnModel() const
+{
+    return bIsCreatingRnModel;
+}
@@ -20,6 +20,8 @@ bool FRnTurnTypeUtil::IsRight(ERnTurnType TurnType) {
 #include "RoadNetwork/Structure/RnLane.h"
 #include "RoadNetwork/Structure/RnTrackBuilder.h"
 #include "RoadNetwork/Util/PLATEAUVectorEx.h"
+#include "RoadNetwork/Util/PLATEAUHermiteSpline.h"
+#include "Components/SplineComponent.h"
 
 
 
@@ -138,6 +140,23 @@ ERnFlowTypeMask URnIntersectionEdge::GetFlowType() const
     return ERnFlowTypeMask::Empty;
 }
 
+FRnTrackCurve::FRnTrackCurve(const TArray<FVector>& InPoints, const TArray<FVector>& InTangents) {
+    const FPLATEAUHermiteSpline Spline(InPoints, InTangents);
+    Points = Spline.GetPoints();
+    Tangents = Spline.GetTangents();
+    ReparamDistances = Spline.GetReparamDistances();
+    ReparamParams = Spline.GetReparamParams();
+}
+
+float FRnTrackCurve::GetLength() const {
+    return ReparamDistances.Num() > 0 ? ReparamDistances.Last() : 0.f;
+}
+
+FVector FRnTrackCurve::GetLocationAtDistance(float Distance) const {
+    const auto Param = FPLATEAUHermiteSpline::EvalParamAtDistance(ReparamDistances, ReparamParams, Distance);
+    return FPLATEAUHermiteSpline::EvalLocationAtParam(Points, Tangents, Param);
+}
+
 URnTrack::URnTrack()
     : FromBorder(nullptr)
     , ToBorder(nullptr)
@@ -167,6 +186,23 @@ bool URnTrack::IsSameInOutWithTrack(const URnTrack* Other) const {
     return false;
 }
 
+USplineComponent* URnTrack::GetOrCreateSpline() {
+    if (Spline || !Curve.IsValid())
+        return Spline;
+
+    // 全ての点をCIM_CurveUserにするとFPLATEAUHermiteSplineと同じ補間になる
+    Spline = NewObject<USplineComponent>(this);
+    Spline->ClearSplinePoints(false);
+    for (const auto& Point : Curve.Points)
+        Spline->AddSplinePoint(Point, ESplineCoordinateSpace::World, false);
+    for (auto i = 0; i < Curve.Points.Num(); ++i) {
+        Spline->SetSplinePointType(i, ESplinePointType::Curve, false);
+        Spline->SetTangentAtSplinePoint(i, Curve.Tangents[i], ESplineCoordinateSpace::World, false);
+    }
+    Spline->UpdateSpline();
+    return Spline;
+}
+
 bool URnTrack::ContainsBorder(const URnWay* Way) const {
     if (FromBorder && ToBorder && Way) {
         return FromBorder->IsSameLineReference(Way) || ToBorder->IsSameLineReference(Way);
@@ -555,9 +591,10 @@ FVector FRnIntersectionEx::FEdgeGroup::GetNormal() const
     return FVector::ZeroVector;
 }
 
-TArray<FRnIntersectionEx::FEdgeGroup> FRnIntersectionEx::CreateEdgeGroup(TRnRef_T<URnIntersection> Intersection)
+TArray<FRnIntersectionEx::FEdgeGroup> FRnIntersectionEx::CreateEdgeGroup(TRnRef_T<URnIntersection> Intersection, bool bAlign)
 {
-    Intersection->Align();
+    if (bAlign)
+        Intersection->Align();
     auto CopiedEdges = Intersection->GetEdges();
     auto Groups = FPLATEAURnEx::GroupByOutlineEdges<TRnRef_T<URnRoadBase>, TRnRef_T<URnIntersectionEdge>>(
         CopiedEdges
@@ -57,6 +57,129 @@ namespace
     {
         return FGeoGraphEx::IsCollinear(A->GetVertex(), B->GetVertex(), C->GetVertex(), DegEpsilon, MidPointTolerance);
     }
+
+    // 以下はURnPoint列と頂点配列で同じ計算をするための実装. GetVertex(i)でi番目の頂点を取得する
+
+    template<class TGetVertex>
+    void GetNearestPointImpl(int32 Num, const TGetVertex& GetVertex, const FVector& Pos, FVector& OutNearest, float& OutPointIndex, float& OutDistance)
+    {
+        OutDistance = MAX_FLT;
+        OutPointIndex = 0;
+
+        for (int32 i = 0; i < Num - 1; ++i) {
+            const FVector Start = GetVertex(i);
+            const FVector End = GetVertex(i + 1);
+            const FVector ProjectedPoint = FMath::ClosestPointOnSegment(Pos, Start, End);
+
+            auto Diff = (End - Start).Size();
+            if (Diff < 1e-8f)
+                continue;
+
+            const float Distance = (Pos - ProjectedPoint).Size();
+            if (Distance < OutDistance) {
+                OutDistance = Distance;
+                OutNearest = ProjectedPoint;
+                auto Offset = (ProjectedPoint - Start);
+                OutPointIndex = i + Offset.Size() / Diff;
+            }
+        }
+    }
+
+    template<class TGetVertex>
+    float CalcLengthImpl(int32 Num, const TGetVertex& GetVertex, float StartPointIndex, float EndPointIndex)
+    {
+        // Determine the starting and ending indices, clamped to valid range.
+        int32 stI = FMath::Max(0, FMath::FloorToInt(StartPointIndex));
+        int32 enI = FMath::Min(Num - 1, FMath::FloorToInt(EndPointIndex));
+
+        // If the starting index is the last, there's no segment.
+        if (stI >= Num - 1) {
+            return 0.f;
+        }
+
+        float t = StartPointIndex - stI;
+        // Linearly interpolate between the two points.
+        FVector last = FMath::Lerp(GetVertex(stI), GetVertex(stI + 1), t);
+        float ret = 0.f;
+        // Sum lengths for full segments between stI+1 and enI.
+        for (int32 i = stI + 1; i <= enI; ++i) {
+            ret += (GetVertex(i) - last).Size();
+            last = GetVertex(i);
+        }
+        // If the end index is not the last point, add the partial segment.
+        if (enI < Num - 1) {
+            float t2 = EndPointIndex - enI;
+            ret += (FMath::Lerp(GetVertex(enI), GetVertex(enI + 1), t2) - last).Size();
+        }
+        return ret;
+    }
+
+    template<class TGetVertex>
+    FVector GetAdvancedPointImpl(int32 Num, const TGetVertex& GetVertex, float Offset, bool bReverse, int32& OutStartIndex, int32& OutEndIndex)
+    {
+        if (Num == 0) {
+            OutStartIndex = OutEndIndex = -1;
+            return FVector::ZeroVector;
+        }
+
+        int32 Delta = bReverse ? -1 : 1;
+        int32 BeginIndex = bReverse ? Num - 1 : 0;
+
+        int32 Index = BeginIndex;
+        for (int32 i = 0; i < Num - 1; ++i) {
+            int32 NextIndex = Index + Delta;
+            FVector P0 = GetVertex(Index);
+            FVector P1 = GetVertex(NextIndex);
+            float Len = (P0 - P1).Size();
+
+            if (Len >= Offset) {
+                OutStartIndex = Index;
+                OutEndIndex = Index + Delta;
+                return P0 + (P1 - P0).GetSafeNormal() * Offset;
+            }
+
+            Offset -= Len;
+            Index = NextIndex;
+        }
+
+        OutStartIndex = OutEndIndex = Num - 1 - BeginIndex;
+        return GetVertex(OutEndIndex);
+    }
+
+    template<class TGetVertex>
+    bool TryGetNearestIntersectionBy2DImpl(int32 Num, const TGetVertex& GetVertex, const FRay& Ray, TTuple<float, FVector>& Res, EAxisPlane Plane)
+    {
+        // 交点のうちRayの始点に一番近いもの(同じ距離なら先に見つかったもの)
+        auto MinSqrDistance = -1.f;
+        for (auto i = 0; i < Num - 1; ++i) {
+            const FLineSegment3D E(GetVertex(i), GetVertex(i + 1));
+            FVector P;
+            float LineLength;
+            float SegmentT;
+            if (E.TryLineIntersectionBy2D(Ray.Origin, Ray.Direction, Plane, -1.f, P, LineLength, SegmentT) == false)
+                continue;
+
+            const auto SqrDistance = (P - Ray.Origin).SizeSquared();
+            if (MinSqrDistance < 0.f || SqrDistance < MinSqrDistance) {
+                MinSqrDistance = SqrDistance;
+                Res = MakeTuple(i + SegmentT, P);
+            }
+        }
+        return MinSqrDistance >= 0.f;
+    }
+
+    template<class TGetVertexA, class TGetVertexB>
+    float GetDistance2DImpl(int32 NumA, const TGetVertexA& GetVertexA, int32 NumB, const TGetVertexB& GetVertexB, EAxisPlane Plane)
+    {
+        float MinDistance = MAX_FLT;
+        for (auto i = 0; i < NumA - 1; ++i) {
+            const auto S1 = FLineSegment3D(GetVertexA(i), GetVertexA(i + 1)).To2D(Plane);
+            for (auto j = 0; j < NumB - 1; ++j) {
+                MinDistance = FMath::Min(MinDistance, S1.GetDistance(FLineSegment3D(GetVertexB(j), GetVertexB(j + 1)).To2D(Plane)));
+            }
+        }
+        return MinDistance;
+    }
 }
 
 void URnLineString::AddPointOrSkip(TRnRef_T<URnPoint> Point, float DistanceEpsilon, float DegEpsilon, float MidPointTolerance) {
@@ -73,6 +196,17 @@ void URnLineString::AddPointOrSkip(TRnRef_T<URnPoint> Point, float DistanceEpsil
     Points.Add(Point);
 }
 
+void URnLineString::AddVertexOrSkip(TArray<FVector>& Vertices, const FVector& Vertex, float DistanceEpsilon, float DegEpsilon, float MidPointTolerance) {
+    if (Vertices.Num() > 0 && DistanceEpsilon >= 0 && (Vertices.Last() - Vertex).SizeSquared() <= DistanceEpsilon * DistanceEpsilon)
+        return;
+
+    if (Vertices.Num() > 1 && FGeoGraphEx::IsCollinear(Vertices[Vertices.Num() - 2], Vertices[Vertices.Num() - 1], Vertex, DegEpsilon, MidPointTolerance)) {
+        Vertices.RemoveAt(Vertices.Num() - 1);
+    }
+
+    Vertices.Add(Vertex);
+}
+
 void URnLineString::AddPointFrontOrSkip(TRnRef_T<URnPoint> Point, float DistanceEpsilon, float DegEpsilon, float MidPointTolerance) {
     if (!Point) return;
 
@@ -238,30 +372,12 @@ void URnLineString::AddFrontPoint(TRnRef_T<URnPoint> Point) {
 
 float URnLineString::CalcLength(float StartPointIndex, float EndPointIndex) const
 {
-    // Determine the starting and ending indices, clamped to valid range.
-    int32 stI = FMath::Max(0, FMath::FloorToInt(StartPointIndex));
-    int32 enI = FMath::Min(Count() - 1, FMath::FloorToInt(EndPointIndex));
-
-    // If the starting index is the last, there's no segment.
-    if (stI >= Count() - 1) {
-        return 0.f;
-    }
+    return CalcLengthImpl(Count(), [this](int32 i) { return (*this)[i]; }, StartPointIndex, EndPointIndex);
+}
 
-    float t = StartPointIndex - stI;
-    // Linearly interpolate between the two points.
-    FVector last = FMath::Lerp((*this)[stI], (*this)[stI + 1], t);
-    float ret = 0.f;
-    // Sum lengths for full segments between stI+1 and enI.
-    for (int32 i = stI + 1; i <= enI; ++i) {
-        ret += ((*this)[i] - last).Size();
-        last = (*this)[i];
-    }
-    // If the end index is not the last point, add the partial segment.
-    if (enI < Count() - 1) {
-        float t2 = EndPointIndex - enI;
-        ret += (FMath::Lerp((*this)[enI], (*this)[enI + 1], t2) - last).Size();
-    }
-    return ret;
+float URnLineString::CalcLength(TConstArrayView<FVector> Vertices, float StartPointIndex, float EndPointIndex)
+{
+    return CalcLengthImpl(Vertices.Num(), [Vertices](int32 i) { return Vertices[i]; }, StartPointIndex, EndPointIndex);
 }
 
 float URnLineString::CalcTotalAngle2D() const {
@@ -290,7 +406,7 @@ TArray<FLineSegment2D> URnLineString::GetEdges2D(EAxisPlane axis) const
     for (auto It = Edges.begin(); It != Edges.end(); ++It) 
     {
         const auto e = *It;
-        Ret.Add(FLineSegment3D(e.P0->Vertex, e.P0->Vertex).To2D(axis));
+        Ret.Add(FLineSegment3D(e.P0->Vertex, e.P1->Vertex).To2D(axis));
     }
     return Ret;
 }
@@ -312,44 +428,23 @@ bool URnLineString::Contains(TRnRef_T<URnPoint> Point) const {
 }
 
 void URnLineString::GetNearestPoint(const FVector& Pos, FVector& OutNearest, float& OutPointIndex, float& OutDistance) const {
-    OutDistance = MAX_FLT;
-    OutPointIndex = 0;
-
-    for (int32 i = 0; i < Points.Num() - 1; ++i) {
-        const FVector Start = GetVertex(i);
-        const FVector End = GetVertex(i+1);
-        const FVector ProjectedPoint = FMath::ClosestPointOnSegment(Pos, Start, End);
-
-
-        auto Diff = (End - Start).Size();
-        if (Diff < 1e-8f)
-            continue;
-
-        const float Distance = (Pos - ProjectedPoint).Size();
-        if (Distance < OutDistance) {
+    GetNearestPointImpl(Count(), [this](int32 i) { return (*this)[i]; }, Pos, OutNearest, OutPointIndex, OutDistance);
+}
 
-            OutDistance = Distance;
-            OutNearest = ProjectedPoint;
-            auto Offset = (ProjectedPoint - Start);
-            OutPointIndex = i + Offset.Size() / Diff;
-        }
-    }
+void URnLineString::GetNearestPoint(TConstArrayView<FVector> Vertices, const FVector& Pos, FVector& OutNearest, float& OutPointIndex, float& OutDistance) {
+    GetNearestPointImpl(Vertices.Num(), [Vertices](int32 i) { return Vertices[i]; }, Pos, OutNearest, OutPointIndex, OutDistance);
 }
 
 float URnLineString::GetDistance2D(const TRnRef_T<URnLineString> Other, EAxisPlane Plane) const {
     if (!Other || !IsValid() || !Other->IsValid()) return MAX_FLT;
 
-    float MinDistance = MAX_FLT;
-    auto SelfEdges = GetEdges2D(Plane);
-    auto OtherEdges = Other->GetEdges2D(Plane);
-    for (auto& s1 : SelfEdges) 
-    {
-        for (auto& s2 : OtherEdges) {
-            MinDistance = FMath::Min(MinDistance, s1.GetDistance(s2));
-        }
-    }
+    return GetDistance2DImpl(Count(), [this](int32 i) { return (*this)[i]; }, Other->Count(), [Other](int32 i) { return (*Other)[i]; }, Plane);
+}
 
-    return MinDistance;
+float URnLineString::GetDistance2D(TConstArrayView<FVector> Vertices, TConstArrayView<FVector> OtherVertices, EAxisPlane Plane) {
+    if (Vertices.Num() < 2 || OtherVertices.Num() < 2) return MAX_FLT;
+
+    return GetDistance2DImpl(Vertices.Num(), [Vertices](int32 i) { return Vertices[i]; }, OtherVertices.Num(), [OtherVertices](int32 i) { return OtherVertices[i]; }, Plane);
 }
 
 FVector URnLineString::GetVertexNormal(int32 VertexIndex) const {
@@ -422,33 +517,12 @@ FVector URnLineString::GetAdvancedPointFromBack(float Offset, int32& OutStartInd
 
 FVector URnLineString::GetAdvancedPoint(float Offset, bool bReverse, int32& OutStartIndex, int32& OutEndIndex) const
 {
-    if (Count() == 0) {
-        OutStartIndex = OutEndIndex = -1;
-        return FVector::ZeroVector;
-    }
-
-    int32 Delta = bReverse ? -1 : 1;
-    int32 BeginIndex = bReverse ? Count() - 1 : 0;
-
-    int32 Index = BeginIndex;
-    for (int32 i = 0; i < Count() - 1; ++i) {
-        int32 NextIndex = Index + Delta;
-        FVector P0 = (*this)[Index];
-        FVector P1 = (*this)[NextIndex];
-        float Len = (P0 - P1).Size();
-
-        if (Len >= Offset) {
-            OutStartIndex = Index;
-            OutEndIndex = Index + Delta;
-            return P0 + (P1 - P0).GetSafeNormal() * Offset;
-        }
-
-        Offset -= Len;
-        Index = NextIndex;
-    }
+    return GetAdvancedPointImpl(Count(), [this](int32 i) { return (*this)[i]; }, Offset, bReverse, OutStartIndex, OutEndIndex);
+}
 
-    OutStartIndex = OutEndIndex = Count() - 1 - BeginIndex;
-    return (*this)[OutEndIndex];
+FVector URnLineString::GetAdvancedPoint(TConstArrayView<FVector> Vertices, float Offset, bool bReverse, int32& OutStartIndex, int32& OutEndIndex)
+{
+    return GetAdvancedPointImpl(Vertices.Num(), [Vertices](int32 i) { return Vertices[i]; }, Offset, bReverse, OutStartIndex, OutEndIndex);
 }
 
 TArray<TTuple<float, FVector>> URnLineString::GetIntersectionBy2D(
@@ -491,18 +565,12 @@ TArray<TTuple<float, FVector>> URnLineString::GetIntersectionBy2D(const FRay& Ra
 
 bool URnLineString::TryGetNearestIntersectionBy2D(const FRay& Ray, TTuple<float, FVector>& Res,
                                                   EAxisPlane Plane) const {
-    auto ret = GetIntersectionBy2D(Ray, Plane);
-    if (ret.IsEmpty()) {
-        return false;
-    }
-    return FPLATEAURnLinq::TryFindMinElement<TTuple<float, FVector>>(
-        ret,
-        [&](const TTuple<float, FVector>& X, const TTuple<float, FVector>& Y) {
-            auto A = (X.Value - Ray.Origin).SizeSquared();
-            auto B = (Y.Value - Ray.Origin).SizeSquared();
-            return A < B;
-        }
-    , Res);
+    return TryGetNearestIntersectionBy2DImpl(Count(), [this](int32 i) { return (*this)[i]; }, Ray, Res, Plane);
+}
+
+bool URnLineString::TryGetNearestIntersectionBy2D(TConstArrayView<FVector> Vertices, const FRay& Ray, TTuple<float, FVector>& Res,
+                                                  EAxisPlane Plane) {
+    return TryGetNearestIntersectionBy2DImpl(Vertices.Num(), [Vertices](int32 i) { return Vertices[i]; }, Ray, Res, Plane);
 }
 
 TOptional<float> URnLineString::CalcProximityScore(const URnLineString* Other) const
@@ -5,12 +5,18 @@
 #include "Algo/AllOf.h"
 #include "Algo/AnyOf.h"
 #include "Algo/Count.h"
+#include "Async/ParallelFor.h"
+#include "RoadNetwork/Structure/RnModelCloner.h"
+#include "RoadNetwork/Structure/RnModelSerializer.h"
 #include "RoadNetwork/Structure/RnRoad.h"
 #include "RoadNetwork/Structure/RnIntersection.h"
 #include "RoadNetwork/Structure/RnSideWalk.h"
 #include "RoadNetwork/Structure/RnLane.h"
+#include "RoadNetwork/Structure/RnLineString.h"
 #include "RoadNetwork/Structure/RnRoadGroup.h"
 #include "RoadNetwork/Structure/RnWay.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/Package.h"
 
 const FString& URnModel::GetFactoryVersion() const
 {
@@ -30,6 +36,9 @@ void URnModel::Init()
     Roads.Reset();
     Intersections.Reset();
     SideWalks.Reset();
+    TargetTranIndex.Reset();
+    AddedOrders.Reset();
+    NextAddedOrder = 0;
 }
 
 void URnModel::AddRoadBase(const TRnRef_T<URnRoadBase>& RoadBase)
@@ -47,35 +56,55 @@ void URnModel::AddRoadBase(const TRnRef_T<URnRoadBase>& RoadBase)
 void URnModel::AddRoad(const TRnRef_T<URnRoad>& Road) {
     if (!Road) return;
     Road->SetParentModel(TRnRef_T<URnModel>(this));
+    const auto OldNum = Roads.Num();
     Roads.AddUnique(Road);
+    if (Roads.Num() != OldNum) {
+        AddedOrders.Add(Road, NextAddedOrder++);
+        AddToTargetTranIndex(Road);
+    }
 }
 
 void URnModel::RemoveRoad(const TRnRef_T<URnRoad>& Road) {
     if (!Road) return;
     Road->SetParentModel(nullptr);
-    Roads.Remove(Road);
+    if (Roads.Remove(Road) > 0) {
+        AddedOrders.Remove(Road);
+        RemoveFromTargetTranIndex(Road);
+    }
 }
 
 void URnModel::AddIntersection(const TRnRef_T<URnIntersection>& Intersection) {
     if (!Intersection) return;
     Intersection->SetParentModel(TRnRef_T<URnModel>(this));
+    const auto OldNum = Intersections.Num();
     Intersections.AddUnique(Intersection);
+    if (Intersections.Num() != OldNum) {
+        AddedOrders.Add(Intersection, NextAddedOrder++);
+        AddToTargetTranIndex(Intersection);
+    }
 }
 
 void URnModel::RemoveIntersection(const TRnRef_T<URnIntersection>& Intersection) {
     if (!Intersection) return;
     Intersection->SetParentModel(nullptr);
-    Intersections.Remove(Intersection);
+    if (Intersections.Remove(Intersection) > 0) {
+        AddedOrders.Remove(Intersection);
+        RemoveFromTargetTranIndex(Intersection);
+    }
 }
 
 void URnModel::AddSideWalk(const TRnRef_T<URnSideWalk>& SideWalk) {
     if (!SideWalk) return;
+    const auto OldNum = SideWalks.Num();
     SideWalks.AddUnique(SideWalk);
+    if (SideWalks.Num() != OldNum)
+        AddedOrders.Add(SideWalk, NextAddedOrder++);
 }
 
 void URnModel::RemoveSideWalk(const TRnRef_T<URnSideWalk>& SideWalk) {
     if (!SideWalk) return;
-    SideWalks.Remove(SideWalk);
+    if (SideWalks.Remove(SideWalk) > 0)
+        AddedOrders.Remove(SideWalk);
 }
 
 const TArray<TRnRef_T<URnRoad>>& URnModel::GetRoads() const {
@@ -90,37 +119,58 @@ const TArray<TRnRef_T<URnSideWalk>>& URnModel::GetSideWalks() const {
     return SideWalks;
 }
 
-TRnRef_T<URnRoad> URnModel::GetRoadBy(UPLATEAUCityObjectGroup* TargetTran) const {
+URnRoadBase* URnModel::FindRoadBaseBy(UPLATEAUCityObjectGroup* TargetTran, TFunctionRef<bool(URnRoadBase*)> Filter) const {
     if (!TargetTran) return nullptr;
 
-    for (const auto& Road : Roads) {
-        if (Road->GetTargetTrans().Contains(TargetTran)) {
-            return Road;
-        }
+    const auto* Candidates = TargetTranIndex.Find(TObjectKey<UPLATEAUCityObjectGroup>(TargetTran));
+    if (!Candidates) return nullptr;
+
+    URnRoadBase* Result = nullptr;
+    auto ResultOrder = MAX_int64;
+    for (auto* RoadBase : *Candidates) {
+        // モデルから削除されたもの/後から追加されたものは除外
+        const auto* Order = AddedOrders.Find(RoadBase);
+        if (!Order || *Order >= ResultOrder)
+            continue;
+        if (!Filter(RoadBase) || !RoadBase->GetTargetTrans().Contains(TargetTran))
+            continue;
+        Result = RoadBase;
+        ResultOrder = *Order;
     }
-    return nullptr;
+    return Result;
 }
 
-TRnRef_T<URnIntersection> URnModel::GetIntersectionBy(UPLATEAUCityObjectGroup* TargetTran) const {
-    if (!TargetTran) return nullptr;
+TRnRef_T<URnRoad> URnModel::GetRoadBy(UPLATEAUCityObjectGroup* TargetTran) const {
+    auto RoadBase = FindRoadBaseBy(TargetTran, [](URnRoadBase* X) { return X->CastToRoad() != nullptr; });
+    return RoadBase ? RoadBase->CastToRoad() : nullptr;
+}
 
-    for (const auto& Intersection : Intersections) {
-        if (Intersection->GetTargetTrans().Contains(TargetTran)) {
-            return Intersection;
-        }
-    }
-    return nullptr;
+TRnRef_T<URnIntersection> URnModel::GetIntersectionBy(UPLATEAUCityObjectGroup* TargetTran) const {
+    auto RoadBase = FindRoadBaseBy(TargetTran, [](URnRoadBase* X) { return X->CastToIntersection() != nullptr; });
+    return RoadBase ? RoadBase->CastToIntersection() : nullptr;
 }
 
 TRnRef_T<URnSideWalk> URnModel::GetSideWalkBy(UPLATEAUCityObjectGroup* TargetTran) const {
     if (!TargetTran) return nullptr;
 
-    for (const auto& SideWalk : SideWalks) {
-        if (SideWalk->GetParentRoad() && SideWalk->GetParentRoad()->GetTargetTrans().Contains(TargetTran)) {
-            return SideWalk;
+    const auto* Candidates = TargetTranIndex.Find(TObjectKey<UPLATEAUCityObjectGroup>(TargetTran));
+    if (!Candidates) return nullptr;
+
+    // 歩道の親はこのモデルに登録されている道路/交差点のみを対象とする
+    URnSideWalk* Result = nullptr;
+    auto ResultOrder = MAX_int64;
+    for (auto* RoadBase : *Candidates) {
+        if (!AddedOrders.Contains(RoadBase) || !RoadBase->GetTargetTrans().Contains(TargetTran))
+            continue;
+        for (auto* SideWalk : RoadBase->GetSideWalks()) {
+            const auto* Order = AddedOrders.Find(SideWalk);
+            if (!Order || *Order >= ResultOrder || SideWalk->GetParentRoad() != RoadBase)
+                continue;
+            Result = SideWalk;
+            ResultOrder = *Order;
         }
     }
-    return nullptr;
+    return Result;
 }
 
 TRnRef_T<URnRoadBase> URnModel::GetRoadBaseBy(UPLATEAUCityObjectGroup* TargetTran) const {
@@ -166,11 +216,20 @@ void URnModel::CalibrateIntersectionBorderForAllRoad(const FRnModelCalibrateInte
     TSet<URnRoad*> Nexts;
 
     TArray<URnRoad*> RnRoads = GetRoads();
-    for (URnRoad* Road : RnRoads) {
+
+    // 切断線の計算は道路ごとに独立しているので並列に行う
+    TArray<FRoadSlicePlan> Plans;
+    Plans.SetNum(RnRoads.Num());
+    ParallelFor(RnRoads.Num(), [&](int32 Index) {
+        Plans[Index] = PlanSliceRoadHorizontalNearByBorder(RnRoads[Index], Option);
+    });
+
+    // 切断は隣接する交差点/歩道を書き換えるので, 結果が変わらないように道路の順番に行う
+    for (auto i = 0; i < RnRoads.Num(); ++i) {
         URnRoad* Prev = nullptr;
         URnRoad* Center = nullptr;
         URnRoad* Next = nullptr;
-        TrySliceRoadHorizontalNearByBorder(Road, Option, Prev, Center, Next);
+        ApplySliceRoadHorizontalNearByBorder(RnRoads[i], Plans[i], Prev, Center, Next);
         // 失敗してもPrev or Nextどっちかは成功しているかもしれないので結果は見ない
         if (Prev) {
             Prevs.Add(Prev);
@@ -199,58 +258,76 @@ bool URnModel::TrySliceRoadHorizontalNearByBorder(
     URnRoad*& OutPrevSideRoad,
     URnRoad*& OutCenterSideRoad,
     URnRoad*& OutNextSideRoad) {
-    OutPrevSideRoad = nullptr;
-    OutNextSideRoad = nullptr;
-    OutCenterSideRoad = Road;
+    return ApplySliceRoadHorizontalNearByBorder(Road, PlanSliceRoadHorizontalNearByBorder(Road, Option), OutPrevSideRoad, OutCenterSideRoad, OutNextSideRoad);
+}
+
+URnModel::FRoadSlicePlan URnModel::PlanSliceRoadHorizontalNearByBorder(
+    const URnRoad* Road,
+    const FRnModelCalibrateIntersectionBorderOption& Option) {
+    FRoadSlicePlan Plan;
 
     if (!Road->IsValid()) {
-        return false;
+        return Plan;
     }
 
     if (!Road->IsAllLaneValid()) {
-        return false;
+        return Plan;
     }
 
-    URnWay* LeftWay = nullptr;
-    URnWay* RightWay = nullptr;
-    Road->TryGetMergedSideWay(NullOpt, LeftWay, RightWay);
+    TArray<FVector> LeftVertices;
+    TArray<FVector> RightVertices;
+    Road->TryGetMergedSideVertices(NullOpt, LeftVertices, RightVertices);
 
-    const float MinLength = FMath::Min(LeftWay->CalcLength(), RightWay->CalcLength());
+    const float MinLength = FMath::Min(
+        URnLineString::CalcLength(LeftVertices, 0, LeftVertices.Num() - 1),
+        URnLineString::CalcLength(RightVertices, 0, RightVertices.Num() - 1));
     const float MaxOffset = Option.MaxOffsetMeter * FPLATEAURnDef::Meter2Unit;
     const float NeedRoadLengthMeter = Option.NeedRoadLengthMeter * FPLATEAURnDef::Meter2Unit;
     if (MinLength < MaxOffset) {
-        return false;
+        return Plan;
     }
-    struct FNeighborInfo {
-        URnIntersection* Intersection;
-        EPLATEAURnLaneBorderType BorderType;
-    };
-  
-    struct SideInfo {
-        URnRoad* FarSide = nullptr;
-        URnRoad* NearSide = nullptr;
-    };
 
-    TArray<FNeighborInfo> Neighbors;
-    for (EPLATEAURnLaneBorderType BorderType : {EPLATEAURnLaneBorderType::Prev, EPLATEAURnLaneBorderType::Next}) {
-        if (URnIntersection* Intersection = Cast<URnIntersection>(Road->GetNeighborRoad(BorderType))) {
-            Neighbors.Add({ Intersection, BorderType });
-        }
+    Plan.bNextIntersection = Cast<URnIntersection>(Road->GetNext()) != nullptr;
+    Plan.bPrevIntersection = Cast<URnIntersection>(Road->GetPrev()) != nullptr;
+    const auto NeighborNum = (Plan.bNextIntersection ? 1 : 0) + (Plan.bPrevIntersection ? 1 : 0);
+    if (NeighborNum == 0) {
+        return Plan;
     }
+    Plan.bTarget = true;
 
-    if (Neighbors.Num() == 0) {
-        return false;
+    const float OffsetLength = FMath::Max(1.0f,
+        FMath::Min(MaxOffset, (MinLength - NeedRoadLengthMeter) / NeighborNum));
+
+    // Prev側もNext側で切断する前の道路で計算する. 切断線は境界線からOffsetLength程度の位置なので,
+    // 反対側を切断しても(道路がNeedRoadLengthMeter以上残る限り)ほぼ同じ位置になる
+    FLineSegment3D Segment;
+    if (Plan.bNextIntersection && Road->TryGetVerticalSliceSegment(EPLATEAURnLaneBorderType::Next, OffsetLength, Segment)) {
+        Plan.NextSegment = Segment;
     }
+    if (Plan.bPrevIntersection && Road->TryGetVerticalSliceSegment(EPLATEAURnLaneBorderType::Prev, OffsetLength, Segment)) {
+        Plan.PrevSegment = Segment;
+    }
+    return Plan;
+}
 
-    const float OffsetLength = FMath::Max(1.0f,
-        FMath::Min(MaxOffset, (MinLength - NeedRoadLengthMeter) / Neighbors.Num()));
+bool URnModel::ApplySliceRoadHorizontalNearByBorder(
+    URnRoad* Road,
+    const FRoadSlicePlan& Plan,
+    URnRoad*& OutPrevSideRoad,
+    URnRoad*& OutCenterSideRoad,
+    URnRoad*& OutNextSideRoad) {
+    OutPrevSideRoad = nullptr;
+    OutNextSideRoad = nullptr;
+    OutCenterSideRoad = Road;
 
-    auto Success = true;
-    if (URnIntersection* NextIntersection = Cast<URnIntersection>(Road->GetNext())) {
-        FLineSegment3D Segment;
+    if (!Plan.bTarget) {
+        return false;
+    }
 
-        if (Road->TryGetVerticalSliceSegment(EPLATEAURnLaneBorderType::Next, OffsetLength, Segment)) {
-            FSliceRoadHorizontalResult Result = SliceRoadHorizontal(Road, Segment);
+    auto Success = true;
+    if (Plan.bNextIntersection) {
+        if (Plan.NextSegment.IsSet()) {
+            FSliceRoadHorizontalResult Result = SliceRoadHorizontal(Road, *Plan.NextSegment);
             if (Result.Result == ERoadCutResult::Success) {
                 OutCenterSideRoad = Result.PrevRoad;
                 OutNextSideRoad = Result.NextRoad;
@@ -265,10 +342,9 @@ bool URnModel::TrySliceRoadHorizontalNearByBorder(
         }
     }
 
-    if (URnIntersection* PrevIntersection = Cast<URnIntersection>(Road->GetPrev())) {
-        FLineSegment3D Segment;
-        if (Road->TryGetVerticalSliceSegment(EPLATEAURnLaneBorderType::Prev, OffsetLength, Segment)) {
-            FSliceRoadHorizontalResult Result = SliceRoadHorizontal(Road, Segment);
+    if (Plan.bPrevIntersection) {
+        if (Plan.PrevSegment.IsSet()) {
+            FSliceRoadHorizontalResult Result = SliceRoadHorizontal(Road, *Plan.PrevSegment);
             if (Result.Result == ERoadCutResult::Success) {
                 OutCenterSideRoad = Result.NextRoad;
                 OutPrevSideRoad = Result.PrevRoad;
@@ -290,6 +366,11 @@ TRnRef_T<URnModel> URnModel::Create() {
     return RnNew<URnModel>();
 }
 
+TRnRef_T<URnModel> URnModel::Clone() const {
+    FRnModelCloner Cloner;
+    return Cloner.Clone(this);
+}
+
 TArray<TRnRef_T<URnRoadBase>> URnModel::GetConnectedRoadBases(const TRnRef_T<URnRoadBase>& RoadBase) const {
     return GetNeighborRoadBases(RoadBase);
 }
@@ -349,12 +430,67 @@ void URnModel::MergeRoadGroup()
     }
 }
 
+namespace
+{
+    // 道路グループごとのレーン分割の計画
+    struct FLaneSplitPlan {
+        // 失敗時に名前を記録する道路
+        TRnRef_T<URnRoad> Road = nullptr;
+        TRnRef_T<URnRoadGroup> RoadGroup = nullptr;
+        // すでにレーンが分かれていて, 左右で独立して分割するかどうか
+        bool bEachDir = false;
+        // 分割するかどうか
+        bool bSplit = false;
+        int32 LeftCount = 0;
+        int32 RightCount = 0;
+    };
+
+    // Dir側のレーンの幅の合計(道路グループ内の最小値)
+    float GetLaneWidth(const URnRoadGroup* RoadGroup, TOptional<EPLATEAURnDir> Dir)
+    {
+        auto Width = FLT_MAX;
+        for (auto&& Road : RoadGroup->Roads) {
+            auto&& WidthSum = 0.f;
+            TArray<TRnRef_T<URnLane>> OutLanes;
+            Road->TryGetLanes(Dir, OutLanes);
+            for (auto&& l : OutLanes)
+                WidthSum += l->CalcWidth();
+            Width = FMath::Min(Width, WidthSum);
+        }
+        return Width;
+    }
+
+    // 道路の幅から分割後のレーン数を決める. レーンを読むだけなので並列に呼べる
+    // (GetLeftLaneCount等はAlignを呼ぶので, bEachDirは事前にゲームスレッドで決めておく)
+    void PlanLaneSplit(FLaneSplitPlan& Plan, float RoadWidth)
+    {
+        auto&& RoadGroup = Plan.RoadGroup;
+        if (Plan.bEachDir) {
+            Plan.bSplit = true;
+            Plan.LeftCount = (int)(GetLaneWidth(RoadGroup, EPLATEAURnDir::Left) / RoadWidth);
+            Plan.RightCount = (int)(GetLaneWidth(RoadGroup, EPLATEAURnDir::Right) / RoadWidth);
+        }
+        else {
+            auto&& Num = (int)(GetLaneWidth(RoadGroup, NullOpt) / RoadWidth);
+            if (Num <= 1)
+                return;
+
+            Plan.bSplit = true;
+            Plan.LeftCount = (Num + 1) / 2;
+            Plan.RightCount = Num - Plan.LeftCount;
+        }
+    }
+}
+
 void URnModel::SplitLaneByWidth(float RoadWidthMeter, bool rebuildTrack, TArray<FString>& failedRoads, TFunction<bool(URnRoadGroup*)> IsLaneSplitTarget)
 {
     failedRoads.Reset();
     TSet<TRnRef_T<URnRoad>> visitedRoads;
     // メートルをユニットに変換
     const auto RoadWidth = FPLATEAURnDef::Meter2Unit * RoadWidthMeter;
+
+    // 道路グループの作成と向きの調整(道路を書き換えるのでゲームスレッドで行う)
+    TArray<FLaneSplitPlan> Plans;
     for(auto&& Road : Roads) 
     {
         if (visitedRoads.Contains(Road))
@@ -378,46 +514,39 @@ void URnModel::SplitLaneByWidth(float RoadWidthMeter, bool rebuildTrack, TArray<
             if (IsLaneSplitTarget(RoadGroup) == false)
                 continue;
 
-            auto&& leftCount = RoadGroup->GetLeftLaneCount();
-            auto&& rightCount = RoadGroup->GetRightLaneCount();
+            FLaneSplitPlan Plan;
+            Plan.Road = Road;
+            Plan.RoadGroup = RoadGroup;
             // すでにレーンが分かれている場合、左右で独立して分割を行う
-            auto GetWidth = [&](TOptional<EPLATEAURnDir> Dir)
-            {
-                auto Width = FLT_MAX;
-                for (auto&& Road : RoadGroup->Roads) {
-                    auto&& WidthSum = 0.f;
-                    TArray<TRnRef_T<URnLane>> OutLanes;
-                    Road->TryGetLanes(Dir, OutLanes);
-                    for (auto&& l : OutLanes)
-                        WidthSum += l->CalcWidth();
-                    Width = FMath::Min(Width, WidthSum);
-                }
-                return Width;
-            };
-            if (leftCount > 0 && rightCount > 0) 
-            {
-                for(auto&& dir : { EPLATEAURnDir::Left, EPLATEAURnDir::Right }) 
-                {
-                    auto Width = GetWidth(dir);
-                    auto&& Num = (int)(Width / RoadWidth);                   
-                    RoadGroup->SetLaneCount(dir, Num, rebuildTrack);
-                }
+            Plan.bEachDir = RoadGroup->GetLeftLaneCount() > 0 && RoadGroup->GetRightLaneCount() > 0;
+            Plans.Add(Plan);
+        }
+        catch (std::exception e) {
+            failedRoads.Add(Road->GetName());
+        }
+    }
+
+    // レーン数の計算は道路グループごとに独立しているので並列に行う
+    ParallelFor(Plans.Num(), [&](int32 Index) {
+        PlanLaneSplit(Plans[Index], RoadWidth);
+    });
+
+    // レーンの分割は隣接する交差点も書き換えるので, 結果が変わらないように道路の順番に行う
+    for (auto&& Plan : Plans) {
+        if (Plan.bSplit == false)
+            continue;
+
+        try {
+            if (Plan.bEachDir) {
+                Plan.RoadGroup->SetLaneCount(EPLATEAURnDir::Left, Plan.LeftCount, rebuildTrack);
+                Plan.RoadGroup->SetLaneCount(EPLATEAURnDir::Right, Plan.RightCount, rebuildTrack);
             }
-            // 
             else {
-                auto&& Width = GetWidth(NullOpt);
-                auto&& Num = (int)(Width / RoadWidth);
-                if (Num <= 1)
-                    continue;
-
-                auto&& LeftLaneCount = (Num + 1) / 2;
-                auto&& RightLaneCount = Num - LeftLaneCount;
-                RoadGroup->SetLaneCount(LeftLaneCount, RightLaneCount, rebuildTrack);
+                Plan.RoadGroup->SetLaneCount(Plan.LeftCount, Plan.RightCount, rebuildTrack);
             }
-
         }
         catch (std::exception e) {
-            failedRoads.Add(Road->GetName());
+            failedRoads.Add(Plan.Road->GetName());
         }
     }
 }
@@ -775,6 +904,160 @@ URnModel::FSliceRoadHorizontalResult URnModel::SliceRoadHorizontal(URnRoad* Road
     return Result;
 }
 
+void URnModel::OnTargetTranAdded(URnRoadBase* RoadBase, UPLATEAUCityObjectGroup* TargetTran) {
+    if (!RoadBase || !TargetTran || !AddedOrders.Contains(RoadBase))
+        return;
+    auto& RoadBases = TargetTranIndex.FindOrAdd(TObjectKey<UPLATEAUCityObjectGroup>(TargetTran));
+    RoadBases.AddUnique(RoadBase);
+}
+
+void URnModel::AddToTargetTranIndex(URnRoadBase* RoadBase) {
+    for (const auto& Tran : RoadBase->GetTargetTrans()) {
+        if (auto* TargetTran = Tran.Get())
+            TargetTranIndex.FindOrAdd(TObjectKey<UPLATEAUCityObjectGroup>(TargetTran)).AddUnique(RoadBase);
+    }
+}
+
+void URnModel::RemoveFromTargetTranIndex(URnRoadBase* RoadBase) {
+    for (const auto& Tran : RoadBase->GetTargetTrans()) {
+        auto* TargetTran = Tran.Get();
+        if (!TargetTran)
+            continue;
+        auto* RoadBases = TargetTranIndex.Find(TObjectKey<UPLATEAUCityObjectGroup>(TargetTran));
+        if (!RoadBases)
+            continue;
+        RoadBases->Remove(RoadBase);
+        if (RoadBases->IsEmpty())
+            TargetTranIndex.Remove(TObjectKey<UPLATEAUCityObjectGroup>(TargetTran));
+    }
+}
+
+void URnModel::RebuildTargetTranIndex() {
+    TargetTranIndex.Reset();
+    AddedOrders.Reset();
+    NextAddedOrder = 0;
+
+    // 道路 -> 交差点 -> 歩道の順で追加されたものとして扱う(同じ種類内の順番はリストの順番になる)
+    for (auto* Road : Roads) {
+        if (!Road || AddedOrders.Contains(Road))
+            continue;
+        AddedOrders.Add(Road, NextAddedOrder++);
+        AddToTargetTranIndex(Road);
+    }
+    for (auto* Intersection : Intersections) {
+        if (!Intersection || AddedOrders.Contains(Intersection))
+            continue;
+        AddedOrders.Add(Intersection, NextAddedOrder++);
+        AddToTargetTranIndex(Intersection);
+    }
+    for (auto* SideWalk : SideWalks) {
+        if (!SideWalk || AddedOrders.Contains(SideWalk))
+            continue;
+        AddedOrders.Add(SideWalk, NextAddedOrder++);
+    }
+}
+
+bool URnModel::ValidateTargetTranIndex() const {
+    // リストの順番と追加順が一致しているか
+    auto IsOrdered = [this](const auto& List) {
+        auto LastOrder = MIN_int64;
+        for (const auto* X : List) {
+            const auto* Order = AddedOrders.Find(X);
+            if (!Order || *Order <= LastOrder)
+                return false;
+            LastOrder = *Order;
+        }
+        return true;
+    };
+    if (!IsOrdered(Roads) || !IsOrdered(Intersections) || !IsOrdered(SideWalks))
+        return false;
+    if (AddedOrders.Num() != Roads.Num() + Intersections.Num() + SideWalks.Num())
+        return false;
+
+    // 全ての道路/交差点が持っているTargetTranで引けるか
+    auto IsIndexed = [this](URnRoadBase* RoadBase) {
+        for (const auto& Tran : RoadBase->GetTargetTrans()) {
+            auto* TargetTran = Tran.Get();
+            if (!TargetTran)
+                continue;
+            const auto* RoadBases = TargetTranIndex.Find(TObjectKey<UPLATEAUCityObjectGroup>(TargetTran));
+            if (!RoadBases || !RoadBases->Contains(RoadBase))
+                return false;
+        }
+        return true;
+    };
+    return Algo::AllOf(Roads, IsIndexed) && Algo::AllOf(Intersections, IsIndexed);
+}
+
+void URnModel::PreSave(FObjectPreSaveContext SaveContext) {
+    Super::PreSave(SaveContext);
+    // 前回の保存が失敗して外せていないものがあれば先に外す
+    ClearTransientFlags();
+    CompactData.Empty();
+    CompactTargetTrans.Empty();
+    if (!bCompactSerialization)
+        return;
+
+    FRnModelSerializer Serializer;
+    Serializer.Write(this, CompactData, CompactTargetTrans);
+
+    // このモデルの道路構造のオブジェクトは保存の間だけTransientにしてUObjectとしては保存しない(参照はnullとして保存される)
+    Serializer.ForEachObject(this, [this](UObject* Object) {
+        if (Object->HasAnyFlags(RF_Transient))
+            return;
+        Object->SetFlags(RF_Transient);
+        TransientFlaggedObjects.Add(Object);
+    }, true);
+    if (!TransientFlaggedObjects.IsEmpty())
+        PackageSavedHandle = UPackage::PackageSavedWithContextEvent.AddUObject(this, &URnModel::OnPackageSaved);
+}
+
+void URnModel::PostLoad() {
+    Super::PostLoad();
+    if (!CompactData.IsEmpty()) {
+        if (!FRnModelSerializer().Read(CompactData, CompactTargetTrans, this))
+            UE_LOG(LogTemp, Error, TEXT("URnModel::PostLoad : failed to read compact data (%s)"), *GetPathName());
+        CompactData.Empty();
+        CompactTargetTrans.Empty();
+    }
+    RebuildTargetTranIndex();
+}
+
+void URnModel::BeginDestroy() {
+    ClearTransientFlags();
+    Super::BeginDestroy();
+}
+
+void URnModel::ClearTransientFlags() {
+    for (const auto& Object : TransientFlaggedObjects) {
+        if (auto* Flagged = Object.Get())
+            Flagged->ClearFlags(RF_Transient);
+    }
+    TransientFlaggedObjects.Empty();
+    if (PackageSavedHandle.IsValid()) {
+        UPackage::PackageSavedWithContextEvent.Remove(PackageSavedHandle);
+        PackageSavedHandle.Reset();
+    }
+}
+
+void URnModel::OnPackageSaved(const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext ObjectSaveContext) {
+    // 保存が終わったらエディタ上のオブジェクトを元に戻す
+    if (Package == GetPackage())
+        ClearTransientFlags();
+}
+
+void URnModel::PostDuplicate(bool bDuplicateForPIE) {
+    Super::PostDuplicate(bDuplicateForPIE);
+    RebuildTargetTranIndex();
+}
+
+#if WITH_EDITOR
+void URnModel::PostEditUndo() {
+    Super::PostEditUndo();
+    RebuildTargetTranIndex();
+}
+#endif
+
 void URnModel::SeparateContinuousBorder()
 {
     for(auto Road : Roads) {
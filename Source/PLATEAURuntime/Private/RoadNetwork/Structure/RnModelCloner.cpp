@@ -0,0 +1,211 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#include "RoadNetwork/Structure/RnModelCloner.h"
+#include "Components/SplineComponent.h"
+#include "RoadNetwork/Structure/RnIntersection.h"
+#include "RoadNetwork/Structure/RnLane.h"
+#include "RoadNetwork/Structure/RnLineString.h"
+#include "RoadNetwork/Structure/RnModel.h"
+#include "RoadNetwork/Structure/RnPoint.h"
+#include "RoadNetwork/Structure/RnRoad.h"
+#include "RoadNetwork/Structure/RnSideWalk.h"
+#include "RoadNetwork/Structure/RnWay.h"
+
+void FRnModelCloner::CopyTo(const URnModel* Source, URnModel* Dest) {
+    CloneMap.Reset();
+    PendingRoadBases.Reset();
+    if (!Source || !Dest || Source == Dest)
+        return;
+
+    // Destと一緒に保存されるように, 複製したオブジェクトはDestをOuterにします
+    Outer = Dest;
+    CloneMap.Add(Source, Dest);
+
+    // AddRoad等はAddUniqueで線形探索になるので, リストを作ってからまとめて設定します
+    TArray<URnRoad*> Roads;
+    Roads.Reserve(Source->Roads.Num());
+    for (const auto* Road : Source->Roads)
+        Roads.Add(Cast<URnRoad>(CloneRoadBase(Road)));
+
+    TArray<URnIntersection*> Intersections;
+    Intersections.Reserve(Source->Intersections.Num());
+    for (const auto* Intersection : Source->Intersections)
+        Intersections.Add(Cast<URnIntersection>(CloneRoadBase(Intersection)));
+
+    TArray<URnSideWalk*> SideWalks;
+    SideWalks.Reserve(Source->SideWalks.Num());
+    for (const auto* SideWalk : Source->SideWalks)
+        SideWalks.Add(CloneSideWalk(SideWalk));
+
+    // 道路/交差点の中身を埋める. 途中でモデル外の道路/交差点が見つかった場合は末尾に追加される
+    for (auto i = 0; i < PendingRoadBases.Num(); ++i) {
+        const auto Pending = PendingRoadBases[i];
+        FillRoadBase(Pending.Key, Pending.Value);
+    }
+    PendingRoadBases.Reset();
+
+    Dest->Init();
+    Dest->Roads = MoveTemp(Roads);
+    Dest->Intersections = MoveTemp(Intersections);
+    Dest->SideWalks = MoveTemp(SideWalks);
+    Dest->FactoryVersion = Source->FactoryVersion;
+    Dest->RebuildTargetTranIndex();
+}
+
+TRnRef_T<URnModel> FRnModelCloner::Clone(const URnModel* Source) {
+    if (!Source)
+        return nullptr;
+    auto Dest = URnModel::Create();
+    CopyTo(Source, Dest);
+    return Dest;
+}
+
+template<class T>
+T* FRnModelCloner::FindOrCreate(const T* Original, bool& bOutCreated) {
+    if (auto** Found = CloneMap.Find(Original)) {
+        bOutCreated = false;
+        return static_cast<T*>(*Found);
+    }
+    // 派生クラス(URnRoad/URnIntersection)のまま複製するためOriginalのクラスで作成します
+    auto* Dst = NewObject<T>(Outer, Original->GetClass());
+    CloneMap.Add(Original, Dst);
+    bOutCreated = true;
+    return Dst;
+}
+
+URnPoint* FRnModelCloner::ClonePoint(const URnPoint* Src) {
+    if (!Src)
+        return nullptr;
+    bool bCreated;
+    auto* Dst = FindOrCreate(Src, bCreated);
+    if (bCreated)
+        Dst->Vertex = Src->Vertex;
+    return Dst;
+}
+
+URnLineString* FRnModelCloner::CloneLineString(const URnLineString* Src) {
+    if (!Src)
+        return nullptr;
+    bool bCreated;
+    auto* Dst = FindOrCreate(Src, bCreated);
+    if (bCreated) {
+        auto& Points = Dst->GetPoints();
+        Points.Reserve(Src->Count());
+        for (const auto& Point : Src->GetPoints())
+            Points.Add(ClonePoint(Point));
+    }
+    return Dst;
+}
+
+URnWay* FRnModelCloner::CloneWay(const URnWay* Src) {
+    if (!Src)
+        return nullptr;
+    bool bCreated;
+    auto* Dst = FindOrCreate(Src, bCreated);
+    if (bCreated) {
+        Dst->IsReversed = Src->IsReversed;
+        Dst->IsReverseNormal = Src->IsReverseNormal;
+        Dst->LineString = CloneLineString(Src->LineString);
+    }
+    return Dst;
+}
+
+URnLane* FRnModelCloner::CloneLane(const URnLane* Src) {
+    if (!Src)
+        return nullptr;
+    bool bCreated;
+    auto* Dst = FindOrCreate(Src, bCreated);
+    if (bCreated) {
+        Dst->Parent = Cast<URnRoad>(CloneRoadBase(Src->Parent));
+        Dst->PrevBorder = CloneWay(Src->PrevBorder);
+        Dst->NextBorder = CloneWay(Src->NextBorder);
+        Dst->LeftWay = CloneWay(Src->LeftWay);
+        Dst->RightWay = CloneWay(Src->RightWay);
+        Dst->bIsReversed = Src->bIsReversed;
+        Dst->CenterWay = CloneWay(Src->CenterWay);
+    }
+    return Dst;
+}
+
+URnSideWalk* FRnModelCloner::CloneSideWalk(const URnSideWalk* Src) {
+    if (!Src)
+        return nullptr;
+    bool bCreated;
+    auto* Dst = FindOrCreate(Src, bCreated);
+    if (bCreated) {
+        // Initは向きをそろえ直すので使わずにそのままコピーします
+        Dst->ParentRoad = CloneRoadBase(Src->ParentRoad.Get());
+        Dst->OutsideWay = CloneWay(Src->OutsideWay);
+        Dst->InsideWay = CloneWay(Src->InsideWay);
+        Dst->StartEdgeWay = CloneWay(Src->StartEdgeWay);
+        Dst->EndEdgeWay = CloneWay(Src->EndEdgeWay);
+        Dst->LaneType = Src->LaneType;
+    }
+    return Dst;
+}
+
+URnIntersectionEdge* FRnModelCloner::CloneEdge(const URnIntersectionEdge* Src) {
+    if (!Src)
+        return nullptr;
+    bool bCreated;
+    auto* Dst = FindOrCreate(Src, bCreated);
+    if (bCreated) {
+        Dst->SetRoad(CloneRoadBase(Src->GetRoad()));
+        Dst->SetBorder(CloneWay(Src->GetBorder()));
+    }
+    return Dst;
+}
+
+URnTrack* FRnModelCloner::CloneTrack(const URnTrack* Src) {
+    if (!Src)
+        return nullptr;
+    bool bCreated;
+    auto* Dst = FindOrCreate(Src, bCreated);
+    if (bCreated) {
+        Dst->FromBorder = CloneWay(Src->FromBorder);
+        Dst->ToBorder = CloneWay(Src->ToBorder);
+        Dst->Spline = Src->Spline ? DuplicateObject<USplineComponent>(Src->Spline, Outer) : nullptr;
+        Dst->Curve = Src->Curve;
+        Dst->TurnType = Src->TurnType;
+    }
+    return Dst;
+}
+
+URnRoadBase* FRnModelCloner::CloneRoadBase(const URnRoadBase* Src) {
+    if (!Src)
+        return nullptr;
+    bool bCreated;
+    auto* Dst = FindOrCreate(Src, bCreated);
+    if (bCreated)
+        PendingRoadBases.Add(MakeTuple(Src, Dst));
+    return Dst;
+}
+
+void FRnModelCloner::FillRoadBase(const URnRoadBase* Src, URnRoadBase* Dst) {
+    // 別のモデルに所属している場合は親を持たない
+    Dst->SetParentModel(Find(Src->GetParentModel()));
+    Dst->GetTargetTrans() = Src->GetTargetTrans();
+    auto& SideWalks = Dst->GetSideWalks();
+    SideWalks.Reserve(Src->GetSideWalks().Num());
+    for (const auto& SideWalk : Src->GetSideWalks())
+        SideWalks.Add(CloneSideWalk(SideWalk));
+
+    if (const auto* SrcRoad = Cast<URnRoad>(Src)) {
+        auto* DstRoad = CastChecked<URnRoad>(Dst);
+        DstRoad->Next = CloneRoadBase(SrcRoad->Next);
+        DstRoad->Prev = CloneRoadBase(SrcRoad->Prev);
+        DstRoad->MainLanes.Reserve(SrcRoad->MainLanes.Num());
+        for (const auto& Lane : SrcRoad->MainLanes)
+            DstRoad->MainLanes.Add(CloneLane(Lane));
+        DstRoad->MedianLane = CloneLane(SrcRoad->MedianLane);
+    }
+    else if (const auto* SrcIntersection = Cast<URnIntersection>(Src)) {
+        auto* DstIntersection = CastChecked<URnIntersection>(Dst);
+        DstIntersection->Edges.Reserve(SrcIntersection->Edges.Num());
+        for (const auto& Edge : SrcIntersection->Edges)
+            DstIntersection->Edges.Add(CloneEdge(Edge));
+        DstIntersection->Tracks.Reserve(SrcIntersection->Tracks.Num());
+        for (const auto& Track : SrcIntersection->Tracks)
+            DstIntersection->Tracks.Add(CloneTrack(Track));
+    }
+}
@@ -0,0 +1,638 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#include "RoadNetwork/Structure/RnModelSerializer.h"
+#include "Components/SplineComponent.h"
+#include "Component/PLATEAUCityObjectGroup.h"
+#include "Misc/Compression.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "RoadNetwork/Structure/RnIntersection.h"
+#include "RoadNetwork/Structure/RnLane.h"
+#include "RoadNetwork/Structure/RnLineString.h"
+#include "RoadNetwork/Structure/RnModel.h"
+#include "RoadNetwork/Structure/RnPoint.h"
+#include "RoadNetwork/Structure/RnRoad.h"
+#include "RoadNetwork/Structure/RnSideWalk.h"
+#include "RoadNetwork/Structure/RnWay.h"
+
+namespace
+{
+    // ファイル先頭の識別子 "RNMB"
+    constexpr uint32 Magic = 0x424D4E52;
+
+    enum class EHeaderFlags : uint32 {
+        None = 0,
+        Compressed = 1 << 0,
+    };
+
+    enum class ERoadBaseType : uint8 {
+        Road,
+        Intersection,
+    };
+
+    // 展開後のサイズの上限. 壊れたデータで巨大な確保をしないようにします
+    constexpr int32 MaxPayloadSize = 1 << 30;
+
+    // 圧縮率の上限. これより大きく展開されるデータは壊れているとみなします
+    constexpr int64 MaxCompressionRatio = 64;
+
+    // 配列の要素数を読み込みます. 残りのバイト数より多い場合は壊れているとみなします
+    int32 ReadNum(FArchive& Ar) {
+        int32 Num = 0;
+        Ar << Num;
+        if (Num < 0 || Num > Ar.TotalSize() - Ar.Tell()) {
+            Ar.SetError();
+            return 0;
+        }
+        return Num;
+    }
+
+    template<class T>
+    void ReadArray(FArchive& Ar, TArray<T>& OutArray) {
+        const auto Num = ReadNum(Ar);
+        OutArray.SetNum(Num);
+        for (auto i = 0; i < Num && !Ar.IsError(); ++i)
+            Ar << OutArray[i];
+    }
+
+    // インデックスに対応するオブジェクトを返します. 範囲外の場合は壊れているとみなします
+    template<class T>
+    T* Resolve(FArchive& Ar, const TArray<T*>& Objects, int32 Index) {
+        if (Index == INDEX_NONE)
+            return nullptr;
+        if (!Objects.IsValidIndex(Index)) {
+            Ar.SetError();
+            return nullptr;
+        }
+        return Objects[Index];
+    }
+
+    template<class T>
+    T* ReadRef(FArchive& Ar, const TArray<T*>& Objects) {
+        int32 Index = INDEX_NONE;
+        Ar << Index;
+        return Resolve(Ar, Objects, Index);
+    }
+
+    template<class T>
+    void CreateObjects(TArray<T*>& Objects, int32 Num, UObject* Outer) {
+        Objects.Reset(Num);
+        for (auto i = 0; i < Num; ++i)
+            Objects.Add(NewObject<T>(Outer));
+    }
+
+    template<class T>
+    void ReadRefs(FArchive& Ar, const TArray<T*>& Objects, TArray<T*>& OutRefs) {
+        const auto Num = ReadNum(Ar);
+        OutRefs.Reset(Num);
+        for (auto i = 0; i < Num && !Ar.IsError(); ++i)
+            OutRefs.Add(ReadRef(Ar, Objects));
+    }
+
+    // RoadBasesを全てT(URnRoad/URnIntersection)に変換する. nullptrや別の種類が含まれていればfalse
+    template<class T>
+    bool CastRoadBases(const TArray<URnRoadBase*>& RoadBases, TArray<T*>& OutRoadBases) {
+        OutRoadBases.Reset(RoadBases.Num());
+        for (auto* RoadBase : RoadBases) {
+            auto* Casted = Cast<T>(RoadBase);
+            if (Casted == nullptr)
+                return false;
+            OutRoadBases.Add(Casted);
+        }
+        return true;
+    }
+}
+
+void FRnModelSerializer::Write(const URnModel* Model, TArray<uint8>& OutData, TArray<TSoftObjectPtr<UPLATEAUCityObjectGroup>>& OutTargetTrans, bool bCompress) {
+    OutData.Reset();
+    OutTargetTrans.Reset();
+    if (!Model)
+        return;
+
+    Collect(Model);
+
+    TArray<uint8> Payload;
+    FMemoryWriter PayloadAr(Payload);
+    WritePayload(PayloadAr, Model, OutTargetTrans);
+
+    // 圧縮しても小さくならない場合はそのまま保存します
+    TArray<uint8> Compressed;
+    if (bCompress) {
+        auto CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Payload.Num());
+        Compressed.SetNumUninitialized(CompressedSize);
+        if (FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedSize, Payload.GetData(), Payload.Num()) && CompressedSize < Payload.Num())
+            Compressed.SetNum(CompressedSize);
+        else
+            Compressed.Reset();
+    }
+
+    FMemoryWriter Ar(OutData);
+    uint32 HeaderMagic = Magic;
+    uint32 HeaderVersion = Version;
+    uint32 Flags = static_cast<uint32>(Compressed.IsEmpty() ? EHeaderFlags::None : EHeaderFlags::Compressed);
+    int32 PayloadSize = Payload.Num();
+    Ar << HeaderMagic << HeaderVersion << Flags << PayloadSize;
+    const auto& Body = Compressed.IsEmpty() ? Payload : Compressed;
+    Ar.Serialize(const_cast<uint8*>(Body.GetData()), Body.Num());
+}
+
+bool FRnModelSerializer::Read(TConstArrayView<uint8> Data, TConstArrayView<TSoftObjectPtr<UPLATEAUCityObjectGroup>> TargetTrans, URnModel* Dest, UObject* Outer) {
+    if (!Dest)
+        return false;
+
+    FMemoryReaderView HeaderAr(Data);
+    uint32 HeaderMagic = 0;
+    uint32 HeaderVersion = 0;
+    uint32 Flags = 0;
+    int32 PayloadSize = 0;
+    HeaderAr << HeaderMagic << HeaderVersion << Flags << PayloadSize;
+    if (HeaderAr.IsError() || HeaderMagic != Magic || HeaderVersion != Version || PayloadSize < 0 || PayloadSize > MaxPayloadSize) {
+        UE_LOG(LogTemp, Warning, TEXT("FRnModelSerializer::Read : invalid header (version %u)"), HeaderVersion);
+        return false;
+    }
+
+    // 展開前に展開後のサイズを本体のサイズで制限し, 壊れたヘッダで巨大な確保をしないようにする
+    const auto Body = Data.RightChop(static_cast<int32>(HeaderAr.Tell()));
+    const auto bCompressed = (Flags & static_cast<uint32>(EHeaderFlags::Compressed)) != 0;
+    const auto bValidSize = bCompressed
+        ? static_cast<int64>(PayloadSize) <= static_cast<int64>(Body.Num()) * MaxCompressionRatio
+        : PayloadSize == Body.Num();
+    if (!bValidSize) {
+        UE_LOG(LogTemp, Warning, TEXT("FRnModelSerializer::Read : invalid payload size"));
+        return false;
+    }
+
+    TArray<uint8> Uncompressed;
+    auto Payload = Body;
+    if (bCompressed) {
+        Uncompressed.SetNumUninitialized(PayloadSize);
+        if (!FCompression::UncompressMemory(NAME_Zlib, Uncompressed.GetData(), PayloadSize, Body.GetData(), Body.Num())) {
+            UE_LOG(LogTemp, Warning, TEXT("FRnModelSerializer::Read : failed to uncompress"));
+            return false;
+        }
+        Payload = Uncompressed;
+    }
+
+    FMemoryReaderView Ar(Payload);
+    if (!ReadPayload(Ar, TargetTrans, Dest, Outer ? Outer : Dest)) {
+        UE_LOG(LogTemp, Warning, TEXT("FRnModelSerializer::Read : broken data"));
+        return false;
+    }
+    return true;
+}
+
+void FRnModelSerializer::ForEachObject(const URnModel* Model, TFunctionRef<void(UObject*)> Func, bool bOwnedOnly) {
+    if (!Model)
+        return;
+    Collect(Model, bOwnedOnly);
+
+    auto ForEach = [&Func](const auto& Objects) {
+        for (const auto* Object : Objects)
+            Func(const_cast<UObject*>(static_cast<const UObject*>(Object)));
+    };
+    ForEach(Points);
+    ForEach(LineStrings);
+    ForEach(Ways);
+    ForEach(Lanes);
+    ForEach(SideWalks);
+    ForEach(Edges);
+    ForEach(Tracks);
+    for (const auto* RoadBase : RoadBases) {
+        if (!bOwnedOnly || RoadBase->GetParentModel() == Model)
+            Func(const_cast<URnRoadBase*>(RoadBase));
+    }
+    for (const auto* Track : Tracks) {
+        if (Track->Spline)
+            Func(Track->Spline);
+    }
+}
+
+int32 FRnModelSerializer::Num() const {
+    return Points.Num() + LineStrings.Num() + Ways.Num() + Lanes.Num() + SideWalks.Num() + Edges.Num() + Tracks.Num() + RoadBases.Num();
+}
+
+void FRnModelSerializer::Collect(const URnModel* Model, bool bOwnedOnly) {
+    Points.Reset();
+    LineStrings.Reset();
+    Ways.Reset();
+    Lanes.Reset();
+    SideWalks.Reset();
+    Edges.Reset();
+    Tracks.Reset();
+    RoadBases.Reset();
+    Indices.Reset();
+
+    for (const auto* Road : Model->Roads)
+        AddRoadBase(Road);
+    for (const auto* Intersection : Model->Intersections)
+        AddRoadBase(Intersection);
+    for (const auto* SideWalk : Model->SideWalks)
+        AddSideWalk(SideWalk);
+
+    // 道路/交差点の中身を辿る. 途中でモデル外の道路/交差点が見つかった場合は末尾に追加される
+    for (auto i = 0; i < RoadBases.Num(); ++i) {
+        if (!bOwnedOnly || RoadBases[i]->GetParentModel() == Model)
+            FillRoadBase(RoadBases[i]);
+    }
+}
+
+int32 FRnModelSerializer::AddPoint(const URnPoint* Point) {
+    if (!Point)
+        return INDEX_NONE;
+    if (const auto* Found = Indices.Find(Point))
+        return *Found;
+    return Indices.Add(Point, Points.Add(Point));
+}
+
+int32 FRnModelSerializer::AddLineString(const URnLineString* LineString) {
+    if (!LineString)
+        return INDEX_NONE;
+    if (const auto* Found = Indices.Find(LineString))
+        return *Found;
+    const auto Index = Indices.Add(LineString, LineStrings.Add(LineString));
+    for (const auto& Point : LineString->GetPoints())
+        AddPoint(Point);
+    return Index;
+}
+
+int32 FRnModelSerializer::AddWay(const URnWay* Way) {
+    if (!Way)
+        return INDEX_NONE;
+    if (const auto* Found = Indices.Find(Way))
+        return *Found;
+    const auto Index = Indices.Add(Way, Ways.Add(Way));
+    AddLineString(Way->LineString);
+    return Index;
+}
+
+int32 FRnModelSerializer::AddLane(const URnLane* Lane) {
+    if (!Lane)
+        return INDEX_NONE;
+    if (const auto* Found = Indices.Find(Lane))
+        return *Found;
+    const auto Index = Indices.Add(Lane, Lanes.Add(Lane));
+    AddRoadBase(Lane->Parent);
+    for (const auto* Way : { Lane->PrevBorder, Lane->NextBorder, Lane->LeftWay, Lane->RightWay, Lane->CenterWay })
+        AddWay(Way);
+    return Index;
+}
+
+int32 FRnModelSerializer::AddSideWalk(const URnSideWalk* SideWalk) {
+    if (!SideWalk)
+        return INDEX_NONE;
+    if (const auto* Found = Indices.Find(SideWalk))
+        return *Found;
+    const auto Index = Indices.Add(SideWalk, SideWalks.Add(SideWalk));
+    AddRoadBase(SideWalk->ParentRoad.Get());
+    for (const auto* Way : { SideWalk->OutsideWay, SideWalk->InsideWay, SideWalk->StartEdgeWay, SideWalk->EndEdgeWay })
+        AddWay(Way);
+    return Index;
+}
+
+int32 FRnModelSerializer::AddEdge(const URnIntersectionEdge* Edge) {
+    if (!Edge)
+        return INDEX_NONE;
+    if (const auto* Found = Indices.Find(Edge))
+        return *Found;
+    const auto Index = Indices.Add(Edge, Edges.Add(Edge));
+    AddRoadBase(Edge->GetRoad());
+    AddWay(Edge->GetBorder());
+    return Index;
+}
+
+int32 FRnModelSerializer::AddTrack(const URnTrack* Track) {
+    if (!Track)
+        return INDEX_NONE;
+    if (const auto* Found = Indices.Find(Track))
+        return *Found;
+    const auto Index = Indices.Add(Track, Tracks.Add(Track));
+    AddWay(Track->FromBorder);
+    AddWay(Track->ToBorder);
+    return Index;
+}
+
+int32 FRnModelSerializer::AddRoadBase(const URnRoadBase* RoadBase) {
+    if (!RoadBase)
+        return INDEX_NONE;
+    if (const auto* Found = Indices.Find(RoadBase))
+        return *Found;
+    // 中身はCollectの最後にFillRoadBaseで辿る
+    return Indices.Add(RoadBase, RoadBases.Add(RoadBase));
+}
+
+void FRnModelSerializer::FillRoadBase(const URnRoadBase* RoadBase) {
+    for (const auto& SideWalk : RoadBase->GetSideWalks())
+        AddSideWalk(SideWalk);
+
+    if (const auto* Road = Cast<URnRoad>(RoadBase)) {
+        AddRoadBase(Road->Next);
+        AddRoadBase(Road->Prev);
+        for (const auto& Lane : Road->MainLanes)
+            AddLane(Lane);
+        AddLane(Road->MedianLane);
+    }
+    else if (const auto* Intersection = Cast<URnIntersection>(RoadBase)) {
+        for (const auto& Edge : Intersection->Edges)
+            AddEdge(Edge);
+        for (const auto& Track : Intersection->Tracks)
+            AddTrack(Track);
+    }
+}
+
+void FRnModelSerializer::WritePayload(FArchive& Ar, const URnModel* Model, TArray<TSoftObjectPtr<UPLATEAUCityObjectGroup>>& OutTargetTrans) {
+    auto IndexOf = [this](const UObject* Object) -> int32 {
+        return Object ? Indices.FindChecked(Object) : INDEX_NONE;
+    };
+    auto WriteRef = [&](const UObject* Object) {
+        auto Index = IndexOf(Object);
+        Ar << Index;
+    };
+    auto WriteRefs = [&](const auto& Objects) {
+        auto Num = Objects.Num();
+        Ar << Num;
+        for (const auto* Object : Objects)
+            WriteRef(Object);
+    };
+    auto WriteFlag = [&](bool bFlag) {
+        uint8 Value = bFlag ? 1 : 0;
+        Ar << Value;
+    };
+
+    // 先に全オブジェクトの数と道路/交差点の種類を書き, 読み込み時にまとめて作成できるようにする
+    auto FactoryVersion = Model->FactoryVersion;
+    Ar << FactoryVersion;
+    for (auto Num : { Points.Num(), LineStrings.Num(), Ways.Num(), Lanes.Num(), SideWalks.Num(), Edges.Num(), Tracks.Num(), RoadBases.Num() })
+        Ar << Num;
+    for (const auto* RoadBase : RoadBases) {
+        auto Type = static_cast<uint8>(RoadBase->IsA<URnIntersection>() ? ERoadBaseType::Intersection : ERoadBaseType::Road);
+        Ar << Type;
+    }
+
+    // 点は座標だけを並べて書く
+    for (const auto* Point : Points) {
+        auto Vertex = Point->Vertex;
+        Ar << Vertex;
+    }
+
+    for (const auto* LineString : LineStrings)
+        WriteRefs(LineString->GetPoints());
+
+    for (const auto* Way : Ways) {
+        WriteRef(Way->LineString);
+        WriteFlag(Way->IsReversed);
+        WriteFlag(Way->IsReverseNormal);
+    }
+
+    for (const auto* Lane : Lanes) {
+        WriteRef(Lane->Parent);
+        for (const auto* Way : { Lane->PrevBorder, Lane->NextBorder, Lane->LeftWay, Lane->RightWay, Lane->CenterWay })
+            WriteRef(Way);
+        WriteFlag(Lane->bIsReversed);
+    }
+
+    for (const auto* SideWalk : SideWalks) {
+        WriteRef(SideWalk->ParentRoad.Get());
+        for (const auto* Way : { SideWalk->OutsideWay, SideWalk->InsideWay, SideWalk->StartEdgeWay, SideWalk->EndEdgeWay })
+            WriteRef(Way);
+        auto LaneType = static_cast<uint8>(SideWalk->LaneType);
+        Ar << LaneType;
+    }
+
+    for (const auto* Edge : Edges) {
+        WriteRef(Edge->GetRoad());
+        WriteRef(Edge->GetBorder());
+    }
+
+    for (const auto* Track : Tracks) {
+        WriteRef(Track->FromBorder);
+        WriteRef(Track->ToBorder);
+        auto TurnType = static_cast<uint8>(Track->TurnType);
+        Ar << TurnType;
+        auto Curve = Track->Curve;
+        Ar << Curve.Points << Curve.Tangents << Curve.ReparamDistances << Curve.ReparamParams;
+    }
+
+    // CityObjectGroupはOutTargetTransにまとめ, インデックスで参照する
+    TMap<const UPLATEAUCityObjectGroup*, int32> TargetTranIndices;
+    TArray<int32> RoadBaseTargetTrans;
+    for (const auto* RoadBase : RoadBases) {
+        RoadBaseTargetTrans.Add(RoadBase->GetTargetTrans().Num());
+        for (const auto& TargetTran : RoadBase->GetTargetTrans()) {
+            const auto* Group = TargetTran.Get();
+            if (!Group) {
+                RoadBaseTargetTrans.Add(INDEX_NONE);
+                continue;
+            }
+            auto* Found = TargetTranIndices.Find(Group);
+            if (!Found)
+                Found = &TargetTranIndices.Add(Group, OutTargetTrans.Emplace(const_cast<UPLATEAUCityObjectGroup*>(Group)));
+            RoadBaseTargetTrans.Add(*Found);
+        }
+    }
+    Ar << RoadBaseTargetTrans;
+
+    for (const auto* RoadBase : RoadBases) {
+        WriteFlag(RoadBase->GetParentModel() == Model);
+        WriteRefs(RoadBase->GetSideWalks());
+        if (const auto* Road = Cast<URnRoad>(RoadBase)) {
+            WriteRef(Road->Next);
+            WriteRef(Road->Prev);
+            WriteRefs(Road->MainLanes);
+            WriteRef(Road->MedianLane);
+        }
+        else if (const auto* Intersection = Cast<URnIntersection>(RoadBase)) {
+            WriteRefs(Intersection->Edges);
+            WriteRefs(Intersection->Tracks);
+        }
+    }
+
+    WriteRefs(Model->Roads);
+    WriteRefs(Model->Intersections);
+    WriteRefs(Model->SideWalks);
+}
+
+bool FRnModelSerializer::ReadPayload(FArchive& Ar, TConstArrayView<TSoftObjectPtr<UPLATEAUCityObjectGroup>> TargetTrans, URnModel* Dest, UObject* Outer) {
+    FString FactoryVersion;
+    Ar << FactoryVersion;
+    int32 Nums[8];
+    for (auto& Num : Nums)
+        Num = ReadNum(Ar);
+    if (Ar.IsError())
+        return false;
+
+    // 全オブジェクトを先に作成する
+    TArray<URnPoint*> NewPoints;
+    TArray<URnLineString*> NewLineStrings;
+    TArray<URnWay*> NewWays;
+    TArray<URnLane*> NewLanes;
+    TArray<URnSideWalk*> NewSideWalks;
+    TArray<URnIntersectionEdge*> NewEdges;
+    TArray<URnTrack*> NewTracks;
+    CreateObjects(NewPoints, Nums[0], Outer);
+    CreateObjects(NewLineStrings, Nums[1], Outer);
+    CreateObjects(NewWays, Nums[2], Outer);
+    CreateObjects(NewLanes, Nums[3], Outer);
+    CreateObjects(NewSideWalks, Nums[4], Outer);
+    CreateObjects(NewEdges, Nums[5], Outer);
+    CreateObjects(NewTracks, Nums[6], Outer);
+
+    TArray<URnRoadBase*> NewRoadBases;
+    NewRoadBases.Reserve(Nums[7]);
+    for (auto i = 0; i < Nums[7] && !Ar.IsError(); ++i) {
+        uint8 Type = 0;
+        Ar << Type;
+        if (Type == static_cast<uint8>(ERoadBaseType::Road))
+            NewRoadBases.Add(NewObject<URnRoad>(Outer));
+        else if (Type == static_cast<uint8>(ERoadBaseType::Intersection))
+            NewRoadBases.Add(NewObject<URnIntersection>(Outer));
+        else
+            Ar.SetError();
+    }
+    if (Ar.IsError())
+        return false;
+
+    for (auto* Point : NewPoints)
+        Ar << Point->Vertex;
+
+    for (auto* LineString : NewLineStrings)
+        ReadRefs(Ar, NewPoints, LineString->GetPoints());
+
+    auto ReadFlag = [&Ar]() {
+        uint8 Value = 0;
+        Ar << Value;
+        return Value != 0;
+    };
+
+    for (auto* Way : NewWays) {
+        Way->LineString = ReadRef(Ar, NewLineStrings);
+        Way->IsReversed = ReadFlag();
+        Way->IsReverseNormal = ReadFlag();
+    }
+
+    for (auto* Lane : NewLanes) {
+        Lane->Parent = Cast<URnRoad>(ReadRef(Ar, NewRoadBases));
+        Lane->PrevBorder = ReadRef(Ar, NewWays);
+        Lane->NextBorder = ReadRef(Ar, NewWays);
+        Lane->LeftWay = ReadRef(Ar, NewWays);
+        Lane->RightWay = ReadRef(Ar, NewWays);
+        Lane->CenterWay = ReadRef(Ar, NewWays);
+        Lane->bIsReversed = ReadFlag();
+    }
+
+    for (auto* SideWalk : NewSideWalks) {
+        // Initは向きをそろえ直すので使わずにそのまま設定します
+        SideWalk->ParentRoad = ReadRef(Ar, NewRoadBases);
+        SideWalk->OutsideWay = ReadRef(Ar, NewWays);
+        SideWalk->InsideWay = ReadRef(Ar, NewWays);
+        SideWalk->StartEdgeWay = ReadRef(Ar, NewWays);
+        SideWalk->EndEdgeWay = ReadRef(Ar, NewWays);
+        uint8 LaneType = 0;
+        Ar << LaneType;
+        SideWalk->LaneType = static_cast<EPLATEAURnSideWalkLaneType>(LaneType);
+    }
+
+    for (auto* Edge : NewEdges) {
+        Edge->SetRoad(ReadRef(Ar, NewRoadBases));
+        Edge->SetBorder(ReadRef(Ar, NewWays));
+    }
+
+    for (auto* Track : NewTracks) {
+        Track->FromBorder = ReadRef(Ar, NewWays);
+        Track->ToBorder = ReadRef(Ar, NewWays);
+        uint8 TurnType = 0;
+        Ar << TurnType;
+        Track->TurnType = static_cast<ERnTurnType>(TurnType);
+        Track->Spline = nullptr;
+        auto& Curve = Track->Curve;
+        ReadArray(Ar, Curve.Points);
+        ReadArray(Ar, Curve.Tangents);
+        ReadArray(Ar, Curve.ReparamDistances);
+        ReadArray(Ar, Curve.ReparamParams);
+    }
+
+    TArray<int32> RoadBaseTargetTrans;
+    ReadArray(Ar, RoadBaseTargetTrans);
+    if (Ar.IsError())
+        return false;
+
+    // 読み込み済みのCityObjectGroupを探す. 見つからない場合は無効な参照のままにする
+    TArray<UPLATEAUCityObjectGroup*> TargetTranGroups;
+    TargetTranGroups.Reserve(TargetTrans.Num());
+    for (const auto& TargetTran : TargetTrans) {
+        auto* Group = TargetTran.Get();
+        if (!Group && !TargetTran.IsNull())
+            UE_LOG(LogTemp, Warning, TEXT("FRnModelSerializer::Read : city object group not found (%s)"), *TargetTran.ToString());
+        TargetTranGroups.Add(Group);
+    }
+
+    auto TargetTranCursor = 0;
+    for (auto* RoadBase : NewRoadBases) {
+        if (!RoadBaseTargetTrans.IsValidIndex(TargetTranCursor))
+            return false;
+        const auto Num = RoadBaseTargetTrans[TargetTranCursor++];
+        if (Num < 0 || TargetTranCursor + Num > RoadBaseTargetTrans.Num())
+            return false;
+        auto& TargetTrans = RoadBase->GetTargetTrans();
+        TargetTrans.Reset(Num);
+        for (auto i = 0; i < Num; ++i) {
+            const auto Index = RoadBaseTargetTrans[TargetTranCursor++];
+            if (Index != INDEX_NONE && !TargetTranGroups.IsValidIndex(Index))
+                return false;
+            TargetTrans.Add(Index == INDEX_NONE ? nullptr : TargetTranGroups[Index]);
+        }
+
+        RoadBase->SetParentModel(ReadFlag() ? Dest : nullptr);
+        ReadRefs(Ar, NewSideWalks, RoadBase->GetSideWalks());
+        if (auto* Road = Cast<URnRoad>(RoadBase)) {
+            Road->Next = ReadRef(Ar, NewRoadBases);
+            Road->Prev = ReadRef(Ar, NewRoadBases);
+            ReadRefs(Ar, NewLanes, Road->MainLanes);
+            Road->MedianLane = ReadRef(Ar, NewLanes);
+        }
+        else if (auto* Intersection = Cast<URnIntersection>(RoadBase)) {
+            ReadRefs(Ar, NewEdges, Intersection->Edges);
+            ReadRefs(Ar, NewTracks, Intersection->Tracks);
+        }
+        if (Ar.IsError())
+            return false;
+    }
+
+    TArray<URnRoadBase*> Roads;
+    TArray<URnRoadBase*> Intersections;
+    TArray<URnSideWalk*> ModelSideWalks;
+    ReadRefs(Ar, NewRoadBases, Roads);
+    ReadRefs(Ar, NewRoadBases, Intersections);
+    ReadRefs(Ar, NewSideWalks, ModelSideWalks);
+    if (Ar.IsError() || !Ar.AtEnd())
+        return false;
+
+    // 道路/交差点の一覧が別の種類やnullptrを参照していたら壊れている
+    TArray<URnRoad*> ModelRoads;
+    TArray<URnIntersection*> ModelIntersections;
+    if (!CastRoadBases(Roads, ModelRoads) || !CastRoadBases(Intersections, ModelIntersections))
+        return false;
+
+    // ここまで来たら壊れていないのでDestを書き換える
+    Dest->Init();
+    Dest->Roads.Reserve(ModelRoads.Num());
+    for (auto* Road : ModelRoads)
+        Dest->Roads.Add(Road);
+    Dest->Intersections.Reserve(ModelIntersections.Num());
+    for (auto* Intersection : ModelIntersections)
+        Dest->Intersections.Add(Intersection);
+    Dest->SideWalks = MoveTemp(ModelSideWalks);
+    Dest->FactoryVersion = FactoryVersion;
+    Dest->RebuildTargetTranIndex();
+
+    // 作成したオブジェクトを覚えておく(Num用)
+    Indices.Reset();
+    Points = TArray<const URnPoint*>(NewPoints);
+    LineStrings = TArray<const URnLineString*>(NewLineStrings);
+    Ways = TArray<const URnWay*>(NewWays);
+    Lanes = TArray<const URnLane*>(NewLanes);
+    SideWalks = TArray<const URnSideWalk*>(NewSideWalks);
+    Edges = TArray<const URnIntersectionEdge*>(NewEdges);
+    Tracks = TArray<const URnTrack*>(NewTracks);
+    RoadBases = TArray<const URnRoadBase*>(NewRoadBases);
+    return true;
+}
@@ -4,12 +4,14 @@
 
 #include "Algo/AllOf.h"
 #include "Algo/AnyOf.h"
+#include "Algo/Reverse.h"
 #include "RoadNetwork/Structure/RnLane.h"
 #include "RoadNetwork/Structure/RnWay.h"
 #include "RoadNetwork/Structure/RnIntersection.h"
 #include "RoadNetwork/Structure/RnPoint.h"
 #include "RoadNetwork/Structure/RnModel.h"
 #include "RoadNetwork/Structure/RnSideWalk.h"
+#include "RoadNetwork/Util/PLATEAURnEx.h"
 #include "RoadNetwork/Util/PLATEAUVectorEx.h"
 #include <algorithm>
 
@@ -269,6 +271,36 @@ TRnRef_T<URnWay> URnRoad::GetMergedBorder(EPLATEAURnLaneBorderType BorderType, T
     return RnNew<URnWay>(Ls);
 }
 
+TArray<FVector> URnRoad::GetMergedBorderVertices(EPLATEAURnLaneBorderType BorderType, TOptional<EPLATEAURnDir> Dir) const
+{
+    TArray<FVector> Vertices;
+    TArray<TRnRef_T<URnLane>> Lanes;
+    if (TryGetLanes(Dir, Lanes) == false)
+        return Vertices;
+
+    for (auto&& Lane : Lanes) {
+        if (!Lane)
+            continue;
+        // GetBorderWayと同じ向きで辿る. ReversedWayを作る代わりに逆順に読む
+        auto LaneBorderType = BorderType;
+        auto LaneBorderDir = EPLATEAURnLaneBorderDir::Left2Right;
+        if (IsLeftLane(Lane) == false) {
+            LaneBorderType = FPLATEAURnLaneBorderTypeEx::GetOpposite(LaneBorderType);
+            LaneBorderDir = FPLATEAURnLaneBorderDirEx::GetOpposite(LaneBorderDir);
+        }
+
+        const auto Border = Lane->GetBorder(LaneBorderType);
+        if (!Border)
+            continue;
+
+        const auto bReverse = Lane->GetBorderDir(LaneBorderType) != LaneBorderDir;
+        const auto Num = Border->Count();
+        for (auto i = 0; i < Num; ++i)
+            URnLineString::AddVertexOrSkip(Vertices, Border->GetVertex(bReverse ? Num - 1 - i : i));
+    }
+    return Vertices;
+}
+
 TRnRef_T<URnWay> URnRoad::GetMergedSideWay(EPLATEAURnDir Dir) const {
     TRnRef_T<URnWay> LeftWay, RightWay;
     if (!TryGetMergedSideWay(Dir, LeftWay, RightWay)) {
@@ -316,6 +348,49 @@ bool URnRoad::TryGetMergedSideWay(TOptional<EPLATEAURnDir>  Dir, TRnRef_T<URnWay
     return true;
 }
 
+bool URnRoad::TryGetMergedSideVertices(TOptional<EPLATEAURnDir> Dir, TArray<FVector>& OutLeftVertices, TArray<FVector>& OutRightVertices) const
+{
+    OutLeftVertices.Reset();
+    OutRightVertices.Reset();
+    if (IsValid() == false)
+        return false;
+
+    TArray<TRnRef_T<URnLane>> TargetLanes;
+    for (auto&& Lane : MainLanes) {
+        if (Dir.IsSet() == false || GetLaneDir(Lane) == *Dir)
+            TargetLanes.Add(Lane);
+    }
+    if (TargetLanes.IsEmpty())
+        return false;
+
+    // TryGetMergedSideWayと同じWayを選び, ReversedWayを作る代わりに逆順に読む
+    auto ToVertices = [](const URnWay* Way, bool bReverse, TArray<FVector>& OutVertices) {
+        if (!Way)
+            return;
+        OutVertices = Way->GetVertices().ToArray();
+        if (bReverse)
+            Algo::Reverse(OutVertices);
+    };
+
+    auto LeftLane = TargetLanes[0];
+    if (LeftLane) {
+        if (IsLeftLane(LeftLane))
+            ToVertices(LeftLane->GetLeftWay(), false, OutLeftVertices);
+        else
+            ToVertices(LeftLane->GetRightWay(), true, OutLeftVertices);
+    }
+
+    auto RightLane = TargetLanes[TargetLanes.Num() - 1];
+    if (RightLane) {
+        if (IsLeftLane(RightLane))
+            ToVertices(RightLane->GetRightWay(), false, OutRightVertices);
+        else
+            ToVertices(RightLane->GetLeftWay(), true, OutRightVertices);
+    }
+
+    return true;
+}
+
 bool URnRoad::TryGetNearestDistanceToSideWays(const TRnRef_T<URnLineString>& LineString, float& OutDistance) const {
     if (!LineString || !LineString->IsValid()) return false;
 
@@ -561,43 +636,46 @@ bool URnRoad::Check()
 }
 
 bool URnRoad::TryGetVerticalSliceSegment(EPLATEAURnLaneBorderType BorderSide, float BorderOffset,
-    FLineSegment3D& OutSegment)
+    FLineSegment3D& OutSegment) const
 {
     OutSegment = FLineSegment3D();
 
-    URnWay* LeftWay = nullptr;
-    URnWay* RightWay = nullptr;
-    if (!TryGetMergedSideWay(NullOpt, LeftWay, RightWay)) {
+    // 並列に切断線を計算できるように, 一時的なWay/LineStringは作らずに頂点配列で計算する
+    TArray<FVector> LeftVertices;
+    TArray<FVector> RightVertices;
+    if (!TryGetMergedSideVertices(NullOpt, LeftVertices, RightVertices) || LeftVertices.IsEmpty() || RightVertices.IsEmpty()) {
         UE_LOG(LogTemp, Warning, TEXT("TryGetMergedSideWayに失敗(%s)"), *GetTargetTransName());
         return false;
     }
 
-    URnWay* PrevBorder = GetMergedBorder(EPLATEAURnLaneBorderType::Prev);
-    URnWay* NextBorder = GetMergedBorder(EPLATEAURnLaneBorderType::Next);
-
-    FVector Start = PrevBorder->GetLerpPoint(0.5f);
-    FVector End = NextBorder->GetLerpPoint(0.5f);
+    const auto PrevBorder = GetMergedBorderVertices(EPLATEAURnLaneBorderType::Prev);
+    const auto NextBorder = GetMergedBorderVertices(EPLATEAURnLaneBorderType::Next);
+    if (PrevBorder.IsEmpty() || NextBorder.IsEmpty()) {
+        UE_LOG(LogTemp, Warning, TEXT("境界線がありません(%s)"), *GetTargetTransName());
+        return false;
+    }
 
+    FVector Start;
+    FVector End;
+    URnWay::GetLerpPoint(PrevBorder, 0.5f, Start);
+    URnWay::GetLerpPoint(NextBorder, 0.5f, End);
 
-    auto Vertices = FPLATEAURnEx::CreateInnerLerpLineString(
-        LeftWay->GetVertices().ToArray(),
-        RightWay->GetVertices().ToArray(),
-        RnNew<URnPoint>(Start),
-        RnNew<URnPoint>(End),
-        PrevBorder,
-        NextBorder,
+    const auto CenterWay = FPLATEAURnEx::CreateInnerLerpVertices(
+        LeftVertices,
+        RightVertices,
+        Start,
+        End,
         0.5f);
 
-    URnWay* CenterWay = RnNew<URnWay>(Vertices);
     int32 StartIndex = 0;
     int32 EndIndex = 0;
     FVector Position = FVector::ZeroVector;
 
-    URnWay* Border = (BorderSide == EPLATEAURnLaneBorderType::Prev) ? PrevBorder : NextBorder;
+    const auto& Border = (BorderSide == EPLATEAURnLaneBorderType::Prev) ? PrevBorder : NextBorder;
 
     TArray<FVector> CheckBorderPoints;
-    CheckBorderPoints.Add(Border->GetVertex(0));
-    CheckBorderPoints.Add(Border->GetVertex(-1));
+    CheckBorderPoints.Add(Border[0]);
+    CheckBorderPoints.Add(Border.Last());
 
     auto MaxBorderAdvanceLength = 10 * FPLATEAURnDef::Meter2Unit;
     URnRoadBase* NeighborRoad = GetNeighborRoad(BorderSide);
@@ -618,7 +696,7 @@ bool URnRoad::TryGetVerticalSliceSegment(EPLATEAURnLaneBorderType BorderSide, fl
 
                 // borderとの距離が一定以上離れている場合, 全然違うところにある歩道の可能性が高いので無視
                 // (交差点に同じ道路をPrev/Next両方でつながっている場合に起こりえる)
-                const auto Distance = Border->GetDistance2D(Way);
+                const auto Distance = URnLineString::GetDistance2D(Border, Way->GetVertices().ToArray());
                 if (Distance > MaxBorderAdvanceLength)
                     continue;
 
@@ -632,14 +710,14 @@ bool URnRoad::TryGetVerticalSliceSegment(EPLATEAURnLaneBorderType BorderSide, fl
         float Index;
         FVector Nearest;
         float Distance;
-        CenterWay->GetNearestPoint(Point, Nearest, Index, Distance);
+        URnLineString::GetNearestPoint(CenterWay, Point, Nearest, Index, Distance);
 
         float Length;
         if (BorderSide == EPLATEAURnLaneBorderType::Next) {
-            Length = CenterWay->CalcLength(Index, CenterWay->Count() - 1);
+            Length = URnLineString::CalcLength(CenterWay, Index, CenterWay.Num() - 1);
         }
         else {
-            Length = CenterWay->CalcLength(0, Index);
+            Length = URnLineString::CalcLength(CenterWay, 0, Index);
         }
 
         // 余りにも長くとりすぎる場合は, 境界線関係ない歩道の可能性が高いので無視する
@@ -652,28 +730,28 @@ bool URnRoad::TryGetVerticalSliceSegment(EPLATEAURnLaneBorderType BorderSide, fl
     }
 
     if (BorderSide == EPLATEAURnLaneBorderType::Next) {
-        Position = CenterWay->GetAdvancedPointFromBack(BorderOffset, StartIndex, EndIndex);
+        Position = URnLineString::GetAdvancedPoint(CenterWay, BorderOffset, true, StartIndex, EndIndex);
     }
     else if (BorderSide == EPLATEAURnLaneBorderType::Prev) {
-        Position = CenterWay->GetAdvancedPointFromFront(BorderOffset, StartIndex, EndIndex);
+        Position = URnLineString::GetAdvancedPoint(CenterWay, BorderOffset, false, StartIndex, EndIndex);
     }
     else {
         UE_LOG(LogTemp, Warning, TEXT("InValid BorderSide(%s)"), *GetTargetTransName());
         return false;
     }
 
-    FVector Direction = (CenterWay->GetVertex(EndIndex) - CenterWay->GetVertex(StartIndex)).GetSafeNormal();
+    FVector Direction = (CenterWay[EndIndex] - CenterWay[StartIndex]).GetSafeNormal();
     Direction = FRotator(0.f, 90.f, 0.f).RotateVector(Direction);
 
     FRay Ray(Position, Direction);
 
     TTuple<float, FVector> LeftIntersection, RightIntersection;
-    if (!LeftWay->LineString->TryGetNearestIntersectionBy2D(Ray, LeftIntersection)) {
+    if (!URnLineString::TryGetNearestIntersectionBy2D(LeftVertices, Ray, LeftIntersection)) {
         UE_LOG(LogTemp, Warning, TEXT("LeftWayの切断に失敗(%s)"), *GetTargetTransName());
         return false;
     }
 
-    if (!RightWay->LineString->TryGetNearestIntersectionBy2D(Ray, RightIntersection)) {
+    if (!URnLineString::TryGetNearestIntersectionBy2D(RightVertices, Ray, RightIntersection)) {
         UE_LOG(LogTemp, Warning, TEXT("RightWayの切断に失敗(%s)"), *GetTargetTransName());
         return false;
     }
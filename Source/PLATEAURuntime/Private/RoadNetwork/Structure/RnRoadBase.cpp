@@ -36,6 +36,8 @@ void URnRoadBase::RemoveSideWalk(const TRnRef_T<URnSideWalk>& SideWalk) {
 void URnRoadBase::AddTargetTran(UPLATEAUCityObjectGroup* TargetTran) {
     if (!TargetTrans.Contains(TargetTran)) {
         TargetTrans.Add(TargetTran);
+        if (ParentModel)
+            ParentModel->OnTargetTranAdded(this, TargetTran);
     }
 }
 
@@ -43,6 +45,8 @@ void URnRoadBase::AddTargetTran(TWeakObjectPtr<UPLATEAUCityObjectGroup> TargetTr
 {
     if (!TargetTrans.Contains(TargetTran)) {
         TargetTrans.Add(TargetTran);
+        if (ParentModel)
+            ParentModel->OnTargetTranAdded(this, TargetTran.Get());
     }
 }
 
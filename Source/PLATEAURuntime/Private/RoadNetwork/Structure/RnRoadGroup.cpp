@@ -10,6 +10,7 @@
 #include "RoadNetwork/Structure/RnWay.h"
 #include "RoadNetwork/Structure/RnLineString.h"
 #include "RoadNetwork/Structure/RnPoint.h"
+#include "RoadNetwork/Structure/RnTrackBuilder.h"
 #include "RoadNetwork/Util/PLATEAURnDebugEx.h"
 #include "RoadNetwork/Util/PLATEAURnEx.h"
 #include "RoadNetwork/Util/PLATEAURnLinq.h"
@@ -438,6 +439,8 @@ void URnRoadGroup::SetLaneCountImpl(int32 Count, EPLATEAURnDir Dir, bool Rebuild
 
     const auto AfterLanes = SplitLane(Count, Dir);
 
+    TArray<URnLineString*> NewNextBorders;
+    TArray<URnLineString*> NewPrevBorders;
     for(auto I = 0; I < Roads.Num(); ++I)
     {
         auto Road = (Roads)[I];
@@ -451,6 +454,7 @@ void URnRoadGroup::SetLaneCountImpl(int32 Count, EPLATEAURnDir Dir, bool Rebuild
             for(auto l : Lanes) 
             {
                 NextIntersection->AddEdge(Road, l->GetNextBorder());
+                NewNextBorders.Add(l->GetNextBorder()->LineString);
             }
         }
         if (I == 0 && PrevIntersection) 
@@ -459,6 +463,7 @@ void URnRoadGroup::SetLaneCountImpl(int32 Count, EPLATEAURnDir Dir, bool Rebuild
                 PrevIntersection->RemoveEdge(Road, l);
             for(auto l : Lanes) {
                 PrevIntersection->AddEdge(Road, l->GetPrevBorder());
+                NewPrevBorders.Add(l->GetPrevBorder()->LineString);
             }
         }
 
@@ -472,6 +477,14 @@ void URnRoadGroup::SetLaneCountImpl(int32 Count, EPLATEAURnDir Dir, bool Rebuild
 
         (Roads)[I]->ReplaceLanes(Lanes, Dir);
     }
+
+    // 新しい境界線につながるトラックを生成しなおす
+    if (RebuildTrack) {
+        if (PrevIntersection)
+            PrevIntersection->BuildTracks(FBuildTrackOption::WithBorder(NewPrevBorders));
+        if (NextIntersection)
+            NextIntersection->BuildTracks(FBuildTrackOption::WithBorder(NewNextBorders));
+    }
 }
 
 void URnRoadGroup::SetLaneCountWithoutMedian(int32 LeftCount, int32 RightCount, bool RebuildTrack) {
@@ -525,6 +538,14 @@ void URnRoadGroup::SetLaneCountWithoutMedian(int32 LeftCount, int32 RightCount,
     for (const auto& Road : Roads) {
         Road->SetMedianLane(nullptr);
     }
+
+    // 新しい境界線につながるトラックを生成しなおす
+    if (RebuildTrack) {
+        if (PrevIntersection)
+            PrevIntersection->BuildTracks(FBuildTrackOption::WithBorder(NewPrevBorders));
+        if (NextIntersection)
+            NextIntersection->BuildTracks(FBuildTrackOption::WithBorder(NewNextBorders));
+    }
 }
 
 void URnRoadGroup::SetLaneCount(int32 LeftCount, int32 RightCount, bool RebuildTrack) {
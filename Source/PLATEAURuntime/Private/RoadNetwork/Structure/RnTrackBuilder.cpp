@@ -2,6 +2,23 @@
 
 #include "RoadNetwork/Structure/RnTrackBuilder.h"
 #include "RoadNetwork/Structure/RnIntersection.h"
+#include "RoadNetwork/Structure/RnWay.h"
+#include "Async/ParallelFor.h"
+
+namespace {
+    // FRnIntersectionEx::GetEdgeNormalと同じ値を, Wayの法線の向きを書き換えずに求める(ワーカースレッド用)
+    FVector GetEdgeNormal(const URnIntersectionEdge* Edge) {
+        const auto Border = Edge->GetBorder();
+        auto Normal = Border->GetEdgeNormal((Border->Count() - 1) / 2);
+        if (Border->IsReverseNormal)
+            Normal *= -1.f;
+        return Normal;
+    }
+
+    FVector2D GetEdgeNormal2D(const URnIntersectionEdge* Edge) {
+        return FPLATEAURnDef::To2D(GetEdgeNormal(Edge));
+    }
+}
 
 bool FBuildTrackOption::IsBuildTarget(URnIntersection* Intersection, URnIntersectionEdge* From, URnIntersectionEdge* To) const {
     // 交差点が無効な場合は対象外
@@ -9,8 +26,17 @@ bool FBuildTrackOption::IsBuildTarget(URnIntersection* Intersection, URnIntersec
         return false;
     }
 
+    // 境界線の指定が無い場合は全てのトラックが対象
+    if (TargetBorderLineStrings.Num() == 0) {
+        return true;
+    }
 
-    return true;
+    // 入口か出口の境界線が指定された線と同じ線を参照している(URnWay::IsSameLineReference)トラックだけが対象
+    auto IsTargetBorder = [this](const URnIntersectionEdge* Edge) {
+        const auto Border = Edge ? Edge->GetBorder() : nullptr;
+        return Border && TargetBorderLineStrings.Contains(Border->GetLineString());
+    };
+    return IsTargetBorder(From) || IsTargetBorder(To);
 }
 
 FBuildTrackOption FBuildTrackOption::Default() {
@@ -41,15 +67,50 @@ FRnTracksBuilder::FRnTracksBuilder() {
 }
 
 void FRnTracksBuilder::BuildTracks(URnIntersection* Intersection, const FBuildTrackOption& Option) {
-    // Option が指定されていない場合は FBuildTrackOption::Default() を利用（呼び出し側で補完してもよい）
-    FBuildTrackOption Op = Option;
+    Intersection->Align();
+    auto Plans = PlanTracks(Intersection, Option);
+    ApplyTracks(Intersection, Option, Plans);
+}
+
+void FRnTracksBuilder::BuildTracks(const TArray<URnIntersection*>& Intersections, const FBuildTrackOption& Option) {
+    // 整列は隣接する道路と共有しているWayも書き換えるので, 先にゲームスレッドで済ませておく
+    for (auto Intersection : Intersections) {
+        if (Intersection)
+            Intersection->Align();
+    }
+
+    TArray<TArray<FTrackPlan>> Plans;
+    Plans.SetNum(Intersections.Num());
+    ParallelFor(Intersections.Num(), [&](int32 Index) {
+        if (Intersections[Index])
+            Plans[Index] = PlanTracks(Intersections[Index], Option);
+    });
+
+    for (auto i = 0; i < Intersections.Num(); ++i) {
+        if (Intersections[i])
+            ApplyTracks(Intersections[i], Option, Plans[i]);
+    }
+}
 
-    if (Op.ClearTracks) {
+void FRnTracksBuilder::ApplyTracks(URnIntersection* Intersection, const FBuildTrackOption& Option, TArray<FTrackPlan>& Plans) const {
+    if (Option.ClearTracks) {
         Intersection->ClearTracks();
     }
 
+    for (auto& Plan : Plans) {
+        URnTrack* Track = RnNew<URnTrack>(Plan.From->GetBorder(), Plan.To->GetBorder(), nullptr, Plan.TurnType);
+        Track->Curve = MoveTemp(Plan.Curve);
+        Intersection->TryAddOrUpdateTrack(Track);
+    }
+}
+
+TArray<FRnTracksBuilder::FTrackPlan> FRnTracksBuilder::PlanTracks(URnIntersection* Intersection, const FBuildTrackOption& Option) const {
+    // Option が指定されていない場合は FBuildTrackOption::Default() を利用（呼び出し側で補完してもよい）
+    const FBuildTrackOption& Op = Option;
+    TArray<FTrackPlan> Plans;
+
     // borderEdgeGroups : Intersection 内のエッジグループから IsBorder が true のものを抽出
-    auto BorderEdgeGroups = FRnIntersectionEx::CreateEdgeGroup(Intersection);
+    auto BorderEdgeGroups = FRnIntersectionEx::CreateEdgeGroup(Intersection, false);
     // Filter : IsBorder == true
     BorderEdgeGroups = BorderEdgeGroups.FilterByPredicate([](const FRnIntersectionEx::FEdgeGroup& Eg) {
         return Eg.IsBorder();
@@ -109,8 +170,8 @@ void FRnTracksBuilder::BuildTracks(URnIntersection* Intersection, const FBuildTr
                 int32 OutBoundIndex = FMath::Clamp(i, 0, OutBoundsLeft2Rights.Num() - 1);
                 URnIntersectionEdge* FromNeighbor = InBoundsLeft2Right[i];
                 FOutBound& OutBound = OutBoundsLeft2Rights[OutBoundIndex];
-                URnTrack* Track = MakeTrack(Intersection, FromNeighbor, Op, &FromEg, OutBound);
-                Intersection->TryAddOrUpdateTrack(Track);
+                if (Op.IsBuildTarget(Intersection, FromNeighbor, OutBound.To))
+                    Plans.Add(MakeTrack(Intersection, FromNeighbor, Op, &FromEg, OutBound));
             }
         }
         else {
@@ -136,8 +197,8 @@ void FRnTracksBuilder::BuildTracks(URnIntersection* Intersection, const FBuildTr
                             auto NowPos = FRnIntersectionEx::GetEdgeCenter2D(Now);
                             auto NextPos = FRnIntersectionEx::GetEdgeCenter2D(Next);
 
-                            auto NowDir = -FRnIntersectionEx::GetEdgeNormal2D(Now);
-                            auto NextDir = -FRnIntersectionEx::GetEdgeNormal2D(Next);
+                            auto NowDir = -GetEdgeNormal2D(Now);
+                            auto NextDir = -GetEdgeNormal2D(Next);
 
                             float NowAngle = FPLATEAUVector2DEx::Angle(NowDir, ToPos - NowPos);
                             float NextAngle = FPLATEAUVector2DEx::Angle(NextDir, ToPos - NextPos);
@@ -151,18 +212,40 @@ void FRnTracksBuilder::BuildTracks(URnIntersection* Intersection, const FBuildTr
 
                 URnIntersectionEdge* FromNeighbor = InBoundsLeft2Right[InBoundIndex];
                 FOutBound& OutBound = OutBoundsLeft2Rights[i];
-                URnTrack* Track = MakeTrack(Intersection, FromNeighbor, Op, &FromEg, OutBound);
-                Intersection->TryAddOrUpdateTrack(Track);
+                if (Op.IsBuildTarget(Intersection, FromNeighbor, OutBound.To))
+                    Plans.Add(MakeTrack(Intersection, FromNeighbor, Op, &FromEg, OutBound));
             }
         }
     }
+    return Plans;
 }
 
-URnTrack* FRnTracksBuilder::MakeTrack(URnIntersection* Intersection, URnIntersectionEdge* From, const FBuildTrackOption& Option,
+FRnTracksBuilder::FTrackPlan FRnTracksBuilder::MakeTrack(URnIntersection* Intersection, URnIntersectionEdge* From, const FBuildTrackOption& Option,
     FRnIntersectionEx::FEdgeGroup* FromEg
-    , const FOutBound& OutBound) {
-    // UEの仕様ではスプラインはいらないので無視
-    return RnNew<URnTrack>(From->GetBorder(), OutBound.To->GetBorder(), nullptr, OutBound.TurnType);}
+    , const FOutBound& OutBound) const {
+    // スプラインコンポーネントは作らず, 値型の曲線として経路を持たせる
+    FTrackPlan Plan;
+    Plan.From = From;
+    Plan.To = OutBound.To;
+    Plan.TurnType = OutBound.TurnType;
+    Plan.Curve = CreateTrackCurve(From, OutBound.To, Option);
+    return Plan;
+}
+
+FRnTrackCurve FRnTracksBuilder::CreateTrackCurve(URnIntersectionEdge* From, URnIntersectionEdge* To, const FBuildTrackOption& Option) {
+    if (!From || !To || !FRnWayEx::IsValidWayOrDefault(From->GetBorder()) || !FRnWayEx::IsValidWayOrDefault(To->GetBorder()))
+        return FRnTrackCurve();
+
+    // 交差点の輪郭の法線は外向きなので, 流入は法線の逆向き, 流出は法線の向き
+    const auto Start = From->GetBorder()->GetLerpPoint(0.5f);
+    const auto End = To->GetBorder()->GetLerpPoint(0.5f);
+    const auto StartDir = -GetEdgeNormal(From).GetSafeNormal();
+    const auto EndDir = GetEdgeNormal(To).GetSafeNormal();
+
+    // タンジェントが短いと境界線付近で急に曲がるので, 始点と終点の距離を下限にする
+    const auto TangentLength = FMath::Max(Option.TangentLength, static_cast<float>(FVector::Dist(Start, End)));
+    return FRnTrackCurve({ Start, End }, { StartDir * TangentLength, EndDir * TangentLength });
+}
 
 
 ERnTurnType FRnTracksBuilder::GetTurnType(const FVector& From, const FVector& To) {
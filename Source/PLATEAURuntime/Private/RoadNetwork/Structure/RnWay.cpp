@@ -3,6 +3,32 @@
 #include "RoadNetwork/Structure/RnWay.h"
 #include "Algo/Reverse.h"
 
+namespace
+{
+    // URnWayと頂点配列で同じ計算をするための実装. GetVertex(i)でi番目の頂点を取得する
+    template<class TGetVertex>
+    float GetLerpPointImpl(int32 Num, const TGetVertex& GetVertex, float TotalLength, float P, FVector& OutMidPoint) {
+        float TargetLength = TotalLength * P;
+        float CurrentLength = 0.0f;
+
+        for (int32 i = 0; i < Num - 1; ++i) {
+            FVector Start = GetVertex(i);
+            FVector End = GetVertex(i + 1);
+            float SegmentLength = (End - Start).Size();
+
+            if (CurrentLength + SegmentLength >= TargetLength) {
+                float T = (TargetLength - CurrentLength) / SegmentLength;
+                OutMidPoint = FMath::Lerp(Start, End, T);
+                return static_cast<float>(i) + T;
+            }
+            CurrentLength += SegmentLength;
+        }
+
+        OutMidPoint = GetVertex(Num - 1);
+        return static_cast<float>(Num - 1);
+    }
+}
+
 
 URnWay::URnWay()
     : IsReversed(false)
@@ -293,25 +319,14 @@ FVector URnWay::GetLerpPoint(float P) const {
 }
 
 float URnWay::GetLerpPoint(float P, FVector& OutMidPoint) const {
-    float TotalLength = CalcLength();
-    float TargetLength = TotalLength * P;
-    float CurrentLength = 0.0f;
-
-    for (int32 i = 0; i < Count() - 1; ++i) {
-        FVector Start = (*this)[i];
-        FVector End = (*this)[i + 1];
-        float SegmentLength = (End - Start).Size();
-
-        if (CurrentLength + SegmentLength >= TargetLength) {
-            float T = (TargetLength - CurrentLength) / SegmentLength;
-            OutMidPoint = FMath::Lerp(Start, End, T);
-            return static_cast<float>(i) + T;
-        }
-        CurrentLength += SegmentLength;
-    }
+    return GetLerpPointImpl(Count(), [this](int32 i) { return (*this)[i]; }, CalcLength(), P, OutMidPoint);
+}
 
-    OutMidPoint = (*this)[Count() - 1];
-    return static_cast<float>(Count() - 1);
+float URnWay::GetLerpPoint(TConstArrayView<FVector> Vertices, float P, FVector& OutMidPoint) {
+    float TotalLength = 0.0f;
+    for (int32 i = 0; i < Vertices.Num() - 1; ++i)
+        TotalLength += (Vertices[i + 1] - Vertices[i]).Size();
+    return GetLerpPointImpl(Vertices.Num(), [Vertices](int32 i) { return Vertices[i]; }, TotalLength, P, OutMidPoint);
 }
 
 void URnWay::MoveAlongNormal(float Offset) {
@@ -0,0 +1,97 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#include "RoadNetwork/Util/PLATEAUHermiteSpline.h"
+
+#include "Algo/BinarySearch.h"
+
+FPLATEAUHermiteSpline::FPLATEAUHermiteSpline(const TArray<FVector>& InPoints, const TArray<FVector>& InTangents, int32 InReparamStepsPerSegment)
+    : Points(InPoints)
+    , Tangents(InTangents)
+{
+    check(Points.Num() == Tangents.Num());
+
+    // FSplineCurves::UpdateSplineと同じ対応表を作る
+    const int32 NumSegments = FMath::Max(0, Points.Num() - 1);
+    ReparamDistances.Reserve(NumSegments * InReparamStepsPerSegment + 1);
+    ReparamParams.Reserve(NumSegments * InReparamStepsPerSegment + 1);
+    float AccumulatedLength = 0.0f;
+    for (int32 SegmentIndex = 0; SegmentIndex < NumSegments; ++SegmentIndex) {
+        for (int32 Step = 0; Step < InReparamStepsPerSegment; ++Step) {
+            const float Param = static_cast<float>(Step) / InReparamStepsPerSegment;
+            const float SegmentLength = (Step == 0) ? 0.0f : GetSegmentLength(SegmentIndex, Param);
+            ReparamDistances.Add(SegmentLength + AccumulatedLength);
+            ReparamParams.Add(SegmentIndex + Param);
+        }
+        AccumulatedLength += GetSegmentLength(SegmentIndex, 1.0f);
+    }
+    ReparamDistances.Add(AccumulatedLength);
+    ReparamParams.Add(static_cast<float>(NumSegments));
+}
+
+float FPLATEAUHermiteSpline::GetLength() const {
+    return ReparamDistances.Last();
+}
+
+FVector FPLATEAUHermiteSpline::GetLocationAtParam(float Param) const {
+    return EvalLocationAtParam(Points, Tangents, Param);
+}
+
+FVector FPLATEAUHermiteSpline::GetLocationAtDistance(float Distance) const {
+    return GetLocationAtParam(EvalParamAtDistance(ReparamDistances, ReparamParams, Distance));
+}
+
+FVector FPLATEAUHermiteSpline::EvalLocationAtParam(TConstArrayView<FVector> InPoints, TConstArrayView<FVector> InTangents, float Param) {
+    if (InPoints.Num() == 0)
+        return FVector::ZeroVector;
+    if (Param <= 0.0f)
+        return InPoints[0];
+    if (Param >= InPoints.Num() - 1)
+        return InPoints.Last();
+
+    const int32 Index = FMath::FloorToInt32(Param);
+    const float Alpha = Param - Index;
+    return FMath::CubicInterp(InPoints[Index], InTangents[Index], InPoints[Index + 1], InTangents[Index + 1], Alpha);
+}
+
+float FPLATEAUHermiteSpline::GetSegmentLength(int32 Index, float Param) const {
+    // FSplineCurves::GetSegmentLengthと同じく, 5点のルジャンドル・ガウス求積で導関数の大きさを積分する
+    static constexpr float Abscissae[] = { 0.0f, -0.5384693f, 0.5384693f, -0.90617985f, 0.90617985f };
+    static constexpr float Weights[] = { 0.5688889f, 0.47862867f, 0.47862867f, 0.23692688f, 0.23692688f };
+
+    const FVector& P0 = Points[Index];
+    const FVector& T0 = Tangents[Index];
+    const FVector& P1 = Points[Index + 1];
+    const FVector& T1 = Tangents[Index + 1];
+
+    const FVector Coeff1 = ((P0 - P1) * 2.0f + T0 + T1) * 3.0f;
+    const FVector Coeff2 = (P1 - P0) * 6.0f - T0 * 4.0f - T1 * 2.0f;
+    const FVector Coeff3 = T0;
+
+    const float HalfParam = Param * 0.5f;
+    float Length = 0.0f;
+    for (int32 i = 0; i < UE_ARRAY_COUNT(Abscissae); ++i) {
+        const float Alpha = HalfParam * (1.0f + Abscissae[i]);
+        const FVector Derivative = (Coeff1 * Alpha + Coeff2) * Alpha + Coeff3;
+        Length += Derivative.Size() * Weights[i];
+    }
+    return Length * HalfParam;
+}
+
+float FPLATEAUHermiteSpline::EvalParamAtDistance(TConstArrayView<float> InReparamDistances, TConstArrayView<float> InReparamParams, float Distance) {
+    if (InReparamDistances.Num() == 0)
+        return 0.0f;
+
+    // FInterpCurveFloat(CIM_Linear)のEvalと同じく, 範囲外は端の値, 範囲内は線形補間
+    if (Distance <= InReparamDistances[0])
+        return InReparamParams[0];
+    if (Distance >= InReparamDistances.Last())
+        return InReparamParams.Last();
+
+    // Distance以下の最後の要素
+    const int32 Index = Algo::UpperBound(InReparamDistances, Distance) - 1;
+    const float Diff = InReparamDistances[Index + 1] - InReparamDistances[Index];
+    if (Diff <= 0.0f)
+        return InReparamParams[Index];
+    const float Alpha = (Distance - InReparamDistances[Index]) / Diff;
+    return FMath::Lerp(InReparamParams[Index], InReparamParams[Index + 1], Alpha);
+}
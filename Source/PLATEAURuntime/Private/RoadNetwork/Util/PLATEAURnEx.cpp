@@ -64,6 +64,42 @@ TRnRef_T<URnLineString> FPLATEAURnEx::CreateInnerLerpLineString(
     return Line;
 }
 
+TArray<FVector> FPLATEAURnEx::CreateInnerLerpVertices(
+    const TArray<FVector>& LeftVertices,
+    const TArray<FVector>& RightVertices,
+    const FVector& Start,
+    const FVector& End,
+    float T,
+    float PointSkipDistance) {
+    // 左右がどちらも直線もしくは点以下の場合 -> start/endを直接つなぐ
+    if (LeftVertices.Num() <= 2 && RightVertices.Num() <= 2) {
+        return TArray<FVector>{ Start, End };
+    }
+
+    auto Plane = FPLATEAURnDef::Plane;
+    TArray<FVector> Line;
+
+    URnLineString::AddVertexOrSkip(Line, Start, PointSkipDistance);
+    auto Segments = FGeoGraphEx::GetInnerLerpSegments(LeftVertices, RightVertices, Plane, T);
+
+    // 1つ目の点はボーダーと重複するのでスキップ
+    for (int32 i = 1; i < Segments.Num(); ++i) {
+        URnLineString::AddVertexOrSkip(Line, Segments[i], PointSkipDistance);
+    }
+
+    URnLineString::AddVertexOrSkip(Line, End, PointSkipDistance);
+
+    // 自己交差があれば削除する
+    FGeoGraph2D::RemoveSelfCrossing<FVector>(
+        Line,
+        [Plane](FVector V) { return FAxisPlaneEx::ToVector2D(V, Plane); },
+        [](FVector P1, FVector P2, FVector P3, FVector P4, const FVector2D& Inter, float F1, float F2) {
+            return FMath::Lerp(P1, P2, F1);
+        });
+
+    return Line;
+}
+
 FPLATEAURnEx::FLineCrossPointResult FPLATEAURnEx::GetLineIntersections(
     const FLineSegment3D& LineSegment,
     const TArray<TRnRef_T<URnWay>>& Ways)
@@ -0,0 +1,95 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#include "RoadNetwork/Util/PLATEAURnStageProfiler.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/UObjectArray.h"
+
+namespace
+{
+    int64 GetUsedPhysical() {
+        return static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical);
+    }
+
+    int32 GetUObjectNum() {
+        return GUObjectArray.GetObjectArrayNumMinusAvailable();
+    }
+}
+
+FPLATEAURnStageProfiler::FScope::FScope(FPLATEAURnStageProfiler* InProfiler, const TCHAR* Name)
+    : Profiler(InProfiler) {
+    if (Profiler)
+        Profiler->Begin(Name);
+}
+
+FPLATEAURnStageProfiler::FScope::~FScope() {
+    if (Profiler)
+        Profiler->End();
+}
+
+void FPLATEAURnStageProfiler::Begin(const TCHAR* Name) {
+    auto& Running = Stack.AddDefaulted_GetRef();
+    // 入れ子の段階は 親/子 の名前にする
+    Running.Name = Stack.Num() > 1 ? Stack[Stack.Num() - 2].Name + TEXT("/") + Name : FString(Name);
+    Running.StartUsedPhysical = GetUsedPhysical();
+    Running.StartUObjectNum = GetUObjectNum();
+    Running.StartTime = FPlatformTime::Seconds();
+}
+
+void FPLATEAURnStageProfiler::End() {
+    if (Stack.IsEmpty()) {
+        UE_LOG(LogTemp, Warning, TEXT("FPLATEAURnStageProfiler::End : no running stage"));
+        return;
+    }
+    const auto EndTime = FPlatformTime::Seconds();
+    const auto Running = Stack.Pop();
+    auto& Record = Records.AddDefaulted_GetRef();
+    Record.Name = Running.Name;
+    Record.Seconds = EndTime - Running.StartTime;
+    Record.UsedPhysicalDelta = GetUsedPhysical() - Running.StartUsedPhysical;
+    Record.UObjectDelta = GetUObjectNum() - Running.StartUObjectNum;
+    if (Counter)
+        Counter(Record.Counts);
+}
+
+void FPLATEAURnStageProfiler::SetCounter(TFunction<void(TArray<TPair<FString, int64>>&)> InCounter) {
+    Counter = MoveTemp(InCounter);
+}
+
+double FPLATEAURnStageProfiler::GetTotalSeconds() const {
+    // 入れ子の段階は親に含まれるので最上位の段階だけを足す
+    auto Total = 0.0;
+    for (const auto& Record : Records) {
+        if (!Record.Name.Contains(TEXT("/")))
+            Total += Record.Seconds;
+    }
+    return Total;
+}
+
+FString FPLATEAURnStageProfiler::ToJson(const TArray<TPair<FString, FString>>& Info) const {
+    auto Root = MakeShared<FJsonObject>();
+    for (const auto& Pair : Info)
+        Root->SetStringField(Pair.Key, Pair.Value);
+    Root->SetNumberField(TEXT("totalSeconds"), GetTotalSeconds());
+
+    TArray<TSharedPtr<FJsonValue>> Stages;
+    for (const auto& Record : Records) {
+        auto Stage = MakeShared<FJsonObject>();
+        Stage->SetStringField(TEXT("name"), Record.Name);
+        Stage->SetNumberField(TEXT("seconds"), Record.Seconds);
+        Stage->SetNumberField(TEXT("usedPhysicalDelta"), static_cast<double>(Record.UsedPhysicalDelta));
+        Stage->SetNumberField(TEXT("uobjectDelta"), Record.UObjectDelta);
+        auto Counts = MakeShared<FJsonObject>();
+        for (const auto& Count : Record.Counts)
+            Counts->SetNumberField(Count.Key, static_cast<double>(Count.Value));
+        Stage->SetObjectField(TEXT("counts"), Counts);
+        Stages.Add(MakeShared<FJsonValueObject>(Stage));
+    }
+    Root->SetArrayField(TEXT("stages"), Stages);
+
+    FString Result;
+    const auto Writer = TJsonWriterFactory<>::Create(&Result);
+    FJsonSerializer::Serialize(Root, Writer);
+    return Result;
+}
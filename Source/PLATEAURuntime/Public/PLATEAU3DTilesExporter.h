@@ -0,0 +1,34 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class APLATEAUInstancedCityModel;
+class UPLATEAUCityObjectGroup;
+struct FPLATEAUMeshExportOptions;
+
+/**
+ * @brief 3D都市モデルをOGC 3D Tiles (tileset.json + glb) として出力します。
+ *
+ * 出力先フォルダの構成は以下のようになります。
+ *
+ * {ExportPath}
+ * |-tileset.json
+ * |-tiles
+ *  |-{タイルID}.glb
+ *
+ * 各コンポーネントはバウンディングボックスの中心によって4分木に分割され、葉のタイルのみがglbを持ちます(refine = ADD)。
+ * glbの各頂点には UV4 に格納された CityObjectIndex から求めた地物IDが EXT_mesh_features の _FEATURE_ID_0 として付与され、
+ * 地物のgml:idと属性は EXT_structural_metadata のプロパティテーブルとして格納されます。
+ *
+ * タイルセットのルートにはENUからECEFへの変換行列を設定します。
+ * 高さはGMLの標高(ジオイド高を含まない)のまま出力されるため、楕円体高を前提とするビューアでは必要に応じて高さ補正を行ってください。
+ */
+class PLATEAURUNTIME_API FPLATEAU3DTilesExporter {
+public:
+    bool Export(const FString& ExportPath, APLATEAUInstancedCityModel* ModelActor, const FPLATEAUMeshExportOptions& Option);
+
+private:
+    TArray<UPLATEAUCityObjectGroup*> GetTargetComponents(APLATEAUInstancedCityModel* ModelActor, const FPLATEAUMeshExportOptions& Option) const;
+};
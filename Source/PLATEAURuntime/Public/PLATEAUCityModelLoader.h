@@ -31,6 +31,8 @@ struct FLoadInputData {
     FString GmlPath;
     bool bIncludeAttrInfo;
     UMaterialInterface* FallbackMaterial;
+    // テクスチャをブロック圧縮するかどうか
+    bool bCompressTexture = false;
 };
 
 UENUM(BlueprintType)
@@ -31,6 +31,8 @@ enum class EMeshFileFormat : uint8 {
     OBJ = 0,
     FBX,
     GLTF,
+    //! OGC 3D Tiles (tileset.json + glb)
+    Tiles3D UMETA(DisplayName = "3D Tiles"),
     EMeshFileFormat_MAX,
 };
 
@@ -44,7 +46,9 @@ struct FPLATEAUMeshExportOptions {
         , bExportTexture(true)
         , CoordinateSystem(ECoordinateSystem::ENU)
         , FileFormat(EMeshFileFormat::FBX)
-        , bExportAsBinary(false) {
+        , bExportAsBinary(false)
+        , MaxComponentsPerTile(64)
+        , bExportAttributes(true) {
     }
 
     UPROPERTY(BlueprintReadWrite, Category = "PLATEAU|ExportSettings")
@@ -64,6 +68,14 @@ struct FPLATEAUMeshExportOptions {
 
     UPROPERTY(BlueprintReadWrite, Category = "PLATEAU|ExportSettings")
     bool bExportAsBinary;
+
+    //! 3D Tiles出力時、1タイルに含めるコンポーネント数の上限です。これを超えるタイルは4分木で分割されます。
+    UPROPERTY(BlueprintReadWrite, Category = "PLATEAU|ExportSettings")
+    int32 MaxComponentsPerTile;
+
+    //! 3D Tiles出力時、地物の属性をプロパティテーブルに出力するかどうかです。
+    UPROPERTY(BlueprintReadWrite, Category = "PLATEAU|ExportSettings")
+    bool bExportAttributes;
 };
 
 namespace plateau::Export {
@@ -80,6 +92,9 @@ namespace plateau::Export {
         case EMeshFileFormat::GLTF:
             FFileManagerGeneric::Get().FindFilesRecursive(FoundFileArray, *InExportPath, UTF8_TO_TCHAR("*.gltf"), true, false);
             break;
+        case EMeshFileFormat::Tiles3D:
+            FFileManagerGeneric::Get().FindFiles(FoundFileArray, *(InExportPath + "/tileset.json"), true, false);
+            break;
         default:
             break;
         }
@@ -95,6 +110,8 @@ namespace plateau::Export {
             return "FBX";
         case EMeshFileFormat::GLTF:
             return "GLTF";
+        case EMeshFileFormat::Tiles3D:
+            return "3D Tiles";
         default:
             return "";
         }
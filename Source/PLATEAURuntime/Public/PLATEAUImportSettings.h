@@ -110,6 +110,12 @@ public:
     UPROPERTY(EditAnywhere, Category = "Import Settings")
         EPLATEAUTexturePackingResolution TexturePackingResolution = EPLATEAUTexturePackingResolution::H4096W4096;
 
+    /*
+    * @brief テクスチャをブロック圧縮(BC/ASTC等、プラットフォームの既定形式)するかどうかを指定します。
+    */
+    UPROPERTY(EditAnywhere, Category = "Import Settings")
+        bool bCompressTexture = false;
+
     UPROPERTY(EditAnywhere, Category = "Import Settings", meta = (ClampMin = 0, UIMin = 0, ClamMax = 3, UIMax = 3))
         int MinLod = 0;
 
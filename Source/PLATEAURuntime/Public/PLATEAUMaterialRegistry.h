@@ -0,0 +1,80 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PLATEAUMeshLoader.h"
+#include "Misc/SecureHash.h"
+#include "UObject/ObjectKey.h"
+
+class UMaterialInterface;
+class UTexture2D;
+
+/**
+ * @brief インポート全体で共有するマテリアル・テクスチャのキャッシュです。
+ *
+ * マテリアルはFSubMeshMaterialSetの内容(色、透明度等)と、テクスチャパスから解決したテクスチャをキーとします。
+ * テクスチャは画像ファイルのパスと、デコード後の画素のハッシュ(FPLATEAUDecodedTexture::ContentHash)をキーとします。
+ * 複数のGMLで同じX3Dマテリアルや同じテクスチャファイルが使われている場合に、1度だけ作成されるようにします。
+ * パスが異なっても画素が同じテクスチャ(GMLごとにコピーされた同じ画像など)は1つのテクスチャを共有し、そのテクスチャを使うマテリアルも共有します。
+ * 複数スレッドから呼び出せます。
+ */
+class PLATEAURUNTIME_API FPLATEAUMaterialRegistry {
+public:
+    /**
+     * @brief キャッシュ済みのマテリアルを返します。なければnullptrを返します。
+     */
+    UMaterialInterface* FindMaterial(const FSubMeshMaterialSet& Key);
+
+    /**
+     * @brief マテリアルを登録します。すでに同じキーで登録されている場合は登録済みのマテリアルを返します。
+     */
+    UMaterialInterface* AddMaterial(const FSubMeshMaterialSet& Key, UMaterialInterface* Material);
+
+    /**
+     * @brief テクスチャがロード済み(ロードに失敗した場合を含む)かどうかを返します。
+     * @param OutTexture ロード済みのテクスチャ。ロードに失敗していた場合はnullptr
+     */
+    bool FindTexture(const FString& TexturePath, UTexture2D*& OutTexture);
+    void AddTexture(const FString& TexturePath, UTexture2D* Texture);
+
+    /**
+     * @brief 同じ画素のテクスチャがロード済みであれば返します。なければnullptrを返します。
+     */
+    UTexture2D* FindTextureByContent(const FSHAHash& ContentHash);
+    void AddTextureContent(const FSHAHash& ContentHash, UTexture2D* Texture);
+
+    /**
+     * @brief 登録されたマテリアル数
+     */
+    int32 GetMaterialCount() const;
+
+    /**
+     * @brief マテリアルの検索回数のうち、キャッシュが使われた回数
+     */
+    int32 GetReusedMaterialCount() const;
+
+private:
+    // マテリアルのキー。テクスチャがロード済みの場合はTexturePathを空にし、代わりにテクスチャで比較します。
+    struct FMaterialKey {
+        FSubMeshMaterialSet MaterialSet;
+        TObjectKey<UTexture2D> Texture;
+
+        bool operator==(const FMaterialKey& Other) const {
+            return MaterialSet == Other.MaterialSet && Texture == Other.Texture;
+        }
+
+        friend uint32 GetTypeHash(const FMaterialKey& Value) {
+            return HashCombine(GetTypeHash(Value.MaterialSet), GetTypeHash(Value.Texture));
+        }
+    };
+
+    // SectionをロックしてからTexturesを使ってキーを作成します。
+    FMaterialKey MakeMaterialKey(const FSubMeshMaterialSet& MaterialSet) const;
+
+    mutable FCriticalSection Section;
+    TMap<FMaterialKey, TWeakObjectPtr<UMaterialInterface>> Materials;
+    TMap<FString, TWeakObjectPtr<UTexture2D>> Textures;
+    TMap<FSHAHash, TWeakObjectPtr<UTexture2D>> TexturesByContent;
+    int32 ReusedMaterialCount = 0;
+};
@@ -13,6 +13,7 @@
 
 struct FPLATEAUCityObject;
 struct FLoadInputData;
+class FPLATEAUMaterialRegistry;
 class UPLATEAUCityObjectGroup;
 class FStaticMeshAttributes;
 
@@ -31,14 +32,15 @@ namespace plateau::polygonMesh {
 // SubMesh情報保持
 struct FSubMeshMaterialSet {
 public:
-    bool hasMaterial;
-    FVector3f Diffuse;
-    FVector3f Specular;
-    FVector3f Emissive;
-    float Shininess;
-    float Transparency;
-    float Ambient;
-    bool isSmooth;
+    // マテリアルを持たない場合も比較・ハッシュ計算に使われるため初期化しておきます。
+    bool hasMaterial = false;
+    FVector3f Diffuse = FVector3f::ZeroVector;
+    FVector3f Specular = FVector3f::ZeroVector;
+    FVector3f Emissive = FVector3f::ZeroVector;
+    float Shininess = 0.f;
+    float Transparency = 0.f;
+    float Ambient = 0.f;
+    bool isSmooth = false;
     FString TexturePath;
     FPolygonGroupID PolygonGroupID = 0;
     FString MaterialSlot = FString("");
@@ -50,7 +52,20 @@ public:
     bool Equals(const FSubMeshMaterialSet& Other) const;
 private:
 };
-FORCEINLINE uint32 GetTypeHash(const FSubMeshMaterialSet& Value);
+FORCEINLINE uint32 GetTypeHash(const FSubMeshMaterialSet& Value) {
+    uint32 Hash = FCrc::MemCrc32(&Value.Diffuse, sizeof(FVector3f));
+    Hash = HashCombine(Hash, FCrc::MemCrc32(&Value.Specular, sizeof(FVector3f)));
+    Hash = HashCombine(Hash, FCrc::MemCrc32(&Value.Emissive, sizeof(FVector3f)));
+    Hash = HashCombine(Hash, ::GetTypeHash(Value.Shininess));
+    Hash = HashCombine(Hash, ::GetTypeHash(Value.Transparency));
+    Hash = HashCombine(Hash, ::GetTypeHash(Value.Ambient));
+    Hash = HashCombine(Hash, ::GetTypeHash(Value.isSmooth));
+    Hash = HashCombine(Hash, ::GetTypeHash(Value.hasMaterial));
+    // FStringのオブジェクトではなく文字列の内容からハッシュを計算します。
+    Hash = HashCombine(Hash, ::GetTypeHash(Value.TexturePath));
+    Hash = HashCombine(Hash, ::GetTypeHash(Value.GameMaterialID));
+    return Hash;
+}
 
 // Nodeから、Node名、Nodeパスを取得し保持
 struct FNodeHierarchy {
@@ -69,14 +84,15 @@ class PLATEAURUNTIME_API FPLATEAUMeshLoader {
 public:
     virtual ~FPLATEAUMeshLoader() = default;
 
-    FPLATEAUMeshLoader() 
-    {
-        bAutomationTest = false;
-    }
-    FPLATEAUMeshLoader(const bool InbAutomationTest)
-    {
-        bAutomationTest = InbAutomationTest;
-    }
+    FPLATEAUMeshLoader();
+    FPLATEAUMeshLoader(const bool InbAutomationTest);
+
+    /**
+     * @brief マテリアル・テクスチャのキャッシュを設定します。
+     * 複数のGMLのロードで同じキャッシュを設定すると、GML間で同一のマテリアル・テクスチャが共有されます。
+     * 設定しない場合はローダーごとのキャッシュが使われます。
+     */
+    void SetMaterialRegistry(const TSharedRef<FPLATEAUMaterialRegistry>& InMaterialRegistry);
 
     void LoadModel(
         AActor* ModelActor,
@@ -105,10 +121,11 @@ protected:
 protected:
     bool bAutomationTest;
     TArray<UStaticMesh*> StaticMeshes;
-    TMap<FSubMeshMaterialSet, UMaterialInterface*> CachedMaterials;
+    /// 何度も同じマテリアル・テクスチャを作成すると重いので使い回せるように覚えておきます
+    TSharedRef<FPLATEAUMaterialRegistry> MaterialRegistry;
 
-    /// 何度も同じテクスチャをロードすると重いので使い回せるように覚えておきます
-     FPathToTexture PathToTexture;
+    /// このローダーで新たにロードしたテクスチャです。ロード後にパッケージを保存します。
+    FPathToTexture PathToTexture;
 
     // 前回のLoadModel, ReloadComponentFromNode実行時に作成されたComponentを保持しておきます
     TArray<USceneComponent*> LastCreatedComponents;
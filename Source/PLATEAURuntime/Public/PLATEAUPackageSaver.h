@@ -0,0 +1,68 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "UObject/StrongObjectPtr.h"
+
+/**
+ * @brief インポート時に作成したアセット(テクスチャ、マテリアル、スタティックメッシュ等)のパッケージ保存を遅延し、まとめて行います。
+ *
+ * Enqueueされたパッケージは、BeginBatch/EndBatchで囲まれた処理がすべて終了した後、
+ * ゲームスレッドのTickごとに一定時間ずつ保存されます。ファイル書き込みは非同期(SAVE_Async)で行われるため、
+ * ディスクへの書き込みは後続の処理と並行して進みます。
+ * 保存の完了を待つ必要がある場合はFlushを呼び出してください。
+ *
+ * すべての関数はゲームスレッドから呼び出してください。
+ */
+class PLATEAURUNTIME_API FPLATEAUPackageSaver {
+public:
+    static FPLATEAUPackageSaver& Get();
+
+    /**
+     * @brief アセットを含むパッケージを保存対象に追加します。同じパッケージは1度だけ保存されます。
+     * コンポーネントに含まれるスタティックメッシュのように、アセットでないオブジェクトの場合はそれを含むパッケージ(レベルやアクターのパッケージ)を保存します。
+     * まだ保存されていない一時パッケージ(/Temp)は保存しません。
+     */
+    void Enqueue(UObject* Asset);
+
+    /**
+     * @brief インポート処理の開始を通知します。EndBatchが呼ばれるまで保存を開始しません。
+     */
+    void BeginBatch();
+
+    /**
+     * @brief インポート処理の終了を通知します。すべてのバッチが終了すると保存を開始します。
+     */
+    void EndBatch();
+
+    /**
+     * @brief 保存待ちのパッケージをすべて保存し、ファイル書き込みの完了を待ちます。
+     * @return すべての保存に成功した場合true
+     */
+    bool Flush();
+
+    int32 GetPendingCount() const;
+
+    /**
+     * @brief BeginBatch/EndBatchで囲まれた処理の実行中かどうか
+     */
+    bool IsInBatch() const;
+
+private:
+    bool Tick(float DeltaTime);
+    bool SaveNext();
+    void StartTickerIfNeeded();
+    void Finish();
+
+    // 保存するアセットと、Enqueue時点のパッケージ
+    TArray<TPair<TStrongObjectPtr<UObject>, const UPackage*>> PendingAssets;
+    TSet<const UPackage*> PendingPackages;
+    FTSTicker::FDelegateHandle TickerHandle;
+    int32 BatchDepth = 0;
+    int32 SavedCount = 0;
+    int32 TotalCount = 0;
+    int32 FailedCount = 0;
+    double StartTime = 0.0;
+};
@@ -13,6 +13,6 @@ public:
     static FString GetContentDir();
 
 private:
-
+    FDelegateHandle EnginePreExitHandle;
 
 };
@@ -4,10 +4,46 @@
 
 #include "CoreMinimal.h"
 #include "Engine/Texture2D.h"
+#include "Misc/SecureHash.h"
+
+/**
+ * @brief デコード済みのテクスチャ画像です。Mips[0]が最大解像度で、以降1/2ずつ縮小されたミップマップが続きます。
+ */
+struct PLATEAURUNTIME_API FPLATEAUDecodedTexture {
+    int32 Width = 0;
+    int32 Height = 0;
+    EPixelFormat PixelFormat = PF_Unknown;
+    TArray<TArray64<uint8>> Mips;
+
+    // 幅、高さ、ピクセルフォーマットとMips[0]の画素から求めたハッシュ。同じ画像を別のパスから読み込んだ場合の判定に使います。
+    FSHAHash ContentHash;
+};
 
 class PLATEAURUNTIME_API FPLATEAUTextureLoader {
 public:
-    static UTexture2D* Load(const FString& TexturePath, bool OverwriteTextre);
+    /**
+     * @brief 画像ファイルをデコードし、ミップマップを生成します。ゲームスレッド以外から呼び出せます。
+     * @param TexturePath 画像ファイルパス
+     * @param OutTexture デコード結果
+     */
+    static bool Decode(const FString& TexturePath, FPLATEAUDecodedTexture& OutTexture);
+
+    /**
+     * @brief 画像ファイルからテクスチャアセットを作成します。
+     * @param bCompress trueの場合、アセットのビルド時にブロック圧縮(DXT/BC)されます。
+     */
+    static UTexture2D* Load(const FString& TexturePath, bool OverwriteTextre, bool bCompress = false);
+
+    /**
+     * @brief デコード済みの画像からテクスチャアセットを作成します。ゲームスレッドから呼び出してください。
+     */
+    static UTexture2D* Load(const FString& TexturePath, const FPLATEAUDecodedTexture& DecodedTexture, bool OverwriteTextre, bool bCompress = false);
+
     static UTexture2D* LoadTransient(const FString& TexturePath);
     static bool SaveTexture(UTexture2D* Texture, const FString& TexturePath);
+
+    /**
+     * @brief テクスチャのパッケージ保存をFPLATEAUPackageSaverに登録し、インポート終了後にまとめて保存します。
+     */
+    static void SaveTextureDeferred(UTexture2D* Texture, const FString& TexturePath);
 };
@@ -40,6 +40,18 @@ public:
 
     virtual void ComposeCachedMaterialFromTarget(const TArray<UPLATEAUCityObjectGroup*>& Target);
 
+    /**
+     * @brief 結合・分割処理の元になるModelをComponentから生成します. 属性情報とマテリアルもここで覚えます
+     *        UObjectを参照するのでゲームスレッドで呼んでください
+     */
+    std::shared_ptr<plateau::polygonMesh::Model> CreateBaseModel(const TArray<UPLATEAUCityObjectGroup*>& TargetCityObjects);
+
+    /**
+     * @brief CreateBaseModelで生成したModelを指定した粒度に変換します
+     *        UObjectを参照しないのでワーカースレッドから呼ぶことができます
+     */
+    std::shared_ptr<plateau::polygonMesh::Model> ConvertBaseModel(const plateau::polygonMesh::Model& BaseModel, const ConvertGranularity Granularity) const;
+
 protected:
     
     APLATEAUInstancedCityModel* CityModelActor;
@@ -3,9 +3,17 @@
 #pragma once
 
 #include "Components/SplineComponent.h"
+#include "UObject/ObjectKey.h"
 #include "PLATEAUReproducedRoad.generated.h"
 
 enum class EPLATEAURoadLineType : uint8;
+struct FPLATEAUMarkedWay;
+class FPLATEAURoadMarkingCache;
+class URnModel;
+class URnRoadBase;
+class URnLineString;
+class UHierarchicalInstancedStaticMeshComponent;
+class UStaticMeshComponent;
 /**
 * @brief 道路の両端に配置される道路標示（横断歩道）において、道路のどちら側に配置されたかを示します。
 * どちらでもない道路標示はNoneとなります。
@@ -17,6 +25,32 @@ enum class EPLATEAUReproducedRoadDirection : uint8 {
     Next UMETA(DisplayName = "Next"),
 };
 
+/**
+* @brief 道路標示の線をどのコンポーネントで表現するかを示します。
+*/
+UENUM(BlueprintType)
+enum class EPLATEAURoadMarkingOutputMode : uint8 {
+    //破線1つごとにUSplineMeshComponentを生成します
+    SplineMesh UMETA(DisplayName = "SplineMesh"),
+    //線の種類と範囲ごとに1つのStaticMeshへまとめます
+    MergedMesh UMETA(DisplayName = "MergedMesh"),
+};
+
+/**
+* @brief 路面メッシュの面の種類です。種類ごとにマテリアルスロットを分けます。
+*/
+UENUM(BlueprintType)
+enum class EPLATEAURoadSurfaceType : uint8 {
+    //車道
+    Lane UMETA(DisplayName = "Lane"),
+    //中央分離帯
+    Median UMETA(DisplayName = "Median"),
+    //歩道
+    SideWalk UMETA(DisplayName = "SideWalk"),
+    //交差点
+    Intersection UMETA(DisplayName = "Intersection"),
+};
+
 /**
 * @brief Road Line 生成用パラメータ
 *
@@ -58,6 +92,21 @@ struct PLATEAURUNTIME_API FPLATEAURoadLineParam {
     float LineLength;
 };
 
+/**
+* @brief 道路/交差点1つ分の道路標示のコンポーネントです。
+*/
+USTRUCT()
+struct PLATEAURUNTIME_API FPLATEAUReproducedRoadBaseComponents {
+    GENERATED_BODY()
+
+    // 道路ネットワークはレベルを開き直すと作り直されるので, 開き直した後は無効になります
+    UPROPERTY()
+    TWeakObjectPtr<URnRoadBase> RoadBase;
+
+    UPROPERTY()
+    TArray<TObjectPtr<USceneComponent>> Components;
+};
+
 /// 道路ネットワークを元に道路の見た目を生成します。
 UCLASS()
 class PLATEAURUNTIME_API APLATEAUReproducedRoad : public AActor {
@@ -69,6 +118,37 @@ public:
     UFUNCTION(BlueprintCallable, meta = (Category = "PLATEAU|RoadAdjust"))
     void CreateRoadMarks(APLATEAURnStructureModel* Model, FString CrosswalkFrequency);
 
+    /// 前回の生成から変更された道路/交差点とその周辺の道路標示だけを生成し直します。
+    /// 前回の生成結果が無い場合や出力方法が変わった場合はCreateRoadMarksと同じです。
+    UFUNCTION(BlueprintCallable, meta = (Category = "PLATEAU|RoadAdjust"))
+    void UpdateRoadMarks(APLATEAURnStructureModel* Model, FString CrosswalkFrequency);
+
+    /// 道路ネットワークを最初のスムージング前の状態に戻します。
+    /// 道路標示は次回のUpdateRoadMarksで全て作り直されます。戻せた場合はtrueを返します。
+    UFUNCTION(BlueprintCallable, meta = (Category = "PLATEAU|RoadAdjust"))
+    bool RestoreRoadNetwork(APLATEAURnStructureModel* Model);
+
+    /// 道路ネットワークから車道/中央分離帯/歩道/交差点の路面メッシュを範囲ごとにまとめて生成します。
+    /// bHideSourceMeshesがtrueの場合、道路ネットワークの元になった道路メッシュをゲーム中に非表示にします。
+    /// エディタ上の表示状態は変えないので、道路ネットワークの再生成の対象からは外れません。
+    UFUNCTION(BlueprintCallable, meta = (Category = "PLATEAU|RoadAdjust"))
+    void CreateRoadSurfaces(APLATEAURnStructureModel* Model, bool bHideSourceMeshes = false);
+
+    //道路標示の線の出力方法
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU|RoadAdjust")
+    EPLATEAURoadMarkingOutputMode MarkingOutputMode = EPLATEAURoadMarkingOutputMode::SplineMesh;
+
+    //MergedMeshの場合に1つのメッシュへまとめる範囲(cm)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU|RoadAdjust", meta = (ClampMin = "100.0"))
+    float MarkingChunkSize = 20000.f;
+
+    //路面メッシュを1つのメッシュへまとめる範囲(cm)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU|RoadAdjust", meta = (ClampMin = "100.0"))
+    float SurfaceChunkSize = 20000.f;
+
+    //路面メッシュの面の種類ごとのマテリアル
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU|RoadAdjust")
+    TMap<EPLATEAURoadSurfaceType, TObjectPtr<UMaterialInterface>> SurfaceMaterials;
 
 protected:
     // Called when the game starts or when spawneds
@@ -79,9 +159,43 @@ public:
 
 private:
 
+    // 生成したコンポーネントの名前の連番. レベルに保存されたコンポーネントと名前が重ならないように保存します
+    UPROPERTY()
     int32 NumComponents;
     TMap<EPLATEAURoadLineType, FPLATEAURoadLineParam> LineTypeMap;
 
+    // 道路/交差点ごとの道路標示の線. UpdateRoadMarksで変化した部分を判定するために使います
+    TSharedPtr<FPLATEAURoadMarkingCache> MarkingCache;
+    TWeakObjectPtr<URnModel> MarkingModel;
+    EPLATEAURoadMarkingOutputMode GeneratedOutputMode = EPLATEAURoadMarkingOutputMode::SplineMesh;
+    float GeneratedChunkSize = 0.f;
+
+    // 最初のスムージング前の道路ネットワークのコピー. RestoreRoadNetworkで戻すまで取り直しません
+    UPROPERTY(Transient)
+    TObjectPtr<URnModel> SmoothingSnapshot;
+    TWeakObjectPtr<URnModel> SnapshotSource;
+
+    // 滑らかにした線. 一部だけを作り直す場合も全体を作り直した場合と同じ形になるように, 同じ線は2回滑らかにしません
+    TSet<TObjectKey<URnLineString>> SmoothedLineStrings;
+
+    // 生成したコンポーネント. レベルを開き直した後も作り直す際に削除できるようにUPROPERTYにします
+    UPROPERTY()
+    TArray<FPLATEAUReproducedRoadBaseComponents> RoadBaseLineComponents;
+    // MergedMeshの線. キーは(チャンクX, チャンクY, 線の種類). レベルに保存してもチャンク単位で作り直せるようにUPROPERTYにします
+    UPROPERTY()
+    TMap<FIntVector, TObjectPtr<UStaticMeshComponent>> MergedLineComponents;
+    UPROPERTY()
+    TArray<TObjectPtr<USceneComponent>> ArrowComponents;
+    UPROPERTY()
+    TArray<TObjectPtr<USceneComponent>> SurfaceComponents;
+    // CreateRoadSurfacesでゲーム中に非表示にした元の道路メッシュ. 非表示の状態はレベルに保存されるので, 開き直した後も戻せるようにUPROPERTYにします
+    UPROPERTY()
+    TArray<TObjectPtr<USceneComponent>> HiddenSourceComponents;
+
     void CreateLineTypeMap();
-    void CreateLineComponentByType(EPLATEAURoadLineType Type, const TArray<FVector>& LinePoints, FVector2D Offset = FVector2D::Zero());
+    USceneComponent* CreateLineComponentByType(EPLATEAURoadLineType Type, const TArray<FVector>& LinePoints, FVector2D Offset = FVector2D::Zero());
+    void CreateMergedLineComponents(const TArray<FPLATEAUMarkedWay>& MarkedWays, const TSet<FIntPoint>* TargetChunks = nullptr);
+    void GenerateRoadMarks(URnModel* RnModel, const TArray<TObjectKey<URnRoadBase>>& UpdatedRoadBases, const TArray<FPLATEAUMarkedWay>& OldMarkedWays, bool bAll);
+    void DestroyRoadMarkComponents();
+    void TakeSmoothingSnapshot(URnModel* RnModel);
 };
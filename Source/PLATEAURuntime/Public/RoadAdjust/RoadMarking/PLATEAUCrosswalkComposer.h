@@ -19,18 +19,29 @@ public:
 
     FPLATEAUMarkedWayList Compose(const IPLATEAURrTarget& Target, const EPLATEAUCrosswalkFrequency& CrosswalkFrequency);
 
+    /**
+     * RoadBasesの道路/交差点1つずつについて横断歩道を生成します。道路ごとに並列で処理します。
+     * 戻り値のi番目はRoadBases[i]だけを対象にComposeを呼んだ結果と同じです(交差点は常に空です)。
+     */
+    TArray<FPLATEAUMarkedWayList> ComposePerRoadBase(const TArray<URnRoadBase*>& RoadBases, const EPLATEAUCrosswalkFrequency& CrosswalkFrequency);
+
 private:
+    /**
+     * 道路1つ分の横断歩道をOutListに追加します。UObjectを生成しないので複数スレッドから同時に呼べます。
+     */
+    void ComposeRoad(URnRoad* Road, IPLATEAUCrosswalkPlacementRule& PlacementRule, FPLATEAUMarkedWayList& OutList) const;
+
     FPLATEAUMarkedWayList GenerateCrosswalk(const FPLATEAUMWLine& Border,
                                             const TRnRef_T<URnIntersection>& Intersection,
                                             const TRnRef_T<URnRoadBase>& SrcRoad,
-                                            EPLATEAUReproducedRoadDirection Direction);
+                                            EPLATEAUReproducedRoadDirection Direction) const;
 
     /**
      * 引数である道路のBorderを停止線とし、そこからPositionOffset分だけ移動した線を返します。
      */
     TArray<FVector> ShiftStopLine(const FPLATEAUMWLine& Border,
                                   const TRnRef_T<URnIntersection>& Intersection,
-                                  float PositionOffsetArg);
+                                  float PositionOffsetArg) const;
 
     static constexpr float PositionOffset = 350.0f;      // 3.5m * 100 (Unreal units)
     static constexpr float CrosslineWidth = 400.0f;      // 4.0m * 100
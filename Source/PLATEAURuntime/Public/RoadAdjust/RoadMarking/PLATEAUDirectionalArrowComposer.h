@@ -6,6 +6,8 @@
 #include "RoadAdjust/PLATEAUReproducedRoad.h"
 #include "RoadNetwork/Structure/RnModel.h"
 
+class UHierarchicalInstancedStaticMeshComponent;
+
 
 enum class EPLATEAUDirectionalArrowType
 {
@@ -19,24 +21,40 @@ enum class EPLATEAUDirectionalArrowType
 
 /**
  * 交差点前の矢印を生成します
+ * 矢印は種類ごとに1つのUHierarchicalInstancedStaticMeshComponentのインスタンスとして配置します
  */
 class PLATEAURUNTIME_API FPLATEAUDirectionalArrowComposer
 {
 public:
+    /**
+     * @brief 矢印1つ分の配置
+     */
+    struct FArrowPlacement
+    {
+        EPLATEAUDirectionalArrowType Type = EPLATEAUDirectionalArrowType::None;
+        FVector Position = FVector::ZeroVector;
+        float Angle = 0.f;
+    };
+
     explicit FPLATEAUDirectionalArrowComposer(TObjectPtr<URnModel> TargetNetwork, TObjectPtr<APLATEAUReproducedRoad> ReproducedRoad);
 
-    TArray<TObjectPtr<UStaticMeshComponent>> Compose();
+    TArray<TObjectPtr<UHierarchicalInstancedStaticMeshComponent>> Compose();
+
+    /**
+     * @brief 全車線の矢印の種類/位置/角度を並列に計算します. 結果は道路/車線の順に並びます
+     */
+    TArray<FArrowPlacement> ComputeArrowPlacements() const;
 
 private:
     static constexpr float ArrowMeshHeightOffset = 9.0f; // cm
     static constexpr float ArrowPositionOffset = 450.0f; // cm 
 
-    TObjectPtr<UStaticMeshComponent> GenerateArrow(const URnWay* LaneBorder, const URnIntersection* Intersection,
-                                                  const FVector& Position, float Rotation);
-    FVector ArrowPosition(const URnLane* Lane, bool bIsNext, bool& bIsSucceed);
-    float ArrowAngle(const URnLane* Lane, bool bIsNext, bool& bIsSucceed);
-    float ArrowAngleOneWay(const URnWay* Way, bool bIsNext);
-    EPLATEAUDirectionalArrowType ArrowType(const URnWay* LaneBorder, const URnIntersection* Intersection);
+    void ComputeLaneArrow(const URnLane* Lane, bool bIsNext, const URnIntersection* Intersection, TArray<FArrowPlacement>& OutPlacements) const;
+    TObjectPtr<UHierarchicalInstancedStaticMeshComponent> GenerateArrows(EPLATEAUDirectionalArrowType Type, const TArray<FTransform>& Transforms);
+    FVector ArrowPosition(const URnLane* Lane, bool bIsNext, bool& bIsSucceed) const;
+    float ArrowAngle(const URnLane* Lane, bool bIsNext, bool& bIsSucceed) const;
+    float ArrowAngleOneWay(const URnWay* Way, bool bIsNext) const;
+    EPLATEAUDirectionalArrowType ArrowType(const URnWay* LaneBorder, const URnIntersection* Intersection) const;
     TObjectPtr<UStaticMesh> ToStaticMesh(EPLATEAUDirectionalArrowType Type) const;
 
     TObjectPtr<URnModel> TargetNetwork;
@@ -47,5 +65,4 @@ private:
     UStaticMesh* MeshStraight;
     UStaticMesh* MeshStraightLeft;
     UStaticMesh* MeshStraightRight;
-    int RoadArrowIndex = 0;
 };
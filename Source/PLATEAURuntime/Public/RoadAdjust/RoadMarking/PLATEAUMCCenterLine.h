@@ -18,6 +18,11 @@ public:
     explicit FPLATEAUIntersectionDistCalc(URnRoad* Road);
 
     float NearestDistFromIntersection(const URnWay* Way, int32 WayIndexOrig) const;
+
+    /**
+     * 頂点配列版です。bIsReversedがtrueの場合はWayIndexOrigを逆順のインデックスとして扱います。
+     */
+    float NearestDistFromIntersection(const TArray<FVector>& Points, bool bIsReversed, int32 WayIndexOrig) const;
     float GetLengthBetweenCenterLine() const { return LengthBetweenIntersections; }
 
 private:
@@ -43,11 +48,11 @@ class PLATEAURUNTIME_API UPLATEAUMCCenterLine : public UObject, public IPLATEAUM
 
 public:
     /**
-     * 道路ネットワークからセンターラインを収集します。
-     * @param Target 道路ネットワークのターゲット
-     * @return 収集されたセンターラインのリスト
+     * 道路からセンターラインを収集します。
+     * @param Road 対象の道路
+     * @param OutList 収集されたセンターラインの追加先
      */
-    virtual FPLATEAUMarkedWayList ComposeFrom(const IPLATEAURrTarget* Target) override;
+    virtual void ComposeRoad(URnRoad* Road, FPLATEAUMarkedWayList& OutList) const override;
 
 private:
     /** センターラインが黄色となる条件に合致するかどうかを返します。 */
@@ -57,10 +62,11 @@ private:
     EPLATEAUMarkedWayType GetCenterLineTypeOfWidth(const URnRoad* Road) const;
 
     /**
-     * 線の中心に点を挿入したRnWayを新たに作って返します。
+     * 線の中心に点を挿入した頂点配列を新たに作って返します。
      * これにより、隣り合う点で近い交差点が違うケースを考慮せずにすみます。
+     * 頂点はWayのLineStringの並び順(IsReversedを適用しない順)で返します。
      */
-    URnWay* WayWithMiddlePoint(const URnWay* Way) const;
+    TArray<FVector> WayWithMiddlePoint(const URnWay* Way) const;
 
     static constexpr float WidthThreshold = 600.0f;                 // センターラインのタイプが変わるしきい値、道路の片側の幅
     static constexpr float YellowIntersectionThreshold = 3000.0f;   // 交差点との距離が近いかどうかのしきい値
@@ -18,11 +18,11 @@ class PLATEAURUNTIME_API UPLATEAUMCIntersection : public UObject, public IPLATEA
 
 public:
     /**
-     * 道路ネットワークから交差点の線を収集します。
-     * @param Target 道路ネットワークのターゲット
-     * @return 収集された交差点の線のリスト
+     * 交差点から交差点の線を収集します。
+     * @param Intersection 対象の交差点
+     * @param OutList 収集された交差点の線の追加先
      */
-    virtual FPLATEAUMarkedWayList ComposeFrom(const IPLATEAURrTarget* Target) override;
+    virtual void ComposeIntersection(URnIntersection* Intersection, FPLATEAUMarkedWayList& OutList) const override;
 
 private:
     /** 長すぎる交差点の線を無視するしきい値 */
@@ -19,9 +19,9 @@ class PLATEAURUNTIME_API UPLATEAUMCLaneLine : public UObject, public IPLATEAUMar
 
 public:
     /**
-     * 道路ネットワークから車線境界線を収集します。
-     * @param Target 道路ネットワークのターゲット
-     * @return 収集された車線境界線のリスト
+     * 道路から車線境界線を収集します。
+     * @param Road 対象の道路
+     * @param OutList 収集された車線境界線の追加先
      */
-    virtual FPLATEAUMarkedWayList ComposeFrom(const IPLATEAURrTarget* Target) override;
+    virtual void ComposeRoad(URnRoad* Road, FPLATEAUMarkedWayList& OutList) const override;
 };
@@ -19,9 +19,9 @@ class PLATEAURUNTIME_API UPLATEAUMCShoulderLine : public UObject, public IPLATEA
 
 public:
     /**
-     * 道路ネットワークから路側帯線を収集します。
-     * @param Target 道路ネットワークのターゲット
-     * @return 収集された路側帯線のリスト
+     * 道路から路側帯線を収集します。
+     * @param Road 対象の道路
+     * @param OutList 収集された路側帯線の追加先
      */
-    virtual FPLATEAUMarkedWayList ComposeFrom(const IPLATEAURrTarget* Target) override;
+    virtual void ComposeRoad(URnRoad* Road, FPLATEAUMarkedWayList& OutList) const override;
 };
@@ -7,6 +7,8 @@
 #include "RoadAdjust/RoadNetworkToMesh/PLATEAURrTarget.h"
 #include "PLATEAUMarkedWayListComposerMain.generated.h"
 
+class URnIntersection;
+
 /// インターフェイス宣言のためのダミークラス。 IPLATEAUMarkedWayListComposer を使ってください
 UINTERFACE()
 class UPLATEAUMarkedWayListComposer : public UInterface
@@ -21,7 +23,21 @@ class PLATEAURUNTIME_API IPLATEAUMarkedWayListComposer
 {
     GENERATED_BODY()
 public:
-    virtual FPLATEAUMarkedWayList ComposeFrom(const IPLATEAURrTarget* Target) = 0;
+    /**
+     * Targetの道路ごとにComposeRoadを, 交差点ごとにComposeIntersectionを呼んだ結果をまとめて返します。
+     */
+    virtual FPLATEAUMarkedWayList ComposeFrom(const IPLATEAURrTarget* Target);
+
+    /**
+     * 道路1つ分の線をOutListに追加します。
+     * UObjectを生成せず道路ネットワークを変更しないので、別々の道路に対して複数スレッドから同時に呼べます。
+     */
+    virtual void ComposeRoad(URnRoad* Road, FPLATEAUMarkedWayList& OutList) const {}
+
+    /**
+     * 交差点1つ分の線をOutListに追加します。ComposeRoadと同様に複数スレッドから同時に呼べます。
+     */
+    virtual void ComposeIntersection(URnIntersection* Intersection, FPLATEAUMarkedWayList& OutList) const {}
 };
 
 /**
@@ -39,10 +55,24 @@ public:
      * 道路ネットワークから、車線を引く対象となるMarkedWayListを収集します。
      */
     virtual FPLATEAUMarkedWayList ComposeFrom(const IPLATEAURrTarget* Target) override;
-    
+
+    /**
+     * RoadBasesの道路/交差点1つずつについて、車線を引く対象となるMarkedWayListを収集します。
+     * 戻り値のi番目はRoadBases[i]だけを対象にComposeFromを呼んだ結果と同じです。
+     */
+    TArray<FPLATEAUMarkedWayList> ComposePerRoadBase(const TArray<URnRoadBase*>& RoadBases);
+
     // 経験的にこのくらいの高さなら道路にめりこまないという値
     static constexpr float HeightOffset = 9.0f;
 
 private:
-    
+    /**
+     * 道路/交差点とコンポーザーの組ごとに並列で線を生成します。
+     * 戻り値の[RoadBaseIndex * Composers.Num() + ComposerIndex]がその組の結果(高さオフセット適用済み)です。
+     */
+    TArray<FPLATEAUMarkedWayList> ComposeEach(const TArray<URnRoadBase*>& RoadBases);
+
+    // 生成したい線の種類ごとのコンポーザー. 道路ごとに何度も呼ばれるので使い回します
+    UPROPERTY()
+    TArray<TScriptInterface<IPLATEAUMarkedWayListComposer>> Composers;
 };
@@ -0,0 +1,75 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "RoadAdjust/PLATEAUCrosswalkPlacementRule.h"
+#include "RoadAdjust/RoadMarking/PLATEAUMarkedWay.h"
+#include "RoadNetwork/Structure/RnModel.h"
+
+/**
+ * @brief 道路/交差点ごとに道路標示の線を保持し, 前回の生成から変化した部分とその周辺だけを作り直すためのキャッシュです。
+ * 変化は道路/交差点の形状と接続から計算したシグネチャで判定します。
+ */
+class PLATEAURUNTIME_API FPLATEAURoadMarkingCache {
+public:
+    /**
+     * @brief 道路/交差点1つ分の道路標示
+     */
+    struct FEntry {
+        // 生成時の形状と接続のシグネチャ
+        uint32 Signature = 0;
+        TArray<FPLATEAUMarkedWay> MarkedWays;
+        // この道路/交差点が変化したときに線を作り直す必要がある道路/交差点
+        TArray<TObjectKey<URnRoadBase>> Dependents;
+    };
+
+    /**
+     * @brief Updateの結果
+     */
+    struct FUpdateResult {
+        // 線を作り直した, または削除した道路/交差点
+        TArray<TObjectKey<URnRoadBase>> UpdatedRoadBases;
+        // 作り直す前の線
+        TArray<FPLATEAUMarkedWay> OldMarkedWays;
+
+        bool IsEmpty() const { return UpdatedRoadBases.Num() == 0; }
+    };
+
+    /**
+     * @brief 前回のUpdateから追加/変更された道路/交差点を返します. 横断歩道の頻度が変わった場合は全てを返します
+     */
+    TArray<URnRoadBase*> FindChangedRoadBases(const URnModel* Model, EPLATEAUCrosswalkFrequency CrosswalkFrequency) const;
+
+    /**
+     * @brief ChangedRoadBasesとその周辺, および削除された道路/交差点の周辺の線を作り直します
+     */
+    FUpdateResult Update(URnModel* Model, const TArray<URnRoadBase*>& ChangedRoadBases, EPLATEAUCrosswalkFrequency CrosswalkFrequency);
+
+    /**
+     * @brief 保持している全ての線をモデルの道路, 交差点の順に返します
+     */
+    TArray<FPLATEAUMarkedWay> GetMarkedWays(const URnModel* Model) const;
+
+    const FEntry* Find(const URnRoadBase* RoadBase) const;
+
+    bool IsEmpty() const { return Entries.Num() == 0; }
+
+    void Reset();
+
+    /**
+     * @brief 道路標示の生成に影響する形状と接続からシグネチャを計算します
+     */
+    static uint32 ComputeSignature(const URnRoadBase* RoadBase);
+
+    /**
+     * @brief RoadBaseが変化したときに線を作り直す必要がある道路/交差点を返します
+     * 道路の場合はセンターラインが交差点までの距離に依存するため, 交差点までの道路の連なり全体が対象になります
+     */
+    static TArray<URnRoadBase*> CollectDependents(const URnRoadBase* RoadBase);
+
+private:
+    TMap<TObjectKey<URnRoadBase>, FEntry> Entries;
+    TOptional<EPLATEAUCrosswalkFrequency> CrosswalkFrequency;
+};
@@ -0,0 +1,92 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MeshDescription.h"
+#include "RoadAdjust/PLATEAUReproducedRoad.h"
+#include "RoadAdjust/PLATEAURoadLineType.h"
+
+/**
+ * @brief 道路標示の線を, 種類と空間チャンクごとに1つのメッシュへまとめます。
+ * ULineGeneratorComponentは破線1つごとにUSplineMeshComponentを作りますが, こちらは同じ位置に板ポリゴンを並べたメッシュを作ります。
+ */
+class PLATEAURUNTIME_API FPLATEAURoadMarkingMeshBuilder {
+public:
+    /**
+     * @brief 破線1つ分(USplineMeshComponent1つ分)の始点/終点
+     */
+    struct FDash {
+        FVector Start;
+        FVector End;
+    };
+
+    /**
+     * @brief 1チャンク分のメッシュ
+     */
+    struct FChunkMesh {
+        EPLATEAURoadLineType Type = EPLATEAURoadLineType::None;
+        FIntPoint Chunk;
+        int32 DashNum = 0;
+        FMeshDescription MeshDescription;
+    };
+
+    // メッシュのマテリアルスロット名
+    static const FName MaterialSlotName;
+
+    /**
+     * @param InLineTypeMap 線の種類ごとのパラメータ. メッシュのサイズを取得するためゲームスレッドで呼び出してください
+     * @param InChunkSize 1つのメッシュにまとめる範囲(cm)
+     */
+    FPLATEAURoadMarkingMeshBuilder(const TMap<EPLATEAURoadLineType, FPLATEAURoadLineParam>& InLineTypeMap, float InChunkSize);
+
+    /**
+     * @brief 線を追加します
+     */
+    void AddLine(EPLATEAURoadLineType Type, const TArray<FVector>& LinePoints, FVector2D Offset = FVector2D::Zero());
+
+    /**
+     * @brief 追加した線をチャンクごとのメッシュにします. UObjectを触らないのでゲームスレッド以外から呼び出せます
+     * @param TargetChunks 指定した場合はそのチャンクのメッシュだけを作ります
+     */
+    TArray<FChunkMesh> Build(const TSet<FIntPoint>* TargetChunks = nullptr) const;
+
+    /**
+     * @brief 位置が属するチャンクを返します
+     */
+    static FIntPoint GetChunk(const FVector& Position, float InChunkSize);
+
+    /**
+     * @brief 線の破線が属しうるチャンク(線のバウンディングボックスと重なるチャンク)を追加します
+     */
+    static void GetOverlappingChunks(const TArray<FVector>& LinePoints, float InChunkSize, TSet<FIntPoint>& OutChunks);
+
+    /**
+     * @brief ULineGeneratorComponentと同じ規則で線を破線に分割します(スプラインは直線補間として扱います)
+     * @param Gap 0の場合は線の頂点ごとに分割します
+     */
+    static TArray<FDash> ComputeDashes(const TArray<FVector>& LinePoints, float MeshLength, float Gap, bool bFillEnd);
+
+private:
+    // 線の種類ごとのメッシュの形状
+    struct FProfile {
+        float MeshLength = 0.f;
+        float Gap = 0.f;
+        bool bFillEnd = false;
+        float HalfWidth = 0.f;
+        float CenterY = 0.f;
+        float Height = 0.f;
+    };
+
+    struct FLine {
+        EPLATEAURoadLineType Type;
+        TArray<FVector> Points;
+        FVector2D Offset;
+    };
+
+    void AppendDash(FMeshDescription& MeshDescription, const FProfile& Profile, const FDash& Dash, const FVector2D& Offset) const;
+
+    TMap<EPLATEAURoadLineType, FProfile> Profiles;
+    TArray<FLine> Lines;
+    float ChunkSize;
+};
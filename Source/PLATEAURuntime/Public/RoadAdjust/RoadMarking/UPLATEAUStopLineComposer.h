@@ -16,11 +16,11 @@ public:
     ~UPLATEAUStopLineComposer() = default;
 
     /**
-     * @brief 道路ネットワークから停止線を生成します。
-     * @param Target 道路ネットワークのターゲット
-     * @return 生成された停止線のリスト
+     * @brief 道路の交差点側の端に停止線を生成します。
+     * @param Road 対象の道路
+     * @param OutList 生成された停止線の追加先
      */
-    FPLATEAUMarkedWayList ComposeFrom(const IPLATEAURrTarget* Target) override;
+    virtual void ComposeRoad(URnRoad* Road, FPLATEAUMarkedWayList& OutList) const override;
 
 private:
     static constexpr float CONST_HeightOffset = 7.0f; // 7cm。経験的にこのくらいの高さなら道路にめりこまないという値
@@ -30,5 +30,5 @@ private:
      * @param WayList 停止線を追加するリスト
      * @param Border 境界線
      */
-    void AddStopLine(FPLATEAUMarkedWayList& WayList, const FPLATEAUMWLine& Border);
+    void AddStopLine(FPLATEAUMarkedWayList& WayList, const FPLATEAUMWLine& Border) const;
 };
@@ -0,0 +1,110 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MeshDescription.h"
+#include "RoadAdjust/PLATEAUReproducedRoad.h"
+
+class URnModel;
+class URnRoad;
+class URnIntersection;
+class URnSideWalk;
+
+/**
+ * @brief 道路ネットワークの車線/中央分離帯/歩道/交差点の輪郭から路面を三角形分割し, 空間チャンクごとに1つのメッシュへまとめます。
+ * 車線と歩道は左右の境界線に挟まれた帯として, 交差点は輪郭の多角形として分割します。
+ */
+class PLATEAURUNTIME_API FPLATEAURoadSurfaceMeshBuilder {
+public:
+    /**
+     * @brief 1チャンク分のメッシュ. ポリゴングループは面の種類の順に並びます
+     */
+    struct FChunkMesh {
+        FIntPoint Chunk;
+        int32 SurfaceNum = 0;
+        FMeshDescription MeshDescription;
+    };
+
+    // 面の種類の数(=マテリアルスロットの数)
+    static constexpr int32 SurfaceTypeNum = 4;
+
+    /**
+     * @brief 面の種類に対応するマテリアルスロット名
+     */
+    static FName GetMaterialSlotName(EPLATEAURoadSurfaceType Type);
+
+    /**
+     * @param InChunkSize 1つのメッシュにまとめる範囲(cm)
+     * @param InUVScale UVの1がこの長さ(cm)になるように上から投影します
+     */
+    explicit FPLATEAURoadSurfaceMeshBuilder(float InChunkSize, float InUVScale = 100.f);
+
+    /**
+     * @brief モデルの全ての道路/交差点/歩道を追加します. UObjectを読むのでゲームスレッドで呼び出してください
+     */
+    void AddModel(const URnModel* Model);
+
+    /**
+     * @brief 道路の車線と中央分離帯を追加します
+     */
+    void AddRoad(const URnRoad* Road);
+
+    /**
+     * @brief 交差点の輪郭で囲まれた面を追加します
+     */
+    void AddIntersection(const URnIntersection* Intersection);
+
+    /**
+     * @brief 歩道の内側と外側の線に挟まれた面を追加します
+     */
+    void AddSideWalk(const URnSideWalk* SideWalk);
+
+    /**
+     * @brief 2本の線に挟まれた帯状の面を追加します. 線の向きが逆の場合はそろえます
+     */
+    void AddStrip(EPLATEAURoadSurfaceType Type, const TArray<FVector>& Left, const TArray<FVector>& Right);
+
+    /**
+     * @brief 輪郭線で囲まれた面を追加します
+     */
+    void AddPolygon(EPLATEAURoadSurfaceType Type, const TArray<FVector>& Outline);
+
+    /**
+     * @brief 追加した面を三角形分割し, チャンクごとのメッシュにします. UObjectを触らないのでゲームスレッド以外から呼び出せます
+     */
+    TArray<FChunkMesh> Build() const;
+
+    int32 Num() const { return Surfaces.Num(); }
+
+    /**
+     * @brief 面が属するチャンク(頂点のバウンディングボックスの中心が含まれるチャンク)を返します
+     */
+    static FIntPoint GetChunk(const TArray<FVector>& Vertices, float InChunkSize);
+
+    /**
+     * @brief 2本の線に挟まれた帯を三角形分割します. 2本の線の向きはそろっている必要があります
+     * @return 頂点配列Left + Rightへのインデックス. 3つで1つの三角形で, 上から見て時計回りです
+     */
+    static TArray<int32> TriangulateStrip(TConstArrayView<FVector> Left, TConstArrayView<FVector> Right);
+
+    /**
+     * @brief XY平面に投影した単純多角形を耳刈り法で三角形分割します
+     * @return 頂点配列Outlineへのインデックス. 3つで1つの三角形で, 上から見て時計回りです
+     */
+    static TArray<int32> TriangulatePolygon(TConstArrayView<FVector> Outline);
+
+private:
+    struct FSurface {
+        EPLATEAURoadSurfaceType Type;
+        TArray<FVector> Vertices;
+        // 帯の場合はVerticesの先頭LeftNum個が片側の線
+        int32 LeftNum = INDEX_NONE;
+    };
+
+    void AppendSurface(FMeshDescription& MeshDescription, const FSurface& Surface, const TArray<int32>& Indices) const;
+
+    TArray<FSurface> Surfaces;
+    float ChunkSize;
+    float UVScale;
+};
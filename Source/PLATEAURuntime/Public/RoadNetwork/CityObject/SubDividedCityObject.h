@@ -16,7 +16,7 @@ class URnPoint;
 struct FAttributeDataHelper;
 
 USTRUCT(BlueprintType)
-struct FSubDividedCityObjectSubMesh {
+struct PLATEAURUNTIME_API FSubDividedCityObjectSubMesh {
     GENERATED_BODY()
 public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
@@ -76,6 +76,8 @@ public:
     ERRoadTypeMask GetRoadType(bool ContainsParent) const;
     TArray<const FSubDividedCityObject*> GetAllChildren() const;
     void SetCityObjectGroup(UPLATEAUCityObjectGroup* Group);
+    // 弱参照をそのまま設定します. UObjectを参照しないのでワーカースレッドから呼べます
+    void SetCityObjectGroup(const TWeakObjectPtr<UPLATEAUCityObjectGroup>& Group);
     TSharedPtr<FSubDividedCityObject> DeepCopy();
 
     static ERRoadTypeMask GetRoadTypeFromCityObject(const FPLATEAUCityObject& CityObject);
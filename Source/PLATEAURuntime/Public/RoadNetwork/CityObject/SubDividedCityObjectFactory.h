@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Tasks/Task.h"
 #include "RoadNetwork/PLATEAURnDef.h"
 #include "PLATEAUInstancedCityModel.h"
 #include "SubDividedCityObject.h"
@@ -31,11 +32,53 @@ public:
         }
     };
 
-    TSharedPtr<FConvertCityObjectResult> ConvertCityObjectsAsync(
+    // 変換の入力. GatherConvertInputsでゲームスレッドで集め, 変換中はUObjectに触らないようにします
+    class FConvertInput {
+    public:
+        // 結果に設定するだけで変換では参照しません
+        TWeakObjectPtr<UPLATEAUCityObjectGroup> CityObjectGroup;
+        std::shared_ptr<plateau::polygonMesh::Model> BaseModel;
+        TMap<FString, FPLATEAUCityObject> CityObjMap;
+    };
+
+    /**
+     * @brief CityObjectGroupsのうち変換対象のメッシュと属性情報を読み出します. ゲームスレッドで呼んでください
+     */
+    static TArray<FConvertInput> GatherConvertInputs(
+        APLATEAUInstancedCityModel* Actor,
+        const TArray<UPLATEAUCityObjectGroup*>& CityObjectGroups);
+
+    /**
+     * @brief GatherConvertInputsで集めた入力を最小地物に分解します. UObjectに触らないのでワーカースレッドから呼び出すことができます
+     *        CityObjectGroupごとに並列で変換し, 結果は入力の順に並べます
+     * @param bCanceled trueになると残りのCityObjectGroupを変換せずに終了します
+     * @param OnProgress 変換済みのCityObjectGroupの数と全体の数を通知します. 複数のスレッドから呼ばれます
+     */
+    TSharedPtr<FConvertCityObjectResult> ConvertCityObjects(
+        TArray<FConvertInput>& Inputs,
+        TAtomic<bool>* bCanceled = nullptr,
+        TFunction<void(int32, int32)> OnProgress = nullptr);
+
+    /**
+     * @brief CityObjectGroupsを最小地物に分解します(GatherConvertInputs + ConvertCityObjects). ゲームスレッドで呼んでください
+     */
+    TSharedPtr<FConvertCityObjectResult> ConvertCityObjects(
+        APLATEAUInstancedCityModel* Actor,
+        const TArray<UPLATEAUCityObjectGroup*>& CityObjectGroups,
+        float Epsilon = 0.1f,
+        bool UseContourMesh = true,
+        TAtomic<bool>* bCanceled = nullptr,
+        TFunction<void(int32, int32)> OnProgress = nullptr);
+
+    /**
+     * @brief 入力をゲームスレッドで集めてから, 変換をワーカースレッドで実行します. ゲームスレッドで呼んでください
+     */
+    UE::Tasks::TTask<TSharedPtr<FConvertCityObjectResult>> ConvertCityObjectsAsync(
         APLATEAUInstancedCityModel* Actor,
         const TArray<UPLATEAUCityObjectGroup*>& CityObjectGroups,
         float Epsilon = 0.1f,
-        bool UseContourMesh = true);
+        bool UseContourMesh = true,
+        TAtomic<bool>* bCanceled = nullptr);
 
 private:
 #if false
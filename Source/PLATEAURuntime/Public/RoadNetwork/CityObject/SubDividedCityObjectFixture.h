@@ -0,0 +1,33 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SubDividedCityObject.h"
+
+class FArchive;
+
+/**
+ * @brief 最小地物(FSubDividedCityObject)をバイナリ形式で保存/復元します. 道路構造生成のベンチマーク入力に使います
+ *        RGraphの作成に必要な情報(名前, 道路タイプ, メッシュ, 子)と, 参照しているCityObjectGroupの名前/MinLOD/Transformを保存します.
+ *        属性情報(CityObject, SerializedCityObjects)は保存しません
+ *        復元時はCityObjectGroupを指定したOuterに作り直すので, 元のアクターが無くても再生できます
+ */
+class PLATEAURUNTIME_API FSubDividedCityObjectFixture
+{
+public:
+    // 形式のバージョン. 互換性のない変更をしたら上げてください
+    static constexpr uint32 Version = 1;
+
+    static void Write(const TArray<FSubDividedCityObject>& CityObjects, TArray<uint8>& OutData);
+
+    /**
+     * @brief Writeで書き込んだデータから最小地物を復元します
+     * @param Outer 作り直すUPLATEAUCityObjectGroupのOuter
+     * @return データが壊れている, もしくはバージョンが異なる場合はfalse
+     */
+    static bool Read(TConstArrayView<uint8> Data, UObject* Outer, TArray<FSubDividedCityObject>& OutCityObjects);
+
+    static bool SaveToFile(const TArray<FSubDividedCityObject>& CityObjects, const FString& Path);
+    static bool LoadFromFile(const FString& Path, UObject* Outer, TArray<FSubDividedCityObject>& OutCityObjects);
+};
@@ -3,12 +3,14 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Tasks/Task.h"
 #include "RoadNetwork/PLATEAURnDef.h"
 #include "../RGraph/RGraphDef.h"
 #include <memory>
 #include <functional>
 
 #include "PLATEAUInstancedCityModel.h"
+#include "RoadNetwork/CityObject/SubDividedCityObjectFactory.h"
 #include "RoadNetwork/RGraph/RGraphFactory.h"
 #include "RoadNetwork/Structure/RnModel.h"
 #include "RoadNetworkFactory.generated.h"
@@ -23,6 +25,7 @@ class URnWay;
 class URnLineString;
 class URnLane;
 class URnPoint;
+class FPLATEAURnStageProfiler;
 
 
 USTRUCT(BlueprintType)
@@ -62,6 +65,10 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
     bool bSaveTmpData = false;
 
+    // 最小地物をベンチマークの入力(FSubDividedCityObjectFixture)としてSaved/PLATEAU/RoadNetwork以下に保存する
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
+    bool bSaveBenchmarkFixture = false;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
     bool bUseContourMesh = true;
 
@@ -95,7 +102,7 @@ public:
 
 };
 
-struct FRoadNetworkFactoryEx
+struct PLATEAURUNTIME_API FRoadNetworkFactoryEx
 {
    
     struct FCreateRnModelRequest {
@@ -107,8 +114,37 @@ struct FRoadNetworkFactoryEx
 
     static void CreateRnModel(const FRoadNetworkFactory& Self, APLATEAUInstancedCityModel* Actor, APLATEAURnStructureModel* DestActor);
 
+    /**
+     * @brief CreateRnModelをワーカースレッドで行います. ゲームスレッドから呼び出してください.
+     *        最小地物への分解, RGraphの作成/最適化, RnModelの構築はワーカースレッドで行い,
+     *        コンポーネントの作成と生成したUObjectの確定だけをゲームスレッドで行います.
+     *        RnModelはDestActorから切り離した新しいものに構築し, 完了時にゲームスレッドでDestActorのRnModelと置き換えます.
+     *        Actor/DestActorは弱参照で保持し, 途中で破棄された場合は中断します.
+     *        ゲームスレッドで行う段階は後続のタスクとして実行するので, 返り値のタスクもゲームスレッドで完了します.
+     *        そのため返り値のタスクをゲームスレッドでWaitしないでください.
+     * @param bCanceled trueになると実行中の段階が終わった時点で中断します. 中断した場合DestActorのRnModelは変更しません
+     * @param OnProgress 進捗(0~1)とその説明. ゲームスレッドで呼ばれます
+     * @return 作成したRnModel. 中断した場合はnullptr
+     */
+    static UE::Tasks::TTask<URnModel*> CreateRnModelAsync(
+        const FRoadNetworkFactory& Self
+        , APLATEAUInstancedCityModel* Actor
+        , APLATEAURnStructureModel* DestActor
+        , TSharedRef<TAtomic<bool>> bCanceled
+        , TFunction<void(float, const FText&)> OnProgress);
+
     // Targetが生成対象かどうか
     static bool IsConvertTarget(UPLATEAUCityObjectGroup* Target);
+
+    /**
+     * @brief 最小地物からRGraphの作成, RnModelの構築までを行います. 記録した入力をベンチマークで再生するために使います
+     * @param Profiler 指定すると段階ごとの時間/メモリ/オブジェクト数を記録します
+     */
+    static TRnRef_T<URnModel> CreateRnModelFromSubDividedCityObjects(
+        const FRoadNetworkFactory& Self
+        , const TArray<FSubDividedCityObject>& SubDividedCityObjects
+        , URnModel* OutModel
+        , FPLATEAURnStageProfiler* Profiler = nullptr);
 private:
 
     static TRnRef_T<URnModel> CreateRoadNetwork(
@@ -125,6 +161,19 @@ private:
         , TArray<UPLATEAUCityObjectGroup*>& CityObjectGroups
         , TArray<FSubDividedCityObject>& OutSubDividedCityObjects);
 
+    // FSubDividedCityObjectFactory::GatherConvertInputs(ゲームスレッド)で集めた入力を最小地物に分解する
+    // UObjectに触らないのでワーカースレッドから呼べる
+    static void ConvertSubDividedCityObjects(TArray<FSubDividedCityObjectFactory::FConvertInput>& Inputs
+        , TArray<FSubDividedCityObject>& OutSubDividedCityObjects
+        , TAtomic<bool>* bCanceled = nullptr
+        , TFunction<void(int32, int32)> OnProgress = nullptr);
+
+    // 最小地物をbSaveTmpDataに応じてコンポーネントとして保存する(ゲームスレッド)
+    static void SaveSubDividedCityObjects(const FRoadNetworkFactory& Self, APLATEAUInstancedCityModel* Actor
+        , AActor* DestActor
+        , USceneComponent* Root
+        , const TArray<FSubDividedCityObject>& SubDividedCityObjects);
+
     // RGraphを作成する
     static void CreateRGraph(const FRoadNetworkFactory& Self, APLATEAUInstancedCityModel* Actor
         , AActor* DestActor
@@ -132,11 +181,19 @@ private:
         , TArray<FSubDividedCityObject>& SubDividedCityObjects
         , RGraphRef_t<URGraph>& OutGraph);
 
+    // RGraphをbSaveTmpDataに応じてコンポーネントとして保存する(ゲームスレッド)
+    static void SaveRGraph(const FRoadNetworkFactory& Self
+        , AActor* DestActor
+        , USceneComponent* Root
+        , RGraphRef_t<URGraph> Graph);
+
     // RnModelを作成する
     static  TRnRef_T<URnModel> CreateRnModel(
         const FRoadNetworkFactory& Self
         , RGraphRef_t<URGraph> Graph
-        , URnModel* OutModel);
+        , URnModel* OutModel
+        , TAtomic<bool>* bCanceled = nullptr
+        , FPLATEAURnStageProfiler* Profiler = nullptr);
 };
 
 
@@ -145,19 +202,27 @@ private:
  *
  * URnPoint 配列から URnLineString および URnWay を生成する際のキャッシュ機能を実装します。
  */
-class FPLATEAULineStringFactoryWork {
+class PLATEAURUNTIME_API FPLATEAULineStringFactoryWork {
 public:
-    // キャッシュにおけるエントリ。point リストのコピーと、それに対応する LineString を保持。
+    // キャッシュにおけるエントリ。CachedPoints 上の point リストの範囲と、それに対応する LineString を保持。
     struct FPointCache {
-        // URnPoint ポインタの配列のコピー
-        TArray<URnPoint*> Points;
+        // CachedPoints 内の先頭位置
+        int32 PointOffset = 0;
+        // ポイント数
+        int32 PointNum = 0;
         // 上記ポイントから生成された URnLineString オブジェクト
         URnLineString* LineString = nullptr;
     };
 
+    // 全エントリの point リストを詰めて保持する配列
+    TArray<URnPoint*> CachedPoints;
+
+    // キャッシュエントリ
+    TArray<FPointCache> PointCaches;
+
     // キャッシュマップ。
-    // キーは各ポイントの DebugMyId を XOR 演算した値、値は FPointCache の配列。
-    TMap<uint64, TArray<FPointCache>> RnPointList2LineStringMap;
+    // キーは point 列を向きを揃えた(正順/逆順のうち小さい方)上で計算したハッシュ、値は PointCaches のインデックス。
+    TMultiMap<uint32, int32> PointCacheIndices;
 
 public:
     FPLATEAULineStringFactoryWork() {}
@@ -170,6 +235,13 @@ public:
      * @return 等しければ true、そうでなければ false を返す
      */
     static bool IsEqual(const TArray<URnPoint*>& A, const TArray<URnPoint*>& B, bool& bIsReversed);
+    static bool IsEqual(TArrayView<URnPoint* const> A, TArrayView<URnPoint* const> B, bool& bIsReversed);
+
+    /**
+     * URnPoint 配列の向きに依存しないハッシュを計算します。
+     * 正順と逆順のうち, ポインタ列として小さい方の向きで計算するため Points とその逆順は同じ値になります。
+     */
+    static uint32 GetDirectionNormalizedHash(TArrayView<URnPoint* const> Points);
 
     /**
      * URnPoint 配列から URnLineString を生成します。
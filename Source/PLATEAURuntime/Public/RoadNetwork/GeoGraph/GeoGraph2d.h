@@ -62,11 +62,57 @@ public:
 
     static TArray<FVector2D> ComputeConvexVolume(const TArray<FVector2D>& Vertices);
 
+    /**
+     * @brief 各頂点について, それより前にある頂点のうち距離がEpsilon未満で最も近い頂点のインデックスを返します.
+     *        該当する頂点が無い場合は自身のインデックスになります.
+     *        CalcDistanceは任意の距離関数を使えるため全頂点の組を調べます(O(N^2)).
+     */
     static TArray<int32> GetNearVertexTable(
         const TArray<FVector>& Vertices,
         TFunction<float(const FVector&, const FVector&)> CalcDistance,
         float Epsilon = 0.1f);
 
+    /**
+     * @brief CalcDistanceにユークリッド距離(FVector::Distance)を使った場合と同じ結果を返します.
+     *        Epsilonサイズのグリッドで近傍の頂点だけを調べます.
+     */
+    static TArray<int32> GetNearVertexTable(
+        const TArray<FVector>& Vertices,
+        float Epsilon = 0.1f);
+
+    /**
+     * @brief 外周の辺リストを頂点ごとに引けるようにしたものです(CSR形式).
+     *        各頂点の辺は元の辺リストの順に並び, 使用済みの辺はPopFirstEdgeで読み飛ばします.
+     *        ComputeMeshOutlineVerticesとFSubDividedCityObjectSubMesh::CreateOutlineIndicesで外周をたどるのに使います.
+     */
+    struct PLATEAURUNTIME_API FOutlineEdgeAdjacency {
+        /**
+         * @param Edges 辺リスト. 頂点インデックスは0以上VertexNum未満
+         */
+        FOutlineEdgeAdjacency(const TArray<TTuple<int32, int32>>& Edges, int32 VertexNum);
+
+        /**
+         * @brief 未使用の辺を使用済みにします. 使用済みだった場合はfalse
+         */
+        bool MarkUsed(int32 EdgeIndex);
+
+        /**
+         * @brief Vertexを含む未使用の辺のうち, 元の辺リストで最も前にあるものを使用済みにして返します. なければINDEX_NONE
+         */
+        int32 PopFirstEdge(int32 Vertex);
+
+    private:
+        // i番目の頂点の辺はEdgeIndices[Offsets[i]]からEdgeIndices[Offsets[i + 1] - 1]
+        TArray<int32> Offsets;
+        TArray<int32> EdgeIndices;
+        TArray<int32> Cursors;
+        TArray<bool> Used;
+    };
+
+    /**
+     * @brief 三角形メッシュの外周(1つの三角形にしか含まれない辺)をたどった頂点列を返します.
+     *        頂点ごとの外周辺リストを使って辿るため外周辺の数に対して線形時間です.
+     */
     static TArray<FVector> ComputeMeshOutlineVertices(
         const TArray<FVector>& Vert,
         const TArray<int32>& Triangles,
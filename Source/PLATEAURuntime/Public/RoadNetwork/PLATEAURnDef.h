@@ -106,6 +106,25 @@ public:
 
     static void SetNewObjectWorld(UObject* World);
 
+    // FNewObjectOuterScopeで現在のスレッドに指定されているOuter. 指定されていない場合はnullptr
+    static UObject* GetScopedNewObjectOuter();
+
+    /*
+     * スコープ内で現在のスレッドがRnNew/RGraphNewで作るオブジェクトのOuterを指定する.
+     * SetNewObjectWorldと異なり他のスレッドには影響しないので, ゲームスレッド以外での構築に使う
+     */
+    class PLATEAURUNTIME_API FNewObjectOuterScope {
+    public:
+        explicit FNewObjectOuterScope(UObject* Outer);
+        ~FNewObjectOuterScope();
+
+        FNewObjectOuterScope(const FNewObjectOuterScope&) = delete;
+        FNewObjectOuterScope& operator=(const FNewObjectOuterScope&) = delete;
+
+    private:
+        UObject* PrevOuter;
+    };
+
     static FVector2D To2D(const FVector& Vector);
 
     static FRay2D To2D(const FRay& Ray);
@@ -0,0 +1,92 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RGraph.h"
+
+class UPLATEAUCityObjectGroup;
+
+/**
+ * @brief URGraphと同じ頂点/辺/面の関係をインデックスで表現したグラフです。
+ *
+ * 頂点座標、辺の端点、面の辺リスト、面の属性をそれぞれ連続した配列で持ちます。
+ * UObjectを生成しないため、FRGraphFactoryExの前半の最適化(高さ調整、頂点/辺の統合)を
+ * GCの対象となるオブジェクトを作らずに行い、最後にToGraphでURGraphへ変換します。
+ *
+ * 頂点や辺の統合はVertexRemap/EdgeRemapに記録するだけで、Compactで配列を詰め直します。
+ */
+class PLATEAURUNTIME_API FRCompactGraph {
+public:
+    /**
+     * @brief 頂点を追加します。同じ座標の頂点が追加済みの場合はそのインデックスを返します。
+     */
+    int32 FindOrAddVertex(const FVector& Position);
+
+    /**
+     * @brief 面を追加します。以降のAddFaceEdgeはこの面に対して行われます。
+     */
+    int32 AddFace(UPLATEAUCityObjectGroup* CityObjectGroup, ERRoadTypeMask RoadType, int32 LodLevel);
+
+    /**
+     * @brief 最後に追加した面に辺(V0, V1)を追加します。同じ頂点からなる辺が追加済みの場合は共有します。
+     */
+    void AddFaceEdge(int32 V0, int32 V1);
+
+    int32 GetVertexCount() const { return Positions.Num(); }
+    int32 GetEdgeCount() const { return EdgeV0.Num(); }
+    int32 GetFaceCount() const { return FaceLodLevels.Num(); }
+
+    /**
+     * @brief FRGraphEx::AdjustSmallLodHeightと同じ処理です。
+     */
+    void AdjustSmallLodHeight(float MergeCellSizeMeter, float HeightToleranceMeter);
+
+    /**
+     * @brief FRGraphEx::EdgeReductionと同じ処理です。同じ頂点からなる辺を統合します。
+     */
+    void EdgeReduction();
+
+    /**
+     * @brief FRGraphEx::VertexReductionと同じ処理です。近い頂点の統合と, 直線上の中間点の削除を行います。
+     */
+    void VertexReduction(float MergeCellSizeMeter, int32 MergeCellLength, float MidPointToleranceMeter);
+
+    /**
+     * @brief 統合/削除された頂点・辺を取り除いて配列を詰め直します。
+     * 統合により同じ辺を持つようになった面は1つにまとめます(UREdge::MergeToと同じ)。
+     */
+    void Compact();
+
+    /**
+     * @brief URGraphを作成します。
+     */
+    RGraphRef_t<URGraph> ToGraph();
+
+private:
+    int32 FindVertex(int32 Vertex);
+    int32 FindEdge(int32 Edge) const;
+    int32 GetOppositeVertex(int32 Edge, int32 Vertex) const;
+
+    static uint64 MakeEdgeKey(int32 V0, int32 V1);
+
+    // 頂点
+    TArray<FVector> Positions;
+    // 統合先の頂点. 統合されていなければ自身
+    TArray<int32> VertexRemap;
+    TMap<FVector, int32> VertexMap;
+
+    // 辺
+    TArray<int32> EdgeV0;
+    TArray<int32> EdgeV1;
+    // 統合先の辺. 統合されていなければ自身, 削除された場合はINDEX_NONE
+    TArray<int32> EdgeRemap;
+    TMap<uint64, int32> EdgeMap;
+
+    // 面. i番目の面の辺はFaceEdges[FaceEdgeOffsets[i]]からFaceEdges[FaceEdgeOffsets[i + 1] - 1]
+    TArray<int32> FaceEdgeOffsets = { 0 };
+    TArray<int32> FaceEdges;
+    TArray<TWeakObjectPtr<UPLATEAUCityObjectGroup>> FaceCityObjectGroups;
+    TArray<ERRoadTypeMask> FaceRoadTypes;
+    TArray<int32> FaceLodLevels;
+};
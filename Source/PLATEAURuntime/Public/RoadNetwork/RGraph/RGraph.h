@@ -19,7 +19,7 @@ class URFace;
 class URGraph;
 
 UCLASS()
-class URVertex : public UObject {
+class PLATEAURUNTIME_API URVertex : public UObject {
     GENERATED_BODY()
 public:
     URVertex() = default;
@@ -59,7 +59,7 @@ private:
 };
 
 UCLASS()
-class UREdge : public UObject {
+class PLATEAURUNTIME_API UREdge : public UObject {
     GENERATED_BODY()
 public:
     enum class EVertexType : uint8 {
@@ -118,7 +118,7 @@ private:
 };
 
 UCLASS()
-class URFace : public UObject {
+class PLATEAURUNTIME_API URFace : public UObject {
     GENERATED_BODY()
 public:
     URFace() = default;
@@ -164,19 +164,46 @@ private:
 };
 
 UCLASS()
-class URGraph : public UObject {
+class PLATEAURUNTIME_API URGraph : public UObject {
     GENERATED_BODY()
 public:
     URGraph();
     void Init(){}
+    virtual void PostLoad() override;
     const auto& GetFaces() const { return Faces; }
+
+    // 面から参照されている全ての辺/頂点. 面/辺/頂点の変更に合わせて更新されるキャッシュを返す
+    // 走査中にグラフを変更する場合はコピーを返すGetAllEdges/GetAllVerticesを使うこと
+    const TSet<RGraphRef_t<UREdge>>& GetEdges() const;
+    const TSet<RGraphRef_t<URVertex>>& GetVertices() const;
     TSet<RGraphRef_t<UREdge>> GetAllEdges();
     TSet<RGraphRef_t<URVertex>> GetAllVertices();
     void AddFace(RGraphRef_t<URFace> Face);
     void RemoveFace(RGraphRef_t<URFace> Face);
+
+    // 辺/頂点のキャッシュを面から作り直したものと比較する. 一致しない場合はエラーログを出してfalseを返す
+    // plateau.RoadNetwork.ValidateGraphCache = 1の時はGetEdges/GetVertices等の呼び出し毎に行われる
+    bool ValidateCache() const;
+
+    // URFace/UREdgeから呼ばれる. キャッシュの更新用
+    void OnFaceEdgeAdded(RGraphRef_t<URFace> Face, RGraphRef_t<UREdge> Edge);
+    void OnFaceEdgeRemoved(RGraphRef_t<URFace> Face, RGraphRef_t<UREdge> Edge);
+    void OnEdgeVertexChanged(RGraphRef_t<UREdge> Edge, RGraphRef_t<URVertex> From, RGraphRef_t<URVertex> To);
 private:
+    void RebuildCache();
+    void AddEdgeRef(RGraphRef_t<UREdge> Edge);
+    void RemoveEdgeRef(RGraphRef_t<UREdge> Edge);
+    void AddVertexRef(RGraphRef_t<URVertex> Vertex);
+    void RemoveVertexRef(RGraphRef_t<URVertex> Vertex);
+
     UPROPERTY()
     TSet<TObjectPtr<URFace>> Faces;
+
+    // 辺を参照している面の数/頂点を参照している辺の数
+    TMap<RGraphRef_t<UREdge>, int32> EdgeRefCounts;
+    TMap<RGraphRef_t<URVertex>, int32> VertexRefCounts;
+    TSet<RGraphRef_t<UREdge>> Edges;
+    TSet<RGraphRef_t<URVertex>> Vertices;
 };
 
 UCLASS()
@@ -4,6 +4,7 @@
 // ☀
 #include "CoreMinimal.h"
 #include "UObject/UObjectGlobals.h"
+#include "RoadNetwork/PLATEAURnDef.h"
 #include "RGraphDef.generated.h"
 
 /**
@@ -87,7 +88,9 @@ struct FRGraphRef {
 
     template<class... Args>
     static T* New(Args&&... args) {
-        auto Ret = NewObject<T>();
+        // FPLATEAURnDef::FNewObjectOuterScopeの指定が無ければTransientPackage
+        auto Outer = FPLATEAURnDef::GetScopedNewObjectOuter();
+        auto Ret = Outer ? NewObject<T>(Outer) : NewObject<T>();
         Ret->Init(Forward<Args>(args)...);
         return Ret;
     }
@@ -13,7 +13,7 @@
 
 class FSubDividedCityObject;
 class UPLATEAUCityObjectGroup;
-class FRGraphEx {
+class PLATEAURUNTIME_API FRGraphEx {
 public:
     static void RemoveInnerVertex(RGraphRef_t<URFace> Face);
     static void RemoveInnerVertex(RGraphRef_t<URGraph> Graph);
@@ -98,7 +98,7 @@ public:
     /**
      * FaceReduction
      *
-     * URGraph に含まれる Face 同士のうち、Edge 数ごとにグループ化し、
+     * URGraph に含まれる Face 同士のうち、Edge 集合のハッシュ(順不同)ごとにグループ化し、
      * 同じ Edge 群を持つ Face (すなわち、f1 のすべての Edge が f2 に含まれる場合)
      * を f2 -> f1 の順にマージします。マージに成功した場合は対象 Face をグループから除去し、
      * マージされた Face 数を返します。
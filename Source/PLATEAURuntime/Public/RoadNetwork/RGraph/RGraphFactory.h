@@ -11,6 +11,7 @@ struct FSubDividedCityObject;
 class UPLATEAUCityObjectGroup;
 class URnModel;
 class URGraph;
+class FPLATEAURnStageProfiler;
 
 USTRUCT(BlueprintType)
 struct FRGraphFactory
@@ -21,6 +22,10 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU|Factory")
     bool bUseCityObjectOutline = true;
 
+    // 頂点/辺の統合まではFRCompactGraph(UObjectを使わないグラフ)で行う
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU|Factory")
+    bool bUseCompactGraph = true;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU|Factory|Optimize")
     float MergeCellSize = 0.2f;
 
@@ -61,5 +66,6 @@ public:
 
 struct FRGraphFactoryEx
 {
-    static RGraphRef_t<URGraph> CreateGraph(const FRGraphFactory& Factory, const TArray<FSubDividedCityObject>& CityObjects);
+    // Profilerを指定すると各最適化処理の時間を記録します
+    static RGraphRef_t<URGraph> CreateGraph(const FRGraphFactory& Factory, const TArray<FSubDividedCityObject>& CityObjects, FPLATEAURnStageProfiler* Profiler = nullptr);
 };
@@ -11,6 +11,7 @@ class AActor;
 class URnModel;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnCreateRnModelFinishedDelegate);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnCreateRnModelProgressDelegate, float, Progress, const FText&, Message);
 
 UCLASS(ClassGroup = (Custom), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
 class PLATEAURUNTIME_API APLATEAURnStructureModel : public AActor {
@@ -34,10 +35,36 @@ public:
     FOnCreateRnModelFinishedDelegate OnCreateRnModelFinished;
 
     /**
-     * @brief 道路構造の生成を行います
+     * @brief 道路構造生成処理の進捗通知イベント
+     */
+    UPROPERTY(BlueprintAssignable, Category = "PLATEAU|BPLibraries")
+    FOnCreateRnModelProgressDelegate OnCreateRnModelProgress;
+
+    /**
+     * @brief 道路構造の生成をワーカースレッドで行います. 中断した場合もOnCreateRnModelFinishedは呼ばれます
+     *        Modelは完了時に新しく作成したものと置き換わります. 中断した場合は変更しません
+     *        返り値のタスクはゲームスレッドで完了し, 生成中にこのアクターが破棄された場合はnullptrを返します
      * @param
      */
     UE::Tasks::TTask<APLATEAURnStructureModel*> CreateRnModelAsync(APLATEAUInstancedCityModel* TargetActor);
+
+    /**
+     * @brief 実行中の道路構造の生成を中断します
+     */
+    UFUNCTION(BlueprintCallable, Category = "PLATEAU|BPLibraries")
+    void CancelCreateRnModel();
+
+    /**
+     * @brief 道路構造の生成中かどうか
+     */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "PLATEAU|BPLibraries")
+    bool IsCreatingRnModel() const;
 public:
     virtual void Tick(float DeltaTime) override;
+
+private:
+    // 実行中の生成タスクの中断フラグ. タスクと共有するので生成ごとに作り直す
+    TSharedPtr<TAtomic<bool>> bCanceled;
+
+    bool bIsCreatingRnModel = false;
 };
@@ -94,6 +94,43 @@ private:
 };
 
 
+/**
+ * FRnTrackCurve
+ *
+ * トラックの経路を表す3次エルミート曲線(FPLATEAUHermiteSpline)の値型表現。
+ * 距離 -> パラメータの対応表も保持するので, USplineComponentを作らずに評価できます。
+ */
+USTRUCT(BlueprintType)
+struct PLATEAURUNTIME_API FRnTrackCurve {
+    GENERATED_BODY()
+
+    FRnTrackCurve() {}
+    FRnTrackCurve(const TArray<FVector>& InPoints, const TArray<FVector>& InTangents);
+
+    // 通過点
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "URnTrack")
+    TArray<FVector> Points;
+
+    // 各点のタンジェント(ArriveTangent = LeaveTangent)
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "URnTrack")
+    TArray<FVector> Tangents;
+
+    // 距離 -> パラメータの対応表. 距離の昇順
+    UPROPERTY()
+    TArray<float> ReparamDistances;
+
+    UPROPERTY()
+    TArray<float> ReparamParams;
+
+    bool IsValid() const { return Points.Num() >= 2; }
+
+    // 曲線全体の長さ
+    float GetLength() const;
+
+    // 始点からの距離での位置
+    FVector GetLocationAtDistance(float Distance) const;
+};
+
 /**
  * URnTrack
  *
@@ -129,10 +166,14 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "URnTrack")
     URnWay* ToBorder;
 
-    // 経路(現状未対応)
+    // 経路をUSplineComponentにしたもの. 編集/デバッグ用にGetOrCreateSplineで必要な時だけ作成します
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "URnTrack")
     USplineComponent* Spline;
 
+    // 経路
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "URnTrack")
+    FRnTrackCurve Curve;
+
     // 曲がり具合
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "URnTrack")
     ERnTurnType TurnType;
@@ -158,6 +199,13 @@ public:
     UFUNCTION(BlueprintCallable, Category = "URnTrack")
     bool IsSameInOutWithTrack(const URnTrack* Other) const;
 
+    /**
+     * 経路のUSplineComponentを取得する. 無い場合はCurveから作成する
+     * @return Curveが無効な場合はnullptr
+     */
+    UFUNCTION(BlueprintCallable, Category = "URnTrack")
+    USplineComponent* GetOrCreateSpline();
+
     /**
      * FromBorder または ToBorder が指定の way と一致しているか判定
      * @param Way 比較対象の RnWay
@@ -170,6 +218,8 @@ public:
 UCLASS(ClassGroup = (Custom), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
 class PLATEAURUNTIME_API URnIntersection : public URnRoadBase {
     GENERATED_BODY()
+    friend class FRnModelCloner;
+    friend class FRnModelSerializer;
 public:
     //using Super = URnRoadBase;
 public:
@@ -337,7 +387,8 @@ struct FRnIntersectionEx
         FEdgeGroup* LeftSide = nullptr;
     };
 
-    static TArray<FEdgeGroup> CreateEdgeGroup(TRnRef_T<URnIntersection> Intersection);
+    // bAlign == falseの場合は整列済みの交差点として扱い, 交差点やWayを変更しない(ワーカースレッドから呼び出せる)
+    static TArray<FEdgeGroup> CreateEdgeGroup(TRnRef_T<URnIntersection> Intersection, bool bAlign = true);
 
     static FVector GetEdgeNormal(TRnRef_T<URnIntersectionEdge> Edge);
     static FVector2D GetEdgeNormal2D(TRnRef_T<URnIntersectionEdge> Edge);
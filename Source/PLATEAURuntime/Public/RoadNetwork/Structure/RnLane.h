@@ -10,10 +10,12 @@
 
 class URnRoad;
 UCLASS(ClassGroup = (Custom), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
-class URnLane : public UObject
+class PLATEAURUNTIME_API URnLane : public UObject
 {
 private:
     GENERATED_BODY()
+    friend class FRnModelCloner;
+    friend class FRnModelSerializer;
 
 public:
     URnLane();
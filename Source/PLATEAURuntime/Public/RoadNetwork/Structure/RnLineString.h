@@ -14,7 +14,7 @@
 
 #include "RnLineString.generated.h"
 UCLASS(ClassGroup = (Custom), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
-class URnLineString : public UObject
+class PLATEAURUNTIME_API URnLineString : public UObject
 {
     GENERATED_BODY()
 private:
@@ -54,9 +54,17 @@ public:
     void GetNearestPoint(const FVector& Pos, FVector& OutNearest, float& OutPointIndex, float& OutDistance) const;
     float GetDistance2D(const TRnRef_T<URnLineString> Other, EAxisPlane Plane = EAxisPlane::Xy) const;
 
+    // GetNearestPoint/GetDistance2Dの頂点配列版. UObjectを触らないのでゲームスレッド以外から呼び出せます
+    static void GetNearestPoint(TConstArrayView<FVector> Vertices, const FVector& Pos, FVector& OutNearest, float& OutPointIndex, float& OutDistance);
+    static float GetDistance2D(TConstArrayView<FVector> Vertices, TConstArrayView<FVector> OtherVertices, EAxisPlane Plane = EAxisPlane::Xy);
+
     void AddPointOrSkip(TRnRef_T<URnPoint> Point, float DistanceEpsilon = DefaultDistanceEpsilon, float DegEpsilon = DefaultDegEpsilon, float MidPointTolerance = DefaultMidPointTolerance);
     void AddPointFrontOrSkip(TRnRef_T<URnPoint> Point, float DistanceEpsilon = DefaultDistanceEpsilon, float DegEpsilon = DefaultDegEpsilon, float MidPointTolerance = DefaultMidPointTolerance);
 
+    // AddPointOrSkipのFVector版. URnPointを作らずに頂点配列へ追加するのでスレッドセーフです
+    // (Pointの同一性は判定できないので, DistanceEpsilonが負の場合は重複を取り除きません)
+    static void AddVertexOrSkip(TArray<FVector>& Vertices, const FVector& Vertex, float DistanceEpsilon = DefaultDistanceEpsilon, float DegEpsilon = DefaultDegEpsilon, float MidPointTolerance = DefaultMidPointTolerance);
+
     FVector GetVertexNormal(int32 VertexIndex) const;
     FVector GetEdgeNormal(int32 StartVertexIndex) const;
 
@@ -65,6 +73,7 @@ public:
 
     float CalcLength() const;
     float CalcLength(float StartIndex, float EndIndex) const;
+    static float CalcLength(TConstArrayView<FVector> Vertices, float StartIndex, float EndIndex);
     float CalcTotalAngle2D() const;
 
 
@@ -88,6 +97,7 @@ public:
     FVector GetAdvancedPointFromBack(float Offset, int32& OutStartIndex, int32& OutEndIndex) const;
 
     FVector GetAdvancedPoint(float Offset, bool bReverse, int32& OutStartIndex, int32& OutEndIndex) const;
+    static FVector GetAdvancedPoint(TConstArrayView<FVector> Vertices, float Offset, bool bReverse, int32& OutStartIndex, int32& OutEndIndex);
 
     TArray<TTuple<float, FVector>> GetIntersectionBy2D(
         const FLineSegment3D& LineSegment,
@@ -98,6 +108,7 @@ public:
         EAxisPlane Plane) const;
 
     bool TryGetNearestIntersectionBy2D(const FRay& Ray, TTuple<float, FVector>& Res, EAxisPlane Plane = FPLATEAURnDef::Plane) const;
+    static bool TryGetNearestIntersectionBy2D(TConstArrayView<FVector> Vertices, const FRay& Ray, TTuple<float, FVector>& Res, EAxisPlane Plane = FPLATEAURnDef::Plane);
 
 
     // selfのotherに対する距離スコアを返す(線分同士の距離ではない).低いほど近い
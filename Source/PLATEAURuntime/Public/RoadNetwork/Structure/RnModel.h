@@ -6,6 +6,7 @@
 #include "Component/PLATEAUSceneComponent.h"
 #include "RoadNetwork/PLATEAURnDef.h"
 #include "RoadNetwork/Util/PLATEAURnEx.h"
+#include "UObject/ObjectKey.h"
 #include "RnModel.generated.h"
 class URnRoadGroup;
 class URnRoad;
@@ -18,6 +19,7 @@ class URnWay;
 class UPLATEAUCityObjectGroup;
 class URnRoadBase;
 struct FLineSegment3D;
+class FObjectPostSaveContext;
 
 USTRUCT(BlueprintType)
 struct FRnModelCalibrateIntersectionBorderOption
@@ -39,7 +41,7 @@ public:
 };
 
 UCLASS(ClassGroup = (Custom), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
-class URnModel : public UPLATEAUSceneComponent
+class PLATEAURUNTIME_API URnModel : public UPLATEAUSceneComponent
 {
 public:
     const FString& GetFactoryVersion() const;
@@ -48,6 +50,8 @@ public:
 
 private:
     GENERATED_BODY()
+    friend class FRnModelCloner;
+    friend class FRnModelSerializer;
 
 public:
     static constexpr float Epsilon = SMALL_NUMBER;
@@ -111,6 +115,7 @@ public:
     TArray<TRnRef_T<URnSideWalk>> GetNeighborSideWalks(const TRnRef_T<URnRoadBase>& RoadBase) const;
 
     // 交差点の境界線を調整する
+    // 切断線は全道路分を並列に計算し, 道路の切断/統合は道路の順番にゲームスレッドで行う
     void CalibrateIntersectionBorderForAllRoad(const FRnModelCalibrateIntersectionBorderOption& Option);
     bool TrySliceRoadHorizontalNearByBorder(URnRoad* Road, const FRnModelCalibrateIntersectionBorderOption& Option,
                                             URnRoad*& OutPrevSideRoad, URnRoad*& OutCenterSideRoad,
@@ -119,6 +124,9 @@ public:
     // 道路ネットワークを作成する
     static TRnRef_T<URnModel> Create();
 
+    // 道路/交差点/歩道を含めた深いコピーを作成する. 点やLineStringの共有関係はコピー先でも保たれる
+    TRnRef_T<URnModel> Clone() const;
+
     // 指定したRoadBaseに接続されている道路/交差点を取得
     TArray<TRnRef_T<URnRoadBase>> GetConnectedRoadBases(const TRnRef_T<URnRoadBase>& RoadBase) const;
 
@@ -140,6 +148,7 @@ public:
     void MergeRoadGroup();
 
     // roadWidthの道路幅を基準にレーンを分割する
+    // 道路グループごとのレーン数は並列に計算し, レーンの分割は道路の順番にゲームスレッドで行う
     void SplitLaneByWidth(float RoadWidth, bool rebuildTrack, TArray<FString>& failedRoads, TFunction<bool(URnRoadGroup*)> IsLaneSplitTarget);
 
     // 不正チェック
@@ -190,11 +199,75 @@ public:
 
     void SeparateContinuousBorder();
 
+    // RoadBaseにTargetTranが追加されたときに呼ばれる. GetRoadBy等の検索用インデックスを更新する
+    void OnTargetTranAdded(URnRoadBase* RoadBase, UPLATEAUCityObjectGroup* TargetTran);
+
+    // 検索用インデックスを道路/交差点/歩道リストから作り直す
+    void RebuildTargetTranIndex();
+
+    // 検索用インデックスが道路/交差点/歩道リストと一致しているか(デバッグ/テスト用)
+    bool ValidateTargetTranIndex() const;
+
+    virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+    virtual void PostLoad() override;
+    virtual void BeginDestroy() override;
+    virtual void PostDuplicate(bool bDuplicateForPIE) override;
+#if WITH_EDITOR
+    virtual void PostEditUndo() override;
+#endif
+
 private:
+    // 交差点付近で道路を切断する位置. 道路を変更しないので複数の道路で並列に計算できる
+    struct FRoadSlicePlan {
+        // 切断対象の道路かどうか
+        bool bTarget = false;
+        // Next/Prev側が交差点かどうか
+        bool bNextIntersection = false;
+        bool bPrevIntersection = false;
+        // 切断線. 計算に失敗した場合は未設定
+        TOptional<FLineSegment3D> NextSegment;
+        TOptional<FLineSegment3D> PrevSegment;
+    };
+
+    static FRoadSlicePlan PlanSliceRoadHorizontalNearByBorder(const URnRoad* Road, const FRnModelCalibrateIntersectionBorderOption& Option);
+
+    bool ApplySliceRoadHorizontalNearByBorder(URnRoad* Road, const FRoadSlicePlan& Plan,
+                                              URnRoad*& OutPrevSideRoad, URnRoad*& OutCenterSideRoad,
+                                              URnRoad*& OutNextSideRoad);
+
+    void AddToTargetTranIndex(URnRoadBase* RoadBase);
+    void RemoveFromTargetTranIndex(URnRoadBase* RoadBase);
+
+    // TargetTranを含む道路/交差点のうち, Filterを満たし一番先に追加されたものを返す
+    URnRoadBase* FindRoadBaseBy(UPLATEAUCityObjectGroup* TargetTran, TFunctionRef<bool(URnRoadBase*)> Filter) const;
+
+    // 保存のためにPreSaveで付けたRF_Transientを外す
+    void ClearTransientFlags();
+
+    void OnPackageSaved(const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext ObjectSaveContext);
 
     // 自動生成で作成されたときのバージョン
     FString FactoryVersion;
 
+public:
+    // trueの場合, 保存時に道路/交差点/歩道をUObjectではなくFRnModelSerializerのバイナリ形式で保存する
+    UPROPERTY(EditAnywhere, Category = "PLATEAU")
+    bool bCompactSerialization = false;
+
+private:
+    // bCompactSerialization時の保存データ. ロード後に展開して空にする
+    UPROPERTY()
+    TArray<uint8> CompactData;
+
+    // CompactDataが参照しているCityObjectGroup. パスの変更に追従させるためにCompactDataとは別に保存する
+    UPROPERTY()
+    TArray<TSoftObjectPtr<UPLATEAUCityObjectGroup>> CompactTargetTrans;
+
+    // PreSaveでRF_Transientを付けたオブジェクト. 元からTransientだったものは含まない
+    TArray<TWeakObjectPtr<UObject>> TransientFlaggedObjects;
+
+    FDelegateHandle PackageSavedHandle;
+
     // 道路リスト
     UPROPERTY(VisibleAnywhere, Category = "PLATEAU")
     TArray<URnRoad*> Roads;
@@ -207,4 +280,12 @@ private:
     UPROPERTY(VisibleAnywhere, Category = "PLATEAU")
     TArray<URnSideWalk*> SideWalks;
 
+    // CityObjectGroup -> それを含む道路/交差点. UPROPERTYではないのでロード後はRebuildTargetTranIndexで作り直す
+    TMap<TObjectKey<UPLATEAUCityObjectGroup>, TArray<URnRoadBase*, TInlineAllocator<1>>> TargetTranIndex;
+
+    // 道路/交差点/歩道が追加された順番. 線形探索時と同じくリストの先頭側にあるものを返すために使う
+    TMap<const UObject*, int64> AddedOrders;
+
+    int64 NextAddedOrder = 0;
+
 };
@@ -0,0 +1,77 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RoadNetwork/PLATEAURnDef.h"
+
+class URnModel;
+class URnRoadBase;
+class URnLane;
+class URnWay;
+class URnLineString;
+class URnPoint;
+class URnSideWalk;
+class URnIntersectionEdge;
+class URnTrack;
+
+/**
+ * @brief URnModelの深いコピーを作成します。
+ * 道路/交差点/歩道/レーン/Way/LineString/Pointを全て複製し, 元のモデル内での参照の共有関係
+ * (複数のWayが同じLineStringを, 隣接するLineStringが同じPointを参照している等)をコピー先でも保ちます。
+ * 対応するUPLATEAUCityObjectGroupは複製せず, 元のモデルと共有します。
+ *
+ * スムージング等の破壊的な処理の前にスナップショットを取るために使います。
+ * 同じインスタンスで繰り返しコピーすると内部のマップのメモリが再利用されます。
+ */
+class PLATEAURUNTIME_API FRnModelCloner {
+public:
+    /**
+     * @brief SourceのコピーをDestに作成します. Destが持っていた道路/交差点/歩道は破棄されます
+     */
+    void CopyTo(const URnModel* Source, URnModel* Dest);
+
+    /**
+     * @brief Sourceのコピーを新しいURnModelとして作成します
+     */
+    TRnRef_T<URnModel> Clone(const URnModel* Source);
+
+    /**
+     * @brief 直前のコピーでOriginalに対応するオブジェクトを返します. 複製されていない場合はnullptr
+     */
+    template<class T>
+    T* Find(const T* Original) const {
+        const auto* Found = CloneMap.Find(Original);
+        return Found ? static_cast<T*>(*Found) : nullptr;
+    }
+
+    /**
+     * @brief 直前のコピーで複製したオブジェクトの数(URnModel自身を含む)
+     */
+    int32 Num() const { return CloneMap.Num(); }
+
+private:
+    // Originalに対応するオブジェクトを返します. まだ無い場合は同じクラスで作成し, bOutCreated = trueを返します
+    template<class T>
+    T* FindOrCreate(const T* Original, bool& bOutCreated);
+
+    URnPoint* ClonePoint(const URnPoint* Src);
+    URnLineString* CloneLineString(const URnLineString* Src);
+    URnWay* CloneWay(const URnWay* Src);
+    URnLane* CloneLane(const URnLane* Src);
+    URnSideWalk* CloneSideWalk(const URnSideWalk* Src);
+    URnIntersectionEdge* CloneEdge(const URnIntersectionEdge* Src);
+    URnTrack* CloneTrack(const URnTrack* Src);
+
+    // 道路/交差点は相互に参照しあうので, 作成だけ行い中身はFillRoadBaseで後から埋めます
+    URnRoadBase* CloneRoadBase(const URnRoadBase* Src);
+    void FillRoadBase(const URnRoadBase* Src, URnRoadBase* Dst);
+
+    // 元のオブジェクト -> 複製したオブジェクト
+    TMap<const UObject*, UObject*> CloneMap;
+
+    // 作成済みで中身が未設定の道路/交差点
+    TArray<TPair<const URnRoadBase*, URnRoadBase*>> PendingRoadBases;
+
+    UObject* Outer = nullptr;
+};
@@ -0,0 +1,88 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RoadNetwork/PLATEAURnDef.h"
+#include "UObject/SoftObjectPtr.h"
+
+class URnModel;
+class URnRoadBase;
+class URnLane;
+class URnWay;
+class URnLineString;
+class URnPoint;
+class URnSideWalk;
+class URnIntersectionEdge;
+class URnTrack;
+class UPLATEAUCityObjectGroup;
+class FArchive;
+
+/**
+ * @brief URnModelをUObjectのグラフではなく, 平坦な配列のバイナリ形式に変換します。
+ * 点は1つの配列にまとめ(同じURnPointを参照している箇所は1つの点になります), 他のオブジェクトはその配列へのインデックスで参照します。
+ * 読み込み時は道路/交差点/歩道/レーン/Way/LineString/Pointを作り直し, 参照の共有関係も元のモデルと同じになります。
+ *
+ * トラックのUSplineComponentは保存しません. 必要になった時にURnTrack::GetOrCreateSplineでCurveから作り直されます。
+ * 対応するUPLATEAUCityObjectGroupはバイナリには含めず, 別に返す一覧へのインデックスで保存します。
+ * 一覧はTSoftObjectPtrのUPROPERTYとして保存することで, レベルの複製やPIE等でのパスの変更にも追従します。
+ */
+class PLATEAURUNTIME_API FRnModelSerializer {
+public:
+    // 形式のバージョン. 互換性のない変更をしたら上げてください
+    static constexpr uint32 Version = 2;
+
+    /**
+     * @brief Modelをバイナリ形式でOutDataに書き込みます
+     * @param OutTargetTrans 道路/交差点が参照しているUPLATEAUCityObjectGroupの一覧. OutDataはこの一覧へのインデックスを持ちます
+     * @param bCompress trueの場合, ヘッダ以降をzlibで圧縮します
+     */
+    void Write(const URnModel* Model, TArray<uint8>& OutData, TArray<TSoftObjectPtr<UPLATEAUCityObjectGroup>>& OutTargetTrans, bool bCompress = true);
+
+    /**
+     * @brief Writeで書き込んだデータからDestの道路/交差点/歩道を作り直します. Destが持っていた道路/交差点/歩道は破棄されます
+     * @param TargetTrans Writeで書き込んだUPLATEAUCityObjectGroupの一覧. 見つからないものは無効な参照になります
+     * @param Outer 作成するオブジェクトのOuter. nullptrの場合はDest
+     * @return データが壊れている, もしくはバージョンが異なる場合はfalse(Destは変更しません)
+     */
+    bool Read(TConstArrayView<uint8> Data, TConstArrayView<TSoftObjectPtr<UPLATEAUCityObjectGroup>> TargetTrans, URnModel* Dest, UObject* Outer = nullptr);
+
+    /**
+     * @brief Modelから参照されている全てのオブジェクト(道路/交差点/歩道/レーン/Way/LineString/Point/トラックとそのSpline)を列挙します
+     * @param bOwnedOnly trueの場合, Modelに属していない道路/交差点とその中身は辿りません
+     */
+    void ForEachObject(const URnModel* Model, TFunctionRef<void(UObject*)> Func, bool bOwnedOnly = false);
+
+    /**
+     * @brief 直前のWrite/Read/ForEachObjectで扱ったオブジェクトの数(URnModel自身は含みません)
+     */
+    int32 Num() const;
+
+private:
+    void Collect(const URnModel* Model, bool bOwnedOnly = false);
+    int32 AddPoint(const URnPoint* Point);
+    int32 AddLineString(const URnLineString* LineString);
+    int32 AddWay(const URnWay* Way);
+    int32 AddLane(const URnLane* Lane);
+    int32 AddSideWalk(const URnSideWalk* SideWalk);
+    int32 AddEdge(const URnIntersectionEdge* Edge);
+    int32 AddTrack(const URnTrack* Track);
+    int32 AddRoadBase(const URnRoadBase* RoadBase);
+    void FillRoadBase(const URnRoadBase* RoadBase);
+
+    void WritePayload(FArchive& Ar, const URnModel* Model, TArray<TSoftObjectPtr<UPLATEAUCityObjectGroup>>& OutTargetTrans);
+    bool ReadPayload(FArchive& Ar, TConstArrayView<TSoftObjectPtr<UPLATEAUCityObjectGroup>> TargetTrans, URnModel* Dest, UObject* Outer);
+
+    // 種類ごとのオブジェクトの配列. 配列内のインデックスで参照します
+    TArray<const URnPoint*> Points;
+    TArray<const URnLineString*> LineStrings;
+    TArray<const URnWay*> Ways;
+    TArray<const URnLane*> Lanes;
+    TArray<const URnSideWalk*> SideWalks;
+    TArray<const URnIntersectionEdge*> Edges;
+    TArray<const URnTrack*> Tracks;
+    TArray<const URnRoadBase*> RoadBases;
+
+    // オブジェクト -> 種類ごとの配列のインデックス
+    TMap<const UObject*, int32> Indices;
+};
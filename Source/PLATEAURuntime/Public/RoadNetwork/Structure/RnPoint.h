@@ -10,7 +10,7 @@
 #include "RnPoint.generated.h"
 
 UCLASS(ClassGroup = (Custom), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
-class URnPoint : public UObject {
+class PLATEAURUNTIME_API URnPoint : public UObject {
     GENERATED_BODY()
 public:
     URnPoint();
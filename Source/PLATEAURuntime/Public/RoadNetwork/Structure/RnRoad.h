@@ -13,7 +13,7 @@ class URnIntersection;
 class UPLATEAUCityObjectGroup;
 
 UCLASS(ClassGroup = (Custom), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
-class URnRoad : public URnRoadBase {
+class PLATEAURUNTIME_API URnRoad : public URnRoadBase {
 private:
     GENERATED_BODY()
 public:
@@ -122,6 +122,10 @@ public:
     // 指定した方向の境界線を取得する(全レーンマージした状態で取得する)
     TRnRef_T<URnWay> GetMergedBorder(EPLATEAURnLaneBorderType BorderType, TOptional<EPLATEAURnDir> Dir = NullOpt) const;
 
+    // GetMergedBorderの頂点配列版. UObjectを生成しないので複数スレッドから同時に呼べます
+    // 境界線が無い場合は空配列を返す
+    TArray<FVector> GetMergedBorderVertices(EPLATEAURnLaneBorderType BorderType, TOptional<EPLATEAURnDir> Dir = NullOpt) const;
+
     // 指定した方向のWayを取得する(全レーンマージした状態で取得する)
     TRnRef_T<URnWay> GetMergedSideWay(EPLATEAURnDir Dir) const;
 
@@ -130,6 +134,9 @@ public:
     // 例) 左２車線でdir==RnDir.Leftの場合, 一番左の車線の左側のWayと左から２番目の車線の右側のWayを返す
     bool TryGetMergedSideWay(TOptional<EPLATEAURnDir> Dir, TRnRef_T<URnWay>& OutLeftWay, TRnRef_T<URnWay>& OutRightWay) const;
 
+    // TryGetMergedSideWayの頂点配列版. ReversedWayを作らないので複数スレッドから同時に呼べます
+    bool TryGetMergedSideVertices(TOptional<EPLATEAURnDir> Dir, TArray<FVector>& OutLeftVertices, TArray<FVector>& OutRightVertices) const;
+
     // 指定したLineStringまでの最短距離を取得する
     bool TryGetNearestDistanceToSideWays(const TRnRef_T<URnLineString>& LineString, float& OutDistance) const;
 
@@ -198,10 +205,12 @@ public:
     virtual bool Check() override;
 
 
+    // BorderSide側の境界線からBorderOffset離れた位置で道路を垂直に切断する線分を返す
+    // UObjectを生成しないので, 道路を変更しない間は複数スレッドから同時に呼べます
     bool TryGetVerticalSliceSegment(
         EPLATEAURnLaneBorderType BorderSide,
         float BorderOffset,
-        FLineSegment3D& OutSegment);
+        FLineSegment3D& OutSegment) const;
 
     // 道路を作成する
     static TRnRef_T<URnRoad> Create(TWeakObjectPtr<UPLATEAUCityObjectGroup> TargetTran = nullptr);
@@ -12,8 +12,10 @@ class URnWay;
 class URnPoint;
 
 UCLASS(ClassGroup = (Custom), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
-class URnSideWalk : public UObject {
+class PLATEAURUNTIME_API URnSideWalk : public UObject {
     GENERATED_BODY()
+    friend class FRnModelCloner;
+    friend class FRnModelSerializer;
 public:
     URnSideWalk();
     void Init();
@@ -95,6 +95,14 @@ public:
         }
     };
 
+    // 生成するトラックの情報. UObjectを作らずに求められるのでワーカースレッドで作成できる
+    struct FTrackPlan {
+        URnIntersectionEdge* From = nullptr;
+        URnIntersectionEdge* To = nullptr;
+        ERnTurnType TurnType = ERnTurnType::Straight;
+        FRnTrackCurve Curve;
+    };
+
     // デフォルトコンストラクタ
     FRnTracksBuilder();
 
@@ -105,14 +113,35 @@ public:
      */
     void BuildTracks(URnIntersection* Intersection, const FBuildTrackOption& Option);
 
+    /**
+     * 複数の交差点のトラックの再生成処理
+     * 交差点の整列とトラックの追加はゲームスレッドで, 経路の計算は交差点ごとに並列で行う
+     */
+    void BuildTracks(const TArray<URnIntersection*>& Intersections, const FBuildTrackOption& Option);
+
+    /**
+     * 整列済みの交差点で生成するトラックを求める. 交差点やWayは変更しない
+     */
+    TArray<FTrackPlan> PlanTracks(URnIntersection* Intersection, const FBuildTrackOption& Option) const;
+
+    /**
+     * PlanTracksで求めたトラックを交差点に追加する
+     */
+    void ApplyTracks(URnIntersection* Intersection, const FBuildTrackOption& Option, TArray<FTrackPlan>& Plans) const;
+
     /**
      * from/to をつなぐトラックを生成する
      */
-    URnTrack* MakeTrack(URnIntersection* Intersection
+    FTrackPlan MakeTrack(URnIntersection* Intersection
         , URnIntersectionEdge* From
         , const FBuildTrackOption& Option
         , FRnIntersectionEx::FEdgeGroup* FromEg
-        , const struct FOutBound& OutBound);
+        , const struct FOutBound& OutBound) const;
+
+    /**
+     * from の境界線の中点から交差点に入り, to の境界線の中点から出ていく経路を作成する
+     */
+    static FRnTrackCurve CreateTrackCurve(URnIntersectionEdge* From, URnIntersectionEdge* To, const FBuildTrackOption& Option);
 
     /**
      * トラック生成（FromBorder/toBorderおよびSpline生成）
@@ -17,7 +17,7 @@
 #include "RnWay.generated.h"
 
 UCLASS(ClassGroup = (Custom), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
-class URnWay : public UObject
+class PLATEAURUNTIME_API URnWay : public UObject
 {
     GENERATED_BODY()
 public:
@@ -200,6 +200,8 @@ public:
     // 線分の距離をp : (1-p)で分割した点を返す
     FVector GetLerpPoint(float P) const;
     float GetLerpPoint(float P, FVector& OutMidPoint) const;
+    // 頂点配列版. UObjectを触らないのでゲームスレッド以外から呼び出せます
+    static float GetLerpPoint(TConstArrayView<FVector> Vertices, float P, FVector& OutMidPoint);
 
     // 同じLineStringを参照しているかどうか
     bool IsSameLineReference(const URnWay* Other) const;
@@ -0,0 +1,59 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @brief 各点のタンジェントを指定した3次エルミートスプラインです。
+ *
+ * 全ての点の補間モードをCIM_CurveUserにしたUSplineComponentと同じ補間・距離による再パラメータ化を行います。
+ * UObjectやワールドを必要としないため、ワーカースレッドからも使用できます。
+ */
+class PLATEAURUNTIME_API FPLATEAUHermiteSpline {
+public:
+    /**
+     * @param InPoints 通過点
+     * @param InTangents 各点のタンジェント(ArriveTangent = LeaveTangent)。InPointsと同じ数
+     * @param InReparamStepsPerSegment 距離 -> パラメータの対応表の区間ごとの分割数(USplineComponentのデフォルトは10)
+     */
+    FPLATEAUHermiteSpline(const TArray<FVector>& InPoints, const TArray<FVector>& InTangents, int32 InReparamStepsPerSegment = 10);
+
+    int32 GetNumPoints() const { return Points.Num(); }
+
+    /**
+     * @brief スプライン全体の長さ(USplineComponent::GetSplineLength)
+     */
+    float GetLength() const;
+
+    /**
+     * @brief パラメータ(点のインデックス + 区間内の割合)での位置
+     */
+    FVector GetLocationAtParam(float Param) const;
+
+    /**
+     * @brief 始点からの距離での位置(USplineComponent::GetLocationAtDistanceAlongSpline)
+     */
+    FVector GetLocationAtDistance(float Distance) const;
+
+    const TArray<FVector>& GetPoints() const { return Points; }
+    const TArray<FVector>& GetTangents() const { return Tangents; }
+    const TArray<float>& GetReparamDistances() const { return ReparamDistances; }
+    const TArray<float>& GetReparamParams() const { return ReparamParams; }
+
+    /**
+     * @brief 保存しておいた点/タンジェントと対応表から, スプラインを作り直さずに位置を求めます
+     */
+    static FVector EvalLocationAtParam(TConstArrayView<FVector> InPoints, TConstArrayView<FVector> InTangents, float Param);
+    static float EvalParamAtDistance(TConstArrayView<float> InReparamDistances, TConstArrayView<float> InReparamParams, float Distance);
+
+private:
+    float GetSegmentLength(int32 Index, float Param) const;
+
+    TArray<FVector> Points;
+    TArray<FVector> Tangents;
+
+    // 距離 -> パラメータの対応表. 距離の昇順
+    TArray<float> ReparamDistances;
+    TArray<float> ReparamParams;
+};
@@ -59,6 +59,15 @@ public:
         float T,
         float PointSkipDistance = 1e-3f);
 
+    // CreateInnerLerpLineStringの頂点配列版. UObjectを作らないのでゲームスレッド以外から呼び出せます
+    static TArray<FVector> CreateInnerLerpVertices(
+        const TArray<FVector>& LeftVertices,
+        const TArray<FVector>& RightVertices,
+        const FVector& Start,
+        const FVector& End,
+        float T,
+        float PointSkipDistance = 1e-3f);
+
     static FLineCrossPointResult GetLineIntersections(
         const FLineSegment3D& LineSegment,
         const TArray<TRnRef_T<URnWay>>& Ways);
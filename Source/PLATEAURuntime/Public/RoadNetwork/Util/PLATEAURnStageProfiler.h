@@ -0,0 +1,67 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// 1段階分の計測結果
+struct PLATEAURUNTIME_API FPLATEAURnStageRecord
+{
+    FString Name;
+
+    // 経過時間(秒)
+    double Seconds = 0.0;
+
+    // 使用物理メモリの増減(byte)
+    int64 UsedPhysicalDelta = 0;
+
+    // 生存しているUObject数の増減
+    int32 UObjectDelta = 0;
+
+    // 段階終了時点のオブジェクト数など(SetCounterで設定した関数で取得する)
+    TArray<TPair<FString, int64>> Counts;
+};
+
+/**
+ * @brief 道路構造の自動生成を段階ごとに計測します. ベンチマーク用です
+ *        nullptrのままFScopeに渡すと何もしないので, 計測しない場合のコストはほぼありません
+ */
+class PLATEAURUNTIME_API FPLATEAURnStageProfiler
+{
+public:
+    // 段階の範囲. ProfilerがnullptrならBegin/Endを呼ばない
+    class PLATEAURUNTIME_API FScope
+    {
+    public:
+        FScope(FPLATEAURnStageProfiler* InProfiler, const TCHAR* Name);
+        ~FScope();
+
+    private:
+        FPLATEAURnStageProfiler* Profiler;
+    };
+
+    void Begin(const TCHAR* Name);
+    void End();
+
+    // 段階終了時にオブジェクト数を取得する関数を設定します. nullptrで解除します
+    void SetCounter(TFunction<void(TArray<TPair<FString, int64>>&)> InCounter);
+
+    const TArray<FPLATEAURnStageRecord>& GetRecords() const { return Records; }
+
+    double GetTotalSeconds() const;
+
+    // 計測結果をJSONで返します. Infoはトップレベルにそのまま追加されます
+    FString ToJson(const TArray<TPair<FString, FString>>& Info = {}) const;
+
+private:
+    struct FRunning {
+        FString Name;
+        double StartTime = 0.0;
+        int64 StartUsedPhysical = 0;
+        int32 StartUObjectNum = 0;
+    };
+
+    TArray<FRunning> Stack;
+    TArray<FPLATEAURnStageRecord> Records;
+    TFunction<void(TArray<TPair<FString, int64>>&)> Counter;
+};
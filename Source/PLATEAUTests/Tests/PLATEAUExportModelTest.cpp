@@ -85,4 +85,64 @@ bool FPLATEAUTest_ModelExporter_Export_Generates_Files::RunTest(const FString& P
     }));
 
     return true;
-}
\ No newline at end of file
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_ModelExporter_Export_Generates_3DTiles, FPLATEAUAutomationTestBase,
+                                        "PLATEAUTest.FPLATEAUTest.ModelExporter.Export_Generates_3DTiles",
+                                        EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_ModelExporter_Export_Generates_3DTiles::RunTest(const FString& Parameters) {
+    InitializeTest("Export_Generates_3DTiles");
+    if (!OpenNewMap())
+        AddError("Failed to OpenNewMap");
+
+    const FString TestDir = FPaths::ProjectDir().Append("Tests3DTiles");
+    if (FPaths::DirectoryExists(TestDir)) {
+        if (!FFileManagerGeneric::Get().DeleteDirectory(*TestDir, true, true))
+            AddError("Failed to DeleteDirectory");
+    }
+
+    const auto& Loader = GetInstancedCityLoader(*GetWorld());
+    Loader->LoadAsync(true);
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Loader, TestDir] {
+        if (Loader->Phase != ECityModelLoadingPhase::Cancelling && Loader->Phase != ECityModelLoadingPhase::Finished)
+            return false;
+
+        TArray<AActor*> CityModelActors;
+        UGameplayStatics::GetAllActorsOfClass(Loader->GetWorld(), APLATEAUInstancedCityModel::StaticClass(), CityModelActors);
+        if (CityModelActors.Num() <= 0) {
+            FinishTest(false, "CityModelActors.Num() <= 0");
+            return true;
+        }
+
+        if (!FFileManagerGeneric::Get().MakeDirectory(*TestDir, true)) {
+            FinishTest(false, "Failed to MakeDirectory");
+            return true;
+        }
+
+        FPLATEAUMeshExportOptions Options;
+        Options.FileFormat = EMeshFileFormat::Tiles3D;
+        Options.bExportHiddenObjects = true;
+        Options.bExportTexture = true;
+        Options.MaxComponentsPerTile = 1;
+        Options.bExportAttributes = true;
+
+        UPLATEAUExportModelAPI::ExportModel(Cast<APLATEAUInstancedCityModel>(CityModelActors.GetData()[0]), TestDir, Options);
+        if (plateau::Export::GetFoundFiles(EMeshFileFormat::Tiles3D, TestDir).Num() != 1) {
+            FinishTest(false, "tileset.json is not found");
+            return true;
+        }
+
+        const auto FoundTiles = FindFiles(TestDir / TEXT("tiles"), "*.glb");
+        if (FoundTiles.Num() <= 1) {
+            FinishTest(false, "Tiles are not subdivided");
+            return true;
+        }
+
+        FinishTest(true, "");
+        return true;
+    }));
+
+    return true;
+}
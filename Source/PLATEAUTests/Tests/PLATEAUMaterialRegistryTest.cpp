@@ -0,0 +1,65 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "PLATEAUMaterialRegistry.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Engine/Texture2D.h"
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_MaterialRegistry, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.MaterialRegistry", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_MaterialRegistry::RunTest(const FString& Parameters) {
+    InitializeTest("MaterialRegistry");
+
+    // 別々に作成した同じ内容のFString、マテリアルを持たないSubMeshでハッシュが一致すること
+    FString PathA = TEXT("Textures/tex_0001.jpg");
+    FString PathB = FString(TEXT("Textures/")) + TEXT("tex_0001.jpg");
+    const FSubMeshMaterialSet SetA(nullptr, PathA, 0);
+    const FSubMeshMaterialSet SetB(nullptr, PathB, 0);
+    const FSubMeshMaterialSet SetOther(nullptr, TEXT("Textures/tex_0002.jpg"), 0);
+    TestTrue("Same content is equal", SetA == SetB);
+    TestEqual("Same content has same hash", GetTypeHash(SetA), GetTypeHash(SetB));
+    TestFalse("Different texture is not equal", SetA == SetOther);
+
+    // 同じ内容のマテリアルは登録済みのものが返ること
+    FPLATEAUMaterialRegistry Registry;
+    UMaterial* BaseMaterial = Cast<UMaterial>(StaticLoadObject(UMaterial::StaticClass(), nullptr, TEXT("/PLATEAU-SDK-for-Unreal/Materials/DefaultMaterial")));
+    UMaterialInstanceDynamic* MaterialA = UMaterialInstanceDynamic::Create(BaseMaterial, GetTransientPackage());
+    UMaterialInstanceDynamic* MaterialB = UMaterialInstanceDynamic::Create(BaseMaterial, GetTransientPackage());
+
+    TestNull("Not registered", Registry.FindMaterial(SetA));
+    TestEqual("First registration", Registry.AddMaterial(SetA, MaterialA), static_cast<UMaterialInterface*>(MaterialA));
+    TestEqual("Duplicated registration returns registered material", Registry.AddMaterial(SetB, MaterialB), static_cast<UMaterialInterface*>(MaterialA));
+    TestEqual("Find by same content", Registry.FindMaterial(SetB), static_cast<UMaterialInterface*>(MaterialA));
+    TestEqual("Unique material count", Registry.GetMaterialCount(), 1);
+    TestEqual("Reused material count", Registry.GetReusedMaterialCount(), 1);
+
+    // ロードに失敗したテクスチャもロード済みとして扱われること
+    UTexture2D* Texture = nullptr;
+    TestFalse("Texture not loaded", Registry.FindTexture(PathA, Texture));
+    Registry.AddTexture(PathA, nullptr);
+    TestTrue("Failed texture is cached", Registry.FindTexture(PathB, Texture));
+    TestNull("Failed texture is nullptr", Texture);
+
+    // 画素が同じテクスチャはパスが異なっても使い回されること
+    FSHAHash HashA;
+    FSHA1::HashBuffer("A", 1, HashA.Hash);
+    FSHAHash HashB;
+    FSHA1::HashBuffer("B", 1, HashB.Hash);
+    UTexture2D* ContentTexture = UTexture2D::CreateTransient(1, 1);
+    TestNull("Content not loaded", Registry.FindTextureByContent(HashA));
+    Registry.AddTextureContent(HashA, ContentTexture);
+    TestEqual("Find by same content", Registry.FindTextureByContent(HashA), ContentTexture);
+    TestNull("Different content", Registry.FindTextureByContent(HashB));
+
+    // パスが異なっても同じテクスチャを使うマテリアルは共有されること
+    const FSubMeshMaterialSet SetCopyA(nullptr, TEXT("GmlA/tex_0003.jpg"), 0);
+    const FSubMeshMaterialSet SetCopyB(nullptr, TEXT("GmlB/tex_0003.jpg"), 0);
+    Registry.AddTexture(SetCopyA.TexturePath, ContentTexture);
+    Registry.AddTexture(SetCopyB.TexturePath, ContentTexture);
+    TestEqual("Register material of shared texture", Registry.AddMaterial(SetCopyA, MaterialB), static_cast<UMaterialInterface*>(MaterialB));
+    TestEqual("Find by another path of same texture", Registry.FindMaterial(SetCopyB), static_cast<UMaterialInterface*>(MaterialB));
+    TestEqual("Material count with shared texture", Registry.GetMaterialCount(), 2);
+
+    return true;
+}
@@ -0,0 +1,234 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "RoadNetwork/GeoGraph/GeoGraph2d.h"
+#include "RoadNetwork/CityObject/SubDividedCityObject.h"
+#include "PLATEAURnTestUtil.h"
+
+namespace {
+    // 近傍頂点を含むランダムな頂点列を作る
+    TArray<FVector> CreateNearVertices(int32 Num, int32 Seed) {
+        FRandomStream Random(Seed);
+        TArray<FVector> Vertices;
+        Vertices.Reserve(Num);
+        const auto Size = FMath::Sqrt(static_cast<float>(Num)) * 10.f;
+        while (Vertices.Num() < Num) {
+            const auto R = Random.FRand();
+            if (Vertices.Num() > 0 && R < 0.1f) {
+                // 同じ座標(距離が同じ頂点が複数ある場合の優先順位の確認用)
+                Vertices.Add(Vertices[Random.RandHelper(Vertices.Num())]);
+            }
+            else if (Vertices.Num() > 0 && R < 0.4f) {
+                Vertices.Add(Vertices[Random.RandHelper(Vertices.Num())] + Random.VRand() * Random.FRandRange(0.f, 0.15f));
+            }
+            else {
+                Vertices.Add(FVector(Random.FRandRange(0.f, Size), Random.FRandRange(0.f, Size), Random.FRandRange(0.f, 1.f)));
+            }
+        }
+        return Vertices;
+    }
+
+    // NumX * NumY頂点の格子状のメッシュ. 一部のセルを抜いて穴を作る
+    void CreateGridMesh(int32 NumX, int32 NumY, int32 Seed, TArray<FVector>& OutVertices, TArray<int32>& OutTriangles) {
+        FRandomStream Random(Seed);
+        OutVertices.Reset(NumX * NumY);
+        OutTriangles.Reset();
+        for (auto Y = 0; Y < NumY; ++Y) {
+            for (auto X = 0; X < NumX; ++X)
+                OutVertices.Add(FVector(X * 100.f, Y * 100.f, 0.f));
+        }
+        for (auto Y = 0; Y < NumY - 1; ++Y) {
+            for (auto X = 0; X < NumX - 1; ++X) {
+                if (Random.FRand() < 0.05f)
+                    continue;
+                const auto V0 = Y * NumX + X;
+                const auto V1 = V0 + 1;
+                const auto V2 = V0 + NumX;
+                const auto V3 = V2 + 1;
+                OutTriangles.Append({ V0, V2, V1, V1, V2, V3 });
+            }
+        }
+    }
+
+    // 高速化前のFGeoGraph2D::ComputeMeshOutlineVertices
+    TArray<FVector> LegacyComputeMeshOutlineVertices(const TArray<FVector>& Vert, const TArray<int32>& Triangles) {
+        TArray<TTuple<int32, int32>> Edges;
+        for (int32 i = 0; i < Triangles.Num(); i += 3) {
+            Edges.Add(MakeTuple(Triangles[i], Triangles[i + 1]));
+            Edges.Add(MakeTuple(Triangles[i + 1], Triangles[i + 2]));
+            Edges.Add(MakeTuple(Triangles[i + 2], Triangles[i]));
+        }
+
+        TMap<TTuple<int32, int32>, int32> EdgeCount;
+        for (const auto& Edge : Edges) {
+            auto NormalizedEdge = Edge.Get<0>() < Edge.Get<1>() ? Edge : MakeTuple(Edge.Get<1>(), Edge.Get<0>());
+            EdgeCount.Add(NormalizedEdge, EdgeCount.FindRef(NormalizedEdge) + 1);
+        }
+
+        TArray<TTuple<int32, int32>> OutlineEdges;
+        for (const auto& Edge : Edges) {
+            auto NormalizedEdge = Edge.Get<0>() < Edge.Get<1>() ? Edge : MakeTuple(Edge.Get<1>(), Edge.Get<0>());
+            if (EdgeCount[NormalizedEdge] == 1) {
+                OutlineEdges.Add(Edge);
+            }
+        }
+
+        TArray<FVector> Result;
+        if (OutlineEdges.Num() == 0) {
+            return Result;
+        }
+
+        int32 CurrentVertex = OutlineEdges[0].Get<0>();
+        Result.Add(Vert[CurrentVertex]);
+
+        while (OutlineEdges.Num() > 0) {
+            bool Found = false;
+            for (int32 i = 0; i < OutlineEdges.Num(); ++i) {
+                if (OutlineEdges[i].Get<0>() == CurrentVertex) {
+                    CurrentVertex = OutlineEdges[i].Get<1>();
+                    Result.Add(Vert[CurrentVertex]);
+                    OutlineEdges.RemoveAt(i);
+                    Found = true;
+                    break;
+                }
+                if (OutlineEdges[i].Get<1>() == CurrentVertex) {
+                    CurrentVertex = OutlineEdges[i].Get<0>();
+                    Result.Add(Vert[CurrentVertex]);
+                    OutlineEdges.RemoveAt(i);
+                    Found = true;
+                    break;
+                }
+            }
+
+            if (!Found) {
+                break;
+            }
+        }
+
+        return Result;
+    }
+
+    // 高速化前のFSubDividedCityObjectSubMesh::CreateOutlineIndices
+    TArray<TArray<int32>> LegacyCreateOutlineIndices(const TArray<int32>& Triangles) {
+        TArray<TArray<int32>> Result;
+        if (Triangles.Num() == 0) {
+            return Result;
+        }
+
+        auto GetEdge = [](int32 A, int32 B) {
+            if (A < B)
+                Swap(A, B);
+            return MakeTuple(A, B);
+        };
+
+        TMap<TTuple<int32, int32>, int32> Edge2Triangle;
+        for (int32 i = 0; i < Triangles.Num(); i += 3) {
+            auto T = i / 3;
+            for (auto X = 0; X < 3; ++X) {
+                auto E = GetEdge(Triangles[i + X], Triangles[i + (X + 1) % 3]);
+                if (Edge2Triangle.Contains(E) == false) {
+                    Edge2Triangle.Add(E, T);
+                }
+                else if (Edge2Triangle[E] != T) {
+                    Edge2Triangle[E] = -1;
+                }
+            }
+        }
+        TArray<TTuple<int32, int32>> OutlineEdges;
+        for (auto& E : Edge2Triangle) {
+            if (E.Value >= 0)
+                OutlineEdges.Add(E.Key);
+        }
+
+        while (OutlineEdges.Num() > 0) {
+            auto Edge = OutlineEdges[0];
+            OutlineEdges.RemoveAt(0);
+
+            auto Indices = TArray<int32>{ Edge.Key, Edge.Value };
+            while (OutlineEdges.Num() > 0) {
+                auto V0 = Indices[0];
+                auto LastV = Indices[Indices.Num() - 1];
+                auto Index = OutlineEdges.IndexOfByPredicate([LastV](const TTuple<int32, int32>& E) { return E.Key == LastV || E.Value == LastV; });
+                if (Index < 0)
+                    break;
+                auto E = OutlineEdges[Index];
+                OutlineEdges.RemoveAt(Index);
+                if (E.Key == V0 || E.Value == V0)
+                    break;
+                Indices.Add(E.Key == LastV ? E.Value : E.Key);
+            }
+            Result.Add(Indices);
+        }
+
+        return Result;
+    }
+
+    float CalcDistance(const FVector& A, const FVector& B) {
+        return FVector::Distance(A, B);
+    }
+
+    FVector2D ToVec2(const FVector& V) {
+        return FVector2D(V.X, V.Y);
+    }
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_GeoGraph2D_NearVertexTable, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.GeoGraph2D.NearVertexTable", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_GeoGraph2D_NearVertexTable::RunTest(const FString& Parameters) {
+    // グリッド版が全探索版(ユークリッド距離)と同じ結果になること
+    const auto Vertices = CreateNearVertices(3000, 20240406);
+    for (const auto Epsilon : { 0.f, 0.01f, 0.1f, 0.5f }) {
+        const auto Expected = FGeoGraph2D::GetNearVertexTable(Vertices, CalcDistance, Epsilon);
+        const auto Actual = FGeoGraph2D::GetNearVertexTable(Vertices, Epsilon);
+        TestTrue(FString::Printf(TEXT("Same table (Epsilon %.2f)"), Epsilon), Actual == Expected);
+    }
+    return true;
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_GeoGraph2D_MeshOutline, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.GeoGraph2D.MeshOutline", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_GeoGraph2D_MeshOutline::RunTest(const FString& Parameters) {
+    // 高速化前と同じ外周になること
+    TArray<FVector> Vertices;
+    TArray<int32> Triangles;
+    for (auto Seed = 0; Seed < 5; ++Seed) {
+        CreateGridMesh(20 + Seed * 5, 15 + Seed * 3, 20240406 + Seed, Vertices, Triangles);
+        const auto Context = FString::Printf(TEXT("Seed %d"), Seed);
+
+        const auto Outline = FGeoGraph2D::ComputeMeshOutlineVertices(Vertices, Triangles, ToVec2);
+        TestTrue(Context + TEXT(" ComputeMeshOutlineVertices"), Outline == LegacyComputeMeshOutlineVertices(Vertices, Triangles));
+
+        FSubDividedCityObjectSubMesh SubMesh;
+        SubMesh.Triangles = Triangles;
+        TestTrue(Context + TEXT(" CreateOutlineIndices"), SubMesh.CreateOutlineIndices() == LegacyCreateOutlineIndices(Triangles));
+    }
+
+    TestEqual("Empty mesh", FGeoGraph2D::ComputeMeshOutlineVertices(Vertices, {}, ToVec2).Num(), 0);
+    return true;
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_GeoGraph2D_Benchmark, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.GeoGraph2D.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FPLATEAUTest_GeoGraph2D_Benchmark::RunTest(const FString& Parameters) {
+    for (const auto Num : { 10000, 100000 }) {
+        const auto Vertices = CreateNearVertices(Num, 20240406);
+        PLATEAURnTestUtil::Measure(*this, TEXT("GetNearVertexTable(Grid)"), Num, TEXT("vertices"), [&] { FGeoGraph2D::GetNearVertexTable(Vertices, 0.1f); });
+        // 全探索版は100k頂点では時間がかかりすぎるため10kのみ計測する
+        if (Num <= 10000)
+            PLATEAURnTestUtil::Measure(*this, TEXT("GetNearVertexTable(TFunction)"), Num, TEXT("vertices"), [&] { FGeoGraph2D::GetNearVertexTable(Vertices, CalcDistance, 0.1f); });
+
+        TArray<FVector> MeshVertices;
+        TArray<int32> Triangles;
+        const auto Size = FMath::CeilToInt32(FMath::Sqrt(static_cast<float>(Num)));
+        CreateGridMesh(Size, Size, 20240406, MeshVertices, Triangles);
+        FSubDividedCityObjectSubMesh SubMesh;
+        SubMesh.Triangles = Triangles;
+        PLATEAURnTestUtil::Measure(*this, TEXT("ComputeMeshOutlineVertices"), MeshVertices.Num(), TEXT("vertices"), [&] { FGeoGraph2D::ComputeMeshOutlineVertices(MeshVertices, Triangles, ToVec2); });
+        PLATEAURnTestUtil::Measure(*this, TEXT("CreateOutlineIndices"), MeshVertices.Num(), TEXT("vertices"), [&] { SubMesh.CreateOutlineIndices(); });
+        if (Num <= 10000) {
+            PLATEAURnTestUtil::Measure(*this, TEXT("ComputeMeshOutlineVertices(Legacy)"), MeshVertices.Num(), TEXT("vertices"), [&] { LegacyComputeMeshOutlineVertices(MeshVertices, Triangles); });
+            PLATEAURnTestUtil::Measure(*this, TEXT("CreateOutlineIndices(Legacy)"), MeshVertices.Num(), TEXT("vertices"), [&] { LegacyCreateOutlineIndices(Triangles); });
+        }
+    }
+    return true;
+}
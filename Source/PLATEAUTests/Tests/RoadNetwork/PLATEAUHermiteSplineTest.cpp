@@ -0,0 +1,42 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "Components/SplineComponent.h"
+#include "RoadNetwork/Util/PLATEAUHermiteSpline.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_HermiteSpline, "PLATEAUTest.FPLATEAUTest.RoadNetwork.HermiteSpline", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_HermiteSpline::RunTest(const FString& Parameters) {
+    // 道路線を滑らかにする時と同じく, 全ての点のタンジェントを指定したUSplineComponentと比較する
+    FRandomStream Random(20240405);
+    for (auto Case = 0; Case < 10; ++Case) {
+        TArray<FVector> Points;
+        TArray<FVector> Tangents;
+        FVector P = FVector::ZeroVector;
+        const auto Num = Random.RandRange(2, 20);
+        for (auto i = 0; i < Num; ++i) {
+            P += FVector(Random.FRandRange(50.f, 500.f), Random.FRandRange(-200.f, 200.f), Random.FRandRange(-10.f, 10.f));
+            Points.Add(P);
+            Tangents.Add(Random.VRand() * Random.FRandRange(0.f, 300.f));
+        }
+
+        auto SplineComp = NewObject<USplineComponent>();
+        SplineComp->ClearSplinePoints();
+        for (auto i = 0; i < Points.Num(); ++i)
+            SplineComp->AddSplinePoint(Points[i], ESplineCoordinateSpace::World);
+        for (auto i = 0; i < Points.Num(); ++i) {
+            SplineComp->SetSplinePointType(i, ESplinePointType::Curve);
+            SplineComp->SetTangentAtSplinePoint(i, Tangents[i], ESplineCoordinateSpace::World);
+        }
+        SplineComp->UpdateSpline();
+
+        const FPLATEAUHermiteSpline Spline(Points, Tangents);
+        const auto Context = FString::Printf(TEXT("Case %d"), Case);
+        TestEqual(Context + TEXT(" length"), Spline.GetLength(), SplineComp->GetSplineLength(), 0.1f);
+        for (float Dist = 0; Dist < SplineComp->GetSplineLength(); Dist += 50.f) {
+            const auto Expected = SplineComp->GetLocationAtDistanceAlongSpline(Dist, ESplineCoordinateSpace::World);
+            TestEqual(Context + TEXT(" location"), Spline.GetLocationAtDistance(Dist), Expected, 0.1f);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,175 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "Algo/Reverse.h"
+#include "RoadNetwork/Factory/RoadNetworkFactory.h"
+#include "RoadNetwork/Structure/RnLineString.h"
+#include "RoadNetwork/Structure/RnPoint.h"
+#include "PLATEAURnTestUtil.h"
+
+namespace {
+    // 高速化前のFPLATEAULineStringFactoryWork::CreateLineString(ポインタのXORをキーにする)
+    struct FLegacyLineStringCache {
+        struct FPointCache {
+            TArray<URnPoint*> Points;
+            URnLineString* LineString = nullptr;
+        };
+        TMap<uint64, TArray<FPointCache>> RnPointList2LineStringMap;
+
+        URnLineString* CreateLineString(const TArray<URnPoint*>& Points, bool& bIsCached, bool& bIsReversed, TFunction<URnLineString* (const TArray<URnPoint*>&)> CreateLineStringFunc) {
+            bIsCached = false;
+            uint64 Key = 0;
+            for (URnPoint* Point : Points) {
+                Key ^= (uint64_t)Point;
+            }
+
+            TArray<FPointCache>* FoundArray = RnPointList2LineStringMap.Find(Key);
+            if (FoundArray) {
+                for (FPointCache& Entry : *FoundArray) {
+                    bool bLocalIsReversed = false;
+                    if (FPLATEAULineStringFactoryWork::IsEqual(Entry.Points, Points, bLocalIsReversed)) {
+                        bIsCached = true;
+                        bIsReversed = bLocalIsReversed;
+                        return Entry.LineString;
+                    }
+                }
+            }
+            else {
+                FoundArray = &RnPointList2LineStringMap.Add(Key);
+            }
+
+            bIsReversed = false;
+            FPointCache NewCacheEntry;
+            NewCacheEntry.Points = Points;
+            NewCacheEntry.LineString = CreateLineStringFunc(Points);
+            FoundArray->Add(NewCacheEntry);
+            return NewCacheEntry.LineString;
+        }
+    };
+
+    TArray<URnPoint*> CreatePoints(int32 Num) {
+        TArray<URnPoint*> Points;
+        for (auto i = 0; i < Num; ++i)
+            Points.Add(RnNew<URnPoint>(FVector(i * 100.f, 0.f, 0.f)));
+        return Points;
+    }
+
+    // 格子状に並んだ道路の境界線. 隣り合う道路で共有されるので同じ点列が正順/逆順で2回ずつ現れる
+    TArray<TArray<URnPoint*>> CreateSharedBorders(int32 CellNum, int32 MidPointNum) {
+        TArray<URnPoint*> Corners = CreatePoints((CellNum + 1) * (CellNum + 1));
+        auto Corner = [&](int32 X, int32 Y) { return Corners[Y * (CellNum + 1) + X]; };
+
+        TArray<TArray<URnPoint*>> Borders;
+        auto AddBorder = [&](URnPoint* Start, URnPoint* End) {
+            auto Border = CreatePoints(MidPointNum);
+            Border.Insert(Start, 0);
+            Border.Add(End);
+            Borders.Add(Border);
+            Borders.Add(TArray<URnPoint*>(Border));
+            Algo::Reverse(Borders.Last());
+        };
+        for (auto Y = 0; Y <= CellNum; ++Y) {
+            for (auto X = 0; X <= CellNum; ++X) {
+                if (X < CellNum)
+                    AddBorder(Corner(X, Y), Corner(X + 1, Y));
+                if (Y < CellNum)
+                    AddBorder(Corner(X, Y), Corner(X, Y + 1));
+            }
+        }
+        return Borders;
+    }
+
+    // 少数の点の並び替え/重複だけで構成される点列. XORのキーが衝突しやすい
+    TArray<TArray<URnPoint*>> CreatePermutedBorders(int32 Num, int32 Seed) {
+        FRandomStream Random(Seed);
+        const auto Pool = CreatePoints(6);
+        TArray<TArray<URnPoint*>> Borders;
+        for (auto i = 0; i < Num; ++i) {
+            TArray<URnPoint*> Border;
+            const auto Length = Random.RandRange(4, 12);
+            for (auto j = 0; j < Length; ++j)
+                Border.Add(Pool[Random.RandHelper(Pool.Num())]);
+            Borders.Add(Border);
+        }
+        return Borders;
+    }
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_LineStringFactory_Cache, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.LineStringFactory.Cache", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_LineStringFactory_Cache::RunTest(const FString& Parameters) {
+    const auto P = CreatePoints(3);
+    FPLATEAULineStringFactoryWork Factory;
+    bool bIsCached = false;
+    bool bIsReversed = false;
+
+    auto* Ls = Factory.CreateLineString({ P[0], P[1], P[2] }, bIsCached, bIsReversed);
+    TestFalse("First creation", bIsCached);
+
+    // 同じ点列/逆順の点列はキャッシュが使われる
+    TestTrue("Same points", Factory.CreateLineString({ P[0], P[1], P[2] }, bIsCached, bIsReversed) == Ls);
+    TestTrue("Same points cached", bIsCached && !bIsReversed);
+    TestTrue("Reversed points", Factory.CreateLineString({ P[2], P[1], P[0] }, bIsCached, bIsReversed) == Ls);
+    TestTrue("Reversed points cached", bIsCached && bIsReversed);
+
+    // 並び替え/重複点は別の点列として扱う
+    Factory.CreateLineString({ P[1], P[0], P[2] }, bIsCached, bIsReversed);
+    TestFalse("Permuted points", bIsCached);
+    auto* Repeated = Factory.CreateLineString({ P[0], P[0], P[1] }, bIsCached, bIsReversed);
+    TestFalse("Repeated points", bIsCached);
+    TestTrue("Reversed repeated points", Factory.CreateLineString({ P[1], P[0], P[0] }, bIsCached, bIsReversed) == Repeated);
+    TestTrue("Reversed repeated points cached", bIsCached && bIsReversed);
+    auto* Palindrome = Factory.CreateLineString({ P[0], P[1], P[0] }, bIsCached, bIsReversed);
+    TestTrue("Palindrome", Factory.CreateLineString({ P[0], P[1], P[0] }, bIsCached, bIsReversed) == Palindrome);
+    TestTrue("Palindrome cached", bIsCached && !bIsReversed);
+
+    Factory.CreateLineString({ P[0], P[1], P[2] }, bIsCached, bIsReversed, false);
+    TestFalse("Cache disabled", bIsCached);
+    TestNull("Empty points", Factory.CreateLineString({}, bIsCached, bIsReversed));
+
+    // 高速化前と同じキャッシュ結果になること
+    for (const auto& Borders : { CreateSharedBorders(5, 3), CreatePermutedBorders(500, 20240409) }) {
+        FPLATEAULineStringFactoryWork NewCache;
+        FLegacyLineStringCache LegacyCache;
+        TMap<URnLineString*, URnLineString*> New2Legacy;
+        auto CreateFunc = [](const TArray<URnPoint*>&) { return NewObject<URnLineString>(GetTransientPackage()); };
+        for (auto i = 0; i < Borders.Num(); ++i) {
+            bool bNewCached = false, bNewReversed = false, bLegacyCached = false, bLegacyReversed = false;
+            auto* NewLs = NewCache.CreateLineString(Borders[i], bNewCached, bNewReversed, true, CreateFunc);
+            auto* LegacyLs = LegacyCache.CreateLineString(Borders[i], bLegacyCached, bLegacyReversed, CreateFunc);
+            const auto Context = FString::Printf(TEXT("Border %d"), i);
+            TestTrue(Context + TEXT(" cached"), bNewCached == bLegacyCached);
+            TestTrue(Context + TEXT(" reversed"), bNewReversed == bLegacyReversed);
+            if (bNewCached)
+                TestTrue(Context + TEXT(" same line string"), New2Legacy.FindRef(NewLs) == LegacyLs);
+            else
+                New2Legacy.Add(NewLs, LegacyLs);
+        }
+    }
+    return true;
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_LineStringFactory_Benchmark, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.LineStringFactory.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FPLATEAUTest_LineStringFactory_Benchmark::RunTest(const FString& Parameters) {
+    // CreateRnModelでのWay生成と同様に, 道路間で共有される境界線を正順/逆順で何度も生成する
+    auto* Dummy = NewObject<URnLineString>(GetTransientPackage());
+    auto CreateFunc = [Dummy](const TArray<URnPoint*>&) { return Dummy; };
+    auto MeasureCase = [&](const FString& Name, const TArray<TArray<URnPoint*>>& Borders) {
+        PLATEAURnTestUtil::Measure(*this, Name + TEXT(" CreateLineString"), Borders.Num(), TEXT("borders"), [&] {
+            FPLATEAULineStringFactoryWork Cache;
+            bool bIsCached = false, bIsReversed = false;
+            for (const auto& Border : Borders)
+                Cache.CreateLineString(Border, bIsCached, bIsReversed, true, CreateFunc);
+        });
+        PLATEAURnTestUtil::Measure(*this, Name + TEXT(" CreateLineString(Legacy)"), Borders.Num(), TEXT("borders"), [&] {
+            FLegacyLineStringCache Cache;
+            bool bIsCached = false, bIsReversed = false;
+            for (const auto& Border : Borders)
+                Cache.CreateLineString(Border, bIsCached, bIsReversed, CreateFunc);
+        });
+    };
+    MeasureCase(TEXT("SharedBorders"), CreateSharedBorders(100, 8));
+    MeasureCase(TEXT("PermutedBorders"), CreatePermutedBorders(20000, 20240409));
+    return true;
+}
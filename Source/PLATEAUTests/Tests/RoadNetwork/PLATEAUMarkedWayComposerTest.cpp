@@ -0,0 +1,175 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "RoadAdjust/RoadMarking/PLATEAUCrosswalkComposer.h"
+#include "RoadAdjust/RoadMarking/PLATEAUMarkedWayListComposerMain.h"
+#include "RoadAdjust/RoadNetworkToMesh/PLATEAURrTarget.h"
+#include "PLATEAURnTestUtil.h"
+
+namespace {
+    constexpr int32 RoadNum = 8;
+    constexpr float RoadLength = 12000.f;
+    constexpr float RoadPitch = 14000.f;
+
+    // Count本の道路が交差点を挟んで一列に並んだモデル. 交差点付近のセンターラインが黄色になる長さにする
+    // 片側1車線と2車線の道路を交互に並べ, 車線の左右のWayは折れ線にしてセンターラインの補間を通す
+    URnModel* CreateModel(int32 Count) {
+        TArray<UPLATEAUCityObjectGroup*> Groups;
+        PLATEAURnTestUtil::FModelParam Param;
+        Param.RoadLength = RoadLength;
+        Param.RoadPitch = RoadPitch;
+        Param.MaxLaneNum = 2;
+        Param.MiddleNum = 3;
+        return PLATEAURnTestUtil::CreateModel(Count, Groups, Param);
+    }
+
+    TArray<FString> ToStrings(const TArray<FPLATEAUMarkedWay>& MarkedWays, bool bSort) {
+        TArray<FString> Result;
+        for (const auto& MarkedWay : MarkedWays) {
+            auto Str = FString::Printf(TEXT("%d %d"), static_cast<int32>(MarkedWay.GetMarkedWayType()), MarkedWay.IsReversed() ? 1 : 0);
+            for (const auto& Point : MarkedWay.GetLine().GetPoints())
+                Str += FString::Printf(TEXT(" (%.2f,%.2f,%.2f)"), Point.X, Point.Y, Point.Z);
+            Result.Add(Str);
+        }
+        if (bSort)
+            Result.Sort();
+        return Result;
+    }
+
+    TArray<FVector> ToVertices(const URnWay* Way) {
+        return Way ? Way->GetVertices().ToArray() : TArray<FVector>();
+    }
+
+    TArray<URnRoadBase*> AllRoadBases(const URnModel* Model) {
+        TArray<URnRoadBase*> Result;
+        Result.Append(Model->GetRoads());
+        Result.Append(Model->GetIntersections());
+        return Result;
+    }
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_MarkedWayComposer_MergedBorderVertices, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.MarkedWayComposer.MergedBorderVertices", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_MarkedWayComposer_MergedBorderVertices::RunTest(const FString& Parameters) {
+    auto* Model = CreateModel(3);
+    for (const auto& Road : Model->GetRoads()) {
+        for (const auto BorderType : { EPLATEAURnLaneBorderType::Prev, EPLATEAURnLaneBorderType::Next }) {
+            for (const auto Dir : { TOptional<EPLATEAURnDir>(), TOptional<EPLATEAURnDir>(EPLATEAURnDir::Left), TOptional<EPLATEAURnDir>(EPLATEAURnDir::Right) }) {
+                const auto Expected = ToVertices(Road->GetMergedBorder(BorderType, Dir));
+                TestTrue("Has border", Expected.Num() >= 2);
+                TestTrue("Same vertices as GetMergedBorder", Road->GetMergedBorderVertices(BorderType, Dir) == Expected);
+            }
+        }
+    }
+
+    // AddPointOrSkipと同じ点が残る
+    const TArray<FVector> Inputs{ FVector(0, 0, 0), FVector(0, 0, 0), FVector(100, 0, 0), FVector(200, 0, 0), FVector(200, 100, 0), FVector(200, 100, 0) };
+    auto* LineString = RnNew<URnLineString>();
+    TArray<FVector> Vertices;
+    for (const auto& Input : Inputs) {
+        LineString->AddPointOrSkip(RnNew<URnPoint>(Input));
+        URnLineString::AddVertexOrSkip(Vertices, Input);
+    }
+    TArray<FVector> Expected;
+    for (const auto& Point : LineString->GetPoints())
+        Expected.Add(Point->Vertex);
+    TestTrue("AddVertexOrSkip same as AddPointOrSkip", Vertices == Expected);
+    return true;
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_MarkedWayComposer_Parallel, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.MarkedWayComposer.Parallel", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_MarkedWayComposer_Parallel::RunTest(const FString& Parameters) {
+    auto* Model = CreateModel(RoadNum);
+    auto* Target = NewObject<UPLATEAURrTargetModel>();
+    Target->Initialize(Model);
+    auto* Composer = NewObject<UPLATEAUMarkedWayListComposerMain>();
+    const auto MarkedWays = Composer->ComposeFrom(Target).GetMarkedWays();
+
+    // 並列化しても直列に処理していた時と同じく, コンポーザーごとに道路/交差点の順で並ぶ
+    // センターラインは両端が交差点の道路では黄色/白/黄色, 片側だけの道路では黄色と白の2本に分かれる
+    TArray<EPLATEAUMarkedWayType> ExpectedTypes;
+    const auto AddExpectedTypes = [&ExpectedTypes](EPLATEAUMarkedWayType Type, int32 Num) {
+        for (auto i = 0; i < Num; ++i)
+            ExpectedTypes.Add(Type);
+    };
+    // 車線境界線は片側2車線の道路に2本ずつ
+    AddExpectedTypes(EPLATEAUMarkedWayType::LaneLine, RoadNum / 2 * 2);
+    AddExpectedTypes(EPLATEAUMarkedWayType::ShoulderLine, RoadNum * 2);
+    for (auto i = 0; i < RoadNum; ++i) {
+        AddExpectedTypes(EPLATEAUMarkedWayType::CenterLineNearIntersection, i > 0 ? 1 : 0);
+        AddExpectedTypes(EPLATEAUMarkedWayType::CenterLineUnder6MWidth, 1);
+        AddExpectedTypes(EPLATEAUMarkedWayType::CenterLineNearIntersection, i < RoadNum - 1 ? 1 : 0);
+    }
+    AddExpectedTypes(EPLATEAUMarkedWayType::ShoulderLine, (RoadNum - 1) * 2);
+    AddExpectedTypes(EPLATEAUMarkedWayType::StopLine, (RoadNum - 1) * 2);
+
+    TArray<EPLATEAUMarkedWayType> Types;
+    for (const auto& MarkedWay : MarkedWays)
+        Types.Add(MarkedWay.GetMarkedWayType());
+    TestEqual("Marked way num", MarkedWays.Num(), 74);
+    TestTrue("Marked way types", Types == ExpectedTypes);
+
+    // 種類ごとの線の長さの合計. 車線の左右の線は3000ごとに横に200ずらした折れ線, 交差点の輪郭は長さ2000で片側だけ600ずれる
+    // 黄色のセンターラインは交差点から3000まで, 停止線は片側の車線の幅(300 x 車線数)
+    const auto WayLength = 4.f * FMath::Sqrt(FMath::Square(3000.f) + FMath::Square(200.f));
+    const auto IntersectionLength = 2000.f + FMath::Sqrt(FMath::Square(2000.f) + FMath::Square(600.f));
+    const TMap<EPLATEAUMarkedWayType, float> ExpectedLengths{
+        { EPLATEAUMarkedWayType::LaneLine, WayLength * 8 },
+        { EPLATEAUMarkedWayType::ShoulderLine, WayLength * 16 + IntersectionLength * 7 },
+        { EPLATEAUMarkedWayType::CenterLineUnder6MWidth, WayLength * 8 - 3000.f * 14 },
+        { EPLATEAUMarkedWayType::CenterLineNearIntersection, 3000.f * 14 },
+        { EPLATEAUMarkedWayType::StopLine, 300.f * 21 },
+    };
+    TMap<EPLATEAUMarkedWayType, float> Lengths;
+    for (const auto& MarkedWay : MarkedWays) {
+        Lengths.FindOrAdd(MarkedWay.GetMarkedWayType()) += MarkedWay.GetLine().SumDistance();
+
+        // 道路にめりこまないように浮かせる. 停止線はさらに高くする
+        const auto Height = UPLATEAUMarkedWayListComposerMain::HeightOffset + (MarkedWay.GetMarkedWayType() == EPLATEAUMarkedWayType::StopLine ? 7.f : 0.f);
+        for (const auto& Point : MarkedWay.GetLine().GetPoints())
+            TestEqual("Height", static_cast<float>(Point.Z), Height, 0.01f);
+    }
+    for (const auto& Expected : ExpectedLengths)
+        TestEqual(FString::Printf(TEXT("Length of type %d"), static_cast<int32>(Expected.Key)), Lengths.FindRef(Expected.Key), Expected.Value, 1.f);
+
+    // 道路/交差点ごとの結果を合わせると全体の結果になる
+    const auto RoadBases = AllRoadBases(Model);
+    TArray<FPLATEAUMarkedWay> PerRoadBase;
+    for (const auto& List : Composer->ComposePerRoadBase(RoadBases))
+        PerRoadBase.Append(List.GetMarkedWays());
+    TestTrue("Per road base same as full", ToStrings(PerRoadBase, true) == ToStrings(MarkedWays, true));
+
+    // 横断歩道は交差点に接する道路の端ごとに1本
+    auto* CrosswalkComposer = NewObject<UPLATEAUCrosswalkComposer>();
+    const auto Crosswalks = CrosswalkComposer->Compose(*Target, EPLATEAUCrosswalkFrequency::All);
+    TestEqual("Crosswalk num", Crosswalks.Num(), Model->GetIntersections().Num() * 2);
+    TArray<FPLATEAUMarkedWay> PerRoadBaseCrosswalks;
+    for (const auto& List : CrosswalkComposer->ComposePerRoadBase(RoadBases, EPLATEAUCrosswalkFrequency::All))
+        PerRoadBaseCrosswalks.Append(List.GetMarkedWays());
+    TestTrue("Per road base crosswalks", ToStrings(PerRoadBaseCrosswalks, false) == ToStrings(Crosswalks.GetMarkedWays(), false));
+    TestEqual("No crosswalk", CrosswalkComposer->Compose(*Target, EPLATEAUCrosswalkFrequency::None).Num(), 0);
+    return true;
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_MarkedWayComposer_Benchmark, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.MarkedWayComposer.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FPLATEAUTest_MarkedWayComposer_Benchmark::RunTest(const FString& Parameters) {
+    auto* Model = CreateModel(5000);
+    auto* Target = NewObject<UPLATEAURrTargetModel>();
+    Target->Initialize(Model);
+    auto* Composer = NewObject<UPLATEAUMarkedWayListComposerMain>();
+    auto* CrosswalkComposer = NewObject<UPLATEAUCrosswalkComposer>();
+
+    auto StartTime = FPlatformTime::Seconds();
+    const auto MarkedWays = Composer->ComposeFrom(Target);
+    const auto Elapsed = FPlatformTime::Seconds() - StartTime;
+
+    StartTime = FPlatformTime::Seconds();
+    const auto Crosswalks = CrosswalkComposer->Compose(*Target, EPLATEAUCrosswalkFrequency::All);
+    const auto CrosswalkElapsed = FPlatformTime::Seconds() - StartTime;
+
+    AddInfo(FString::Printf(TEXT("MarkedWayComposer : %d roads, %d marked ways in %.3f sec, crosswalk %d in %.3f sec"),
+        Model->GetRoads().Num(), MarkedWays.Num(), Elapsed, Crosswalks.Num(), CrosswalkElapsed));
+    return true;
+}
@@ -0,0 +1,370 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "RoadNetwork/RGraph/RGraph.h"
+#include "RoadNetwork/RGraph/RGraphEx.h"
+#include "RoadNetwork/RGraph/RCompactGraph.h"
+#include "RoadNetwork/GeoGraph/LineSegment3D.h"
+
+namespace {
+    // 変更前の平面走査(全走査中の辺と比較)による実装. 結果の比較用
+    void LegacyInsertVertexInNearEdge(RGraphRef_t<URGraph> Graph, float ToleranceMeter) {
+        auto Tolerance = ToleranceMeter * FPLATEAURnDef::Meter2Unit;
+        auto&& Vertices = Graph->GetAllVertices().Array();
+        constexpr auto Comp = FPLATEAURnDef::Vector3Comparer();
+        Vertices.Sort([&](const URVertex& A, const URVertex& B) {
+            return Comp(A.Position, B.Position) < 0;
+            });
+
+        TSet<RGraphRef_t<UREdge>> queue;
+        TMap<RGraphRef_t<UREdge>, TSet<RGraphRef_t<URVertex>>> edgeInsertMap;
+        auto Threshold = Tolerance * Tolerance;
+        for (auto V : Vertices) {
+            TArray<RGraphRef_t<UREdge>> addEdges;
+            TSet<RGraphRef_t<UREdge>> removeEdges;
+            for (auto&& E : V->GetEdges()) {
+                auto d = Comp(V->Position, E->GetOppositeVertex(V)->Position);
+                if (d < 0)
+                    addEdges.Add(E);
+                else if (d > 0)
+                    removeEdges.Add(E);
+            }
+            for (auto&& remove : removeEdges)
+                queue.Remove(remove);
+            for (auto e : queue) {
+                if (e->GetV0() == V || e->GetV1() == V)
+                    continue;
+                auto s = FLineSegment3D(e->GetV0()->GetPosition(), e->GetV1()->GetPosition());
+                if ((s.GetNearestPoint(V->GetPosition()) - V->GetPosition()).SquaredLength() < Threshold)
+                    edgeInsertMap.FindOrAdd(e).Add(V);
+            }
+            for (auto&& add : addEdges)
+                queue.Add(add);
+        }
+        for (auto&& e : edgeInsertMap)
+            FRGraphEx::InsertVertices(e.Key, e.Value.Array());
+    }
+
+    void LegacyInsertVerticesInEdgeIntersection(RGraphRef_t<URGraph> Graph, float HeightToleranceMeter) {
+        auto HeightTolerance = HeightToleranceMeter * FPLATEAURnDef::Meter2Unit;
+        auto&& Vertices = Graph->GetAllVertices().Array();
+        constexpr auto Comp = FPLATEAURnDef::Vector3Comparer();
+        Vertices.Sort([&](const URVertex& A, const URVertex& B) {
+            return Comp(A.Position, B.Position) < 0;
+            });
+
+        TSet<RGraphRef_t<UREdge>> queue;
+        TMap<RGraphRef_t<UREdge>, TSet<RGraphRef_t<URVertex>>> edgeInsertMap;
+        TMap<FVector, RGraphRef_t<URVertex>> vertexMap;
+        auto NearlyEqual = [](float a, float b) { return FMath::Abs(a - b) < 1e-3f; };
+        for (auto V : Vertices) {
+            TArray<RGraphRef_t<UREdge>> addEdges;
+            TSet<RGraphRef_t<UREdge>> removeEdges;
+            for (auto&& E : V->GetEdges()) {
+                auto d = Comp(V->Position, E->GetOppositeVertex(V)->Position);
+                if (d < 0)
+                    addEdges.Add(E);
+                else if (d > 0)
+                    removeEdges.Add(E);
+            }
+            TArray<RGraphRef_t<UREdge>> targets;
+            for (auto&& t : queue) {
+                if (t->GetV0() == V || t->GetV1() == V || removeEdges.Contains(t))
+                    continue;
+                targets.Add(t);
+            }
+            for (auto e0 : removeEdges) {
+                auto s0 = FLineSegment3D(e0->GetV0()->GetPosition(), e0->GetV1()->GetPosition());
+                for (auto e1 : targets) {
+                    auto s1 = FLineSegment3D(e1->GetV0()->GetPosition(), e1->GetV1()->GetPosition());
+                    RGraphRef_t<URVertex> shareV;
+                    if (e0->IsShareAnyVertex(e1, shareV))
+                        continue;
+                    FVector intersection;
+                    float t1, t2;
+                    if (s0.TrySegmentIntersectionBy2D(s1, FPLATEAURnDef::Plane, HeightTolerance, intersection, t1, t2)) {
+                        if ((NearlyEqual(t1, 0) || NearlyEqual(t1, 1)) && (NearlyEqual(t2, 0) || NearlyEqual(t2, 1)))
+                            continue;
+                        if (vertexMap.Contains(intersection) == false)
+                            vertexMap.Add(intersection, RGraphNew<URVertex>(intersection));
+                        auto p = vertexMap[intersection];
+                        edgeInsertMap.FindOrAdd(e0).Add(p);
+                        edgeInsertMap.FindOrAdd(e1).Add(p);
+                    }
+                }
+            }
+            for (auto&& add : addEdges)
+                queue.Add(add);
+            for (auto&& remove : removeEdges)
+                queue.Remove(remove);
+        }
+        for (auto&& e : edgeInsertMap)
+            FRGraphEx::InsertVertices(e.Key, e.Value.Array());
+    }
+
+    // 固定シードで道路メッシュ相当のグラフを作成する
+    // 格子状の四角形面(一部は隣接面の辺上に頂点を持つ)と, それらと交差する斜めの面からなる
+    RGraphRef_t<URGraph> CreateRecordedGraph() {
+        FRandomStream Random(20240401);
+        auto Graph = RGraphNew<URGraph>();
+        TMap<FVector, RGraphRef_t<URVertex>> VertexMap;
+        auto GetVertex = [&](const FVector& P) {
+            if (auto Found = VertexMap.Find(P))
+                return *Found;
+            return VertexMap.Add(P, RGraphNew<URVertex>(P));
+        };
+        auto AddFace = [&](const TArray<FVector>& Points) {
+            auto Face = RGraphNew<URFace>(Graph, nullptr, ERRoadTypeMask::Road, 1);
+            for (auto i = 0; i < Points.Num(); ++i)
+                Face->AddEdge(RGraphNew<UREdge>(GetVertex(Points[i]), GetVertex(Points[(i + 1) % Points.Num()])));
+            Graph->AddFace(Face);
+        };
+
+        constexpr float Cell = 1000.f;
+        for (auto x = 0; x < 12; ++x) {
+            for (auto y = 0; y < 12; ++y) {
+                const FVector O(x * Cell, y * Cell, Random.FRandRange(0.f, 20.f));
+                TArray<FVector> Points = { O, O + FVector(Cell, 0, 0), O + FVector(Cell, Cell, 0), O + FVector(0, Cell, 0) };
+                // 辺の途中に, 隣の面の辺から少しずれた頂点を追加する
+                if (Random.FRand() < 0.5f)
+                    Points.Insert(O + FVector(Cell, Random.FRandRange(0.2f, 0.8f) * Cell, 0) + FVector(Random.FRandRange(-5.f, 5.f), 0, 0), 2);
+                AddFace(Points);
+            }
+        }
+        for (auto i = 0; i < 30; ++i) {
+            const FVector A(Random.FRandRange(0.f, 12.f * Cell), Random.FRandRange(0.f, 12.f * Cell), 0.f);
+            const FVector B = A + FVector(Random.FRandRange(-3.f, 3.f) * Cell, Random.FRandRange(-3.f, 3.f) * Cell, 0.f);
+            AddFace({ A, B, B + FVector(50.f, 50.f, 0.f) });
+        }
+        return Graph;
+    }
+
+    // 辺の両端座標(順不同)と面ごとの辺数から, オブジェクトの同一性に依存しないトポロジーの表現を作る
+    TArray<FString> GetTopology(RGraphRef_t<URGraph> Graph) {
+        TArray<FString> Result;
+        for (auto&& E : Graph->GetAllEdges()) {
+            auto P0 = E->GetV0()->GetPosition().ToString();
+            auto P1 = E->GetV1()->GetPosition().ToString();
+            Result.Add(P0 < P1 ? P0 + TEXT("|") + P1 : P1 + TEXT("|") + P0);
+        }
+        for (auto&& F : Graph->GetFaces())
+            Result.Add(FString::Printf(TEXT("Face:%d"), F->GetEdges().Num()));
+        Result.Sort();
+        return Result;
+    }
+
+    // 辺を共有する四角形の格子と, そのうちDuplicateCount個の面と同じ辺を持つ面からなるグラフ
+    RGraphRef_t<URGraph> CreateQuadGridGraph(int32 NumX, int32 NumY, int32 DuplicateCount) {
+        FRandomStream Random(20240403);
+        auto Graph = RGraphNew<URGraph>();
+        TArray<RGraphRef_t<URVertex>> Vertices;
+        for (auto y = 0; y <= NumY; ++y) {
+            for (auto x = 0; x <= NumX; ++x)
+                Vertices.Add(RGraphNew<URVertex>(FVector(x * 100.f, y * 100.f, 0.f)));
+        }
+        auto GetVertex = [&](int32 x, int32 y) { return Vertices[y * (NumX + 1) + x]; };
+
+        // 横/縦方向の辺
+        TArray<RGraphRef_t<UREdge>> XEdges;
+        TArray<RGraphRef_t<UREdge>> YEdges;
+        for (auto y = 0; y <= NumY; ++y) {
+            for (auto x = 0; x < NumX; ++x)
+                XEdges.Add(RGraphNew<UREdge>(GetVertex(x, y), GetVertex(x + 1, y)));
+        }
+        for (auto y = 0; y < NumY; ++y) {
+            for (auto x = 0; x <= NumX; ++x)
+                YEdges.Add(RGraphNew<UREdge>(GetVertex(x, y), GetVertex(x, y + 1)));
+        }
+
+        auto AddQuad = [&](int32 x, int32 y) {
+            auto Face = RGraphNew<URFace>(Graph, nullptr, ERRoadTypeMask::Road, 1);
+            Face->AddEdge(XEdges[y * NumX + x]);
+            Face->AddEdge(XEdges[(y + 1) * NumX + x]);
+            Face->AddEdge(YEdges[y * (NumX + 1) + x]);
+            Face->AddEdge(YEdges[y * (NumX + 1) + x + 1]);
+            Graph->AddFace(Face);
+        };
+        for (auto y = 0; y < NumY; ++y) {
+            for (auto x = 0; x < NumX; ++x)
+                AddQuad(x, y);
+        }
+
+        // 重複させる面は異なるセルから選ぶ
+        TArray<int32> Cells;
+        for (auto i = 0; i < NumX * NumY; ++i)
+            Cells.Add(i);
+        for (auto i = 0; i < DuplicateCount; ++i) {
+            Cells.Swap(i, Random.RandRange(i, Cells.Num() - 1));
+            AddQuad(Cells[i] % NumX, Cells[i] / NumX);
+        }
+        return Graph;
+    }
+
+    // 頂点/辺の統合用の入力. 少しずれた頂点で隣接する四角形の帯と, 外周の辺上の中間点, 重複した面からなる
+    TArray<TPair<int32, TArray<FVector>>> CreateReductionFaces() {
+        FRandomStream Random(20240402);
+        auto Jitter = [&](const FVector& P) {
+            return P + FVector(Random.FRandRange(-3.f, 3.f), Random.FRandRange(-3.f, 3.f), Random.FRandRange(0.f, 5.f));
+        };
+
+        TArray<TPair<int32, TArray<FVector>>> Faces;
+        constexpr float Cell = 1000.f;
+        for (auto x = 0; x < 10; ++x) {
+            const FVector O(x * Cell, 0, 0);
+            TArray<FVector> Points = { Jitter(O), Jitter(O + FVector(Cell, 0, 0)), Jitter(O + FVector(Cell, Cell, 0)), Jitter(O + FVector(0, Cell, 0)) };
+            const auto Lod = x < 5 ? 1 : 2;
+            if (x % 3 == 0)
+                Faces.Emplace(Lod, Points);
+            // 外周の辺上にほぼ直線となる中間点を追加する
+            Points.Insert(FVector(O.X + Random.FRandRange(0.2f, 0.8f) * Cell, Random.FRandRange(-5.f, 5.f), 0), 1);
+            Faces.Emplace(Lod, Points);
+        }
+        return Faces;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RGraphEx_InsertVertex, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RGraphEx.InsertVertex", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RGraphEx_InsertVertex::RunTest(const FString& Parameters) {
+    {
+        auto Expected = CreateRecordedGraph();
+        auto Actual = CreateRecordedGraph();
+        TestTrue("Same input", GetTopology(Actual) == GetTopology(Expected));
+
+        LegacyInsertVertexInNearEdge(Expected, 0.2f);
+        FRGraphEx::InsertVertexInNearEdge(Actual, 0.2f);
+        const auto ExpectedTopology = GetTopology(Expected);
+        TestTrue("InsertVertexInNearEdge changes graph", ExpectedTopology != GetTopology(CreateRecordedGraph()));
+        TestTrue("InsertVertexInNearEdge", GetTopology(Actual) == ExpectedTopology);
+    }
+    {
+        auto Expected = CreateRecordedGraph();
+        auto Actual = CreateRecordedGraph();
+
+        LegacyInsertVerticesInEdgeIntersection(Expected, 1.f);
+        FRGraphEx::InsertVerticesInEdgeIntersection(Actual, 1.f);
+        const auto ExpectedTopology = GetTopology(Expected);
+        TestTrue("InsertVerticesInEdgeIntersection changes graph", ExpectedTopology != GetTopology(CreateRecordedGraph()));
+        TestTrue("InsertVerticesInEdgeIntersection", GetTopology(Actual) == ExpectedTopology);
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RGraph_CompactGraph, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RGraph.CompactGraph", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RGraph_CompactGraph::RunTest(const FString& Parameters) {
+    const auto Faces = CreateReductionFaces();
+
+    auto Expected = RGraphNew<URGraph>();
+    {
+        TMap<FVector, RGraphRef_t<URVertex>> VertexMap;
+        TMap<TPair<RGraphRef_t<URVertex>, RGraphRef_t<URVertex>>, RGraphRef_t<UREdge>> EdgeMap;
+        for (auto&& Face : Faces) {
+            auto F = RGraphNew<URFace>(Expected, nullptr, ERRoadTypeMask::Road, Face.Key);
+            TArray<RGraphRef_t<URVertex>> Vertices;
+            for (auto&& P : Face.Value) {
+                if (VertexMap.Contains(P) == false)
+                    VertexMap.Add(P, RGraphNew<URVertex>(P));
+                Vertices.Add(VertexMap[P]);
+            }
+            for (auto i = 0; i < Vertices.Num(); ++i) {
+                auto V0 = Vertices[i];
+                auto V1 = Vertices[(i + 1) % Vertices.Num()];
+                if (V0 > V1)
+                    Swap(V0, V1);
+                const auto Key = MakeTuple(V0, V1);
+                if (EdgeMap.Contains(Key) == false)
+                    EdgeMap.Add(Key, RGraphNew<UREdge>(V0, V1));
+                F->AddEdge(EdgeMap[Key]);
+            }
+            Expected->AddFace(F);
+        }
+    }
+
+    FRCompactGraph Compact;
+    for (auto&& Face : Faces) {
+        Compact.AddFace(nullptr, ERRoadTypeMask::Road, Face.Key);
+        TArray<int32> Vertices;
+        for (auto&& P : Face.Value)
+            Vertices.Add(Compact.FindOrAddVertex(P));
+        for (auto i = 0; i < Vertices.Num(); ++i)
+            Compact.AddFaceEdge(Vertices[i], Vertices[(i + 1) % Vertices.Num()]);
+    }
+    TestTrue("Same input", GetTopology(Compact.ToGraph()) == GetTopology(Expected));
+
+    FRGraphEx::AdjustSmallLodHeight(Expected, 0.2f, 2, 0.3f);
+    FRGraphEx::EdgeReduction(Expected);
+    FRGraphEx::VertexReduction(Expected, 0.2f, 2, 0.3f);
+
+    Compact.AdjustSmallLodHeight(0.2f, 0.3f);
+    Compact.EdgeReduction();
+    Compact.VertexReduction(0.2f, 2, 0.3f);
+
+    // 帯の四角形の頂点は22個に統合され, 中間点と重複した面は削除される
+    TestEqual("Vertex count", Compact.GetVertexCount(), 22);
+    TestEqual("Face count", Compact.GetFaceCount(), 10);
+    TestTrue("Same result", GetTopology(Compact.ToGraph()) == GetTopology(Expected));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RGraph_Cache, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RGraph.Cache", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RGraph_Cache::RunTest(const FString& Parameters) {
+    // 各処理の後で, 差分更新された辺/頂点の集合が面から作り直したものと一致すること
+    auto Graph = CreateRecordedGraph();
+    TestTrue("Create", Graph->ValidateCache());
+
+    FRGraphEx::AdjustSmallLodHeight(Graph, 0.2f, 2, 0.3f);
+    FRGraphEx::EdgeReduction(Graph);
+    TestTrue("EdgeReduction", Graph->ValidateCache());
+    FRGraphEx::VertexReduction(Graph, 0.2f, 2, 0.3f);
+    TestTrue("VertexReduction", Graph->ValidateCache());
+    FRGraphEx::RemoveIsolatedEdgeFromFace(Graph);
+    TestTrue("RemoveIsolatedEdgeFromFace", Graph->ValidateCache());
+    FRGraphEx::InsertVertexInNearEdge(Graph, 0.3f);
+    TestTrue("InsertVertexInNearEdge", Graph->ValidateCache());
+    FRGraphEx::InsertVerticesInEdgeIntersection(Graph, 1.f);
+    TestTrue("InsertVerticesInEdgeIntersection", Graph->ValidateCache());
+    FRGraphEx::SeparateFaces(Graph);
+    TestTrue("SeparateFaces", Graph->ValidateCache());
+    FRGraphEx::FaceReduction(Graph);
+    TestTrue("FaceReduction", Graph->ValidateCache());
+
+    // 面を削除すると, その面だけが参照していた辺/頂点も集合から削除されること
+    auto Faces = Graph->GetFaces().Array();
+    for (auto i = 0; i < Faces.Num(); i += 2)
+        Faces[i]->DisConnect();
+    TestTrue("DisConnect", Graph->ValidateCache());
+    for (auto&& Face : Graph->GetFaces().Array())
+        Graph->RemoveFace(Face);
+    TestEqual("Empty edges", Graph->GetEdges().Num(), 0);
+    TestEqual("Empty vertices", Graph->GetVertices().Num(), 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RGraphEx_FaceReduction, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RGraphEx.FaceReduction", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RGraphEx_FaceReduction::RunTest(const FString& Parameters) {
+    auto Graph = CreateQuadGridGraph(10, 10, 15);
+    TestEqual("Face count", Graph->GetFaces().Num(), 115);
+    TestEqual("Removed face count", FRGraphEx::FaceReduction(Graph), 15);
+    TestEqual("Face count after reduction", Graph->GetFaces().Num(), 100);
+    TestEqual("No duplicated face", FRGraphEx::FaceReduction(Graph), 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RGraphEx_FaceReductionBenchmark, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RGraphEx.FaceReductionBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FPLATEAUTest_RGraphEx_FaceReductionBenchmark::RunTest(const FString& Parameters) {
+    // 300x300の格子 + 重複面10000 = 100000面
+    auto Graph = CreateQuadGridGraph(300, 300, 10000);
+    TestEqual("Face count", Graph->GetFaces().Num(), 100000);
+
+    const auto StartTime = FPlatformTime::Seconds();
+    const auto RemovedCount = FRGraphEx::FaceReduction(Graph);
+    const auto Elapsed = FPlatformTime::Seconds() - StartTime;
+    AddInfo(FString::Printf(TEXT("FaceReduction : %d faces, %d removed, %.3f sec"), 100000, RemovedCount, Elapsed));
+
+    TestEqual("Removed face count", RemovedCount, 10000);
+    return true;
+}
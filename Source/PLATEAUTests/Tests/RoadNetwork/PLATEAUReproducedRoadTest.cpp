@@ -0,0 +1,157 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "RoadAdjust/PLATEAUReproducedRoad.h"
+#include "RoadAdjust/RoadMarking/LineGeneratorComponent.h"
+#include "RoadNetwork/Structure/PLATEAURnStructureModel.h"
+#include "RoadNetwork/Structure/RnModel.h"
+#include "RoadNetwork/Structure/RnRoad.h"
+#include "RoadNetwork/Structure/RnLane.h"
+#include "RoadNetwork/Structure/RnWay.h"
+#include "RoadNetwork/Structure/RnLineString.h"
+#include "RoadNetwork/Structure/RnPoint.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+
+namespace {
+    URnLineString* CreateLineString(const TArray<FVector>& Vertices) {
+        TArray<URnPoint*> Points;
+        for (const auto& Vertex : Vertices)
+            Points.Add(RnNew<URnPoint>(Vertex));
+        return URnLineString::Create(Points);
+    }
+
+    // X方向の車線の側線. 滑らかにすると形が変わるように途中で折れ曲がっている
+    URnWay* CreateSideWay(float StartX, float EndX, float Y) {
+        const auto MidX = (StartX + EndX) * 0.5f;
+        return URnWay::Create(CreateLineString({ FVector(StartX, Y, 0.f), FVector(MidX, Y + 100.f, 0.f), FVector(EndX, Y, 0.f) }));
+    }
+
+    // X=Xの境界線. 隣の道路と共有するために線だけを作る
+    URnLineString* CreateBorder(float X, int32 Index) {
+        const auto Y0 = Index * 300.f;
+        const auto Y1 = (Index + 1) * 300.f;
+        return CreateLineString({ FVector(X, Y0, 0.f), FVector(X + 50.f, (Y0 + Y1) * 0.5f, 0.f), FVector(X, Y1, 0.f) });
+    }
+
+    URnLane* CreateLane(float StartX, float EndX, int32 Index, bool bIsReversed, URnLineString* PrevBorder, URnLineString* NextBorder) {
+        auto* Lane = RnNew<URnLane>(
+            CreateSideWay(StartX, EndX, Index * 300.f),
+            CreateSideWay(StartX, EndX, (Index + 1) * 300.f),
+            URnWay::Create(PrevBorder),
+            URnWay::Create(NextBorder));
+        Lane->SetIsReversed(bIsReversed);
+        return Lane;
+    }
+
+    // R0 - R1 と連なる対向2車線の道路. R0とR1の間の境界線は共有する
+    // bAddLaneがtrueならR1に3本目の車線を加える
+    URnModel* CreateModel(bool bAddLane) {
+        auto* Model = URnModel::Create();
+        TArray<URnLineString*> SharedBorders = { CreateBorder(1000.f, 0), CreateBorder(1000.f, 1) };
+        auto* R0 = URnRoad::Create();
+        auto* R1 = URnRoad::Create();
+        for (auto i = 0; i < 2; ++i) {
+            R0->AddMainLane(CreateLane(0.f, 1000.f, i, i == 1, CreateBorder(0.f, i), SharedBorders[i]));
+            R1->AddMainLane(CreateLane(1000.f, 2000.f, i, i == 1, SharedBorders[i], CreateBorder(2000.f, i)));
+        }
+        if (bAddLane)
+            R1->AddMainLane(CreateLane(1000.f, 2000.f, 2, true, CreateBorder(1000.f, 2), CreateBorder(2000.f, 2)));
+        R0->SetPrevNext(nullptr, R1);
+        R1->SetPrevNext(R0, nullptr);
+        Model->AddRoad(R0);
+        Model->AddRoad(R1);
+        return Model;
+    }
+
+    FString ToString(const FVector& V) {
+        return FString::Printf(TEXT("(%.1f,%.1f,%.1f)"), V.X, V.Y, V.Z);
+    }
+
+    // 道路ネットワークの全ての線の頂点. 道路/車線の順に並べる
+    TArray<FString> GetNetworkLines(const URnModel* Model) {
+        TArray<FString> Result;
+        for (const auto& Road : Model->GetRoads()) {
+            for (const auto& Lane : Road->GetAllLanesWithMedian()) {
+                for (const auto& Way : Lane->GetAllWays()) {
+                    FString Str;
+                    for (const auto& Vertex : Way->GetVertices())
+                        Str += ToString(Vertex);
+                    Result.Add(Str);
+                }
+            }
+        }
+        return Result;
+    }
+
+    // 生成された道路標示. コンポーネントの名前や順番によらずに比較するために文字列にしてソートする
+    TArray<FString> GetRoadMarks(const APLATEAUReproducedRoad* Road) {
+        TArray<FString> Result;
+        TArray<ULineGeneratorComponent*> Lines;
+        Road->GetComponents(Lines);
+        for (const auto* Line : Lines) {
+            FString Str = TEXT("Line");
+            for (auto i = 0; i < Line->GetNumberOfSplinePoints(); ++i)
+                Str += ToString(Line->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World));
+            Result.Add(Str);
+        }
+        TArray<UHierarchicalInstancedStaticMeshComponent*> Arrows;
+        Road->GetComponents(Arrows);
+        for (const auto* Arrow : Arrows) {
+            for (auto i = 0; i < Arrow->GetInstanceCount(); ++i) {
+                FTransform Transform;
+                Arrow->GetInstanceTransform(i, Transform, true);
+                Result.Add(FString::Printf(TEXT("Arrow %s %s"), *GetNameSafe(Arrow->GetStaticMesh()), *ToString(Transform.GetLocation())));
+            }
+        }
+        Result.Sort();
+        return Result;
+    }
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_ReproducedRoad_UpdateRoadMarks, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.ReproducedRoad.UpdateRoadMarks", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_ReproducedRoad_UpdateRoadMarks::RunTest(const FString& Parameters) {
+    InitializeTest("ReproducedRoadUpdateRoadMarks");
+    if (!OpenNewMap()) {
+        AddError("Failed to OpenNewMap");
+        return false;
+    }
+    auto* World = GetWorld();
+    if (World == nullptr)
+        return false;
+    const auto Frequency = TEXT("All");
+
+    // 生成した後に車線を追加して, 変化した部分だけを作り直す
+    auto* Incremental = World->SpawnActor<APLATEAURnStructureModel>();
+    Incremental->Model = CreateModel(false);
+    auto* IncrementalRoad = World->SpawnActor<APLATEAUReproducedRoad>();
+    IncrementalRoad->CreateRoadMarks(Incremental, Frequency);
+    auto* R1 = Incremental->Model->GetRoads()[1];
+    R1->AddMainLane(CreateLane(1000.f, 2000.f, 2, true, CreateBorder(1000.f, 2), CreateBorder(2000.f, 2)));
+    IncrementalRoad->UpdateRoadMarks(Incremental, Frequency);
+    const auto IncrementalLines = GetNetworkLines(Incremental->Model);
+    const auto IncrementalMarks = GetRoadMarks(IncrementalRoad);
+
+    // 同じ道路ネットワークを一度に生成する. CreateRoadMarksは他のAPLATEAUReproducedRoadを削除するので結果を取った後に行う
+    auto* Full = World->SpawnActor<APLATEAURnStructureModel>();
+    Full->Model = CreateModel(true);
+    auto* FullRoad = World->SpawnActor<APLATEAUReproducedRoad>();
+    FullRoad->CreateRoadMarks(Full, Frequency);
+    const auto FullLines = GetNetworkLines(Full->Model);
+    const auto FullMarks = GetRoadMarks(FullRoad);
+
+    // 共有している境界線を含め, 滑らかにした線も道路標示も一度に生成した場合と同じになること
+    TestEqual("Network lines", IncrementalLines.Num(), FullLines.Num());
+    TestTrue("Same network lines", IncrementalLines == FullLines);
+    TestTrue("Has road marks", FullMarks.Num() > 0);
+    TestEqual("Road marks", IncrementalMarks.Num(), FullMarks.Num());
+    TestTrue("Same road marks", IncrementalMarks == FullMarks);
+
+    // 作り直しても前回のコンポーネントが残らないこと
+    FullRoad->CreateRoadMarks(Full, Frequency);
+    TestTrue("Recreate road marks", GetRoadMarks(FullRoad) == FullMarks);
+    TestTrue("Recreate network lines", GetNetworkLines(Full->Model) == FullLines);
+
+    FinishTest(true, "");
+    return true;
+}
@@ -0,0 +1,75 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "PLATEAURnTestUtil.h"
+#include "RoadNetwork/Structure/RnModelCloner.h"
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnModelCloner_Clone, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RnModelCloner.Clone", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RnModelCloner_Clone::RunTest(const FString& Parameters) {
+    TArray<UPLATEAUCityObjectGroup*> Groups;
+    auto* Model = PLATEAURnTestUtil::CreateModel(3, Groups);
+    Model->GetRoads()[1]->SetMedianLane1(RnNew<URnLane>(
+        PLATEAURnTestUtil::CreateWay(RnNew<URnPoint>(FVector(1500.f, 290.f, 0.f)), RnNew<URnPoint>(FVector(2500.f, 290.f, 0.f))),
+        PLATEAURnTestUtil::CreateWay(RnNew<URnPoint>(FVector(1500.f, 310.f, 0.f)), RnNew<URnPoint>(FVector(2500.f, 310.f, 0.f))),
+        nullptr, nullptr));
+
+    // 全てのオブジェクトが複製され, 共有関係が保たれていること
+    FRnModelCloner Cloner;
+    auto* Clone = Cloner.Clone(Model);
+    PLATEAURnTestUtil::FRnModelChecker Checker(*this);
+    Checker.CheckModel(Model, Clone);
+    TestEqual("Cloned object count", Cloner.Num(), Checker.Num());
+    TestTrue("Find", Cloner.Find(Model->GetRoads()[0]) == Clone->GetRoads()[0]);
+    TestTrue("Parent model", Clone->GetRoads()[0]->GetParentModel() == Clone);
+    TestTrue("Check", Clone->Check() == Model->Check());
+    TestTrue("ValidateTargetTranIndex", Clone->ValidateTargetTranIndex());
+    for (auto* Group : Groups)
+        TestTrue(Group->GetName() + TEXT(" GetRoadBaseBy"), Cloner.Find(Model->GetRoadBaseBy(Group)) == Clone->GetRoadBaseBy(Group));
+
+    // コピーを変更しても元のモデルは変わらないこと
+    auto* SharedPoint = Model->GetRoads()[0]->GetMainLanes()[0]->GetRightWay()->GetPoint(0);
+    const auto OriginalVertex = SharedPoint->Vertex;
+    Cloner.Find(SharedPoint)->Vertex += FVector(0.f, 100.f, 0.f);
+    TestTrue("Original vertex", SharedPoint->Vertex == OriginalVertex);
+    TestTrue("Shared point in clone", Clone->GetRoads()[0]->GetMainLanes()[1]->GetLeftWay()->GetPoint(0)->Vertex == OriginalVertex + FVector(0.f, 100.f, 0.f));
+    Clone->RemoveRoad(Clone->GetRoads()[2]);
+    TestEqual("Original road count", Model->GetRoads().Num(), 3);
+
+    // 既存のモデルへのコピーは中身を置き換えること
+    auto* Dest = URnModel::Create();
+    TArray<UPLATEAUCityObjectGroup*> DestGroups;
+    Cloner.CopyTo(PLATEAURnTestUtil::CreateModel(5, DestGroups), Dest);
+    Cloner.CopyTo(Model, Dest);
+    PLATEAURnTestUtil::FRnModelChecker DestChecker(*this);
+    DestChecker.CheckModel(Model, Dest);
+    TestTrue("Dest ValidateTargetTranIndex", Dest->ValidateTargetTranIndex());
+    TestNull("Old road base", Dest->GetRoadBaseBy(DestGroups[0]));
+    // Destと一緒に保存できるようにDestの中に作られること
+    TestTrue("Outer", Dest->GetRoads()[0]->GetOuter() == Dest && Dest->GetRoads()[0]->GetMainLanes()[0]->GetLeftWay()->GetPoint(0)->GetOuter() == Dest);
+    return true;
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnModelCloner_CloneBenchmark, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RnModelCloner.CloneBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FPLATEAUTest_RnModelCloner_CloneBenchmark::RunTest(const FString& Parameters) {
+    // 道路10000本 + 交差点9999個
+    TArray<UPLATEAUCityObjectGroup*> Groups;
+    auto* Model = PLATEAURnTestUtil::CreateModel(10000, Groups);
+
+    FRnModelCloner Cloner;
+    auto StartTime = FPlatformTime::Seconds();
+    auto* Clone = Cloner.Clone(Model);
+    const auto FirstElapsed = FPlatformTime::Seconds() - StartTime;
+
+    // 2回目以降は内部のマップを再利用する
+    StartTime = FPlatformTime::Seconds();
+    Cloner.CopyTo(Model, Clone);
+    const auto SecondElapsed = FPlatformTime::Seconds() - StartTime;
+    AddInfo(FString::Printf(TEXT("Clone : %d roads, %d objects, first %.3f sec, reuse %.3f sec"), Model->GetRoads().Num(), Cloner.Num(), FirstElapsed, SecondElapsed));
+
+    TestEqual("Road count", Clone->GetRoads().Num(), Model->GetRoads().Num());
+    TestEqual("Intersection count", Clone->GetIntersections().Num(), Model->GetIntersections().Num());
+    TestTrue("ValidateTargetTranIndex", Clone->ValidateTargetTranIndex());
+    return true;
+}
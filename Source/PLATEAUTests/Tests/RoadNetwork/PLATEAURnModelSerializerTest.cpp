@@ -0,0 +1,177 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "PLATEAURnTestUtil.h"
+#include "RoadNetwork/Structure/RnModelSerializer.h"
+#include "Serialization/ObjectReader.h"
+#include "Serialization/ObjectWriter.h"
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnModelSerializer_RoundTrip, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RnModelSerializer.RoundTrip", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RnModelSerializer_RoundTrip::RunTest(const FString& Parameters) {
+    TArray<UPLATEAUCityObjectGroup*> Groups;
+    auto* Model = PLATEAURnTestUtil::CreateModel(3, Groups);
+
+    for (const auto bCompress : { false, true }) {
+        FRnModelSerializer Writer;
+        TArray<uint8> Data;
+        TArray<TSoftObjectPtr<UPLATEAUCityObjectGroup>> TargetTrans;
+        Writer.Write(Model, Data, TargetTrans, bCompress);
+        TestTrue("Written", Data.Num() > 0);
+        TestEqual("TargetTrans num", TargetTrans.Num(), Groups.Num());
+
+        // 既存の中身は置き換えられること
+        TArray<UPLATEAUCityObjectGroup*> DestGroups;
+        auto* Dest = PLATEAURnTestUtil::CreateModel(5, DestGroups);
+        FRnModelSerializer Reader;
+        if (!TestTrue("Read", Reader.Read(Data, TargetTrans, Dest)))
+            continue;
+
+        PLATEAURnTestUtil::FRnModelChecker Checker(*this);
+        Checker.CheckModel(Model, Dest);
+        TestEqual("Object count", Reader.Num(), Writer.Num());
+        TestTrue("Parent model", Dest->GetRoads()[0]->GetParentModel() == Dest);
+        TestTrue("Outer", Dest->GetRoads()[0]->GetOuter() == Dest);
+        TestTrue("ValidateTargetTranIndex", Dest->ValidateTargetTranIndex());
+        TestNull("Old road base", Dest->GetRoadBaseBy(DestGroups[0]));
+        for (auto* Group : Groups)
+            TestNotNull(Group->GetName() + TEXT(" GetRoadBaseBy"), Dest->GetRoadBaseBy(Group));
+
+        // 共有していた点は読み込み後も共有していること
+        auto* SharedPoint = Dest->GetRoads()[0]->GetMainLanes()[0]->GetRightWay()->GetPoint(0);
+        TestTrue("Shared point", Dest->GetRoads()[0]->GetMainLanes()[1]->GetLeftWay()->GetPoint(0) == SharedPoint);
+    }
+
+    // 見つからないCityObjectGroupは無効な参照として読み込むこと
+    TArray<uint8> Data;
+    TArray<TSoftObjectPtr<UPLATEAUCityObjectGroup>> TargetTrans;
+    FRnModelSerializer().Write(Model, Data, TargetTrans);
+    const auto MissingIndex = TargetTrans.IndexOfByKey(TSoftObjectPtr<UPLATEAUCityObjectGroup>(Groups[0]));
+    if (TestTrue("Has group", MissingIndex != INDEX_NONE)) {
+        TargetTrans[MissingIndex] = TSoftObjectPtr<UPLATEAUCityObjectGroup>(FSoftObjectPath(TEXT("/Temp/Missing.Missing:Group")));
+        auto* Dest = URnModel::Create();
+        if (TestTrue("Read missing", FRnModelSerializer().Read(Data, TargetTrans, Dest))) {
+            TestFalse("Missing group", Dest->GetRoads()[0]->GetTargetTrans()[0].IsValid());
+            TestNotNull("Other group", Dest->GetRoadBaseBy(Groups[1]));
+        }
+    }
+    return true;
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnModelSerializer_BrokenData, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RnModelSerializer.BrokenData", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RnModelSerializer_BrokenData::RunTest(const FString& Parameters) {
+    TArray<UPLATEAUCityObjectGroup*> Groups;
+    auto* Model = PLATEAURnTestUtil::CreateModel(3, Groups);
+    TArray<uint8> Data;
+    TArray<TSoftObjectPtr<UPLATEAUCityObjectGroup>> TargetTrans;
+    FRnModelSerializer().Write(Model, Data, TargetTrans, false);
+
+    TArray<UPLATEAUCityObjectGroup*> DestGroups;
+    auto* Dest = PLATEAURnTestUtil::CreateModel(2, DestGroups);
+    auto* DestRoad = Dest->GetRoads()[0];
+    auto CheckRejected = [&](const TCHAR* What, const TArray<uint8>& Broken) {
+        TestFalse(What, FRnModelSerializer().Read(Broken, TargetTrans, Dest));
+        TestTrue(FString(What) + TEXT(" keeps dest"), Dest->GetRoads().Num() == 2 && Dest->GetRoads()[0] == DestRoad);
+    };
+
+    auto BadMagic = Data;
+    BadMagic[0] ^= 0xFF;
+    CheckRejected(TEXT("Magic"), BadMagic);
+
+    auto BadVersion = Data;
+    BadVersion[4] = static_cast<uint8>(FRnModelSerializer::Version + 1);
+    CheckRejected(TEXT("Version"), BadVersion);
+
+    auto Truncated = Data;
+    Truncated.SetNum(Data.Num() - 1);
+    CheckRejected(TEXT("Truncated"), Truncated);
+
+    // 最後の値はモデルの歩道リストの最後のインデックス
+    auto BadIndex = Data;
+    const int32 OutOfRange = MAX_int32;
+    FMemory::Memcpy(BadIndex.GetData() + BadIndex.Num() - sizeof(int32), &OutOfRange, sizeof(int32));
+    CheckRejected(TEXT("Index"), BadIndex);
+
+    // 末尾は 道路(3) / 交差点(2) / 歩道(3) の一覧で, それぞれ個数 + インデックス
+    const auto LastRoadOffset = Data.Num() - static_cast<int32>(sizeof(int32)) * (4 + 3 + 1);
+    const auto FirstIntersectionOffset = Data.Num() - static_cast<int32>(sizeof(int32)) * (4 + 2);
+    auto NullRoad = Data;
+    const int32 NullIndex = INDEX_NONE;
+    FMemory::Memcpy(NullRoad.GetData() + LastRoadOffset, &NullIndex, sizeof(int32));
+    CheckRejected(TEXT("Null road"), NullRoad);
+    auto IntersectionAsRoad = Data;
+    FMemory::Memcpy(IntersectionAsRoad.GetData() + LastRoadOffset, Data.GetData() + FirstIntersectionOffset, sizeof(int32));
+    CheckRejected(TEXT("Intersection as road"), IntersectionAsRoad);
+
+    // ヘッダの展開後のサイズは本体のサイズに見合っていること
+    constexpr int32 PayloadSizeOffset = sizeof(uint32) * 3;
+    auto BadPayloadSize = Data;
+    const int32 LargerSize = Data.Num();
+    FMemory::Memcpy(BadPayloadSize.GetData() + PayloadSizeOffset, &LargerSize, sizeof(int32));
+    CheckRejected(TEXT("Payload size"), BadPayloadSize);
+
+    TArray<uint8> Compressed;
+    FRnModelSerializer().Write(Model, Compressed, TargetTrans, true);
+    auto TooLarge = Compressed;
+    const int32 TooLargeSize = (Compressed.Num() - PayloadSizeOffset - static_cast<int32>(sizeof(int32))) * 64 + 1;
+    FMemory::Memcpy(TooLarge.GetData() + PayloadSizeOffset, &TooLargeSize, sizeof(int32));
+    CheckRejected(TEXT("Compression ratio"), TooLarge);
+
+    // CityObjectGroupの一覧の範囲外を参照している
+    TargetTrans.Pop();
+    CheckRejected(TEXT("TargetTrans"), Data);
+
+    CheckRejected(TEXT("Empty"), TArray<uint8>());
+    return true;
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnModelSerializer_Benchmark, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RnModelSerializer.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FPLATEAUTest_RnModelSerializer_Benchmark::RunTest(const FString& Parameters) {
+    // 道路10000本 + 交差点9999個
+    TArray<UPLATEAUCityObjectGroup*> Groups;
+    auto* Model = PLATEAURnTestUtil::CreateModel(10000, Groups);
+
+    // 比較用: 全オブジェクトをUObjectのプロパティとして書き出して読み戻す
+    FRnModelSerializer Serializer;
+    TArray<UObject*> Objects;
+    Serializer.ForEachObject(Model, [&Objects](UObject* Object) { Objects.Add(Object); });
+    TArray<TArray<uint8>> ObjectData;
+    ObjectData.SetNum(Objects.Num());
+    auto StartTime = FPlatformTime::Seconds();
+    for (auto i = 0; i < Objects.Num(); ++i)
+        FObjectWriter Writer(Objects[i], ObjectData[i]);
+    const auto ObjectWriteElapsed = FPlatformTime::Seconds() - StartTime;
+    int64 ObjectSize = 0;
+    for (const auto& Data : ObjectData)
+        ObjectSize += Data.Num();
+
+    StartTime = FPlatformTime::Seconds();
+    for (auto i = 0; i < Objects.Num(); ++i) {
+        auto* Object = NewObject<UObject>(GetTransientPackage(), Objects[i]->GetClass());
+        FObjectReader Reader(Object, ObjectData[i]);
+    }
+    const auto ObjectReadElapsed = FPlatformTime::Seconds() - StartTime;
+    AddInfo(FString::Printf(TEXT("UObject : %d objects, %lld bytes, write %.3f sec, read %.3f sec"), Objects.Num(), ObjectSize, ObjectWriteElapsed, ObjectReadElapsed));
+
+    for (const auto bCompress : { false, true }) {
+        TArray<uint8> Data;
+        TArray<TSoftObjectPtr<UPLATEAUCityObjectGroup>> TargetTrans;
+        StartTime = FPlatformTime::Seconds();
+        Serializer.Write(Model, Data, TargetTrans, bCompress);
+        const auto WriteElapsed = FPlatformTime::Seconds() - StartTime;
+
+        auto* Dest = URnModel::Create();
+        FRnModelSerializer Reader;
+        StartTime = FPlatformTime::Seconds();
+        TestTrue("Read", Reader.Read(Data, TargetTrans, Dest));
+        const auto ReadElapsed = FPlatformTime::Seconds() - StartTime;
+        AddInfo(FString::Printf(TEXT("Compact%s : %d objects, %d bytes, write %.3f sec, read %.3f sec"),
+            bCompress ? TEXT(" (zlib)") : TEXT(""), Reader.Num(), Data.Num(), WriteElapsed, ReadElapsed));
+
+        TestEqual("Road count", Dest->GetRoads().Num(), Model->GetRoads().Num());
+        TestEqual("Intersection count", Dest->GetIntersections().Num(), Model->GetIntersections().Num());
+    }
+    return true;
+}
@@ -0,0 +1,350 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "RoadNetwork/GeoGraph/LineSegment3D.h"
+#include "PLATEAURnTestUtil.h"
+
+namespace {
+    // インデックス化前の線形探索版GetRoadBy
+    URnRoad* LegacyGetRoadBy(const URnModel* Model, UPLATEAUCityObjectGroup* TargetTran) {
+        for (auto* Road : Model->GetRoads()) {
+            if (Road->GetTargetTrans().Contains(TargetTran))
+                return Road;
+        }
+        return nullptr;
+    }
+
+    // インデックス化前の線形探索版GetIntersectionBy
+    URnIntersection* LegacyGetIntersectionBy(const URnModel* Model, UPLATEAUCityObjectGroup* TargetTran) {
+        for (auto* Intersection : Model->GetIntersections()) {
+            if (Intersection->GetTargetTrans().Contains(TargetTran))
+                return Intersection;
+        }
+        return nullptr;
+    }
+
+    // インデックス化前の線形探索版GetSideWalkBy
+    URnSideWalk* LegacyGetSideWalkBy(const URnModel* Model, UPLATEAUCityObjectGroup* TargetTran) {
+        for (auto* SideWalk : Model->GetSideWalks()) {
+            if (SideWalk->GetParentRoad() && SideWalk->GetParentRoad()->GetTargetTrans().Contains(TargetTran))
+                return SideWalk;
+        }
+        return nullptr;
+    }
+
+    // 全てのCityObjectGroupについて線形探索版と同じ結果になるか確認する
+    void TestSameAsLegacy(FAutomationTestBase& Test, const FString& Context, const URnModel* Model, const TArray<UPLATEAUCityObjectGroup*>& Groups) {
+        Test.TestTrue(Context + TEXT(" ValidateTargetTranIndex"), Model->ValidateTargetTranIndex());
+        for (auto* Group : Groups) {
+            const auto Name = Context + TEXT(" ") + Group->GetName();
+            Test.TestTrue(Name + TEXT(" GetRoadBy"), Model->GetRoadBy(Group) == LegacyGetRoadBy(Model, Group));
+            Test.TestTrue(Name + TEXT(" GetIntersectionBy"), Model->GetIntersectionBy(Group) == LegacyGetIntersectionBy(Model, Group));
+            Test.TestTrue(Name + TEXT(" GetSideWalkBy"), Model->GetSideWalkBy(Group) == LegacyGetSideWalkBy(Model, Group));
+        }
+    }
+
+    TArray<UPLATEAUCityObjectGroup*> CreateGroups(int32 Num) {
+        TArray<UPLATEAUCityObjectGroup*> Groups;
+        for (auto i = 0; i < Num; ++i)
+            Groups.Add(NewObject<UPLATEAUCityObjectGroup>(GetTransientPackage()));
+        return Groups;
+    }
+
+    // X方向に長さLength, 幅Widthの1車線の道路を作る
+    URnRoad* CreateStraightRoad(UPLATEAUCityObjectGroup* Group, float Length, float Width) {
+        auto* P0 = RnNew<URnPoint>(FVector(0.f, 0.f, 0.f));
+        auto* P1 = RnNew<URnPoint>(FVector(Length, 0.f, 0.f));
+        auto* P2 = RnNew<URnPoint>(FVector(0.f, Width, 0.f));
+        auto* P3 = RnNew<URnPoint>(FVector(Length, Width, 0.f));
+        auto* Lane = RnNew<URnLane>(PLATEAURnTestUtil::CreateWay(P0, P1), PLATEAURnTestUtil::CreateWay(P2, P3), PLATEAURnTestUtil::CreateWay(P0, P2), PLATEAURnTestUtil::CreateWay(P1, P3));
+        return URnRoad::CreateOneLaneRoad(Group, Lane);
+    }
+
+    // 長さ10000の道路Count本が, 長さ2000の交差点を挟んで一列に並んだモデル. 車線の幅は600
+    constexpr float RoadLength = 10000.f;
+    constexpr float RoadPitch = 12000.f;
+    URnModel* CreateRoadRowModel(int32 Count, PLATEAURnTestUtil::ESideWalkType SideWalk = PLATEAURnTestUtil::ESideWalkType::None) {
+        TArray<UPLATEAUCityObjectGroup*> Groups;
+        PLATEAURnTestUtil::FModelParam Param;
+        Param.RoadLength = RoadLength;
+        Param.RoadPitch = RoadPitch;
+        Param.LaneWidth = 600.f;
+        Param.SideWalk = SideWalk;
+        return PLATEAURnTestUtil::CreateModel(Count, Groups, Param);
+    }
+
+    // 道路ごとのレーンの左右の線の頂点を文字列にする
+    TArray<FString> ToLaneStrings(const URnModel* Model) {
+        TArray<FString> Result;
+        for (const auto& Road : Model->GetRoads()) {
+            FString Str;
+            for (const auto& Lane : Road->GetMainLanes()) {
+                for (const auto& Way : { Lane->GetLeftWay(), Lane->GetRightWay() }) {
+                    Str += TEXT(" |");
+                    for (const auto& Vertex : Way->GetVertices())
+                        Str += FString::Printf(TEXT(" (%.2f,%.2f,%.2f)"), Vertex.X, Vertex.Y, Vertex.Z);
+                }
+            }
+            Result.Add(Str);
+        }
+        return Result;
+    }
+
+    // 道路の車線の左右の線のX方向の範囲
+    TInterval<double> GetRangeX(const URnRoad* Road) {
+        TInterval<double> Range;
+        for (const auto& Lane : Road->GetMainLanes()) {
+            for (const auto& Way : { Lane->GetLeftWay(), Lane->GetRightWay() }) {
+                for (const auto& Vertex : Way->GetVertices())
+                    Range.Include(Vertex.X);
+            }
+        }
+        return Range;
+    }
+
+    // 道路ごとのX方向の範囲を文字列にする. 道路の順番によらずに比べるためにソートする
+    TArray<FString> ToRoadRanges(const URnModel* Model) {
+        TArray<FString> Result;
+        for (const auto& Road : Model->GetRoads()) {
+            const auto Range = GetRangeX(Road);
+            Result.Add(FString::Printf(TEXT("%.1f - %.1f"), Range.Min, Range.Max));
+        }
+        Result.Sort();
+        return Result;
+    }
+
+    // CreateRoadRowModelの道路を, 交差点に接する側の端からOffsetの位置で切断した場合の道路ごとの範囲
+    TArray<FString> ExpectedRoadRanges(int32 Count, float Offset) {
+        TArray<FString> Result;
+        for (auto i = 0; i < Count; ++i) {
+            const auto StartX = i * RoadPitch;
+            const auto EndX = StartX + RoadLength;
+            TArray<float> Xs{ StartX };
+            if (i > 0)
+                Xs.Add(StartX + Offset);
+            if (i < Count - 1)
+                Xs.Add(EndX - Offset);
+            Xs.Add(EndX);
+            for (auto j = 0; j < Xs.Num() - 1; ++j)
+                Result.Add(FString::Printf(TEXT("%.1f - %.1f"), Xs[j], Xs[j + 1]));
+        }
+        Result.Sort();
+        return Result;
+    }
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnModel_TargetTranIndex, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RnModel.TargetTranIndex", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RnModel_TargetTranIndex::RunTest(const FString& Parameters) {
+    // 追加/削除/TargetTranの追加を繰り返しても線形探索版と同じ結果になること
+    FRandomStream Random(20240408);
+    const auto Groups = CreateGroups(8);
+    auto* Model = URnModel::Create();
+
+    TArray<URnRoadBase*> RoadBases;
+    for (auto i = 0; i < 30; ++i) {
+        if (Random.FRand() < 0.7f) {
+            auto* Road = URnRoad::Create(TWeakObjectPtr<UPLATEAUCityObjectGroup>(Groups[Random.RandHelper(Groups.Num())]));
+            RoadBases.Add(Road);
+            Model->AddRoad(Road);
+        }
+        else {
+            auto* Intersection = URnIntersection::Create(TObjectPtr<UPLATEAUCityObjectGroup>(Groups[Random.RandHelper(Groups.Num())]));
+            RoadBases.Add(Intersection);
+            Model->AddIntersection(Intersection);
+        }
+    }
+    TestSameAsLegacy(*this, TEXT("Initial"), Model, Groups);
+
+    for (auto Step = 0; Step < 200; ++Step) {
+        auto* RoadBase = RoadBases[Random.RandHelper(RoadBases.Num())];
+        const auto Op = Random.RandHelper(5);
+        if (Op == 0) {
+            // DisConnect(true)と同様に歩道もモデルから削除する
+            for (auto* SideWalk : RoadBase->GetSideWalks())
+                Model->RemoveSideWalk(SideWalk);
+            Model->RemoveRoad(RoadBase->CastToRoad());
+            Model->RemoveIntersection(RoadBase->CastToIntersection());
+        }
+        else if (Op == 1) {
+            Model->AddRoadBase(RoadBase);
+        }
+        else if (Op == 2) {
+            RoadBase->AddTargetTran(Groups[Random.RandHelper(Groups.Num())]);
+        }
+        else if (Op == 3 && RoadBase->GetParentModel() == Model) {
+            Model->AddSideWalk(URnSideWalk::Create(RoadBase, nullptr, nullptr, nullptr, nullptr));
+        }
+        else if (Op == 4 && RoadBase->GetSideWalks().Num() > 0) {
+            Model->RemoveSideWalk(RoadBase->GetSideWalks()[0]);
+        }
+        TestSameAsLegacy(*this, FString::Printf(TEXT("Step %d"), Step), Model, Groups);
+    }
+
+    // 作り直しても同じ結果になること
+    Model->RebuildTargetTranIndex();
+    TestSameAsLegacy(*this, TEXT("Rebuild"), Model, Groups);
+
+    Model->Init();
+    for (auto* Group : Groups)
+        TestNull(TEXT("Init"), Model->GetRoadBaseBy(Group));
+    return true;
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnModel_TargetTranIndexSliceMerge, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RnModel.TargetTranIndexSliceMerge", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RnModel_TargetTranIndexSliceMerge::RunTest(const FString& Parameters) {
+    // 道路の分割/統合後も線形探索版と同じ結果になること
+    const auto Groups = CreateGroups(2);
+    auto* Model = URnModel::Create();
+    auto* Road = CreateStraightRoad(Groups[0], 1000.f, 300.f);
+    Model->AddRoad(Road);
+    TestSameAsLegacy(*this, TEXT("Initial"), Model, Groups);
+
+    const auto Result = Model->SliceRoadHorizontal(Road, FLineSegment3D(FVector(500.f, -100.f, 0.f), FVector(500.f, 400.f, 0.f)));
+    if (!TestEqual("Slice result", static_cast<int32>(Result.Result), static_cast<int32>(URnModel::ERoadCutResult::Success)))
+        return true;
+    TestEqual("Road count after slice", Model->GetRoads().Num(), 2);
+    TestTrue("Slice keeps first road", Model->GetRoadBy(Groups[0]) == Result.PrevRoad);
+    TestSameAsLegacy(*this, TEXT("Slice"), Model, Groups);
+
+    // 分割後の道路にだけ別のグループを追加する
+    Result.NextRoad->AddTargetTran(Groups[1]);
+    TestTrue("Added target tran", Model->GetRoadBy(Groups[1]) == Result.NextRoad);
+    TestSameAsLegacy(*this, TEXT("AddTargetTran"), Model, Groups);
+
+    Model->MergeRoadGroup();
+    TestSameAsLegacy(*this, TEXT("Merge"), Model, Groups);
+    if (Model->GetRoads().Num() == 1)
+        TestTrue("Merged road", Model->GetRoadBy(Groups[1]) == Model->GetRoads()[0]);
+    return true;
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnModel_LineStringVertices, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RnModel.LineStringVertices", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RnModel_LineStringVertices::RunTest(const FString& Parameters) {
+    // 頂点配列版の計算がURnLineString版と同じ結果になること
+    const TArray<FVector> Vertices{ FVector(0, 0, 0), FVector(1000, 0, 0), FVector(1000, 0, 0), FVector(1500, 800, 0), FVector(3000, 800, 100) };
+    const TArray<FVector> Others{ FVector(500, 300, 0), FVector(600, 400, 0) };
+    auto* LineString = URnLineString::Create(Vertices, false);
+    auto* Other = URnLineString::Create(Others, false);
+
+    for (const auto& Pos : { FVector(500, 300, 0), FVector(1200, 600, 0), FVector(5000, 0, 0) }) {
+        FVector Nearest, ExpectedNearest;
+        float Index, ExpectedIndex, Distance, ExpectedDistance;
+        LineString->GetNearestPoint(Pos, ExpectedNearest, ExpectedIndex, ExpectedDistance);
+        URnLineString::GetNearestPoint(Vertices, Pos, Nearest, Index, Distance);
+        TestEqual("Nearest", Nearest, ExpectedNearest);
+        TestEqual("Nearest index", Index, ExpectedIndex);
+        TestEqual("Nearest distance", Distance, ExpectedDistance);
+
+        TestEqual("Length", URnLineString::CalcLength(Vertices, 0.5f, Index), LineString->CalcLength(0.5f, Index));
+    }
+
+    for (const auto Offset : { 0.f, 700.f, 1500.f, 100000.f }) {
+        for (const auto bReverse : { false, true }) {
+            int32 Start, End, ExpectedStart, ExpectedEnd;
+            const auto Expected = LineString->GetAdvancedPoint(Offset, bReverse, ExpectedStart, ExpectedEnd);
+            TestEqual("Advanced point", URnLineString::GetAdvancedPoint(Vertices, Offset, bReverse, Start, End), Expected);
+            TestEqual("Advanced start", Start, ExpectedStart);
+            TestEqual("Advanced end", End, ExpectedEnd);
+        }
+    }
+
+    const FRay Ray(FVector(1200, -500, 0), FVector(0, 1, 0));
+    TTuple<float, FVector> Hit, ExpectedHit;
+    TestTrue("Intersection", URnLineString::TryGetNearestIntersectionBy2D(Vertices, Ray, Hit));
+    TestTrue("Expected intersection", LineString->TryGetNearestIntersectionBy2D(Ray, ExpectedHit));
+    TestEqual("Intersection index", Hit.Key, ExpectedHit.Key);
+    TestEqual("Intersection point", Hit.Value, ExpectedHit.Value);
+
+    // 辺同士の距離(頂点同士ではない)
+    TestEqual("Distance2D", URnLineString::GetDistance2D(Vertices, Others), LineString->GetDistance2D(Other));
+    TestEqual("Distance2D value", URnLineString::GetDistance2D(Vertices, Others), 300.f, 0.01f);
+
+    FVector Mid;
+    const auto Way = URnWay::Create(LineString);
+    TestEqual("Lerp index", URnWay::GetLerpPoint(Vertices, 0.5f, Mid), Way->GetLerpPoint(0.5f, Mid));
+    TestEqual("Lerp point", Mid, Way->GetLerpPoint(0.5f));
+    return true;
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnModel_CalibrateIntersectionBorder, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RnModel.CalibrateIntersectionBorder", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RnModel_CalibrateIntersectionBorder::RunTest(const FString& Parameters) {
+    // 切断線をまとめて並列に計算しても, 交差点に接する道路の端から決まった位置で切断されること
+    // 切断位置は境界線から5m. 交差点と歩道の端の線(境界線から800)を共有しているので, そこから2.5m道路側にずれる
+    const auto RoadNum = 10;
+    FRnModelCalibrateIntersectionBorderOption Option;
+    Option.SkipMergeRoads = true;
+
+    auto* Model = CreateRoadRowModel(RoadNum, PLATEAURnTestUtil::ESideWalkType::BothWithEdge);
+    Model->CalibrateIntersectionBorderForAllRoad(Option);
+
+    // 両端の道路は片側, それ以外は両側で切断される
+    TestEqual("Road num", Model->GetRoads().Num(), RoadNum * 3 - 2);
+    TestTrue("Road ranges", ToRoadRanges(Model) == ExpectedRoadRanges(RoadNum, 800.f + 250.f));
+
+    // 道路の歩道は道路と一緒に切断され, 交差点の歩道はそのまま残る
+    TestEqual("Side walk num", Model->GetSideWalks().Num(), (RoadNum * 3 - 2) * 2 + (RoadNum - 1) * 2);
+    for (const auto& Road : Model->GetRoads()) {
+        const auto Range = GetRangeX(Road);
+        for (const auto& SideWalk : Road->GetSideWalks()) {
+            for (const auto& Way : SideWalk->GetAllWays()) {
+                for (const auto& Vertex : Way->GetVertices())
+                    TestTrue("Side walk inside road", Vertex.X >= Range.Min - 0.1 && Vertex.X <= Range.Max + 0.1);
+            }
+        }
+    }
+
+    // 歩道が無い場合は境界線から5mの位置で切断される(隣の歩道を見る経路を通っていること)
+    auto* WithoutSideWalk = CreateRoadRowModel(RoadNum);
+    WithoutSideWalk->CalibrateIntersectionBorderForAllRoad(Option);
+    TestEqual("Road num without side walk", WithoutSideWalk->GetRoads().Num(), RoadNum * 3 - 2);
+    TestTrue("Road ranges without side walk", ToRoadRanges(WithoutSideWalk) == ExpectedRoadRanges(RoadNum, 500.f));
+    return true;
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnModel_SplitLaneByWidth, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RnModel.SplitLaneByWidth", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RnModel_SplitLaneByWidth::RunTest(const FString& Parameters) {
+    auto* Model = CreateRoadRowModel(10);
+    TArray<FString> FailedRoads;
+    Model->SplitLaneByWidth(3.f, false, FailedRoads, [](URnRoadGroup*) { return true; });
+    TestEqual("Failed roads", FailedRoads.Num(), 0);
+
+    // 幅600の車線が左右それぞれ幅300の2車線になる
+    for (const auto& Road : Model->GetRoads()) {
+        TestEqual("Left lane num", Road->GetLeftLaneCount(), 2);
+        TestEqual("Right lane num", Road->GetRightLaneCount(), 2);
+    }
+
+    // 対象外の道路グループは分割しない
+    auto* Skipped = CreateRoadRowModel(3);
+    const auto Expected = ToLaneStrings(Skipped);
+    Skipped->SplitLaneByWidth(3.f, false, FailedRoads, [](URnRoadGroup*) { return false; });
+    TestTrue("Skipped", ToLaneStrings(Skipped) == Expected);
+    return true;
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnModel_ParallelBenchmark, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RnModel.ParallelBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FPLATEAUTest_RnModel_ParallelBenchmark::RunTest(const FString& Parameters) {
+    // 都市全体のモデル相当の道路数で, 切断線の計算と車線の分割にかかる時間を測る
+    FRnModelCalibrateIntersectionBorderOption Option;
+    Option.SkipMergeRoads = true;
+    auto* Model = CreateRoadRowModel(3000);
+
+    auto StartTime = FPlatformTime::Seconds();
+    Model->CalibrateIntersectionBorderForAllRoad(Option);
+    const auto CalibrateTime = FPlatformTime::Seconds() - StartTime;
+
+    TArray<FString> FailedRoads;
+    StartTime = FPlatformTime::Seconds();
+    Model->SplitLaneByWidth(3.f, false, FailedRoads, [](URnRoadGroup*) { return true; });
+    const auto SplitTime = FPlatformTime::Seconds() - StartTime;
+
+    AddInfo(FString::Printf(TEXT("Roads=%d Calibrate=%.3f sec SplitLaneByWidth=%.3f sec"),
+        Model->GetRoads().Num(), CalibrateTime, SplitTime));
+    return true;
+}
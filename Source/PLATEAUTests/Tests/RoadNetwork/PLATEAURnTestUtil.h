@@ -0,0 +1,287 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Component/PLATEAUCityObjectGroup.h"
+#include "RoadNetwork/Structure/RnModel.h"
+#include "RoadNetwork/Structure/RnRoad.h"
+#include "RoadNetwork/Structure/RnIntersection.h"
+#include "RoadNetwork/Structure/RnSideWalk.h"
+#include "RoadNetwork/Structure/RnLane.h"
+#include "RoadNetwork/Structure/RnWay.h"
+#include "RoadNetwork/Structure/RnLineString.h"
+#include "RoadNetwork/Structure/RnPoint.h"
+
+//道路構造のテスト用共通処理
+namespace PLATEAURnTestUtil {
+
+    // Funcの実行時間をNum個のUnitを処理した時間としてテストのログに出す
+    inline void Measure(FAutomationTestBase& Test, const FString& Name, int32 Num, const TCHAR* Unit, TFunctionRef<void()> Func) {
+        const auto StartTime = FPlatformTime::Seconds();
+        Func();
+        Test.AddInfo(FString::Printf(TEXT("%s : %d %s, %.3f sec"), *Name, Num, Unit, FPlatformTime::Seconds() - StartTime));
+    }
+
+    // ABを結ぶWay. MiddleNumを指定すると途中に横にずらした点を挟んだ折れ線にする
+    inline URnWay* CreateWay(URnPoint* A, URnPoint* B, int32 MiddleNum = 0) {
+        TArray<URnPoint*> Points{ A };
+        for (auto i = 1; i <= MiddleNum; ++i) {
+            const auto T = static_cast<float>(i) / (MiddleNum + 1);
+            Points.Add(RnNew<URnPoint>(FMath::Lerp(A->Vertex, B->Vertex, T) + FVector(0.f, (i % 2) * 200.f, 0.f)));
+        }
+        Points.Add(B);
+        return URnWay::Create(URnLineString::Create(Points));
+    }
+
+    // X方向にStartXからEndXまでの片側LaneNum車線の道路. 右側の車線は逆向き. 車線間のWayと端点は車線同士で共有する
+    // MiddleNumは車線の左右のWayの途中の点の数, LaneWidthは車線の幅
+    inline URnRoad* CreateRoad(UPLATEAUCityObjectGroup* Group, float StartX, float EndX, int32 LaneNum = 1, int32 MiddleNum = 0, float LaneWidth = 300.f) {
+        TArray<URnPoint*> Starts;
+        TArray<URnPoint*> Ends;
+        TArray<URnWay*> SideWays;
+        for (auto i = 0; i <= LaneNum * 2; ++i) {
+            Starts.Add(RnNew<URnPoint>(FVector(StartX, i * LaneWidth, 0.f)));
+            Ends.Add(RnNew<URnPoint>(FVector(EndX, i * LaneWidth, 0.f)));
+            SideWays.Add(CreateWay(Starts[i], Ends[i], MiddleNum));
+        }
+        auto* Road = URnRoad::Create(Group);
+        for (auto i = 0; i < LaneNum * 2; ++i) {
+            auto* Lane = RnNew<URnLane>(SideWays[i], SideWays[i + 1], CreateWay(Starts[i], Starts[i + 1]), CreateWay(Ends[i], Ends[i + 1]));
+            Lane->SetIsReversed(i >= LaneNum);
+            Road->AddMainLane(Lane);
+        }
+        return Road;
+    }
+
+    // Prev - 交差点 - Next とつながる交差点を作る. 道路とつながっていない輪郭と, 直進のトラックを1つ持つ
+    inline URnIntersection* CreateIntersection(URnModel* Model, UPLATEAUCityObjectGroup* Group, URnRoad* Prev, URnRoad* Next) {
+        auto* Intersection = URnIntersection::Create(Group);
+        for (const auto& Lane : Prev->GetMainLanes())
+            Intersection->AddEdge(Prev, Lane->GetNextBorder());
+        Intersection->AddEdge(nullptr, CreateWay(Prev->GetMainLanes().Last()->GetRightWay()->GetPoint(-1), Next->GetMainLanes().Last()->GetRightWay()->GetPoint(0)));
+        for (const auto& Lane : Next->GetMainLanes())
+            Intersection->AddEdge(Next, Lane->GetPrevBorder());
+        Intersection->AddEdge(nullptr, CreateWay(Next->GetMainLanes()[0]->GetLeftWay()->GetPoint(0), Prev->GetMainLanes()[0]->GetLeftWay()->GetPoint(-1)));
+
+        auto* From = Prev->GetMainLanes()[0]->GetNextBorder();
+        auto* To = Next->GetMainLanes()[0]->GetPrevBorder();
+        auto* Track = RnNew<URnTrack>(From, To, nullptr, ERnTurnType::Straight);
+        Track->Curve.Points = { From->GetPoint(0)->Vertex, To->GetPoint(0)->Vertex };
+        Track->Curve.Tangents = { FVector(500.f, 0.f, 0.f), FVector(500.f, 0.f, 0.f) };
+        Intersection->TryAddOrUpdateTrack(Track);
+
+        Prev->SetNext(Intersection);
+        Next->SetPrev(Intersection);
+        Model->AddIntersection(Intersection);
+        return Intersection;
+    }
+
+    // X=Xの位置で, 車道側の点InsideYから外側の点OutsideYまでの歩道の端の線
+    inline URnWay* CreateSideWalkEdge(float X, float InsideY, float OutsideY) {
+        return CreateWay(RnNew<URnPoint>(FVector(X, InsideY, 0.f)), RnNew<URnPoint>(FVector(X, OutsideY, 0.f)));
+    }
+
+    // StartEdgeからEndEdgeまでの歩道. 端の線は隣の道路/交差点の歩道と共有するために外から渡す
+    inline URnSideWalk* CreateSideWalk(URnModel* Model, URnRoadBase* Parent, URnWay* StartEdge, URnWay* EndEdge) {
+        auto* SideWalk = URnSideWalk::Create(Parent,
+            CreateWay(StartEdge->GetPoint(1), EndEdge->GetPoint(1)),
+            CreateWay(StartEdge->GetPoint(0), EndEdge->GetPoint(0)),
+            StartEdge, EndEdge);
+        Model->AddSideWalk(SideWalk);
+        return SideWalk;
+    }
+
+    // CreateModelで付ける歩道
+    enum class ESideWalkType {
+        // 歩道なし
+        None,
+        // 道路の左側に1つ. 内側の線は車線と同じLineStringを共有する
+        Left,
+        // 道路の両側に1つずつ. 道路の歩道は両端からSideWalkAdvanceだけ短くし, 残りは交差点の歩道として端の線を共有する
+        BothWithEdge,
+    };
+
+    // CreateModelで作る道路の形
+    struct FModelParam {
+        // 道路の長さ
+        float RoadLength = 1000.f;
+        // 道路の始点の間隔. RoadLengthとの差が交差点の長さになる
+        float RoadPitch = 1500.f;
+        // 片側の車線数. 道路ごとに1からMaxLaneNumまでを繰り返す
+        int32 MaxLaneNum = 1;
+        // 車線の左右のWayの途中の点の数
+        int32 MiddleNum = 0;
+        // 車線の幅
+        float LaneWidth = 300.f;
+        ESideWalkType SideWalk = ESideWalkType::Left;
+        float SideWalkAdvance = 800.f;
+    };
+
+    // Count本の道路が交差点を挟んで一列に並んだモデル
+    inline URnModel* CreateModel(int32 Count, TArray<UPLATEAUCityObjectGroup*>& OutGroups, const FModelParam& Param = FModelParam()) {
+        auto* Model = URnModel::Create();
+        Model->SetFactoryVersion(TEXT("1.0"));
+        URnRoad* PrevRoad = nullptr;
+        // 前の道路の歩道の終端の線(左, 右)
+        TArray<URnWay*> PrevSideWalkEnds;
+        for (auto i = 0; i < Count; ++i) {
+            auto* Group = NewObject<UPLATEAUCityObjectGroup>(GetTransientPackage());
+            OutGroups.Add(Group);
+            const auto StartX = i * Param.RoadPitch;
+            const auto EndX = StartX + Param.RoadLength;
+            const auto LaneNum = 1 + i % Param.MaxLaneNum;
+            auto* Road = CreateRoad(Group, StartX, EndX, LaneNum, Param.MiddleNum, Param.LaneWidth);
+            Model->AddRoad(Road);
+
+            TArray<URnWay*> SideWalkStarts;
+            TArray<URnWay*> SideWalkEnds;
+            if (Param.SideWalk == ESideWalkType::Left) {
+                const auto* LeftWay = Road->GetMainLanes()[0]->GetLeftWay();
+                auto* Outside = CreateWay(RnNew<URnPoint>(FVector(StartX, -200.f, 0.f)), RnNew<URnPoint>(FVector(EndX, -200.f, 0.f)));
+                auto* Inside = URnWay::Create(LeftWay->LineString);
+                Model->AddSideWalk(URnSideWalk::Create(Road, Outside, Inside, nullptr, nullptr, EPLATEAURnSideWalkLaneType::LeftLane));
+            }
+            else if (Param.SideWalk == ESideWalkType::BothWithEdge) {
+                const auto Width = LaneNum * 2 * Param.LaneWidth;
+                for (const auto& Y : { TPair<float, float>(0.f, -300.f), TPair<float, float>(Width, Width + 300.f) }) {
+                    SideWalkStarts.Add(CreateSideWalkEdge(StartX + Param.SideWalkAdvance, Y.Key, Y.Value));
+                    SideWalkEnds.Add(CreateSideWalkEdge(EndX - Param.SideWalkAdvance, Y.Key, Y.Value));
+                    CreateSideWalk(Model, Road, SideWalkStarts.Last(), SideWalkEnds.Last());
+                }
+            }
+
+            if (PrevRoad != nullptr) {
+                auto* IntersectionGroup = NewObject<UPLATEAUCityObjectGroup>(GetTransientPackage());
+                OutGroups.Add(IntersectionGroup);
+                auto* Intersection = CreateIntersection(Model, IntersectionGroup, PrevRoad, Road);
+                for (auto j = 0; j < SideWalkStarts.Num(); ++j)
+                    CreateSideWalk(Model, Intersection, PrevSideWalkEnds[j], SideWalkStarts[j]);
+            }
+            PrevRoad = Road;
+            PrevSideWalkEnds = SideWalkEnds;
+        }
+        return Model;
+    }
+
+    /**
+     * @brief 元のモデルと複製/読み込みしたモデルを並行にたどり, 全てのオブジェクトが1対1に対応していること,
+     *        値と参照の共有関係が同じであることを確認します
+     */
+    class FRnModelChecker {
+    public:
+        explicit FRnModelChecker(FAutomationTestBase& InTest)
+            : Test(InTest) {
+        }
+
+        void CheckModel(const URnModel* A, const URnModel* B) {
+            Map(A, B);
+            Test.TestEqual("FactoryVersion", B->GetFactoryVersion(), A->GetFactoryVersion());
+            CheckArray(A->GetRoads(), B->GetRoads(), [this](const URnRoad* X, const URnRoad* Y) { CheckRoadBase(X, Y); });
+            CheckArray(A->GetIntersections(), B->GetIntersections(), [this](const URnIntersection* X, const URnIntersection* Y) { CheckRoadBase(X, Y); });
+            CheckArray(A->GetSideWalks(), B->GetSideWalks(), [this](const URnSideWalk* X, const URnSideWalk* Y) { CheckSideWalk(X, Y); });
+        }
+
+        // 対応付けたオブジェクトの数(URnModel自身を含む)
+        int32 Num() const { return Forward.Num(); }
+
+    private:
+        // AとBを対応付ける. 初めて対応付けた場合は中身を比較するためにtrueを返す
+        bool Map(const UObject* A, const UObject* B) {
+            if (A == nullptr || B == nullptr) {
+                Test.TestTrue("Both null", A == nullptr && B == nullptr);
+                return false;
+            }
+            Test.TestTrue("Not shared with original", A != B);
+            if (const auto* Found = Forward.Find(A)) {
+                Test.TestTrue("Same sharing", *Found == B);
+                return false;
+            }
+            Test.TestFalse("Unique object", Backward.Contains(B));
+            Test.TestTrue("Same class", A->GetClass() == B->GetClass());
+            Forward.Add(A, B);
+            Backward.Add(B);
+            return true;
+        }
+
+        template<class T, class TFunc>
+        void CheckArray(const TArray<T*>& A, const TArray<T*>& B, TFunc Func) {
+            if (!Test.TestEqual("Array num", B.Num(), A.Num()))
+                return;
+            for (auto i = 0; i < A.Num(); ++i)
+                Func(A[i], B[i]);
+        }
+
+        void CheckPoint(const URnPoint* A, const URnPoint* B) {
+            if (Map(A, B))
+                Test.TestTrue("Vertex", A->Vertex == B->Vertex);
+        }
+
+        void CheckWay(const URnWay* A, const URnWay* B) {
+            if (!Map(A, B))
+                return;
+            Test.TestTrue("IsReversed", A->IsReversed == B->IsReversed);
+            Test.TestTrue("IsReverseNormal", A->IsReverseNormal == B->IsReverseNormal);
+            if (Map(A->LineString, B->LineString))
+                CheckArray(A->LineString->GetPoints(), B->LineString->GetPoints(), [this](const URnPoint* X, const URnPoint* Y) { CheckPoint(X, Y); });
+        }
+
+        void CheckLane(const URnLane* A, const URnLane* B) {
+            if (!Map(A, B))
+                return;
+            Test.TestTrue("Lane IsReversed", A->GetIsReversed() == B->GetIsReversed());
+            CheckRoadBase(A->GetParent(), B->GetParent());
+            CheckWay(A->GetLeftWay(), B->GetLeftWay());
+            CheckWay(A->GetRightWay(), B->GetRightWay());
+            CheckWay(A->GetPrevBorder(), B->GetPrevBorder());
+            CheckWay(A->GetNextBorder(), B->GetNextBorder());
+        }
+
+        void CheckSideWalk(const URnSideWalk* A, const URnSideWalk* B) {
+            if (!Map(A, B))
+                return;
+            Test.TestTrue("LaneType", A->GetLaneType() == B->GetLaneType());
+            CheckRoadBase(A->GetParentRoad(), B->GetParentRoad());
+            CheckWay(A->GetOutsideWay(), B->GetOutsideWay());
+            CheckWay(A->GetInsideWay(), B->GetInsideWay());
+            CheckWay(A->GetStartEdgeWay(), B->GetStartEdgeWay());
+            CheckWay(A->GetEndEdgeWay(), B->GetEndEdgeWay());
+        }
+
+        void CheckRoadBase(const URnRoadBase* A, const URnRoadBase* B) {
+            if (!Map(A, B))
+                return;
+            Test.TestTrue("TargetTrans", A->GetTargetTrans() == B->GetTargetTrans());
+            CheckArray(A->GetSideWalks(), B->GetSideWalks(), [this](const URnSideWalk* X, const URnSideWalk* Y) { CheckSideWalk(X, Y); });
+
+            if (const auto* RoadA = Cast<URnRoad>(A)) {
+                const auto* RoadB = Cast<URnRoad>(B);
+                CheckRoadBase(RoadA->GetPrev(), RoadB->GetPrev());
+                CheckRoadBase(RoadA->GetNext(), RoadB->GetNext());
+                CheckArray(RoadA->GetMainLanes(), RoadB->GetMainLanes(), [this](const URnLane* X, const URnLane* Y) { CheckLane(X, Y); });
+                CheckLane(RoadA->GetMedianLane(), RoadB->GetMedianLane());
+            }
+            else if (const auto* IntersectionA = Cast<URnIntersection>(A)) {
+                const auto* IntersectionB = Cast<URnIntersection>(B);
+                CheckArray(IntersectionA->GetEdges(), IntersectionB->GetEdges(), [this](const URnIntersectionEdge* X, const URnIntersectionEdge* Y) {
+                    if (!Map(X, Y))
+                        return;
+                    CheckRoadBase(X->GetRoad(), Y->GetRoad());
+                    CheckWay(X->GetBorder(), Y->GetBorder());
+                });
+                CheckArray(IntersectionA->GetTracks(), IntersectionB->GetTracks(), [this](const URnTrack* X, const URnTrack* Y) {
+                    if (!Map(X, Y))
+                        return;
+                    Test.TestTrue("TurnType", X->TurnType == Y->TurnType);
+                    Test.TestTrue("Curve", X->Curve.Points == Y->Curve.Points && X->Curve.Tangents == Y->Curve.Tangents);
+                    CheckWay(X->FromBorder, Y->FromBorder);
+                    CheckWay(X->ToBorder, Y->ToBorder);
+                });
+            }
+        }
+
+        FAutomationTestBase& Test;
+        TMap<const UObject*, const UObject*> Forward;
+        TSet<const UObject*> Backward;
+    };
+}
@@ -0,0 +1,182 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "Components/SplineComponent.h"
+#include "RoadNetwork/Structure/RnModel.h"
+#include "RoadNetwork/Structure/RnRoad.h"
+#include "RoadNetwork/Structure/RnIntersection.h"
+#include "RoadNetwork/Structure/RnLane.h"
+#include "RoadNetwork/Structure/RnWay.h"
+#include "RoadNetwork/Structure/RnLineString.h"
+#include "RoadNetwork/Structure/RnPoint.h"
+#include "RoadNetwork/Structure/RnTrackBuilder.h"
+
+namespace {
+    URnWay* CreateWay(URnPoint* A, URnPoint* B) {
+        return URnWay::Create(URnLineString::Create(TArray<URnPoint*>{ A, B }));
+    }
+
+    // X方向にStartXからEndXまでの対向2車線の道路
+    URnRoad* CreateRoad(float StartX, float EndX) {
+        TArray<URnPoint*> Starts;
+        TArray<URnPoint*> Ends;
+        TArray<URnWay*> SideWays;
+        for (auto i = 0; i < 3; ++i) {
+            Starts.Add(RnNew<URnPoint>(FVector(StartX, i * 300.f, 0.f)));
+            Ends.Add(RnNew<URnPoint>(FVector(EndX, i * 300.f, 0.f)));
+            SideWays.Add(CreateWay(Starts[i], Ends[i]));
+        }
+        auto* Road = URnRoad::Create();
+        for (auto i = 0; i < 2; ++i) {
+            auto* Lane = RnNew<URnLane>(SideWays[i], SideWays[i + 1], CreateWay(Starts[i], Starts[i + 1]), CreateWay(Ends[i], Ends[i + 1]));
+            Lane->SetIsReversed(i == 1);
+            Road->AddMainLane(Lane);
+        }
+        return Road;
+    }
+
+    // Prev - 交差点 - Next とつながる交差点を作る
+    void CreateIntersection(URnModel* Model, URnRoad* Prev, URnRoad* Next) {
+        auto* Intersection = URnIntersection::Create();
+        for (const auto& Lane : Prev->GetMainLanes())
+            Intersection->AddEdge(Prev, Lane->GetNextBorder());
+        Intersection->AddEdge(nullptr, CreateWay(Prev->GetMainLanes().Last()->GetRightWay()->GetPoint(1), Next->GetMainLanes().Last()->GetRightWay()->GetPoint(0)));
+        for (const auto& Lane : Next->GetMainLanes())
+            Intersection->AddEdge(Next, Lane->GetPrevBorder());
+        Intersection->AddEdge(nullptr, CreateWay(Next->GetMainLanes()[0]->GetLeftWay()->GetPoint(0), Prev->GetMainLanes()[0]->GetLeftWay()->GetPoint(1)));
+
+        Prev->SetNext(Intersection);
+        Next->SetPrev(Intersection);
+        Model->AddIntersection(Intersection);
+    }
+
+    // Count本の道路が長さ2000の交差点を挟んで一列に並んだモデル
+    URnModel* CreateModel(int32 Count) {
+        auto* Model = URnModel::Create();
+        URnRoad* PrevRoad = nullptr;
+        for (auto i = 0; i < Count; ++i) {
+            const auto StartX = i * 12000.f;
+            auto* Road = CreateRoad(StartX, StartX + 10000.f);
+            Model->AddRoad(Road);
+            if (PrevRoad != nullptr)
+                CreateIntersection(Model, PrevRoad, Road);
+            PrevRoad = Road;
+        }
+        return Model;
+    }
+
+    TArray<FString> ToStrings(const URnModel* Model) {
+        TArray<FString> Result;
+        for (const auto& Intersection : Model->GetIntersections()) {
+            for (const auto& Track : Intersection->GetTracks()) {
+                auto Str = FString::Printf(TEXT("%d"), static_cast<int32>(Track->TurnType));
+                for (const auto& Point : Track->Curve.Points)
+                    Str += FString::Printf(TEXT(" (%.2f,%.2f,%.2f)"), Point.X, Point.Y, Point.Z);
+                for (const auto& Tangent : Track->Curve.Tangents)
+                    Str += FString::Printf(TEXT(" (%.2f,%.2f,%.2f)"), Tangent.X, Tangent.Y, Tangent.Z);
+                Result.Add(Str);
+            }
+        }
+        return Result;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnTrackBuilder_Curve, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RnTrackBuilder.Curve", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RnTrackBuilder_Curve::RunTest(const FString& Parameters) {
+    auto* Model = CreateModel(3);
+    for (const auto& Intersection : Model->GetIntersections()) {
+        Intersection->BuildTracks();
+
+        // 対向2車線の直線道路なので, 各方向に直進のトラックが1つずつ
+        TestEqual("Track num", Intersection->GetTracks().Num(), 2);
+        for (const auto& Track : Intersection->GetTracks()) {
+            TestTrue("Turn type", Track->TurnType == ERnTurnType::Straight);
+            TestNull("No spline component", Track->Spline);
+            TestTrue("Valid curve", Track->Curve.IsValid());
+            if (!Track->Curve.IsValid())
+                continue;
+
+            // 境界線の中点同士を結ぶ. 境界線に垂直に出入りするので直線になる
+            const auto Start = Track->FromBorder->GetLerpPoint(0.5f);
+            const auto End = Track->ToBorder->GetLerpPoint(0.5f);
+            TestEqual("Start", Track->Curve.GetLocationAtDistance(0.f), Start, 0.1f);
+            TestEqual("End", Track->Curve.GetLocationAtDistance(Track->Curve.GetLength()), End, 0.1f);
+            TestEqual("Length", Track->Curve.GetLength(), static_cast<float>(FVector::Dist(Start, End)), 1.f);
+            TestEqual("Middle", Track->Curve.GetLocationAtDistance(Track->Curve.GetLength() * 0.5f), (Start + End) * 0.5, 1.f);
+
+            // 必要な時だけUSplineComponentを作り, 同じ経路になる
+            auto* Spline = Track->GetOrCreateSpline();
+            TestNotNull("Spline component", Spline);
+            if (Spline == nullptr)
+                continue;
+            TestTrue("Cached spline", Track->GetOrCreateSpline() == Spline);
+            TestEqual("Spline length", Spline->GetSplineLength(), Track->Curve.GetLength(), 0.1f);
+            for (float Dist = 0.f; Dist < Track->Curve.GetLength(); Dist += 250.f)
+                TestEqual("Spline location", Spline->GetLocationAtDistanceAlongSpline(Dist, ESplineCoordinateSpace::World), Track->Curve.GetLocationAtDistance(Dist), 0.1f);
+        }
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnTrackBuilder_Parallel, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RnTrackBuilder.Parallel", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RnTrackBuilder_Parallel::RunTest(const FString& Parameters) {
+    // 交差点ごとに生成した場合と, まとめて並列に生成した場合で同じトラックになる
+    auto* Serial = CreateModel(20);
+    for (const auto& Intersection : Serial->GetIntersections())
+        Intersection->BuildTracks();
+
+    auto* Parallel = CreateModel(20);
+    FRnTracksBuilder Builder;
+    Builder.BuildTracks(Parallel->GetIntersections(), FBuildTrackOption::Default());
+
+    const auto Expected = ToStrings(Serial);
+    TestEqual("Track num", Expected.Num(), Serial->GetIntersections().Num() * 2);
+    TestTrue("Same as serial", ToStrings(Parallel) == Expected);
+
+    // 再生成してもトラックは増えない
+    Builder.BuildTracks(Parallel->GetIntersections(), FBuildTrackOption::Default());
+    TestTrue("Rebuild", ToStrings(Parallel) == Expected);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnTrackBuilder_WithBorder, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RnTrackBuilder.WithBorder", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RnTrackBuilder_WithBorder::RunTest(const FString& Parameters) {
+    auto* Model = CreateModel(2);
+    auto* Intersection = Model->GetIntersections()[0];
+    auto* Border = Model->GetRoads()[0]->GetMainLanes()[0]->GetNextBorder();
+
+    // 指定した境界線に接するトラックだけを生成する
+    Intersection->ClearTracks();
+    Intersection->BuildTracks(FBuildTrackOption::WithBorder({ Border->GetLineString() }));
+    if (!TestEqual("Track num", Intersection->GetTracks().Num(), 1))
+        return false;
+    const auto* Track = Intersection->GetTracks()[0];
+    TestTrue("Track touches border", Track->FromBorder->IsSameLineReference(Border) || Track->ToBorder->IsSameLineReference(Border));
+
+    // 既存のトラックは残したまま, 指定が無い場合は全て生成する
+    Intersection->BuildTracks(FBuildTrackOption::UnBuiltTracks());
+    TestEqual("All tracks", Intersection->GetTracks().Num(), 2);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnTrackBuilder_Benchmark, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RnTrackBuilder.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FPLATEAUTest_RnTrackBuilder_Benchmark::RunTest(const FString& Parameters) {
+    auto* Model = CreateModel(5000);
+
+    auto StartTime = FPlatformTime::Seconds();
+    for (const auto& Intersection : Model->GetIntersections())
+        Intersection->BuildTracks();
+    const auto SerialTime = FPlatformTime::Seconds() - StartTime;
+
+    StartTime = FPlatformTime::Seconds();
+    FRnTracksBuilder Builder;
+    Builder.BuildTracks(Model->GetIntersections(), FBuildTrackOption::Default());
+    const auto ParallelTime = FPlatformTime::Seconds() - StartTime;
+
+    AddInfo(FString::Printf(TEXT("Intersections=%d Serial=%.3f sec Parallel=%.3f sec"), Model->GetIntersections().Num(), SerialTime, ParallelTime));
+    return true;
+}
@@ -0,0 +1,124 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "RoadAdjust/RoadMarking/PLATEAURoadMarkingCache.h"
+#include "RoadNetwork/Structure/RnModel.h"
+#include "RoadNetwork/Structure/RnRoad.h"
+#include "RoadNetwork/Structure/RnLane.h"
+#include "RoadNetwork/Structure/RnWay.h"
+#include "RoadNetwork/Structure/RnLineString.h"
+#include "RoadNetwork/Structure/RnPoint.h"
+
+namespace {
+    URnWay* CreateWay(const FVector& A, const FVector& B) {
+        return URnWay::Create(URnLineString::Create(TArray<URnPoint*>{ RnNew<URnPoint>(A), RnNew<URnPoint>(B) }));
+    }
+
+    // X方向にStartXからEndXまで, Y=Index*300からY=(Index+1)*300までの車線を作る
+    URnLane* CreateLane(float StartX, float EndX, int32 Index, bool bIsReversed) {
+        const auto Y0 = Index * 300.f;
+        const auto Y1 = (Index + 1) * 300.f;
+        auto* Lane = RnNew<URnLane>(
+            CreateWay(FVector(StartX, Y0, 0.f), FVector(EndX, Y0, 0.f)),
+            CreateWay(FVector(StartX, Y1, 0.f), FVector(EndX, Y1, 0.f)),
+            CreateWay(FVector(StartX, Y0, 0.f), FVector(StartX, Y1, 0.f)),
+            CreateWay(FVector(EndX, Y0, 0.f), FVector(EndX, Y1, 0.f)));
+        Lane->SetIsReversed(bIsReversed);
+        return Lane;
+    }
+
+    // 対向2車線の道路
+    URnRoad* CreateRoad(float StartX, float EndX) {
+        auto* Road = URnRoad::Create();
+        Road->AddMainLane(CreateLane(StartX, EndX, 0, false));
+        Road->AddMainLane(CreateLane(StartX, EndX, 1, true));
+        return Road;
+    }
+
+    // 線の集合として比較するために文字列にしてソートする
+    TArray<FString> ToSortedStrings(const TArray<FPLATEAUMarkedWay>& MarkedWays) {
+        TArray<FString> Result;
+        for (const auto& MarkedWay : MarkedWays) {
+            auto Str = FString::Printf(TEXT("%d %d"), static_cast<int32>(MarkedWay.GetMarkedWayType()), MarkedWay.IsReversed() ? 1 : 0);
+            for (const auto& Point : MarkedWay.GetLine().GetPoints())
+                Str += FString::Printf(TEXT(" (%.1f,%.1f,%.1f)"), Point.X, Point.Y, Point.Z);
+            Result.Add(Str);
+        }
+        Result.Sort();
+        return Result;
+    }
+
+    bool IsUpdated(const FPLATEAURoadMarkingCache::FUpdateResult& Result, const URnRoadBase* RoadBase) {
+        return Result.UpdatedRoadBases.Contains(TObjectKey<URnRoadBase>(RoadBase));
+    }
+
+    TArray<URnRoadBase*> AllRoadBases(const URnModel* Model) {
+        TArray<URnRoadBase*> Result;
+        Result.Append(Model->GetRoads());
+        Result.Append(Model->GetIntersections());
+        return Result;
+    }
+
+    // 全体を作り直した場合と同じ線になるか確認する
+    void TestSameAsFull(FAutomationTestBase& Test, const FString& Context, URnModel* Model, const FPLATEAURoadMarkingCache& Cache, EPLATEAUCrosswalkFrequency Frequency) {
+        FPLATEAURoadMarkingCache FullCache;
+        FullCache.Update(Model, AllRoadBases(Model), Frequency);
+        const auto Expected = ToSortedStrings(FullCache.GetMarkedWays(Model));
+        const auto Actual = ToSortedStrings(Cache.GetMarkedWays(Model));
+        Test.TestTrue(Context + TEXT(" has marked ways"), Expected.Num() > 0);
+        Test.TestTrue(Context + TEXT(" same marked ways"), Actual == Expected);
+        Test.TestEqual(Context + TEXT(" no changes"), Cache.FindChangedRoadBases(Model, Frequency).Num(), 0);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RoadMarkingCache_Incremental, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RoadMarkingCache.Incremental", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RoadMarkingCache_Incremental::RunTest(const FString& Parameters) {
+    // R0 - R1 - R2 と連なる道路と, 離れた道路R3
+    const auto Frequency = EPLATEAUCrosswalkFrequency::All;
+    auto* Model = URnModel::Create();
+    auto* R0 = CreateRoad(0.f, 1000.f);
+    auto* R1 = CreateRoad(1000.f, 2000.f);
+    auto* R2 = CreateRoad(2000.f, 3000.f);
+    auto* R3 = CreateRoad(10000.f, 11000.f);
+    R0->SetPrevNext(nullptr, R1);
+    R1->SetPrevNext(R0, R2);
+    R2->SetPrevNext(R1, nullptr);
+    for (auto* Road : { R0, R1, R2, R3 })
+        Model->AddRoad(Road);
+
+    FPLATEAURoadMarkingCache Cache;
+    TestEqual("Initial changes", Cache.FindChangedRoadBases(Model, Frequency).Num(), 4);
+    Cache.Update(Model, Cache.FindChangedRoadBases(Model, Frequency), Frequency);
+    TestSameAsFull(*this, TEXT("Initial"), Model, Cache, Frequency);
+
+    // 車線数を変えた道路と, 同じ連なりの道路だけが作り直されること
+    R1->AddMainLane(CreateLane(1000.f, 2000.f, 2, true));
+    const auto Changed = Cache.FindChangedRoadBases(Model, Frequency);
+    TestTrue("Lane count changed", Changed.Num() == 1 && Changed[0] == R1);
+    const auto Result = Cache.Update(Model, Changed, Frequency);
+    TestTrue("Updated R0", IsUpdated(Result, R0));
+    TestTrue("Updated R1", IsUpdated(Result, R1));
+    TestTrue("Updated R2", IsUpdated(Result, R2));
+    TestFalse("Not updated R3", IsUpdated(Result, R3));
+    TestSameAsFull(*this, TEXT("AddLane"), Model, Cache, Frequency);
+
+    // 頂点を動かした場合
+    R3->GetMainLanes()[0]->GetLeftWay()->GetPoint(1)->Vertex += FVector(0.f, 50.f, 0.f);
+    const auto MoveResult = Cache.Update(Model, Cache.FindChangedRoadBases(Model, Frequency), Frequency);
+    TestTrue("Moved R3", MoveResult.UpdatedRoadBases.Num() == 1 && IsUpdated(MoveResult, R3));
+    TestSameAsFull(*this, TEXT("MovePoint"), Model, Cache, Frequency);
+
+    // 道路を削除した場合
+    Model->RemoveRoad(R2);
+    R1->SetNext(nullptr);
+    const auto RemoveResult = Cache.Update(Model, Cache.FindChangedRoadBases(Model, Frequency), Frequency);
+    TestTrue("Removed R2", IsUpdated(RemoveResult, R2));
+    TestTrue("Removed R2 old marked ways", RemoveResult.OldMarkedWays.Num() > 0);
+    TestNull("Removed R2 entry", Cache.Find(R2));
+    TestSameAsFull(*this, TEXT("RemoveRoad"), Model, Cache, Frequency);
+
+    // 横断歩道の頻度が変わった場合は全て作り直す
+    TestEqual("Frequency changed", Cache.FindChangedRoadBases(Model, EPLATEAUCrosswalkFrequency::None).Num(), 3);
+    return true;
+}
@@ -0,0 +1,101 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "Engine/StaticMesh.h"
+#include "RoadAdjust/PLATEAURoadLineType.h"
+#include "RoadAdjust/RoadMarking/LineGeneratorComponent.h"
+#include "RoadAdjust/RoadMarking/PLATEAURoadMarkingMeshBuilder.h"
+
+namespace {
+    // ULineGeneratorComponent::CreateSplineMeshSegmentBasedと同じ区切り方で, スプライン上の破線の始点/終点を求める
+    TArray<FPLATEAURoadMarkingMeshBuilder::FDash> SplineDashes(const TArray<FVector>& Points, float MeshLength, float Gap, bool bFillEnd) {
+        auto* Spline = NewObject<ULineGeneratorComponent>(GetTransientPackage());
+        Spline->CreateSplineFromVectorArray(Points);
+
+        TArray<FPLATEAURoadMarkingMeshBuilder::FDash> Dashes;
+        const auto SplineLength = Spline->GetSplineLength();
+        const auto Length = MeshLength + Gap;
+        const auto NumLoop = static_cast<int32>(SplineLength / Length);
+        for (auto Index = 0; Index < NumLoop; ++Index) {
+            const auto StartDistance = Length * Index;
+            auto EndDistance = Length * (Index + 1) - Gap;
+            if (Index == NumLoop - 1 && bFillEnd)
+                EndDistance = SplineLength - 0.01f;
+            Dashes.Add({
+                Spline->GetLocationAtDistanceAlongSpline(StartDistance, ESplineCoordinateSpace::Local),
+                Spline->GetLocationAtDistanceAlongSpline(EndDistance, ESplineCoordinateSpace::Local) });
+        }
+        return Dashes;
+    }
+
+    TArray<FVector> CreatePolyline(FRandomStream& Random, int32 Num) {
+        TArray<FVector> Points;
+        FVector Point = FVector::ZeroVector;
+        for (auto i = 0; i < Num; ++i) {
+            Points.Add(Point);
+            Point += FVector(Random.FRandRange(100.f, 3000.f), Random.FRandRange(-1000.f, 1000.f), Random.FRandRange(-50.f, 50.f));
+        }
+        return Points;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RoadMarkingMeshBuilder_Dashes, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RoadMarkingMeshBuilder.Dashes", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RoadMarkingMeshBuilder_Dashes::RunTest(const FString& Parameters) {
+    // 線形スプラインのUSplineMeshComponentと同じ位置に破線が並ぶこと
+    FRandomStream Random(20240410);
+    for (auto Case = 0; Case < 20; ++Case) {
+        const auto Points = CreatePolyline(Random, Random.RandRange(2, 8));
+        const auto MeshLength = Random.FRandRange(50.f, 300.f);
+        const auto Gap = Random.FRandRange(50.f, 300.f);
+        const auto bFillEnd = Random.RandHelper(2) == 0;
+
+        const auto Context = FString::Printf(TEXT("Case %d"), Case);
+        const auto Actual = FPLATEAURoadMarkingMeshBuilder::ComputeDashes(Points, MeshLength, Gap, bFillEnd);
+        const auto Expected = SplineDashes(Points, MeshLength, Gap, bFillEnd);
+        if (!TestEqual(Context + TEXT(" dash count"), Actual.Num(), Expected.Num()))
+            continue;
+        for (auto i = 0; i < Actual.Num(); ++i) {
+            TestTrue(Context + TEXT(" start"), Actual[i].Start.Equals(Expected[i].Start, 1.f));
+            TestTrue(Context + TEXT(" end"), Actual[i].End.Equals(Expected[i].End, 1.f));
+        }
+    }
+
+    // 隙間が無い場合は頂点間ごとに1つ
+    const TArray<FVector> Points = { FVector(0.f, 0.f, 0.f), FVector(100.f, 0.f, 0.f), FVector(100.f, 0.f, 0.f), FVector(100.f, 200.f, 0.f) };
+    const auto Segments = FPLATEAURoadMarkingMeshBuilder::ComputeDashes(Points, 100.f, 0.f, false);
+    TestEqual("Length based dash count", Segments.Num(), 3);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RoadMarkingMeshBuilder_Build, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RoadMarkingMeshBuilder.Build", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RoadMarkingMeshBuilder_Build::RunTest(const FString& Parameters) {
+    const auto Mesh = Cast<UStaticMesh>(StaticLoadObject(UStaticMesh::StaticClass(), nullptr, TEXT("/Engine/BasicShapes/Cube.Cube")));
+    if (!TestNotNull("Mesh", Mesh))
+        return true;
+
+    TMap<EPLATEAURoadLineType, FPLATEAURoadLineParam> LineTypeMap;
+    LineTypeMap.Add(EPLATEAURoadLineType::WhiteLine, PLATEAURoadLineTypeExtension::ToRoadLineParam(EPLATEAURoadLineType::WhiteLine, Mesh, Mesh));
+    LineTypeMap.Add(EPLATEAURoadLineType::DashedWhilteLine, PLATEAURoadLineTypeExtension::ToRoadLineParam(EPLATEAURoadLineType::DashedWhilteLine, Mesh, Mesh));
+
+    // 種類とチャンクごとにまとまり, 破線1つにつき2ポリゴンになること
+    FPLATEAURoadMarkingMeshBuilder Builder(LineTypeMap, 1000.f);
+    const TArray<FVector> Line = { FVector(0.f, 0.f, 0.f), FVector(1900.f, 0.f, 0.f) };
+    Builder.AddLine(EPLATEAURoadLineType::WhiteLine, Line);
+    Builder.AddLine(EPLATEAURoadLineType::DashedWhilteLine, Line);
+    Builder.AddLine(EPLATEAURoadLineType::None, Line);
+    const auto ChunkMeshes = Builder.Build();
+
+    TSet<TTuple<EPLATEAURoadLineType, FIntPoint>> Keys;
+    for (const auto& ChunkMesh : ChunkMeshes) {
+        TestFalse("Unique chunk", Keys.Contains(MakeTuple(ChunkMesh.Type, ChunkMesh.Chunk)));
+        Keys.Add(MakeTuple(ChunkMesh.Type, ChunkMesh.Chunk));
+        TestTrue("Known type", LineTypeMap.Contains(ChunkMesh.Type));
+        TestEqual("Polygon group", ChunkMesh.MeshDescription.PolygonGroups().Num(), 1);
+        TestEqual("Triangles", ChunkMesh.MeshDescription.Triangles().Num(), ChunkMesh.DashNum * 2);
+    }
+    TestTrue("WhiteLine chunk 0", Keys.Contains(MakeTuple(EPLATEAURoadLineType::WhiteLine, FIntPoint(0, 0))));
+    TestTrue("DashedWhiteLine chunk 1", Keys.Contains(MakeTuple(EPLATEAURoadLineType::DashedWhilteLine, FIntPoint(1, 0))));
+    return true;
+}
@@ -0,0 +1,97 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "Component/PLATEAUCityObjectGroup.h"
+#include "RoadNetwork/Factory/RoadNetworkFactory.h"
+#include "RoadNetwork/Structure/PLATEAURnStructureModel.h"
+#include "RoadNetwork/Structure/RnModel.h"
+#include "RoadNetwork/Structure/RnModelSerializer.h"
+
+namespace {
+    // 道路1つだけのCityObjectGroupを持つ都市モデル
+    APLATEAUInstancedCityModel* CreateRoadCityModel(UWorld& World) {
+        auto* Actor = PLATEAUAutomationTestUtil::Fixtures::CreateActor(World);
+        auto* Road = Actor->FindComponentByTag<UPLATEAUCityObjectGroup>(PLATEAUAutomationTestUtil::Fixtures::TEST_OBJ_TAG);
+
+        FPLATEAUCityObject CityObject;
+        CityObject.SetGmlID(TEXT("tran_00000000-0000-0000-0000-000000000000"));
+        CityObject.SetCityObjectsType(TEXT("Road"));
+        CityObject.SetCityObjectIndex(plateau::polygonMesh::CityObjectIndex(0, -1));
+        Road->SerializeCityObject(CityObject);
+        Road->SetStaticMesh(PLATEAUAutomationTestUtil::Fixtures::CreateStaticMesh(Actor, FName(TEXT("RoadMesh"))));
+        return Actor;
+    }
+
+    // 比較用にRnModelを圧縮せずにバイナリにする
+    TArray<uint8> WriteModel(const URnModel* Model) {
+        TArray<uint8> Data;
+        TArray<TSoftObjectPtr<UPLATEAUCityObjectGroup>> TargetTrans;
+        FRnModelSerializer().Write(Model, Data, TargetTrans, false);
+        return Data;
+    }
+}
+
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RoadNetworkFactory_CreateRnModelAsync, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RoadNetworkFactory.CreateRnModelAsync", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RoadNetworkFactory_CreateRnModelAsync::RunTest(const FString& Parameters) {
+    InitializeTest("RoadNetworkFactory.CreateRnModelAsync");
+    if (!OpenNewMap()) {
+        AddError("Failed to OpenNewMap");
+        return false;
+    }
+    auto* World = GetWorld();
+    if (World == nullptr)
+        return false;
+
+    auto* CityModel = CreateRoadCityModel(*World);
+    FRoadNetworkFactory Factory;
+
+    // 同期版の結果を正解とする
+    auto* SyncActor = World->SpawnActor<APLATEAURnStructureModel>();
+    FRoadNetworkFactoryEx::CreateRnModel(Factory, CityModel, SyncActor);
+    if (!TestNotNull("Sync model", SyncActor->Model))
+        return false;
+    const auto Expected = WriteModel(SyncActor->Model);
+
+    // 完了まで実行する. 返り値のタスクはゲームスレッドで完了するのでWaitせずにLatentCommandで待つ
+    auto* AsyncActor = World->SpawnActor<APLATEAURnStructureModel>();
+    auto Progress = MakeShared<float>(0.f);
+    const auto Task = FRoadNetworkFactoryEx::CreateRnModelAsync(Factory, CityModel, AsyncActor, MakeShared<TAtomic<bool>>(false)
+        , [Progress](float Value, const FText&) {
+            check(IsInGameThread());
+            *Progress = Value;
+        });
+
+    // 開始直後に中断する
+    auto* CanceledActor = World->SpawnActor<APLATEAURnStructureModel>();
+    const auto bCanceled = MakeShared<TAtomic<bool>>(false);
+    const auto CanceledTask = FRoadNetworkFactoryEx::CreateRnModelAsync(Factory, CityModel, CanceledActor, bCanceled, nullptr);
+    bCanceled->Store(true);
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Task, CanceledTask, Progress, AsyncActor, CanceledActor, Expected] {
+        // 完了通知は完了後にゲームスレッドで呼ばれる
+        if (!Task.IsCompleted() || !CanceledTask.IsCompleted() || *Progress < 1.f)
+            return false;
+
+        auto* Model = Task.GetResult();
+        if (TestNotNull("Async model", Model)) {
+            TestTrue("Replaced", AsyncActor->Model == Model);
+            TestTrue("Outer", Model->GetOuter() == AsyncActor);
+            TestTrue("Same as sync", WriteModel(Model) == Expected);
+            // 作成したオブジェクトはGCの対象に戻っている
+            bool bAsyncFlagCleared = true;
+            FRnModelSerializer().ForEachObject(Model, [&](UObject* Object) {
+                bAsyncFlagCleared &= !Object->HasAnyInternalFlags(EInternalObjectFlags::Async);
+            });
+            TestTrue("Async flag cleared", bAsyncFlagCleared);
+        }
+
+        TestNull("Canceled result", CanceledTask.GetResult());
+        TestNull("Canceled model", CanceledActor->Model);
+        TestNull("Canceled component", CanceledActor->GetComponentByClass<URnModel>());
+
+        FinishTest(!HasAnyErrors(), "");
+        return true;
+    }));
+    return true;
+}
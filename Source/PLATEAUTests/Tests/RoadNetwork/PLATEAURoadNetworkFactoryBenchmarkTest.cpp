@@ -0,0 +1,142 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "Component/PLATEAUCityObjectGroup.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "RoadNetwork/CityObject/SubDividedCityObjectFixture.h"
+#include "RoadNetwork/Factory/RoadNetworkFactory.h"
+#include "RoadNetwork/Structure/RnModel.h"
+#include "RoadNetwork/Util/PLATEAURnStageProfiler.h"
+
+namespace {
+    // (X0, Y0)-(X1, Y1)の長方形1枚の最小地物
+    FSubDividedCityObject CreateRect(UObject* Outer, const FString& Name, float X0, float Y0, float X1, float Y1) {
+        auto* Group = NewObject<UPLATEAUCityObjectGroup>(Outer, MakeUniqueObjectName(Outer, UPLATEAUCityObjectGroup::StaticClass(), FName(*Name)));
+        Group->MinLOD = 1;
+
+        FSubDividedCityObject CityObject;
+        CityObject.Name = Name;
+        CityObject.SetCityObjectGroup(Group);
+        CityObject.SelfRoadType = ERRoadTypeMask::Road;
+        CityObject.ParentRoadType = ERRoadTypeMask::Empty;
+        auto& Mesh = CityObject.Meshes.AddDefaulted_GetRef();
+        Mesh.Vertices = { FVector(X0, Y0, 0.f), FVector(X1, Y0, 0.f), FVector(X1, Y1, 0.f), FVector(X0, Y1, 0.f) };
+        Mesh.SubMeshes.AddDefaulted_GetRef().Triangles = { 0, 1, 2, 0, 2, 3 };
+        return CityObject;
+    }
+
+    // Count x Count個の交差点を格子状に道路でつないだ最小地物. 隣り合う道路と交差点は頂点を共有する
+    TArray<FSubDividedCityObject> CreateGridCityObjects(UObject* Outer, int32 Count) {
+        constexpr float IntersectionSize = 2000.f;
+        constexpr float RoadLength = 8000.f;
+        constexpr float Pitch = IntersectionSize + RoadLength;
+
+        TArray<FSubDividedCityObject> Result;
+        for (auto X = 0; X < Count; ++X) {
+            for (auto Y = 0; Y < Count; ++Y) {
+                const auto X0 = X * Pitch;
+                const auto Y0 = Y * Pitch;
+                Result.Add(CreateRect(Outer, FString::Printf(TEXT("Intersection_%d_%d"), X, Y), X0, Y0, X0 + IntersectionSize, Y0 + IntersectionSize));
+                if (X + 1 < Count)
+                    Result.Add(CreateRect(Outer, FString::Printf(TEXT("RoadX_%d_%d"), X, Y), X0 + IntersectionSize, Y0, X0 + Pitch, Y0 + IntersectionSize));
+                if (Y + 1 < Count)
+                    Result.Add(CreateRect(Outer, FString::Printf(TEXT("RoadY_%d_%d"), X, Y), X0, Y0 + IntersectionSize, X0 + IntersectionSize, Y0 + Pitch));
+            }
+        }
+        return Result;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RoadNetworkFactory_Fixture, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RoadNetworkFactory.Fixture", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RoadNetworkFactory_Fixture::RunTest(const FString& Parameters) {
+    auto CityObjects = CreateGridCityObjects(GetTransientPackage(), 2);
+    CityObjects[0].Children.Add(CreateRect(GetTransientPackage(), TEXT("Child"), 0.f, 0.f, 100.f, 100.f));
+    CityObjects[0].Children[0].ParentRoadType = ERRoadTypeMask::Road;
+    CityObjects[0].CityObjectGroup->SetWorldLocation(FVector(100.f, 200.f, 300.f));
+
+    TArray<uint8> Data;
+    FSubDividedCityObjectFixture::Write(CityObjects, Data);
+
+    // 最小地物とCityObjectGroupの情報が復元されること
+    TArray<FSubDividedCityObject> Read;
+    if (!TestTrue("Read", FSubDividedCityObjectFixture::Read(Data, GetTransientPackage(), Read)))
+        return false;
+    if (!TestEqual("Num", Read.Num(), CityObjects.Num()))
+        return false;
+    for (auto i = 0; i < Read.Num(); ++i) {
+        const auto& A = CityObjects[i];
+        const auto& B = Read[i];
+        TestEqual("Name", B.Name, A.Name);
+        TestTrue("RoadType", B.GetRoadType(true) == A.GetRoadType(true));
+        TestTrue("Vertices", B.Meshes.Num() == 1 && B.Meshes[0].Vertices == A.Meshes[0].Vertices);
+        TestTrue("Triangles", B.Meshes.Num() == 1 && B.Meshes[0].SubMeshes.Num() == 1 && B.Meshes[0].SubMeshes[0].Triangles == A.Meshes[0].SubMeshes[0].Triangles);
+        if (!TestTrue("Group", B.CityObjectGroup.IsValid()))
+            continue;
+        TestTrue("Recreated group", B.CityObjectGroup.Get() != A.CityObjectGroup.Get());
+        TestEqual("MinLOD", B.CityObjectGroup->MinLOD, A.CityObjectGroup->MinLOD);
+        TestTrue("Transform", B.CityObjectGroup->GetComponentTransform().Equals(A.CityObjectGroup->GetComponentTransform()));
+    }
+    if (TestEqual("Children", Read[0].Children.Num(), 1)) {
+        TestEqual("Child name", Read[0].Children[0].Name, FString(TEXT("Child")));
+        TestTrue("Child road type", Read[0].Children[0].ParentRoadType == ERRoadTypeMask::Road);
+    }
+
+    // 壊れたデータは読み込まない
+    auto Truncated = Data;
+    Truncated.SetNum(Data.Num() - 1);
+    TestFalse("Truncated", FSubDividedCityObjectFixture::Read(Truncated, GetTransientPackage(), Read));
+    TestEqual("Truncated result", Read.Num(), 0);
+    auto BadMagic = Data;
+    BadMagic[0] ^= 0xFF;
+    TestFalse("Magic", FSubDividedCityObjectFixture::Read(BadMagic, GetTransientPackage(), Read));
+    return true;
+}
+
+/**
+ * 記録した最小地物を道路構造の自動生成に通し, 段階ごとの時間/メモリ/オブジェクト数をJSONで出力します
+ * -RnBenchmarkFixture=<path> : 入力(FRoadNetworkFactory::bSaveBenchmarkFixtureで保存したもの). 省略時は格子状の道路を生成して使う
+ * -RnBenchmarkOutput=<path>  : 出力先. 省略時はSaved/Automation/RoadNetworkFactoryBenchmark.json
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RoadNetworkFactory_Benchmark, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RoadNetworkFactory.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FPLATEAUTest_RoadNetworkFactory_Benchmark::RunTest(const FString& Parameters) {
+    FString FixturePath;
+    FString OutputPath = FPaths::Combine(FPaths::AutomationDir(), TEXT("RoadNetworkFactoryBenchmark.json"));
+    FParse::Value(FCommandLine::Get(), TEXT("RnBenchmarkFixture="), FixturePath);
+    FParse::Value(FCommandLine::Get(), TEXT("RnBenchmarkOutput="), OutputPath);
+
+    // 入力もファイルを経由させて, 記録した入力と同じ経路で読み込む
+    if (FixturePath.IsEmpty()) {
+        FixturePath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("RoadNetworkFactoryBenchmark.rnfixture"));
+        if (!TestTrue("Save fixture", FSubDividedCityObjectFixture::SaveToFile(CreateGridCityObjects(GetTransientPackage(), 30), FixturePath)))
+            return false;
+    }
+
+    FPLATEAURnStageProfiler Profiler;
+    TArray<FSubDividedCityObject> CityObjects;
+    {
+        FPLATEAURnStageProfiler::FScope Stage(&Profiler, TEXT("LoadFixture"));
+        if (!TestTrue("Load fixture", FSubDividedCityObjectFixture::LoadFromFile(FixturePath, GetTransientPackage(), CityObjects)))
+            return false;
+    }
+
+    FRoadNetworkFactory Factory;
+    auto* Model = URnModel::Create();
+    FRoadNetworkFactoryEx::CreateRnModelFromSubDividedCityObjects(Factory, CityObjects, Model, &Profiler);
+    TestTrue("Created", Model->GetRoads().Num() + Model->GetIntersections().Num() > 0);
+
+    TArray<TPair<FString, FString>> Info;
+    Info.Emplace(TEXT("fixture"), FPaths::GetCleanFilename(FixturePath));
+    Info.Emplace(TEXT("factoryVersion"), FRoadNetworkFactory::FactoryVersion);
+    Info.Emplace(TEXT("cityObjects"), FString::FromInt(CityObjects.Num()));
+    const auto Json = Profiler.ToJson(Info);
+    for (const auto& Record : Profiler.GetRecords())
+        AddInfo(FString::Printf(TEXT("%s : %.3f sec, %lld bytes, %d UObjects"), *Record.Name, Record.Seconds, Record.UsedPhysicalDelta, Record.UObjectDelta));
+    AddInfo(Json);
+    TestTrue("Save result", FFileHelper::SaveStringToFile(Json, *OutputPath));
+    return true;
+}
@@ -0,0 +1,161 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "RoadAdjust/RoadNetworkToMesh/PLATEAURoadSurfaceMeshBuilder.h"
+#include "Algo/Reverse.h"
+#include "StaticMeshAttributes.h"
+#include "RoadNetwork/Structure/RnModel.h"
+#include "RoadNetwork/Structure/RnRoad.h"
+#include "RoadNetwork/Structure/RnIntersection.h"
+#include "RoadNetwork/Structure/RnLane.h"
+#include "RoadNetwork/Structure/RnWay.h"
+#include "RoadNetwork/Structure/RnLineString.h"
+#include "RoadNetwork/Structure/RnPoint.h"
+
+namespace {
+    double Cross2D(const FVector& A, const FVector& B, const FVector& C) {
+        return (B.X - A.X) * (C.Y - A.Y) - (B.Y - A.Y) * (C.X - A.X);
+    }
+
+    // 三角形の面積の合計. 裏向きの三角形があればbAllFrontがfalseになる
+    double TriangleArea(TConstArrayView<FVector> Vertices, const TArray<int32>& Indices, bool& bAllFront) {
+        bAllFront = true;
+        double Area = 0.0;
+        for (auto i = 0; i + 2 < Indices.Num(); i += 3) {
+            const auto Cross = Cross2D(Vertices[Indices[i]], Vertices[Indices[i + 1]], Vertices[Indices[i + 2]]);
+            bAllFront &= Cross > 0;
+            Area += FMath::Abs(Cross) * 0.5;
+        }
+        return Area;
+    }
+
+    TArray<FVector> Line(const FVector& Start, const FVector& End, int32 Num) {
+        TArray<FVector> Result;
+        for (auto i = 0; i < Num; ++i)
+            Result.Add(FMath::Lerp(Start, End, static_cast<float>(i) / (Num - 1)));
+        return Result;
+    }
+
+    URnWay* CreateWay(const FVector& Start, const FVector& End) {
+        return URnWay::Create(URnLineString::Create(TArray<FVector>{ Start, End }));
+    }
+
+    // X方向にStartXから長さ1000の2車線道路と, 終端につながる交差点
+    void AddRoadWithIntersection(URnModel* Model, float StartX) {
+        const auto EndX = StartX + 1000.f;
+        auto* Road = URnRoad::Create();
+        for (auto i = 0; i < 2; ++i) {
+            Road->AddMainLane(RnNew<URnLane>(
+                CreateWay(FVector(StartX, i * 300.f, 0.f), FVector(EndX, i * 300.f, 0.f)),
+                CreateWay(FVector(StartX, (i + 1) * 300.f, 0.f), FVector(EndX, (i + 1) * 300.f, 0.f)),
+                CreateWay(FVector(StartX, i * 300.f, 0.f), FVector(StartX, (i + 1) * 300.f, 0.f)),
+                CreateWay(FVector(EndX, i * 300.f, 0.f), FVector(EndX, (i + 1) * 300.f, 0.f))));
+        }
+        Model->AddRoad(Road);
+
+        auto* Intersection = URnIntersection::Create();
+        Intersection->AddEdge(Road, CreateWay(FVector(EndX, 0.f, 0.f), FVector(EndX, 600.f, 0.f)));
+        Intersection->AddEdge(nullptr, CreateWay(FVector(EndX, 600.f, 0.f), FVector(EndX + 600.f, 600.f, 0.f)));
+        Intersection->AddEdge(nullptr, CreateWay(FVector(EndX + 600.f, 600.f, 0.f), FVector(EndX + 600.f, 0.f, 0.f)));
+        Intersection->AddEdge(nullptr, CreateWay(FVector(EndX + 600.f, 0.f, 0.f), FVector(EndX, 0.f, 0.f)));
+        Road->SetNext(Intersection);
+        Model->AddIntersection(Intersection);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RoadSurfaceMeshBuilder_Triangulate, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RoadSurfaceMeshBuilder.Triangulate", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RoadSurfaceMeshBuilder_Triangulate::RunTest(const FString& Parameters) {
+    bool bAllFront;
+
+    // 頂点数の異なる2本の線に挟まれた1000x300の帯
+    {
+        const auto Left = Line(FVector(0, 0, 0), FVector(1000, 0, 0), 5);
+        const auto Right = Line(FVector(0, 300, 0), FVector(1000, 300, 0), 3);
+        const auto Indices = FPLATEAURoadSurfaceMeshBuilder::TriangulateStrip(Left, Right);
+        TArray<FVector> Vertices = Left;
+        Vertices.Append(Right);
+        TestEqual("Strip triangle num", Indices.Num() / 3, Left.Num() + Right.Num() - 2);
+        TestTrue("Strip area", FMath::IsNearlyEqual(TriangleArea(Vertices, Indices, bAllFront), 1000.0 * 300.0, 1.0));
+        TestTrue("Strip front face", bAllFront);
+    }
+
+    // L字の多角形. 時計回り/反時計回りのどちらでも同じ面積で表向きに分割される
+    {
+        TArray<FVector> Outline{
+            FVector(0, 0, 0), FVector(0, 200, 0), FVector(100, 200, 0),
+            FVector(100, 100, 0), FVector(200, 100, 0), FVector(200, 0, 0),
+        };
+        for (auto k = 0; k < 2; ++k) {
+            const auto Indices = FPLATEAURoadSurfaceMeshBuilder::TriangulatePolygon(Outline);
+            TestEqual("Polygon triangle num", Indices.Num() / 3, Outline.Num() - 2);
+            TestTrue("Polygon area", FMath::IsNearlyEqual(TriangleArea(Outline, Indices, bAllFront), 30000.0, 1.0));
+            TestTrue("Polygon front face", bAllFront);
+            Algo::Reverse(Outline);
+        }
+
+        // 閉じた輪郭(終点=始点)も同じ結果
+        auto Closed = Outline;
+        Closed.Add(Outline[0]);
+        TestEqual("Closed outline", FPLATEAURoadSurfaceMeshBuilder::TriangulatePolygon(Closed).Num(), (Outline.Num() - 2) * 3);
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RoadSurfaceMeshBuilder_Build, "PLATEAUTest.FPLATEAUTest.RoadNetwork.RoadSurfaceMeshBuilder.Build", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RoadSurfaceMeshBuilder_Build::RunTest(const FString& Parameters) {
+    // 逆向きの線同士でもそろえてから分割する
+    {
+        FPLATEAURoadSurfaceMeshBuilder Builder(100000.f);
+        auto Right = Line(FVector(0, 300, 0), FVector(1000, 300, 0), 4);
+        Algo::Reverse(Right);
+        Builder.AddStrip(EPLATEAURoadSurfaceType::SideWalk, Line(FVector(0, 0, 0), FVector(1000, 0, 0), 4), Right);
+        const auto ChunkMeshes = Builder.Build();
+        TestEqual("Reversed strip chunk num", ChunkMeshes.Num(), 1);
+        if (ChunkMeshes.Num() == 1) {
+            const auto& MeshDescription = ChunkMeshes[0].MeshDescription;
+            TestEqual("Reversed strip triangle num", MeshDescription.Triangles().Num(), 6);
+            TestEqual("Side walk polygon group", MeshDescription.GetNumPolygonGroupTriangles(FPolygonGroupID(static_cast<int32>(EPLATEAURoadSurfaceType::SideWalk))), 6);
+        }
+    }
+
+    // 2000cm間隔で道路と交差点を並べ, 5000cmのチャンクにまとめる
+    auto* Model = URnModel::Create();
+    const auto RoadNum = 6;
+    for (auto i = 0; i < RoadNum; ++i)
+        AddRoadWithIntersection(Model, i * 2000.f);
+
+    FPLATEAURoadSurfaceMeshBuilder Builder(5000.f);
+    Builder.AddModel(Model);
+    TestEqual("Surface num", Builder.Num(), RoadNum * 3);
+
+    const auto ChunkMeshes = Builder.Build();
+    TestEqual("Chunk num", ChunkMeshes.Num(), 3);
+
+    TSet<FIntPoint> Chunks;
+    auto SurfaceNum = 0;
+    for (const auto& ChunkMesh : ChunkMeshes) {
+        Chunks.Add(ChunkMesh.Chunk);
+        SurfaceNum += ChunkMesh.SurfaceNum;
+        const auto& MeshDescription = ChunkMesh.MeshDescription;
+        TestEqual("Polygon group num", MeshDescription.PolygonGroups().Num(), FPLATEAURoadSurfaceMeshBuilder::SurfaceTypeNum);
+        TestTrue("Has lane", MeshDescription.GetNumPolygonGroupTriangles(FPolygonGroupID(static_cast<int32>(EPLATEAURoadSurfaceType::Lane))) > 0);
+        TestTrue("Has intersection", MeshDescription.GetNumPolygonGroupTriangles(FPolygonGroupID(static_cast<int32>(EPLATEAURoadSurfaceType::Intersection))) > 0);
+
+        const FStaticMeshConstAttributes Attributes(MeshDescription);
+        TestEqual("Slot name", Attributes.GetPolygonGroupMaterialSlotNames()[FPolygonGroupID(0)], FPLATEAURoadSurfaceMeshBuilder::GetMaterialSlotName(EPLATEAURoadSurfaceType::Lane));
+
+        // 全ての三角形が上向き
+        for (const auto TriangleID : MeshDescription.Triangles().GetElementIDs()) {
+            const auto Normal = Attributes.GetVertexInstanceNormals()[MeshDescription.GetTriangleVertexInstance(TriangleID, 0)];
+            if (Normal.Z <= 0.f) {
+                AddError("Triangle faces down");
+                break;
+            }
+        }
+    }
+    TestEqual("Unique chunks", Chunks.Num(), ChunkMeshes.Num());
+    TestEqual("All surfaces in chunks", SurfaceNum, Builder.Num());
+    return true;
+}
@@ -0,0 +1,88 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUTests/Tests/PLATEAUAutomationTestBase.h"
+#include "RoadNetwork/CityObject/SubDividedCityObject.h"
+
+namespace {
+    // 高速化前のFSubDividedCityObjectSubMesh::Separate
+    TArray<FSubDividedCityObjectSubMesh> LegacySeparate(const TArray<int32>& Triangles) {
+        TArray<FSubDividedCityObjectSubMesh> Result;
+        TArray<bool> Used;
+        Used.SetNum(Triangles.Num() / 3);
+
+        for (int32 i = 0; i < Used.Num(); ++i) {
+            if (Used[i]) continue;
+
+            FSubDividedCityObjectSubMesh NewMesh;
+            TArray<int32> Stack = { i };
+            while (Stack.Num() > 0) {
+                int32 Current = Stack.Pop();
+                if (Used[Current]) continue;
+
+                Used[Current] = true;
+                for (int32 j = 0; j < 3; ++j)
+                    NewMesh.Triangles.Add(Triangles[Current * 3 + j]);
+
+                for (int32 j = 0; j < Used.Num(); ++j) {
+                    if (Used[j]) continue;
+                    bool IsConnected = false;
+                    for (int32 k = 0; k < 3 && !IsConnected; ++k) {
+                        for (int32 l = 0; l < 3; ++l) {
+                            if (Triangles[Current * 3 + k] == Triangles[j * 3 + l]) {
+                                IsConnected = true;
+                                break;
+                            }
+                        }
+                    }
+                    if (IsConnected)
+                        Stack.Add(j);
+                }
+            }
+            Result.Add(NewMesh);
+        }
+        return Result;
+    }
+
+    // 三角形の集合として比較するためにソートする
+    TArray<FIntVector> ToSortedTriangles(const TArray<int32>& Triangles) {
+        TArray<FIntVector> Result;
+        for (auto i = 0; i + 2 < Triangles.Num(); i += 3)
+            Result.Add(FIntVector(Triangles[i], Triangles[i + 1], Triangles[i + 2]));
+        Result.Sort([](const FIntVector& A, const FIntVector& B) {
+            return A.X != B.X ? A.X < B.X : (A.Y != B.Y ? A.Y < B.Y : A.Z < B.Z);
+        });
+        return Result;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_SubDividedCityObject_Separate, "PLATEAUTest.FPLATEAUTest.RoadNetwork.SubDividedCityObject.Separate", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_SubDividedCityObject_Separate::RunTest(const FString& Parameters) {
+    // 頂点を共有する三角形がまとまり, 高速化前と同じグループ(順番も同じ)になること
+    FRandomStream Random(20240407);
+    for (auto Case = 0; Case < 10; ++Case) {
+        FSubDividedCityObjectSubMesh SubMesh;
+        const auto VertexNum = Random.RandRange(10, 300);
+        const auto TriangleNum = Random.RandRange(1, 200);
+        for (auto i = 0; i < TriangleNum * 3; ++i)
+            SubMesh.Triangles.Add(Random.RandHelper(VertexNum));
+
+        const auto Context = FString::Printf(TEXT("Case %d"), Case);
+        const auto Actual = SubMesh.Separate();
+        const auto Expected = LegacySeparate(SubMesh.Triangles);
+        if (!TestEqual(Context + TEXT(" group count"), Actual.Num(), Expected.Num()))
+            continue;
+        for (auto i = 0; i < Actual.Num(); ++i)
+            TestTrue(Context + TEXT(" same group"), ToSortedTriangles(Actual[i].Triangles) == ToSortedTriangles(Expected[i].Triangles));
+    }
+
+    // 頂点を共有しない2つの三角形は別のグループになる
+    FSubDividedCityObjectSubMesh SubMesh;
+    SubMesh.Triangles = { 0, 1, 2, 3, 4, 5, 2, 6, 7 };
+    const auto Groups = SubMesh.Separate();
+    if (TestEqual("Separated group count", Groups.Num(), 2)) {
+        TestTrue("First group", Groups[0].Triangles == TArray<int32>({ 0, 1, 2, 2, 6, 7 }));
+        TestTrue("Second group", Groups[1].Triangles == TArray<int32>({ 3, 4, 5 }));
+    }
+    return true;
+}